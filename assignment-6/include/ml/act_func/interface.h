@@ -3,6 +3,9 @@
  */
 #pragma once
 
+#include "ml/act_func/type.h"
+#include "ml/scalar.h"
+
 namespace ml::act_func
 {
 /**
@@ -23,7 +26,7 @@ public:
      * 
      * @return The activation function value at the given input.
      */
-    virtual double output(double input) const noexcept = 0;
+    virtual Scalar output(Scalar input) const noexcept = 0;
 
     /**
      * @brief Compute the activation function derivative (delta for backpropagation).
@@ -32,6 +35,13 @@ public:
      * 
      * @return The derivative value at the given input.
      */
-    virtual double delta(double input) const noexcept = 0;
+    virtual Scalar delta(Scalar input) const noexcept = 0;
+
+    /**
+     * @brief Get the activation function type.
+     * 
+     * @return The activation function type.
+     */
+    virtual Type type() const noexcept = 0;
 };
 } // namespace ml::act_func
@@ -0,0 +1,171 @@
+/**
+ * @brief Vectorized activation function kernels.
+ */
+#pragma once
+
+#include <cstddef>
+
+#include "ml/act_func/type.h"
+#include "ml/scalar.h"
+
+namespace ml::act_func
+{
+/**
+ * @brief Vectorized activation function kernels.
+ *
+ *        The kernels are selected once, when the kernel object is created, and each apply
+ *        the activation function to a whole buffer. The loops are instantiated for every
+ *        activation function and compiled for every SIMD level (see ml/linalg/simd.h), so
+ *        the function is inlined and the loops are vectorized, as opposed to calling
+ *        act_func::Interface once per element. The SIMD level active when the kernel object
+ *        is created is used.
+ *
+ *        The derivatives are computed from the cached outputs y = f(x) rather than from
+ *        the inputs, which avoids evaluating the activation function again:
+ *        - ReLU: 1 where y > 0, else 0 (a mask).
+ *        - Leaky ReLU: 1 where y > 0, else the slope.
+ *        - Tanh: 1 - y^2.
+ *        - Sigmoid: y * (1 - y).
+ *
+ *        In single precision builds (ML_FLOAT32), tanh and sigmoid use the rational
+ *        approximation of fastTanh(), else they are exact.
+ */
+class Kernel final
+{
+public:
+    /**
+     * @brief Create kernels for given activation function.
+     *
+     * @param[in] type The activation function type (default = none).
+     */
+    explicit Kernel(Type type = Type::None) noexcept;
+
+    /**
+     * @brief Get the activation function type.
+     *
+     * @return The activation function type.
+     */
+    Type type() const noexcept { return myType; }
+
+    /**
+     * @brief Apply the activation function, i.e. out[i] = f(in[i]).
+     *
+     * @param[in] n Number of elements.
+     * @param[in] in Pointer to the inputs.
+     * @param[out] out Pointer to the outputs, may equal the inputs.
+     */
+    void forward(const std::size_t n, const Scalar* in, Scalar* out) const noexcept
+    {
+        myForward(n, in, out);
+    }
+
+    /**
+     * @brief Add a bias and apply the activation function, i.e. data[i] = f(data[i] + bias).
+     *
+     * @param[in] n Number of elements.
+     * @param[in] bias The bias to add to every element.
+     * @param[in, out] data Pointer to the sums, replaced by the outputs.
+     */
+    void forward(const std::size_t n, const Scalar bias, Scalar* data) const noexcept
+    {
+        myForwardBias(n, bias, data);
+    }
+
+    /**
+     * @brief Add biases and apply the activation function, i.e. data[i] = f(data[i] + bias[i]).
+     *
+     * @param[in] n Number of elements.
+     * @param[in] bias Pointer to the biases, one per element.
+     * @param[in, out] data Pointer to the sums, replaced by the outputs.
+     */
+    void forwardBiases(const std::size_t n, const Scalar* bias, Scalar* data) const noexcept
+    {
+        myForwardBiases(n, bias, data);
+    }
+
+    /**
+     * @brief Compute the deltas from the outputs, i.e. delta[i] = gradients[i] * f'(x[i]),
+     *        where f'(x[i]) is computed from out[i] = f(x[i]).
+     *
+     * @param[in] n Number of elements.
+     * @param[in] out Pointer to the outputs of the activation function.
+     * @param[in] gradients Pointer to the output gradients.
+     * @param[out] delta Pointer to the deltas, may equal the gradients.
+     */
+    void backwardFromOutput(const std::size_t n, const Scalar* out, const Scalar* gradients,
+                            Scalar* delta) const noexcept
+    {
+        myBackward(n, out, gradients, delta);
+    }
+
+private:
+    /** Kernel applying the activation function. */
+    using Forward = void (*)(std::size_t n, const Scalar* in, Scalar* out) noexcept;
+
+    /** Kernel adding a single bias before the activation. */
+    using ForwardBias = void (*)(std::size_t n, Scalar bias, Scalar* data) noexcept;
+
+    /** Kernel adding one bias per element before the activation. */
+    using ForwardBiases = void (*)(std::size_t n, const Scalar* bias, Scalar* data) noexcept;
+
+    /** Kernel computing the deltas from the outputs. */
+    using Backward = void (*)(std::size_t n, const Scalar* out, const Scalar* gradients,
+                              Scalar* delta) noexcept;
+
+    template <typename Op>
+    void select() noexcept;
+
+    /** Activation function type. */
+    Type myType;
+
+    /** Kernel applying the activation function. */
+    Forward myForward;
+
+    /** Kernel adding a single bias before the activation. */
+    ForwardBias myForwardBias;
+
+    /** Kernel adding one bias per element before the activation. */
+    ForwardBiases myForwardBiases;
+
+    /** Kernel computing the deltas from the outputs. */
+    Backward myBackward;
+};
+
+/**
+ * @brief Compute tanh via a vectorizable rational approximation, out[i] ~ tanh(in[i]).
+ *
+ *        Uses a [13/6] rational function of the input clamped to [-7.9053, 7.9053], beyond
+ *        which tanh rounds to +-1 in single precision. The absolute error is below 4e-7 in
+ *        single precision (a few ulp) and below 3e-7 in double precision, so the
+ *        approximation is meant for single precision.
+ *
+ * @param[in] n Number of elements.
+ * @param[in] in Pointer to the inputs.
+ * @param[out] out Pointer to the outputs, may equal the inputs.
+ */
+void fastTanh(std::size_t n, const Scalar* in, Scalar* out) noexcept;
+
+/**
+ * @brief Compute the softmax of a vector, out[i] = e^in[i] / sum_j(e^in[j]).
+ *
+ *        The maximum input is subtracted before exponentiation, so large inputs don't
+ *        overflow.
+ *
+ * @param[in] n Number of elements. Must be greater than 0.
+ * @param[in] in Pointer to the inputs.
+ * @param[out] out Pointer to the outputs, may equal the inputs.
+ */
+void softmax(std::size_t n, const Scalar* in, Scalar* out) noexcept;
+
+/**
+ * @brief Compute the input gradients of softmax from its outputs,
+ *        i.e. delta[i] = out[i] * (gradients[i] - sum_j(gradients[j] * out[j])).
+ *
+ * @param[in] n Number of elements.
+ * @param[in] out Pointer to the outputs of the softmax.
+ * @param[in] gradients Pointer to the output gradients.
+ * @param[out] delta Pointer to the input gradients, may equal the output gradients.
+ */
+void softmaxBackwardFromOutput(std::size_t n, const Scalar* out, const Scalar* gradients,
+                               Scalar* delta) noexcept;
+} // namespace ml::act_func
@@ -0,0 +1,73 @@
+/**
+ * @brief Leaky ReLU (Rectified Linear Unit) activation function implementation.
+ */
+#pragma once
+
+#include "ml/act_func/interface.h"
+#include "ml/act_func/type.h"
+#include "ml/scalar.h"
+
+namespace ml::act_func
+{
+/**
+ * @brief Leaky ReLU (Rectified Linear Unit) activation function implementation.
+ * 
+ *        Unlike ReLU, negative inputs keep a small gradient, so nodes cannot get stuck
+ *        at 0.
+ * 
+ *        This class is non-copyable and non-movable.
+ */
+class LeakyRelu final : public Interface
+{
+public:
+    /** Slope for negative inputs. */
+    static constexpr Scalar Slope{static_cast<Scalar>(0.01)};
+
+    /** 
+     * @brief Constructor. 
+     */
+    LeakyRelu() noexcept = default;
+
+    /**
+     * @brief Destructor.
+     */
+    ~LeakyRelu() noexcept override = default;
+
+    /**
+     * @brief Compute the activation function output.
+     * 
+     * @param[in] input The activation function input.
+     * 
+     * @return The input if positive, otherwise the input times the slope 
+     *         (f(x) = x if x > 0, else 0.01x).
+     */
+    Scalar output(const Scalar input) const noexcept override 
+    { 
+        return Scalar{} < input ? input : Slope * input; 
+    }
+
+    /**
+     * @brief Compute the activation function derivative (delta for backpropagation).
+     * 
+     * @param[in] input The activation function input.
+     * 
+     * @return 1 if input is positive, otherwise the slope (f'(x) = 1 if x > 0, else 0.01).
+     */
+    Scalar delta(const Scalar input) const noexcept override 
+    { 
+        return Scalar{} < input ? Scalar{1} : Slope; 
+    }
+
+    /**
+     * @brief Get the activation function type.
+     * 
+     * @return The activation function type (leaky ReLU).
+     */
+    Type type() const noexcept override { return Type::LeakyRelu; }
+
+    LeakyRelu(const LeakyRelu&)            = delete; // No copy constructor.
+    LeakyRelu(LeakyRelu&&)                 = delete; // No move constructor.
+    LeakyRelu& operator=(const LeakyRelu&) = delete; // No copy assignment.
+    LeakyRelu& operator=(LeakyRelu&&)      = delete; // No move assignment.
+};
+} // namespace ml::act_func
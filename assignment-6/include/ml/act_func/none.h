@@ -4,6 +4,8 @@
 #pragma once
 
 #include "ml/act_func/interface.h"
+#include "ml/act_func/type.h"
+#include "ml/scalar.h"
 
 namespace ml::act_func
 {
@@ -32,7 +34,7 @@ public:
      * 
      * @return The input value (identity function: f(x) = x).
      */
-    double output(const double input) const noexcept override { return input; }
+    Scalar output(const Scalar input) const noexcept override { return input; }
 
     /**
      * @brief Compute the activation function derivative (delta for backpropagation).
@@ -41,13 +43,20 @@ public:
      * 
      * @return Always returns 1 (derivative of identity function: f'(x) = 1).
      */
-    double delta(const double input) const noexcept override 
+    Scalar delta(const Scalar input) const noexcept override 
     {
-        constexpr double deltaVal{1.0};
+        constexpr Scalar deltaVal{1.0};
         (void)(input); 
         return deltaVal;
     }
 
+    /**
+     * @brief Get the activation function type.
+     * 
+     * @return The activation function type (identity).
+     */
+    Type type() const noexcept override { return Type::None; }
+
     None(const None&)            = delete; // No copy constructor.
     None(None&&)                 = delete; // No move constructor.
     None& operator=(const None&) = delete; // No copy assignment.
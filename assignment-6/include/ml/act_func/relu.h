@@ -4,6 +4,8 @@
 #pragma once
 
 #include "ml/act_func/interface.h"
+#include "ml/act_func/type.h"
+#include "ml/scalar.h"
 
 namespace ml::act_func
 {
@@ -32,7 +34,10 @@ public:
      * 
      * @return The input if positive, otherwise 0 (ReLU function: f(x) = max(0, x)).
      */
-    double output(const double input) const noexcept override { return 0.0 < input ? input : 0.0; }
+    Scalar output(const Scalar input) const noexcept override 
+    { 
+        return Scalar{} < input ? input : Scalar{}; 
+    }
 
     /**
      * @brief Compute the activation function derivative (delta for backpropagation).
@@ -41,7 +46,17 @@ public:
      * 
      * @return 1 if input is positive, otherwise 0 (ReLU derivative: f'(x) = 1 if x > 0, else 0).
      */
-    double delta(const double input) const noexcept override { return 0.0 < input ? 1.0 : 0.0; }
+    Scalar delta(const Scalar input) const noexcept override 
+    { 
+        return Scalar{} < input ? Scalar{1} : Scalar{}; 
+    }
+
+    /**
+     * @brief Get the activation function type.
+     * 
+     * @return The activation function type (ReLU).
+     */
+    Type type() const noexcept override { return Type::Relu; }
 
     Relu(const Relu&)            = delete; // No copy constructor.
     Relu(Relu&&)                 = delete; // No move constructor.
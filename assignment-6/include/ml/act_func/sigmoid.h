@@ -0,0 +1,69 @@
+/**
+ * @brief Sigmoid (logistic) activation function implementation.
+ */
+#pragma once
+
+#include <cmath>
+
+#include "ml/act_func/interface.h"
+#include "ml/act_func/type.h"
+#include "ml/scalar.h"
+
+namespace ml::act_func
+{
+/**
+ * @brief Sigmoid (logistic) activation function implementation.
+ * 
+ *        This class is non-copyable and non-movable.
+ */
+class Sigmoid final : public Interface
+{
+public:
+    /** 
+     * @brief Constructor. 
+     */
+    Sigmoid() noexcept = default;
+
+    /**
+     * @brief Destructor.
+     */
+    ~Sigmoid() noexcept override = default;
+
+    /**
+     * @brief Compute the activation function output.
+     * 
+     * @param[in] input The activation function input.
+     * 
+     * @return Sigmoid of input (sigmoid function: f(x) = 1 / (1 + e^-x), range [0, 1]).
+     */
+    Scalar output(const Scalar input) const noexcept override 
+    { 
+        return Scalar{1} / (Scalar{1} + std::exp(-input)); 
+    }
+
+    /**
+     * @brief Compute the activation function derivative (delta for backpropagation).
+     * 
+     * @param[in] input The activation function input.
+     * 
+     * @return Derivative of sigmoid (f'(x) = f(x) * (1 - f(x))).
+     */
+    Scalar delta(const Scalar input) const noexcept override 
+    { 
+        const Scalar sigmoidOutput{output(input)};
+        return sigmoidOutput * (Scalar{1} - sigmoidOutput);
+    }
+
+    /**
+     * @brief Get the activation function type.
+     * 
+     * @return The activation function type (sigmoid).
+     */
+    Type type() const noexcept override { return Type::Sigmoid; }
+
+    Sigmoid(const Sigmoid&)            = delete; // No copy constructor.
+    Sigmoid(Sigmoid&&)                 = delete; // No move constructor.
+    Sigmoid& operator=(const Sigmoid&) = delete; // No copy assignment.
+    Sigmoid& operator=(Sigmoid&&)      = delete; // No move assignment.
+};
+} // namespace ml::act_func
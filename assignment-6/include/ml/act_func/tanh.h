@@ -6,6 +6,8 @@
 #include <cmath>
 
 #include "ml/act_func/interface.h"
+#include "ml/act_func/type.h"
+#include "ml/scalar.h"
 
 namespace ml::act_func
 {
@@ -34,7 +36,7 @@ public:
      * 
      * @return Hyperbolic tangent of input (tanh function: f(x) = tanh(x), range [-1, 1]).
      */
-    double output(const double input) const noexcept override { return std::tanh(input); }
+    Scalar output(const Scalar input) const noexcept override { return std::tanh(input); }
 
     /**
      * @brief Compute the activation function derivative (delta for backpropagation).
@@ -43,12 +45,19 @@ public:
      * 
      * @return Derivative of tanh (f'(x) = 1 - tanh²(x)).
      */
-    double delta(const double input) const noexcept override 
+    Scalar delta(const Scalar input) const noexcept override 
     { 
-        const double tanhOutput{std::tanh(input)};
+        const Scalar tanhOutput{std::tanh(input)};
         return 1.0 - tanhOutput * tanhOutput;
     }
 
+    /**
+     * @brief Get the activation function type.
+     * 
+     * @return The activation function type (tanh).
+     */
+    Type type() const noexcept override { return Type::Tanh; }
+
     Tanh(const Tanh&)            = delete; // No copy constructor.
     Tanh(Tanh&&)                 = delete; // No move constructor.
     Tanh& operator=(const Tanh&) = delete; // No copy assignment.
@@ -12,8 +12,10 @@ namespace ml::act_func
  */
 enum class Type : std::uint8_t
 {
-    Relu, ///< ReLU (Rectified Linear Unit).
-    Tanh, ///< Hyperbolic tangent.
-    None, ///< Identity/no activation function.
+    Relu,      ///< ReLU (Rectified Linear Unit).
+    Tanh,      ///< Hyperbolic tangent.
+    None,      ///< Identity/no activation function.
+    Sigmoid,   ///< Logistic sigmoid.
+    LeakyRelu, ///< Leaky ReLU, with a small slope for negative inputs.
 };
 } // namespace ml::act_func
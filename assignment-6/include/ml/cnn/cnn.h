@@ -3,12 +3,46 @@
  */
 #pragma once
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "ml/act_func/type.h"
 #include "ml/cnn/interface.h"
+#include "ml/conv_layer/algorithm/type.h"
+#include "ml/dataset/interface.h"
+#include "ml/memory/buffer.h"
+#include "ml/memory/mapped_file.h"
+#include "ml/memory/planner.h"
+#include "ml/optimizer/optimizer.h"
+#include "ml/parameter_mode.h"
+#include "ml/tensor.h"
 #include "ml/types.h"
 
+namespace ml::dataset { class Pipeline; }
+namespace ml::quant { class QuantizedCnn; }
+
 namespace ml::cnn
 {
+/**
+ * @brief Description of a multi-channel convolutional stage, i.e. a multi-channel
+ *        convolutional layer optionally followed by a max pooling layer.
+ */
+struct ConvStage
+{
+    /** Number of output channels (filters), at most or a multiple of conv_layer::ChannelBlock. */
+    std::size_t channelCount;
+
+    /** Kernel size. */
+    std::size_t kernelSize;
+
+    /** Activation function. */
+    act_func::Type actFunc;
+
+    /** Pooling layer size, 1 for no pooling layer. */
+    std::size_t poolSize;
+};
+
 /**
  * @brief Convolutional neural network (CNN) implementation.
  */
@@ -25,9 +59,30 @@ public:
      * @param[in] poolSize Pooling layer size.
      * @param[in] denseOutput Dense layer output size.
      * @param[in] denseFunc Dense layer activation function.
+     * @param[in] convAlgorithm Convolutional layer algorithm (default = direct).
      */
     explicit Cnn(factory::Interface& factory, std::size_t convInput, std::size_t convKernel,
                  act_func::Type convFunc, std::size_t poolSize, std::size_t denseOutput,
+                 act_func::Type denseFunc, 
+                 conv_layer::algorithm::Type convAlgorithm = conv_layer::algorithm::Type::Direct);
+
+    /**
+     * @brief Constructor for a network with multi-channel convolutional layers.
+     * 
+     *        The first stage takes a single-channel input, every further stage takes the
+     *        channels of the previous stage. The feature maps are stored in the
+     *        channel-blocked layout (see ml/conv_layer/layout.h).
+     * 
+     * @param[in] factory Machine learning factory.
+     * @param[in] inputSize Input size.
+     * @param[in] stages The convolutional stages in forward order. Must not be empty.
+     * @param[in] denseOutput Dense layer output size.
+     * @param[in] denseFunc Dense layer activation function.
+     * 
+     * @throw std::invalid_argument If there are no stages or if a stage is invalid.
+     */
+    explicit Cnn(factory::Interface& factory, std::size_t inputSize, 
+                 const std::vector<ConvStage>& stages, std::size_t denseOutput, 
                  act_func::Type denseFunc);
 
     /**
@@ -52,11 +107,32 @@ public:
     /**
      * @brief Predict based on the given input.
      * 
+     *        The activations are stored in the layers, so prediction is not thread-safe. Use
+     *        one ml::cnn::InferenceContext per thread for concurrent inference. Each pooling 
+     *        layer is fused with the layer before it, whose output is then not stored.
+     * 
      * @param[in] input Input for which to predict.
      * 
      * @return The predicted output.
      */
-    const Matrix1d& predict(const Matrix2d& input) noexcept override;
+    const Tensor& predict(const Tensor& input) noexcept override;
+
+    /**
+     * @brief Predict based on a batch of inputs.
+     * 
+     *        The inputs are fed through every layer a batch at a time, so that each weight 
+     *        set is traversed once per batch rather than once per input. The batches are 
+     *        limited to a tile small enough for the outputs of every layer to stay cached 
+     *        between the layers, and each pooling layer is fused with the layer before it.
+     * 
+     * @param[in] inputs Inputs for which to predict, shape (set count, input size, input size).
+     * @param[out] outputs Tensor in which to store the predicted outputs, shape 
+     *                     (set count, output size). May be a view of a caller-provided buffer.
+     * @param[in] batchSize Maximum number of inputs per batch (default = 32).
+     * 
+     * @return True on success, false on failure.
+     */
+    bool predictBatch(const Tensor& inputs, Tensor& outputs, std::size_t batchSize = 32U);
 
     /**
      * @brief Add dense layer.
@@ -68,18 +144,121 @@ public:
      */
     void addDenseLayer(std::size_t outputSize, act_func::Type actFunc);
 
+    /**
+     * @brief Get the convolutional layers (including the pooling layers) in forward order.
+     * 
+     * @return Reference to the convolutional layers.
+     */
+    const ConvLayerList& convLayers() const noexcept { return myConvLayers; }
+
+    /**
+     * @brief Get the dense layers in forward order.
+     * 
+     * @return Reference to the dense layers.
+     */
+    const DenseLayerList& denseLayers() const noexcept { return myDenseLayers; }
+
     /**
      * @brief Train the network.
      * 
-     * @param[in] trainIn Training input sets.
-     * @param[in] trainOut Training output sets.
+     *        The training sets are processed in mini-batches in shuffled order. Each batch is
+     *        fed through every layer at once, after which the gradients are averaged over the
+     *        batch and the parameters are optimized once.
+     * 
+     * @param[in] trainIn Training input sets, shape (set count, input size, input size).
+     * @param[in] trainOut Training output sets, shape (set count, output size).
      * @param[in] epochCount Number of epochs to train the model.
      * @param[in] learningRate Learning rate to use during training.
+     * @param[in] batchSize Number of training sets per batch (default = 1).
+     * 
+     * @return True on success, false on failure.
+     */
+    bool train(const Tensor& trainIn, const Tensor& trainOut, std::size_t epochCount,
+               double learningRate, std::size_t batchSize = 1U);
+
+    /**
+     * @brief Train the network on a dataset.
+     * 
+     *        The samples are loaded from the dataset into the batch buffers of the network
+     *        batch by batch, in shuffled order, so the dataset never needs to be held in
+     *        memory as tensors.
+     * 
+     * @param[in] dataset Training dataset, whose input and output size must match the network.
+     * @param[in] epochCount Number of epochs to train the model.
+     * @param[in] learningRate Learning rate to use during training.
+     * @param[in] batchSize Number of training sets per batch (default = 1).
+     * 
+     * @return True on success, false on failure.
+     */
+    bool train(const dataset::Interface& dataset, std::size_t epochCount, double learningRate,
+               std::size_t batchSize = 1U);
+
+    /**
+     * @brief Train the network on the batches of an input pipeline.
+     * 
+     *        The pipeline prepares the batches in the background, so the network doesn't wait
+     *        for the data as long as the workers keep up. Trains every remaining batch of the
+     *        pipeline, i.e. the epoch count and the batch size of the pipeline.
+     * 
+     * @param[in] pipeline Input pipeline, whose input and output size must match the network.
+     * @param[in] learningRate Learning rate to use during training.
      * 
      * @return True on success, false on failure.
      */
-    bool train(const Matrix3d& trainIn, const Matrix2d& trainOut, std::size_t epochCount,
-               double learningRate);
+    bool train(dataset::Pipeline& pipeline, double learningRate);
+
+    /**
+     * @brief Get the peak memory of the batch buffers (activations and gradients).
+     * 
+     *        The batch buffers of all layers are placed in a single arena, planned separately
+     *        for inference and training, where buffers that are never live at the same time
+     *        share memory. The arena holds the inference plan until the first training step.
+     * 
+     * @return The memory report for the current max batch size.
+     */
+    memory::Report memoryReport() const noexcept;
+
+    /**
+     * @brief Get the optimizer used during training.
+     * 
+     * @return Reference to the optimizer.
+     */
+    const optimizer::Optimizer& optimizer() const noexcept { return *myOptimizer; }
+
+    /**
+     * @brief Set the optimizer used during training.
+     * 
+     *        Plain SGD (the default) is applied by the layers themselves, fused with the
+     *        gradient computation. Every other optimizer type keeps its state for the whole
+     *        network and updates all parameters in one fused pass after the gradients have
+     *        been computed. Setting an optimizer resets the optimizer state.
+     * 
+     * @param[in] config Optimizer settings.
+     * 
+     * @throw std::invalid_argument If any hyperparameter is out of range.
+     */
+    void setOptimizer(const optimizer::Config& config);
+
+    /**
+     * @brief Get the number of threads used to split the work inside the layers.
+     * 
+     * @return The number of threads (including the calling thread).
+     */
+    std::size_t threadCount() const noexcept;
+
+    /**
+     * @brief Set the number of threads used to split the work inside the layers.
+     * 
+     *        The threads belong to the thread pool shared by all networks, so the setting
+     *        applies to every network. Layers too small to benefit always run on the calling
+     *        thread. Must not be called during prediction or training.
+     * 
+     * @param[in] threadCount The number of threads (including the calling thread). 
+     *                        Must be greater than 0.
+     * 
+     * @throw std::invalid_argument If the thread count is 0.
+     */
+    void setThreadCount(std::size_t threadCount);
 
     Cnn()                      = delete; // No default constructor.
     Cnn(const Cnn&)            = delete; // No copy constructor.
@@ -88,13 +267,46 @@ public:
     Cnn& operator=(Cnn&&)      = delete; // No move constructor.
 
 private:
-    const Matrix1d& output() const noexcept;
-    const Matrix2d& convOutput() const noexcept;
+    friend class InferenceContext;
+    friend class ParallelTrainer;
+    friend class quant::QuantizedCnn;
+    friend bool saveModel(Cnn& cnn, const std::string& path);
+    friend std::unique_ptr<Cnn> loadModel(factory::Interface& factory, const std::string& path,
+                                          memory::Access access);
+
+    // Constructors creating the layers in given parameter mode, see ml::ParameterMode.
+    explicit Cnn(ParameterMode mode, factory::Interface& factory, std::size_t convInput,
+                 std::size_t convKernel, act_func::Type convFunc, std::size_t poolSize,
+                 std::size_t denseOutput, act_func::Type denseFunc,
+                 conv_layer::algorithm::Type convAlgorithm);
+    explicit Cnn(ParameterMode mode, factory::Interface& factory, std::size_t inputSize,
+                 const std::vector<ConvStage>& stages, std::size_t denseOutput,
+                 act_func::Type denseFunc);
+    void addDenseLayer(std::size_t outputSize, act_func::Type actFunc, ParameterMode mode);
+
+    std::size_t checkTrainArgs(const dataset::Interface& dataset, std::size_t epochCount,
+                               double learningRate, std::size_t batchSize) const noexcept;
+    std::unique_ptr<Cnn> replicate(bool shared = false);
+    std::unique_ptr<Cnn> replicateLayers(ParameterMode mode);
+    TensorList parameters();
+    TensorList gradients();
+    bool shareParameters(Cnn& source) noexcept;
+    const Tensor& output() const noexcept;
+    const Tensor& convOutput() const noexcept;
     std::size_t convOutputSize() const noexcept;
+    std::size_t maxBatchSize() const noexcept;
+    void setMaxBatchSize(std::size_t batchSize);
 
-    bool feedforward(const Matrix2d& input) noexcept;
-    bool backpropagate(const Matrix1d& output) noexcept;
+    void planInference();
+    void planMemory();
+    bool useMemoryPlan(bool inference) noexcept;
+    bool feedforward(const Tensor& input, bool inference = false) noexcept;
+    bool feedforwardConv(const Tensor& input, bool inference) noexcept;
+    bool backpropagate(const Tensor& target) noexcept;
     bool optimize(double learningRate) noexcept;
+    bool computeGradients() noexcept;
+    bool applyGradients(double learningRate) noexcept;
+    bool stepOptimizer(double learningRate, bool compute) noexcept;
 
     /** List of convolutional layers. */
     ConvLayerList myConvLayers;
@@ -105,6 +317,51 @@ private:
     /** Flatten layer between the convolutional and dense layers. */
     FlattenLayerPtr myFlattenLayer;
 
+    /** Output gradient batch, shape (max batch size, output size). */
+    Tensor myOutputGradientBatch;
+
+    /**
+     * @brief Step of the inference plan.
+     */
+    struct InferenceStep
+    {
+        /** Index of the convolutional layer of the step. */
+        std::size_t layer;
+
+        /** True if the layer is fused with the pooling layer after it. */
+        bool pooled;
+    };
+
+    /** Inference plan of the convolutional layers, created at construction. */
+    std::vector<InferenceStep> myInferencePlan;
+
+    /** Maximum number of samples per batch during batch prediction, see planInference(). */
+    std::size_t myTileSize;
+
+    /** Batch buffers of the layers and the network, in the order of the memory plans. */
+    memory::BufferList myBuffers;
+
+    /** Memory plan of the batch buffers for inference. */
+    memory::Planner myInferenceMemory;
+
+    /** Memory plan of the batch buffers for training. */
+    memory::Planner myTrainingMemory;
+
+    /** Arena holding the batch buffers of the memory plan in use. */
+    Tensor myArena;
+
+    /** Memory plan in use, nullptr if the buffers haven't been placed in the arena yet. */
+    const memory::Planner* myMemoryPlan;
+
+    /** Model file holding the parameters of the layers, nullptr if not loaded from a file. */
+    std::unique_ptr<memory::MappedFile> myModelFile;
+
+    /** Optimizer used during training. */
+    std::unique_ptr<optimizer::Optimizer> myOptimizer;
+
+    /** Algorithm used by the convolutional layers. */
+    conv_layer::algorithm::Type myConvAlgorithm;
+
     /** Machine learning factory. */
     factory::Interface& myFactory;
 };
@@ -0,0 +1,107 @@
+/**
+ * @brief Execution context for concurrent inference with a shared network.
+ */
+#pragma once
+
+#include <memory>
+
+#include "ml/cnn/cnn.h"
+#include "ml/cnn/interface.h"
+#include "ml/tensor.h"
+#include "ml/types.h"
+
+namespace ml::cnn
+{
+/**
+ * @brief Execution context for concurrent inference with a shared network.
+ *
+ *        The context holds its own layers, which read the parameters of the network instead
+ *        of copying them, and only own the buffers needed for inference (activations, padded
+ *        inputs and cached kernel transforms). Each thread can therefore run inference via
+ *        its own context, while the parameters are only stored once, in the network.
+ *
+ *        Neither the context nor the network may be used for training while other threads
+ *        predict via the context. The network must outlive the context. Since kernel
+ *        transforms are cached per context, call refresh() after the network has been
+ *        trained.
+ *
+ *        This class is non-copyable and non-movable.
+ */
+class InferenceContext final : public Interface
+{
+public:
+    /**
+     * @brief Create a new execution context.
+     *
+     *        The layers are created without own parameters, gradients or optimizer state.
+     *        Not thread-safe with respect to training the network.
+     *
+     * @param[in] cnn The network holding the parameters, must outlive the context.
+     *
+     * @throw std::runtime_error If the parameters of the network cannot be shared.
+     */
+    explicit InferenceContext(Cnn& cnn);
+
+    /**
+     * @brief Destructor.
+     */
+    ~InferenceContext() noexcept override;
+
+    /**
+     * @brief Get the input size of the network.
+     *
+     * @return The input size of the network.
+     */
+    std::size_t inputSize() const noexcept override;
+
+    /**
+     * @brief Get the output size of the network.
+     *
+     * @return The output size of the network.
+     */
+    std::size_t outputSize() const noexcept override;
+
+    /**
+     * @brief Predict based on the given input.
+     *
+     * @param[in] input Input for which to predict.
+     *
+     * @return The predicted output, valid until the next prediction via this context.
+     */
+    const Tensor& predict(const Tensor& input) noexcept override;
+
+    /**
+     * @brief Predict based on a batch of inputs.
+     *
+     * @param[in] inputs Inputs for which to predict, shape (set count, input size, input size).
+     * @param[out] outputs Tensor in which to store the predicted outputs, shape
+     *                     (set count, output size).
+     * @param[in] batchSize Maximum number of inputs per batch (default = 32).
+     *
+     * @return True on success, false on failure.
+     */
+    bool predictBatch(const Tensor& inputs, Tensor& outputs, std::size_t batchSize = 32U);
+
+    /**
+     * @brief Drop data derived from the parameters, such as cached kernel transforms.
+     *
+     *        Call after the network has been trained.
+     *
+     * @return True on success, false on failure.
+     */
+    bool refresh() noexcept;
+
+    InferenceContext()                                   = delete; // No default constructor.
+    InferenceContext(const InferenceContext&)            = delete; // No copy constructor.
+    InferenceContext(InferenceContext&&)                 = delete; // No move constructor.
+    InferenceContext& operator=(const InferenceContext&) = delete; // No copy assignment.
+    InferenceContext& operator=(InferenceContext&&)      = delete; // No move assignment.
+
+private:
+    /** The network holding the parameters. */
+    Cnn& myCnn;
+
+    /** Layers of the context, sharing the parameters of the network. */
+    std::unique_ptr<Cnn> myReplica;
+};
+} // namespace ml::cnn
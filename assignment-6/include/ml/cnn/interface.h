@@ -3,6 +3,7 @@
  */
 #pragma once
 
+#include "ml/tensor.h"
 #include "ml/types.h"
 
 namespace ml::cnn
@@ -39,6 +40,6 @@ public:
      * 
      * @return The predicted output.
      */
-    virtual const Matrix1d& predict(const Matrix2d& input) noexcept = 0;
+    virtual const Tensor& predict(const Tensor& input) noexcept = 0;
 };
 } // namespace ml::cnn
\ No newline at end of file
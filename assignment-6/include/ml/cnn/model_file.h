@@ -0,0 +1,73 @@
+/**
+ * @brief Binary model files, loaded via memory mapping.
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "ml/cnn/cnn.h"
+#include "ml/memory/mapped_file.h"
+#include "ml/types.h"
+
+namespace ml::cnn
+{
+/** Version of the model file format. */
+constexpr std::uint32_t ModelFileVersion{2U};
+
+/** Alignment of the parameters in a model file in bytes. */
+constexpr std::size_t ModelFileAlignment{64U};
+
+/**
+ * @brief Save a network to a binary model file.
+ *
+ *        The file is laid out as follows, in the byte order of the host:
+ *
+ *        - A 64-byte header: the magic "MLCNNMDL", the format version, the scalar size, the
+ *          input size, the convolution algorithm, the number of convolutional layers
+ *          (including the pooling layers), the number of dense layers, the file size and a
+ *          byte order mark, so that a file saved on a host of the other byte order is
+ *          rejected when loading.
+ *        - One 16-byte record per layer in forward order, convolutional layers first: the
+ *          layer type, the activation function, the channel count (the output size for
+ *          dense layers) and the kernel size (the pool size for pooling layers).
+ *        - The parameters of each layer in forward order, in the order of parameters().
+ *          Each parameter starts at a multiple of ModelFileAlignment and is stored exactly as
+ *          in the layer, i.e. including the row padding of the dense weights, so that a
+ *          loaded network can use the parameters in place.
+ *
+ * @param[in] cnn The network to save.
+ * @param[in] path Path to the model file, which is replaced if it exists.
+ *
+ * @return True on success, false on failure.
+ */
+bool saveModel(Cnn& cnn, const std::string& path);
+
+/**
+ * @brief Load a network from a binary model file created via saveModel().
+ *
+ *        The file is memory-mapped and the layers use the parameters in place, without
+ *        copying them. The layers are created without allocating or initializing own
+ *        parameters, so loading only costs the batch buffers and the page faults of the
+ *        parameters read, and processes loading the same file share one physical copy of
+ *        the parameters. By default the file is mapped read-only for inference, so a write to
+ *        the parameters faults and a network loaded this way cannot be trained. Load the file
+ *        copy-on-write to train the network, whereby the modified pages are copied into
+ *        private memory and the file is left unchanged. The file must not be modified while
+ *        the network exists.
+ *
+ * @param[in] factory Machine learning factory, which must create the same layer types as
+ *                    the factory of the saved network.
+ * @param[in] path Path to the model file.
+ * @param[in] access Access mode of the mapping, memory::Access::CopyOnWrite to train the
+ *                   loaded network (default = read-only).
+ *
+ * @return The loaded network.
+ *
+ * @throw std::runtime_error If the file cannot be mapped, is invalid or was saved with a
+ *                           different byte order, scalar type or layer implementation.
+ */
+std::unique_ptr<Cnn> loadModel(factory::Interface& factory, const std::string& path,
+                               memory::Access access = memory::Access::ReadOnly);
+} // namespace ml::cnn
@@ -0,0 +1,136 @@
+/**
+ * @brief Data-parallel trainer for convolutional neural networks.
+ */
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "ml/cnn/cnn.h"
+#include "ml/cnn/train_mode.h"
+#include "ml/dataset/interface.h"
+#include "ml/tensor.h"
+#include "ml/types.h"
+
+namespace ml::cnn
+{
+/**
+ * @brief Data-parallel trainer for convolutional neural networks.
+ *
+ *        The network is replicated once per worker thread (the calling thread uses the
+ *        network itself). Each mini-batch is split into one shard per worker, and every
+ *        worker runs feedforward and backpropagation on its shard. The gradients are then
+ *        summed via a ring all-reduce, after which every worker applies the same update to
+ *        its replica, so that all replicas stay identical.
+ *
+ *        The shards and the summation order only depend on the batch size and the thread
+ *        count, so the results are deterministic for a fixed random seed and thread count.
+ *
+ *        In Hogwild mode, the replicas instead share the parameters of the network. Each
+ *        worker trains on its own part of every epoch and updates the shared parameters
+ *        after each of its batches, without locks or synchronization between the updates.
+ *        Concurrent updates of the same parameter may overwrite each other, which is
+ *        tolerated for sparse enough updates, while aligned scalars are never torn. Results
+ *        are not deterministic in this mode.
+ *
+ *        This class is non-copyable and non-movable.
+ */
+class ParallelTrainer final
+{
+public:
+    /**
+     * @brief Create a new trainer.
+     *
+     * @param[in] cnn The network to train.
+     * @param[in] threadCount Number of worker threads. Must be greater than 0.
+     * @param[in] mode Training mode (default = synchronous).
+     *
+     * @throw std::invalid_argument If the thread count is 0.
+     */
+    explicit ParallelTrainer(Cnn& cnn, std::size_t threadCount, 
+                             TrainMode mode = TrainMode::Synchronous);
+
+    /**
+     * @brief Destructor.
+     */
+    ~ParallelTrainer() noexcept;
+
+    /**
+     * @brief Get the number of worker threads.
+     *
+     * @return The number of worker threads.
+     */
+    std::size_t threadCount() const noexcept { return myThreadCount; }
+
+    /**
+     * @brief Get the training mode.
+     *
+     * @return The training mode.
+     */
+    TrainMode mode() const noexcept { return myMode; }
+
+    /**
+     * @brief Train the network.
+     *
+     *        The replicas are created from the network at the start of each call, so the
+     *        network may be modified between calls.
+     *
+     * @param[in] trainIn Training input sets, shape (set count, input size, input size).
+     * @param[in] trainOut Training output sets, shape (set count, output size).
+     * @param[in] epochCount Number of epochs to train the model.
+     * @param[in] learningRate Learning rate to use during training.
+     * @param[in] batchSize Number of training sets per batch, split across the workers, or
+     *                      per worker and update in Hogwild mode (default = 1).
+     *
+     * @return True on success, false on failure.
+     */
+    bool train(const Tensor& trainIn, const Tensor& trainOut, std::size_t epochCount,
+               double learningRate, std::size_t batchSize = 1U);
+
+    /**
+     * @brief Train the network on a dataset.
+     *
+     *        Every worker loads the samples of its shards from the dataset into its own batch
+     *        buffers, so the dataset is read concurrently.
+     *
+     * @param[in] dataset Training dataset, whose input and output size must match the network.
+     * @param[in] epochCount Number of epochs to train the model.
+     * @param[in] learningRate Learning rate to use during training.
+     * @param[in] batchSize Number of training sets per batch, split across the workers, or
+     *                      per worker and update in Hogwild mode (default = 1).
+     *
+     * @return True on success, false on failure.
+     */
+    bool train(const dataset::Interface& dataset, std::size_t epochCount, double learningRate,
+               std::size_t batchSize = 1U);
+
+    ParallelTrainer()                                  = delete; // No default constructor.
+    ParallelTrainer(const ParallelTrainer&)            = delete; // No copy constructor.
+    ParallelTrainer(ParallelTrainer&&)                 = delete; // No move constructor.
+    ParallelTrainer& operator=(const ParallelTrainer&) = delete; // No copy assignment.
+    ParallelTrainer& operator=(ParallelTrainer&&)      = delete; // No move assignment.
+
+private:
+    class Barrier;
+    struct Job;
+    struct Worker;
+
+    bool runWorker(Job& job, std::size_t index);
+    bool runHogwildWorker(Job& job, std::size_t index);
+    void allReduce(Job& job, std::size_t index);
+    bool propagate(Worker& worker, const Job& job, std::size_t first, 
+                   std::size_t sampleCount) noexcept;
+
+    /** The network to train. */
+    Cnn& myCnn;
+
+    /** Number of worker threads. */
+    std::size_t myThreadCount;
+
+    /** Training mode. */
+    TrainMode myMode;
+
+    /** Workers, holding the replicas and their buffers (only set during training). */
+    std::vector<std::unique_ptr<Worker>> myWorkers;
+};
+} // namespace ml::cnn
@@ -0,0 +1,18 @@
+/**
+ * @brief Parallel training modes.
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace ml::cnn
+{
+/**
+ * @brief Enumeration of parallel training modes.
+ */
+enum class TrainMode : std::uint8_t
+{
+    Synchronous, ///< Gradients are all-reduced, then applied once per batch by every worker.
+    Hogwild,     ///< Workers update shared parameters asynchronously without locks.
+};
+} // namespace ml::cnn
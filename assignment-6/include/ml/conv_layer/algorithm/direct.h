@@ -0,0 +1,75 @@
+/**
+ * @brief Direct convolution algorithm.
+ */
+#pragma once
+
+#include <cstdlib>
+
+#include "ml/conv_layer/algorithm/interface.h"
+#include "ml/tensor.h"
+
+namespace ml::conv_layer::algorithm
+{
+/**
+ * @brief Direct convolution algorithm.
+ * 
+ *        Each output is computed by iterating through the kernel. The input is treated as
+ *        zero-padded without being copied: the border pixels clip the kernel window, while
+ *        the interior pixels use the whole window without bounds checks.
+ *        This class is non-copyable and non-movable.
+ */
+class Direct final : public Interface
+{
+public:
+    /**
+     * @brief Constructor.
+     * 
+     * @param[in] inputSize Input size. Must be greater than 0.
+     * @param[in] kernelSize Kernel size. Must be greater than 0.
+     */
+    explicit Direct(std::size_t inputSize, std::size_t kernelSize);
+
+    /**
+     * @brief Destructor.
+     */
+    ~Direct() noexcept override = default;
+
+    /**
+     * @brief Compute the convolution of given input and kernel.
+     * 
+     * @param[in] input Tensor holding input data.
+     * @param[in] kernel Tensor holding the kernel weights.
+     * @param[in] bias Bias value to add to each output.
+     * @param[out] output Tensor in which to store the output (before activation).
+     */
+    void feedforward(const Tensor& input, const Tensor& kernel, Scalar bias,
+                     Tensor& output) noexcept override;
+
+    /**
+     * @brief Compute the kernel and input gradients for given input.
+     * 
+     * @param[in] input Tensor holding the input data.
+     * @param[in] delta Tensor holding the output deltas.
+     * @param[in] kernel Tensor holding the kernel weights.
+     * @param[out] kernelGradients Tensor in which to store the kernel gradients.
+     * @param[out] inputGradients Tensor in which to store the input gradients.
+     */
+    void backpropagate(const Tensor& input, const Tensor& delta, const Tensor& kernel,
+                       Tensor& kernelGradients, Tensor& inputGradients) noexcept override;
+
+    /**
+     * @brief Invalidate data cached from the kernel (nothing is cached by this algorithm).
+     */
+    void invalidate() noexcept override {}
+
+    Direct()                         = delete; // No default constructor.
+    Direct(const Direct&)            = delete; // No copy constructor.
+    Direct(Direct&&)                 = delete; // No move constructor.
+    Direct& operator=(const Direct&) = delete; // No copy assignment.
+    Direct& operator=(Direct&&)      = delete; // No move assignment.
+
+private:
+    /** Pad offset (the number of zeros in each direction). */
+    std::size_t myPadOffset;
+};
+} // namespace ml::conv_layer::algorithm
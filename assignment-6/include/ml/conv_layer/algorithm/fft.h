@@ -0,0 +1,113 @@
+/**
+ * @brief FFT convolution algorithm.
+ */
+#pragma once
+
+#include <cstdlib>
+#include <vector>
+
+#include "ml/conv_layer/algorithm/interface.h"
+#include "ml/linalg/fft.h"
+#include "ml/tensor.h"
+
+namespace ml::conv_layer::algorithm
+{
+/**
+ * @brief FFT convolution algorithm.
+ *
+ *        Convolutions are computed as element-wise products of spectra, zero padded to a
+ *        power of two N >= input size + kernel size - 1 so that no circular wrap-around
+ *        reaches the stored outputs. The cost per convolution is O(N² log N) regardless of
+ *        the kernel size, which beats the O(n²K²) direct method for large kernels.
+ *
+ *        - Feedforward: the input spectrum times the spectrum of the kernel rotated 180 degrees.
+ *        - Input gradients: the delta spectrum times the kernel spectrum.
+ *        - Kernel gradients: the input spectrum times the conjugated delta spectrum.
+ *
+ *        The kernel spectra are cached until invalidate() is called, i.e. between
+ *        optimizations.
+ *
+ *        This class is non-copyable and non-movable.
+ */
+class Fft final : public Interface
+{
+public:
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] inputSize Input size. Must be greater than 0.
+     * @param[in] kernelSize Kernel size. Must be greater than 0.
+     */
+    explicit Fft(std::size_t inputSize, std::size_t kernelSize);
+
+    /**
+     * @brief Destructor.
+     */
+    ~Fft() noexcept override = default;
+
+    /**
+     * @brief Compute the convolution of given input and kernel.
+     *
+     * @param[in] input Tensor holding input data.
+     * @param[in] kernel Tensor holding the kernel weights.
+     * @param[in] bias Bias value to add to each output.
+     * @param[out] output Tensor in which to store the output (before activation).
+     */
+    void feedforward(const Tensor& input, const Tensor& kernel, Scalar bias,
+                     Tensor& output) noexcept override;
+
+    /**
+     * @brief Compute the kernel and input gradients for given input.
+     *
+     * @param[in] input Tensor holding the input data.
+     * @param[in] delta Tensor holding the output deltas.
+     * @param[in] kernel Tensor holding the kernel weights.
+     * @param[out] kernelGradients Tensor in which to store the kernel gradients.
+     * @param[out] inputGradients Tensor in which to store the input gradients.
+     */
+    void backpropagate(const Tensor& input, const Tensor& delta, const Tensor& kernel,
+                       Tensor& kernelGradients, Tensor& inputGradients) noexcept override;
+
+    /**
+     * @brief Invalidate the cached kernel spectra.
+     */
+    void invalidate() noexcept override;
+
+    Fft()                      = delete; // No default constructor.
+    Fft(const Fft&)            = delete; // No copy constructor.
+    Fft(Fft&&)                 = delete; // No move constructor.
+    Fft& operator=(const Fft&) = delete; // No copy assignment.
+    Fft& operator=(Fft&&)      = delete; // No move assignment.
+
+private:
+    void updateKernelSpectra(const Tensor& kernel) noexcept;
+
+    /** Transform used for all spectra. */
+    linalg::RealFft2d myFft;
+
+    /** Spectrum of the latest input. */
+    std::vector<linalg::Complex> myInputSpectrum;
+
+    /** Spectrum of the latest output deltas. */
+    std::vector<linalg::Complex> myDeltaSpectrum;
+
+    /** Cached spectrum of the kernel (used for the input gradients). */
+    std::vector<linalg::Complex> myKernelSpectrum;
+
+    /** Cached spectrum of the kernel rotated 180 degrees (used for feedforward). */
+    std::vector<linalg::Complex> myRotatedKernelSpectrum;
+
+    /** Work buffer holding a spectrum product. */
+    std::vector<linalg::Complex> myProduct;
+
+    /** Rotated kernel, zero padded. */
+    Tensor myRotatedKernel;
+
+    /** Zero padding on each side of the input (kernel size / 2). */
+    std::size_t myPadOffset;
+
+    /** Indicate whether the cached kernel spectra are valid. */
+    bool myKernelValid;
+};
+
+} // namespace ml::conv_layer::algorithm
@@ -0,0 +1,106 @@
+/**
+ * @brief Im2col convolution algorithm.
+ */
+#pragma once
+
+#include <cstdlib>
+
+#include "ml/conv_layer/algorithm/interface.h"
+#include "ml/tensor.h"
+
+namespace ml::conv_layer::algorithm
+{
+/**
+ * @brief Im2col convolution algorithm.
+ * 
+ *        The input is lowered into a column matrix of shape (kernel size², input size²), 
+ *        where each column holds the input window of one output. The convolution then
+ *        becomes a matrix multiplication with the flattened kernel, computed by the blocked
+ *        GEMM in ml::linalg. Input gradients are computed as a matrix multiplication into
+ *        column space, after which col2im scatters them back onto the input.
+ * 
+ *        With a single kernel the multiplication is a vector-matrix product, which can't
+ *        reuse the loaded columns across kernels, so the lowering costs more than it saves
+ *        and direct convolution is faster (see source/bench/conv_algorithms.cpp). Lowering
+ *        pays off for multi-channel layers, where every output channel adds a column.
+ * 
+ *        This class is non-copyable and non-movable.
+ */
+class Im2col final : public Interface
+{
+public:
+    /**
+     * @brief Constructor.
+     * 
+     * @param[in] inputSize Input size. Must be greater than 0.
+     * @param[in] kernelSize Kernel size. Must be greater than 0.
+     */
+    explicit Im2col(std::size_t inputSize, std::size_t kernelSize);
+
+    /**
+     * @brief Destructor.
+     */
+    ~Im2col() noexcept override = default;
+
+    /**
+     * @brief Compute the convolution of given input and kernel.
+     * 
+     * @param[in] input Tensor holding input data.
+     * @param[in] kernel Tensor holding the kernel weights.
+     * @param[in] bias Bias value to add to each output.
+     * @param[out] output Tensor in which to store the output (before activation).
+     */
+    void feedforward(const Tensor& input, const Tensor& kernel, Scalar bias,
+                     Tensor& output) noexcept override;
+
+    /**
+     * @brief Compute the kernel and input gradients for given input.
+     * 
+     * @param[in] input Tensor holding the input data.
+     * @param[in] delta Tensor holding the output deltas.
+     * @param[in] kernel Tensor holding the kernel weights.
+     * @param[out] kernelGradients Tensor in which to store the kernel gradients.
+     * @param[out] inputGradients Tensor in which to store the input gradients.
+     */
+    void backpropagate(const Tensor& input, const Tensor& delta, const Tensor& kernel,
+                       Tensor& kernelGradients, Tensor& inputGradients) noexcept override;
+
+    /**
+     * @brief Invalidate data cached from the kernel (nothing is cached by this algorithm).
+     */
+    void invalidate() noexcept override {}
+
+    Im2col()                         = delete; // No default constructor.
+    Im2col(const Im2col&)            = delete; // No copy constructor.
+    Im2col(Im2col&&)                 = delete; // No move constructor.
+    Im2col& operator=(const Im2col&) = delete; // No copy assignment.
+    Im2col& operator=(Im2col&&)      = delete; // No move assignment.
+
+private:
+    /**
+     * @brief Lower the input into the column matrix.
+     * 
+     * @param[in] input Tensor holding input data.
+     */
+    void im2col(const Tensor& input) noexcept;
+
+    /**
+     * @brief Accumulate the column gradients onto the input gradients.
+     * 
+     * @param[out] inputGradients Tensor in which to store the input gradients.
+     */
+    void col2im(Tensor& inputGradients) const noexcept;
+
+    /** Column matrix of the latest input, shape (kernel size², input size²). */
+    Tensor myColumns;
+
+    /** Gradients in column space, shape (kernel size², input size²). */
+    Tensor myColumnGradients;
+
+    /** Input size. */
+    std::size_t myInputSize;
+
+    /** Kernel size. */
+    std::size_t myKernelSize;
+};
+} // namespace ml::conv_layer::algorithm
@@ -0,0 +1,58 @@
+/**
+ * @brief Convolution algorithm interface.
+ */
+#pragma once
+
+#include "ml/tensor.h"
+
+namespace ml::conv_layer::algorithm
+{
+/**
+ * @brief Convolution algorithm interface.
+ * 
+ *        A convolution algorithm computes the 'same' convolution of a square input with a
+ *        square kernel (zero padded by kernel size / 2 on each side), as well as the
+ *        corresponding gradients. Activation functions are applied by the owning layer.
+ */
+class Interface
+{
+public:
+    /**
+     * @brief Destructor.
+     */
+    virtual ~Interface() noexcept = default;
+
+    /**
+     * @brief Compute the convolution of given input and kernel.
+     * 
+     * @param[in] input Tensor holding input data.
+     * @param[in] kernel Tensor holding the kernel weights.
+     * @param[in] bias Bias value to add to each output.
+     * @param[out] output Tensor in which to store the output (before activation).
+     */
+    virtual void feedforward(const Tensor& input, const Tensor& kernel, Scalar bias,
+                             Tensor& output) noexcept = 0;
+
+    /**
+     * @brief Compute the kernel and input gradients for given input.
+     * 
+     *        The input is passed explicitly rather than cached by the feedforward, so that a
+     *        whole batch can be fed forward before any sample is backpropagated.
+     * 
+     * @param[in] input Tensor holding the input data the deltas refer to.
+     * @param[in] delta Tensor holding the output deltas (gradients times activation derivative).
+     * @param[in] kernel Tensor holding the kernel weights.
+     * @param[out] kernelGradients Tensor in which to store the kernel gradients.
+     * @param[out] inputGradients Tensor in which to store the input gradients.
+     */
+    virtual void backpropagate(const Tensor& input, const Tensor& delta, const Tensor& kernel,
+                               Tensor& kernelGradients, Tensor& inputGradients) noexcept = 0;
+
+    /**
+     * @brief Invalidate data cached from the kernel, such as transformed kernels.
+     * 
+     *        Must be called whenever the kernel weights have been updated.
+     */
+    virtual void invalidate() noexcept = 0;
+};
+} // namespace ml::conv_layer::algorithm
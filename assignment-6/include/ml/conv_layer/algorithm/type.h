@@ -0,0 +1,22 @@
+/**
+ * @brief Convolution algorithm types.
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace ml::conv_layer::algorithm
+{
+/**
+ * @brief Enumeration of convolution algorithms.
+ */
+enum class Type : std::uint8_t
+{
+    Direct,      ///< Direct convolution (nested loops over output pixels and kernel elements).
+    Im2col,      ///< Lowering to a matrix multiplication via im2col/col2im.
+    Winograd2x2, ///< Winograd F(2x2, 3x3) transform (3x3 kernels only).
+    Winograd4x4, ///< Winograd F(4x4, 3x3) transform (3x3 kernels only).
+    Fft,         ///< Element-wise products of spectra (fast for large kernels).
+    Auto,        ///< Select the fastest algorithm for the kernel size (measured).
+};
+} // namespace ml::conv_layer::algorithm
@@ -0,0 +1,147 @@
+/**
+ * @brief Winograd convolution algorithm for 3x3 kernels.
+ */
+#pragma once
+
+#include <cstdlib>
+
+#include "ml/conv_layer/algorithm/interface.h"
+#include "ml/tensor.h"
+
+namespace ml::conv_layer::algorithm
+{
+/**
+ * @brief Winograd F(m x m, 3 x 3) convolution algorithm.
+ *
+ *        The output is computed in tiles of m x m outputs. Each (m + 2) x (m + 2) input tile
+ *        is transformed as V = B^T d B, multiplied element-wise with the transformed kernel
+ *        U = G g G^T and transformed back as Y = A^T (U ⊙ V) A. This takes (m + 2)²
+ *        multiplications per tile instead of 9m² for the direct method, i.e. 2.25x fewer
+ *        for F(2x2, 3x3) and 4x fewer for F(4x4, 3x3).
+ *
+ *        The input gradients are the 'same' convolution of the output deltas with the kernel
+ *        rotated 180 degrees, which is computed with the same transforms. The kernel gradients
+ *        are accumulated in the Winograd domain as the sum over the tiles of (A δ A^T) ⊙ V,
+ *        i.e. with (m + 2)² multiplications per tile, and transformed back once per image.
+ *        The transforms are written out as additions, subtractions and scalings, since the
+ *        transform matrices only hold small integers and simple fractions.
+ *
+ *        The transformed kernels are cached until invalidate() is called, i.e. between
+ *        optimizations. This class is non-copyable and non-movable.
+ *
+ * @tparam TileSize Output tile size m (2 or 4).
+ */
+template <std::size_t TileSize>
+class Winograd final : public Interface
+{
+public:
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] inputSize Input size. Must be greater than 0.
+     * @param[in] kernelSize Kernel size. Must be 3.
+     *
+     * @throw std::invalid_argument If the kernel size isn't 3.
+     */
+    explicit Winograd(std::size_t inputSize, std::size_t kernelSize);
+
+    /**
+     * @brief Destructor.
+     */
+    ~Winograd() noexcept override = default;
+
+    /**
+     * @brief Compute the convolution of given input and kernel.
+     *
+     * @param[in] input Tensor holding input data.
+     * @param[in] kernel Tensor holding the kernel weights.
+     * @param[in] bias Bias value to add to each output.
+     * @param[out] output Tensor in which to store the output (before activation).
+     */
+    void feedforward(const Tensor& input, const Tensor& kernel, Scalar bias,
+                     Tensor& output) noexcept override;
+
+    /**
+     * @brief Compute the kernel and input gradients for given input.
+     *
+     * @param[in] input Tensor holding the input data.
+     * @param[in] delta Tensor holding the output deltas.
+     * @param[in] kernel Tensor holding the kernel weights.
+     * @param[out] kernelGradients Tensor in which to store the kernel gradients.
+     * @param[out] inputGradients Tensor in which to store the input gradients.
+     */
+    void backpropagate(const Tensor& input, const Tensor& delta, const Tensor& kernel,
+                       Tensor& kernelGradients, Tensor& inputGradients) noexcept override;
+
+    /**
+     * @brief Invalidate the cached kernel transforms.
+     */
+    void invalidate() noexcept override;
+
+    Winograd()                           = delete; // No default constructor.
+    Winograd(const Winograd&)            = delete; // No copy constructor.
+    Winograd(Winograd&&)                 = delete; // No move constructor.
+    Winograd& operator=(const Winograd&) = delete; // No copy assignment.
+    Winograd& operator=(Winograd&&)      = delete; // No move assignment.
+
+private:
+    /** Supported kernel size. */
+    static constexpr std::size_t KernelSize{3U};
+
+    /** Input tile size (output tile size + kernel size - 1). */
+    static constexpr std::size_t InputTileSize{TileSize + KernelSize - 1U};
+
+    /**
+     * @brief Copy given matrix into the interior of a padded matrix.
+     *
+     * @param[in] source The matrix to copy.
+     * @param[out] padded The padded matrix, with one row/column of zeros before the interior.
+     */
+    static void pad(const Tensor& source, Tensor& padded) noexcept;
+
+    /**
+     * @brief Compute U = G g G^T for given kernel.
+     *
+     * @param[in] kernel Tensor holding the kernel weights.
+     * @param[in] rotate True to rotate the kernel 180 degrees before the transform.
+     * @param[out] transformed Tensor in which to store the transformed kernel.
+     */
+    static void transformKernel(const Tensor& kernel, bool rotate, Tensor& transformed) noexcept;
+
+    /**
+     * @brief Compute the 'same' convolution of a padded input with a transformed kernel.
+     *
+     * @param[in] padded The padded input.
+     * @param[in] transformed The transformed kernel.
+     * @param[in] bias Bias value to add to each output.
+     * @param[out] output Tensor in which to store the output.
+     */
+    static void convolve(const Tensor& padded, const Tensor& transformed, Scalar bias,
+                         Tensor& output) noexcept;
+
+    /** Input (padded with zeros to a whole number of tiles). */
+    Tensor myInputPadded;
+
+    /** Output deltas (padded with zeros to a whole number of tiles). */
+    Tensor myDeltaPadded;
+
+    /** Cached kernel transform. */
+    Tensor myKernelTransformed;
+
+    /** Cached transform of the rotated kernel (used for the input gradients). */
+    Tensor myRotatedKernelTransformed;
+
+    /** Indicate whether the cached kernel transform is valid. */
+    bool myKernelValid;
+
+    /** Indicate whether the cached rotated kernel transform is valid. */
+    bool myRotatedKernelValid;
+};
+
+/** Winograd F(2x2, 3x3) convolution algorithm. */
+using Winograd2x2 = Winograd<2U>;
+
+/** Winograd F(4x4, 3x3) convolution algorithm. */
+using Winograd4x4 = Winograd<4U>;
+
+} // namespace ml::conv_layer::algorithm
@@ -9,14 +9,16 @@
 #include <memory>
 #include <vector>
 
+#include "ml/act_func/kernel.h"
 #include "ml/act_func/type.h"
+#include "ml/conv_layer/algorithm/type.h"
 #include "ml/conv_layer/interface.h"
+#include "ml/memory/buffer.h"
+#include "ml/parameter_mode.h"
+#include "ml/tensor.h"
 #include "ml/types.h"
 #include "ml/utils.h"
 
-/** Activation function interface. */
-namespace ml::act_func { class Interface; }
-
 namespace ml::conv_layer
 {
 class ConvLayer final : public Interface
@@ -28,9 +30,14 @@ public:
      * @param[in] inputSize Input size as a size_t. Must be > 0.
      * @param[in] kernelSize Kernel size as a size_t. Must be > 0 and < input size
      * @param[in] actFuncType Activation function to use (default = none).
+     * @param[in] algorithm Convolution algorithm to use (default = direct).
+     * @param[in] mode Parameter mode (default = owned). In external mode the kernel and the
+     *                 bias must be supplied via useParameters() or shareParameters() before use.
      */
     explicit ConvLayer(const std::size_t inputSize, const std::size_t kernelSize,
-                       const act_func::Type actFuncType = act_func::Type::None);
+                       const act_func::Type actFuncType = act_func::Type::None,
+                       const algorithm::Type algorithm = algorithm::Type::Direct,
+                       const ParameterMode mode = ParameterMode::Owned);
 
     /**
      * @brief Destructor.
@@ -54,34 +61,150 @@ public:
     /**
      * @brief Get the output of the layer.
      * 
-     * @return Matrix holding the output of the layer.
+     * @return Tensor holding the output of the layer.
      */
-    const Matrix2d& output() const noexcept override;
+    const Tensor& output() const noexcept override;
 
     /**
      * @brief Get the input gradients of the layer.
      * 
-     * @return Matrix holding the input gradients of the layer.
+     * @return Tensor holding the input gradients of the layer.
+     */
+    const Tensor& inputGradients() const noexcept override;
+
+    /**
+     * @brief Get the number of output channels of the layer.
+     * 
+     * @return The number of output channels (always 1).
+     */
+    std::size_t channelCount() const noexcept override;
+
+    /**
+     * @brief Get the type of the layer.
+     * 
+     * @return The layer type.
+     */
+    Type type() const noexcept override;
+
+    /**
+     * @brief Get the kernel size of the layer.
+     * 
+     * @return The kernel size of the layer.
+     */
+    std::size_t kernelSize() const noexcept override;
+
+    /**
+     * @brief Get the activation function of the layer.
+     * 
+     * @return The activation function type.
+     */
+    act_func::Type actFunc() const noexcept override;
+
+    /**
+     * @brief Get the trainable parameters of the layer.
+     * 
+     * @return List of views of the parameters.
+     */
+    TensorList parameters() override;
+
+    /**
+     * @brief Get the gradients of the trainable parameters of the layer.
+     * 
+     * @return List of views of the kernel gradients and the bias gradient.
+     */
+    TensorList gradients() override;
+
+    /**
+     * @brief Share the trainable parameters of given layer.
+     * 
+     * @param[in] source Layer of the same type and size, must outlive this layer.
+     * 
+     * @return True on success, false if the layers don't match.
+     */
+    bool shareParameters(Interface& source) noexcept override;
+
+    /**
+     * @brief Use given tensors as the trainable parameters of the layer.
+     * 
+     * @param[in] parameters Tensors shaped and strided like the views returned by
+     *                       parameters(), in the same order. Must outlive this layer.
+     * 
+     * @return True on success, false if the tensors don't match the parameters.
+     */
+    bool useParameters(TensorList& parameters) noexcept override;
+
+    /**
+     * @brief Notify the layer that its parameters have been updated externally.
+     */
+    void invalidateParameters() noexcept override;
+
+    /**
+     * @brief Get the maximum number of samples per batch.
+     * 
+     * @return The maximum batch size.
+     */
+    std::size_t maxBatchSize() const noexcept override;
+
+    /**
+     * @brief Set the maximum number of samples per batch.
+     * 
+     * @param[in] batchSize The maximum batch size. Must be greater than 0.
+     * 
+     * @throw std::invalid_argument If the batch size is 0.
      */
-    const Matrix2d& inputGradients() const noexcept override;
+    void setMaxBatchSize(std::size_t batchSize) override;
+
+    /**
+     * @brief Get the batch buffers of the layer, for memory planning.
+     * 
+     * @return List of the batch buffers, valid as long as the layer.
+     */
+    memory::BufferList buffers() noexcept override;
 
     /**
      * @brief Perform feedforward operation.
      * 
-     * @param[in] input Matrix holding input data.
+     * @param[in] input Tensor holding a single input sample or a batch of samples.
      * 
      * @return True on success, false on failure.
      */
-    bool feedforward(const Matrix2d& input) noexcept override;
+    bool feedforward(const Tensor& input) noexcept override;
+
+    /**
+     * @brief Perform feedforward operation followed by max pooling, for inference only.
+     * 
+     *        The bias and the activation function are applied to the pooled values only,
+     *        which is exact since every activation function is non-decreasing. The input is
+     *        not stored and the output batch is used as scratch space for the convolution.
+     * 
+     * @param[in] input Tensor holding a single input sample or a batch of samples.
+     * @param[in] poolSize Pool size. Must divide the output size.
+     * @param[in,out] output Output batch of the pooling layer, replaced by a view of the
+     *                       pooled output on success.
+     * 
+     * @return True on success, false on failure.
+     */
+    bool feedforwardPooled(const Tensor& input, std::size_t poolSize, 
+                           Tensor& output) noexcept override;
+
+    /**
+     * @brief Perform feedforward operation of given layer followed by this layer.
+     * 
+     * @param[in] source The layer preceding this layer.
+     * @param[in] input Input of the source layer.
+     * 
+     * @return True on success, false on failure.
+     */
+    bool feedforwardFused(Interface& source, const Tensor& input) noexcept override;
 
     /**
      * @brief Perform backpropagation.
      * 
-     * @param[in] outputGradients Matrix holding gradients from the next layer.
+     * @param[in] outputGradients Tensor holding gradients from the next layer.
      * 
      * @return True on success, false on failure.
      */
-    bool backpropagate(const Matrix2d& outputGradients) noexcept override;
+    bool backpropagate(const Tensor& outputGradients) noexcept override;
 
     /**
      * @brief Perform optimization.
@@ -102,43 +225,46 @@ public:
     ConvLayer& operator=(ConvLayer&&)       = delete;
 
 private:
-    /**
-     * @brief Pad input with zeros.
-     *
-     * @param[in] input Input data.
-     */
-    void padInput(const Matrix2d& input) noexcept;
+    /** Latest input batch, shape (max batch size, input size, input size). */
+    Tensor myInputBatch;
 
-    /**
-     * @brief Extract input gradients.
-     */
-    void extractInputGradients() noexcept;
+    /** Input gradient batch (without padding). */
+    Tensor myInputGradientBatch;
 
-    /** Input matrix (padded with zeros). */
-    Matrix2d myInputPadded;
+    /** View of the input gradients of the latest batch. */
+    Tensor myInputGradients;
 
-    /** Input gradient matrix (padded with zeros). */
-    Matrix2d myInputGradientsPadded;
+    /** Kernel matrix (holding weights). */
+    Tensor myKernel;
 
-    /** Input gradient matrix (without padding). */
-    Matrix2d myInputGradients;
+    /** Kernel gradient matrix, averaged over the latest batch. */
+    Tensor myKernelGradients;
 
-    /** Kernel matrix (holding weights). */
-    Matrix2d myKernel;
+    /** Kernel gradient matrix of a single sample. */
+    Tensor mySampleKernelGradients;
+
+    /** Output batch. */
+    Tensor myOutputBatch;
+
+    /** View of the output of the latest batch. */
+    Tensor myOutput;
+
+    /** Output delta matrix (output gradients times activation function derivative). */
+    Tensor myDelta;
 
-    /** Kernel gradient matrix. */
-    Matrix2d myKernelGradients;
+    /** Bias value (as a tensor of size 1). */
+    Tensor myBias;
 
-    /** Output matrix. */
-    Matrix2d myOutput;
+    /** Bias gradient, averaged over the latest batch. */
+    Scalar myBiasGradient;
 
-    /** Bias value. */
-    double myBias;
+    /** Number of samples in the latest batch. */
+    std::size_t myBatchSize;
 
-    /** Bias gradient. */
-    double myBiasGradient;
+    /** Activation function kernels. */
+    act_func::Kernel myActFunc;
 
-    /** Activation function implementation. */
-    std::unique_ptr<act_func::Interface> myActFunc;
+    /** Convolution algorithm implementation. */
+    ConvAlgorithmPtr myAlgorithm;
 };
 } // namespace ml
@@ -5,12 +5,20 @@
 
 #include <memory>
 
+#include "ml/act_func/type.h"
+#include "ml/conv_layer/type.h"
+#include "ml/memory/buffer.h"
+#include "ml/tensor.h"
 #include "ml/types.h"
 
 namespace ml::conv_layer
 {
 /**
  * @brief Convolutional layer interface.
+ *
+ *        Layers process either a single sample or a batch of samples stacked along the first
+ *        dimension, up to the max batch size (1 by default). The output and the gradients
+ *        are shaped like the latest input, i.e. with or without the batch dimension.
  */
 class Interface
 {
@@ -37,34 +45,183 @@ public:
     /**
      * @brief Get the output of the layer.
      * 
-     * @return Matrix holding the output of the layer.
+     * @return Tensor holding the output of the layer.
      */
-    virtual const Matrix2d& output() const noexcept = 0;
+    virtual const Tensor& output() const noexcept = 0;
 
     /**
      * @brief Get the input gradients of the layer.
      * 
-     * @return Matrix holding the input gradients of the layer.
+     * @return Tensor holding the input gradients of the layer.
      */
-    virtual const Matrix2d& inputGradients() const noexcept = 0;
+    virtual const Tensor& inputGradients() const noexcept = 0;
+
+    /**
+     * @brief Get the number of output channels (feature maps) of the layer.
+     * 
+     *        Multi-channel outputs are stored in the channel-blocked layout described in
+     *        ml/conv_layer/layout.h.
+     * 
+     * @return The number of output channels.
+     */
+    virtual std::size_t channelCount() const noexcept = 0;
+
+    /**
+     * @brief Get the type of the layer.
+     * 
+     * @return The layer type.
+     */
+    virtual Type type() const noexcept = 0;
+
+    /**
+     * @brief Get the kernel size of the layer (the pool size for pooling layers).
+     * 
+     * @return The kernel size of the layer.
+     */
+    virtual std::size_t kernelSize() const noexcept = 0;
+
+    /**
+     * @brief Get the activation function of the layer.
+     * 
+     * @return The activation function type (none for pooling layers).
+     */
+    virtual act_func::Type actFunc() const noexcept = 0;
+
+    /**
+     * @brief Get the trainable parameters of the layer.
+     * 
+     *        Convolutional layers return the kernel followed by the bias (as a tensor of size 1),
+     *        layers without trainable parameters return an empty list.
+     * 
+     * @return List of views of the parameters, valid as long as the layer.
+     */
+    virtual TensorList parameters() = 0;
+
+    /**
+     * @brief Get the gradients of the trainable parameters of the layer.
+     * 
+     *        The gradients are computed by the latest backpropagation (averaged over the
+     *        batch) and applied by the next optimization. They may be modified in between,
+     *        e.g. to combine the gradients of several layers.
+     * 
+     * @return List of views of the gradients, in the same order and with the same shapes as
+     *         the parameters.
+     */
+    virtual TensorList gradients() = 0;
+
+    /**
+     * @brief Share the trainable parameters of given layer.
+     * 
+     *        This layer stops using its own parameters and instead reads and updates the
+     *        parameters of the source layer, e.g. for lock-free asynchronous training.
+     * 
+     * @param[in] source Layer of the same type and size, must outlive this layer.
+     * 
+     * @return True on success, false if the layers don't match.
+     */
+    virtual bool shareParameters(Interface& source) noexcept = 0;
+
+    /**
+     * @brief Use given tensors as the trainable parameters of the layer.
+     * 
+     *        This layer stops using its own parameters and instead reads and updates the
+     *        given memory, e.g. a memory-mapped model file (see ml/cnn/model_file.h).
+     * 
+     * @param[in] parameters Tensors shaped and strided like the views returned by
+     *                       parameters(), in the same order. Must outlive this layer.
+     * 
+     * @return True on success, false if the tensors don't match the parameters.
+     */
+    virtual bool useParameters(TensorList& parameters) noexcept = 0;
+
+    /**
+     * @brief Notify the layer that its parameters have been updated externally.
+     * 
+     *        Must be called after writing to the tensors returned by parameters(), e.g. by an
+     *        optimizer (see ml/optimizer/optimizer.h), so that data derived from the
+     *        parameters is recomputed.
+     */
+    virtual void invalidateParameters() noexcept = 0;
+
+    /**
+     * @brief Get the maximum number of samples per batch.
+     * 
+     * @return The maximum batch size.
+     */
+    virtual std::size_t maxBatchSize() const noexcept = 0;
+
+    /**
+     * @brief Set the maximum number of samples per batch.
+     * 
+     *        The batch buffers are reallocated, i.e. the current output and gradients are lost.
+     * 
+     * @param[in] batchSize The maximum batch size. Must be greater than 0.
+     * 
+     * @throw std::invalid_argument If the batch size is 0.
+     */
+    virtual void setMaxBatchSize(std::size_t batchSize) = 0;
+
+    /**
+     * @brief Get the batch buffers of the layer, for memory planning.
+     * 
+     *        The owner of the layer may replace each buffer with a view of the same shape into
+     *        memory it owns, so that buffers that are never live at the same time can share
+     *        memory (see ml/memory/planner.h). The view of the latest batch is then reset to
+     *        the first sample, and the content of the buffers is lost. The buffers must be
+     *        collected again after each call to setMaxBatchSize.
+     * 
+     * @return List of the batch buffers, valid as long as the layer.
+     */
+    virtual memory::BufferList buffers() noexcept = 0;
 
     /**
      * @brief Perform feedforward operation.
      * 
-     * @param[in] input Matrix holding input data.
+     * @param[in] input Tensor holding a single input sample or a batch of samples.
+     * 
+     * @return True on success, false on failure.
+     */
+    virtual bool feedforward(const Tensor& input) noexcept = 0;
+
+    /**
+     * @brief Perform feedforward operation followed by max pooling, for inference only.
+     * 
+     *        The pooled output is written straight to given tensor, the output of this layer
+     *        is not stored. Backpropagation therefore fails until the next feedforward.
+     * 
+     * @param[in] input Tensor holding a single input sample or a batch of samples.
+     * @param[in] poolSize Pool size. Must divide the output size.
+     * @param[in,out] output Output batch of the pooling layer, replaced by a view of the
+     *                       pooled output (shaped like the input) on success.
+     * 
+     * @return True on success, false on failure or if the layer cannot pool its output.
+     */
+    virtual bool feedforwardPooled(const Tensor& input, std::size_t poolSize,
+                                   Tensor& output) noexcept = 0;
+
+    /**
+     * @brief Perform feedforward operation of given layer followed by this layer, for
+     *        inference only.
+     * 
+     *        Pooling layers let the source layer pool its output when supported (see
+     *        feedforwardPooled), else the layers are run one by one. Backpropagation is
+     *        only valid after a regular feedforward operation.
+     * 
+     * @param[in] source The layer preceding this layer.
+     * @param[in] input Input of the source layer.
      * 
      * @return True on success, false on failure.
      */
-    virtual bool feedforward(const Matrix2d& input) noexcept = 0;
+    virtual bool feedforwardFused(Interface& source, const Tensor& input) noexcept = 0;
 
     /**
      * @brief Perform backpropagation.
      * 
-     * @param[in] outputGradients Matrix holding gradients from the next layer.
+     * @param[in] outputGradients Tensor holding gradients from the next layer.
      * 
      * @return True on success, false on failure.
      */
-    virtual bool backpropagate(const Matrix2d& outputGradients) noexcept = 0;
+    virtual bool backpropagate(const Tensor& outputGradients) noexcept = 0;
 
     /**
      * @brief Perform optimization.
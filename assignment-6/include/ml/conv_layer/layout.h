@@ -0,0 +1,83 @@
+/**
+ * @brief Channel-blocked memory layout of multi-channel feature maps.
+ */
+#pragma once
+
+#include <cstddef>
+
+#include "ml/scalar.h"
+#include "ml/tensor.h"
+
+namespace ml::conv_layer
+{
+/**
+ * @brief Number of channels per block, i.e. the number of scalars in a 256-bit vector.
+ *
+ *        Feature maps with C channels are stored in the channel-blocked NCHWc layout, i.e.
+ *        with shape (C / width, size, size, width), where the block width is
+ *        min(C, ChannelBlock). The channels of a block are adjacent for every pixel, so the
+ *        convolution can update a whole block of output channels with one vector operation.
+ *        Single-channel feature maps have shape (size, size), which is the same layout.
+ */
+constexpr std::size_t ChannelBlock{32U / sizeof(Scalar)};
+
+/**
+ * @brief Get the block width of feature maps with given number of channels.
+ *
+ * @param[in] channelCount The number of channels.
+ *
+ * @return The number of channels per block.
+ */
+constexpr std::size_t blockWidth(const std::size_t channelCount) noexcept
+{
+    return channelCount < ChannelBlock ? channelCount : ChannelBlock;
+}
+
+/**
+ * @brief Check whether feature maps can hold given number of channels, i.e. whether the
+ *        channel count is at most ChannelBlock or a multiple of ChannelBlock.
+ *
+ * @param[in] channelCount The number of channels.
+ *
+ * @return True if the channel count is valid, else false.
+ */
+constexpr bool isValidChannelCount(const std::size_t channelCount) noexcept
+{
+    return (0U < channelCount) && (0U == channelCount % blockWidth(channelCount));
+}
+
+/**
+ * @brief Create a batch of zero-initialized feature maps in the channel-blocked layout.
+ *
+ * @param[in] batchSize The number of samples.
+ * @param[in] channelCount The number of channels. Must be valid (see isValidChannelCount).
+ * @param[in] size The size (height and width) of the feature maps.
+ *
+ * @return Tensor of shape (batch size, size, size) for a single channel, else of shape
+ *         (batch size, channel count / block width, size, size, block width).
+ */
+Tensor featureMaps(std::size_t batchSize, std::size_t channelCount, std::size_t size);
+
+/**
+ * @brief Create a view of existing data as a batch of feature maps in the channel-blocked 
+ *        layout, e.g. to unflatten a flattened batch without copying.
+ *
+ * @param[in] data The data, at least batch size * channel count * size² values.
+ * @param[in] batchSize The number of samples.
+ * @param[in] channelCount The number of channels. Must be valid (see isValidChannelCount).
+ * @param[in] size The size (height and width) of the feature maps.
+ *
+ * @return View shaped like featureMaps(batchSize, channelCount, size).
+ */
+Tensor featureMapView(Scalar* data, std::size_t batchSize, std::size_t channelCount, 
+                      std::size_t size) noexcept;
+
+/**
+ * @brief Get the size (height and width) of a batch of feature maps.
+ *
+ * @param[in] batch Tensor created via featureMaps().
+ *
+ * @return The size of the feature maps.
+ */
+std::size_t featureMapSize(const Tensor& batch) noexcept;
+} // namespace ml::conv_layer
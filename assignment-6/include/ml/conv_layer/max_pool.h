@@ -6,6 +6,7 @@
  */
 #pragma once
 
+#include <cstdint>
 #include <cstdlib>
 #include <vector>
 
@@ -13,6 +14,8 @@
 //!       träningsbara parametrar.
 #include "ml/conv_layer/interface.h"
 #include "ml/act_func/relu.h"
+#include "ml/memory/buffer.h"
+#include "ml/tensor.h"
 #include "ml/types.h"
 #include "ml/utils.h"
 
@@ -25,9 +28,13 @@ public:
      * @brief Constructor.
      * 
      * @param[in] inputSize Input size. Must be greater than 0.
-     * @param[in] poolSize Pool size. Must divide the input size.
+     * @param[in] poolSize Pool size. Must divide the input size and be at most 256.
+     * @param[in] channelCount Number of channels, each pooled separately (default = 1).
+     *                         Must be at most ChannelBlock or a multiple of ChannelBlock
+     *                         (see ml/conv_layer/layout.h).
      */
-    explicit MaxPoolLayer(const std::size_t inputSize, const std::size_t poolSize);
+    explicit MaxPoolLayer(const std::size_t inputSize, const std::size_t poolSize,
+                          const std::size_t channelCount = 1U);
 
     /**
      * @brief Destructor.
@@ -51,34 +58,151 @@ public:
     /**
      * @brief Get the output of the layer.
      * 
-     * @return Matrix holding the output of the layer.
+     * @return Tensor holding the output of the layer.
      */
-    const Matrix2d& output() const noexcept override;
+    const Tensor& output() const noexcept override;
 
     /**
      * @brief Get the input gradients of the layer.
      * 
-     * @return Matrix holding the input gradients of the layer.
+     * @return Tensor holding the input gradients of the layer.
      */
-    const Matrix2d& inputGradients() const noexcept override;
+    const Tensor& inputGradients() const noexcept override;
+
+    /**
+     * @brief Get the number of output channels of the layer.
+     * 
+     * @return The number of channels (same as the input).
+     */
+    std::size_t channelCount() const noexcept override;
+
+    /**
+     * @brief Get the type of the layer.
+     * 
+     * @return The layer type.
+     */
+    Type type() const noexcept override;
+
+    /**
+     * @brief Get the pool size of the layer.
+     * 
+     * @return The pool size of the layer.
+     */
+    std::size_t kernelSize() const noexcept override;
+
+    /**
+     * @brief Get the activation function of the layer.
+     * 
+     * @return The activation function type (always none).
+     */
+    act_func::Type actFunc() const noexcept override;
+
+    /**
+     * @brief Get the trainable parameters of the layer.
+     * 
+     * @return An empty list, since pooling layers have no trainable parameters.
+     */
+    TensorList parameters() override;
+
+    /**
+     * @brief Get the gradients of the trainable parameters of the layer.
+     * 
+     * @return An empty list, since pooling layers have no trainable parameters.
+     */
+    TensorList gradients() override;
+
+    /**
+     * @brief Share the trainable parameters of given layer.
+     * 
+     * @param[in] source Layer of the same type and size.
+     * 
+     * @return True on success (pooling layers have no parameters), false if the layers 
+     *         don't match.
+     */
+    bool shareParameters(Interface& source) noexcept override;
+
+    /**
+     * @brief Use given tensors as the trainable parameters of the layer.
+     * 
+     * @param[in] parameters Tensors shaped and strided like the views returned by
+     *                       parameters(), in the same order. Must outlive this layer.
+     * 
+     * @return True on success, false if the tensors don't match the parameters.
+     */
+    bool useParameters(TensorList& parameters) noexcept override;
+
+    /**
+     * @brief Notify the layer that its parameters have been updated externally.
+     */
+    void invalidateParameters() noexcept override;
+
+    /**
+     * @brief Get the maximum number of samples per batch.
+     * 
+     * @return The maximum batch size.
+     */
+    std::size_t maxBatchSize() const noexcept override;
+
+    /**
+     * @brief Set the maximum number of samples per batch.
+     * 
+     * @param[in] batchSize The maximum batch size. Must be greater than 0.
+     * 
+     * @throw std::invalid_argument If the batch size is 0.
+     */
+    void setMaxBatchSize(std::size_t batchSize) override;
+
+    /**
+     * @brief Get the batch buffers of the layer, for memory planning.
+     * 
+     * @return List of the batch buffers, valid as long as the layer.
+     */
+    memory::BufferList buffers() noexcept override;
 
     /**
      * @brief Perform feedforward operation.
      * 
-     * @param[in] input Matrix holding input data.
+     * @param[in] input Tensor holding a single input sample or a batch of samples.
      * 
      * @return True on success, false on failure.
      */
-    bool feedforward(const Matrix2d& input) noexcept override;
+    bool feedforward(const Tensor& input) noexcept override;
+
+    /**
+     * @brief Perform feedforward operation followed by max pooling, for inference only.
+     * 
+     * @param[in] input Tensor holding a single input sample or a batch of samples.
+     * @param[in] poolSize Pool size.
+     * @param[in,out] output Output batch of the next pooling layer.
+     * 
+     * @return False, since pooling layers cannot pool their own output.
+     */
+    bool feedforwardPooled(const Tensor& input, std::size_t poolSize, 
+                           Tensor& output) noexcept override;
+
+    /**
+     * @brief Perform feedforward operation of given layer followed by this layer, for
+     *        inference only.
+     * 
+     *        The source layer pools its output straight into the output of this layer when
+     *        supported, else the layers are run one by one. Backpropagation is only valid 
+     *        after a regular feedforward operation.
+     * 
+     * @param[in] source The layer preceding this layer.
+     * @param[in] input Input of the source layer.
+     * 
+     * @return True on success, false on failure.
+     */
+    bool feedforwardFused(Interface& source, const Tensor& input) noexcept override;
 
     /**
      * @brief Perform backpropagation.
      * 
-     * @param[in] outputGradients Matrix holding gradients from the next layer.
+     * @param[in] outputGradients Tensor holding gradients from the next layer.
      * 
      * @return True on success, false on failure.
      */
-    bool backpropagate(const Matrix2d& outputGradients) noexcept override;
+    bool backpropagate(const Tensor& outputGradients) noexcept override;
 
     /**
      * @brief Perform optimization.
@@ -99,14 +223,27 @@ public:
     MaxPoolLayer& operator=(MaxPoolLayer&&)       = delete;
 
 private:
-    /** Input matrix. */
-    Matrix2d myInput;
+    /** Position of the max value within its pool (row * pool size + column) of each output
+     *  value of the latest batch, laid out like the output batch. */
+    std::vector<std::uint16_t> myMaxIndices;
+
+    /** Input gradient batch, in the channel-blocked layout (see ml/conv_layer/layout.h). */
+    Tensor myInputGradientBatch;
+
+    /** View of the input gradients of the latest batch. */
+    Tensor myInputGradients;
+
+    /** Output batch. */
+    Tensor myOutputBatch;
+
+    /** View of the output of the latest batch. */
+    Tensor myOutput;
 
-    /** Input gradient matrix. */
-    Matrix2d myInputGradients;
+    /** Number of samples in the latest batch. */
+    std::size_t myBatchSize;
 
-    /** Output matrix. */
-    Matrix2d myOutput;
+    /** Number of channels. */
+    std::size_t myChannelCount;
 
     //! @note Detta attribut bör tas bort!
     /** Relu. */
@@ -0,0 +1,329 @@
+/**
+ * @brief Multi-channel convolutional layer implementation.
+ */
+#pragma once
+
+#include <cstdlib>
+
+#include "ml/act_func/kernel.h"
+#include "ml/act_func/type.h"
+#include "ml/conv_layer/algorithm/type.h"
+#include "ml/conv_layer/interface.h"
+#include "ml/memory/buffer.h"
+#include "ml/parameter_mode.h"
+#include "ml/tensor.h"
+#include "ml/types.h"
+
+namespace ml::conv_layer
+{
+/**
+ * @brief Convolutional layer mapping multiple input channels to multiple output channels.
+ *
+ *        Each output channel is the sum of the input channels convolved with one kernel per
+ *        input channel, plus a bias per output channel. The feature maps are stored in the
+ *        channel-blocked layout (see ml/conv_layer/layout.h), and the filters with shape
+ *        (output blocks, input blocks, kernel size², input width, output width), so the
+ *        innermost loop updates a whole block of output channels with the same input value.
+ *        The border is handled by clipping the kernel window instead of padding the input.
+ *
+ *        Alternatively the convolution is lowered onto the blocked GEMM in ml::linalg: the
+ *        input windows of all pixels form a matrix of shape (size², input channels * kernel
+ *        size²), which is multiplied with the filters as a matrix of shape (input channels *
+ *        kernel size², output channels). The filter and input gradients are computed as
+ *        matrix multiplications as well, the latter followed by scattering the gradients of
+ *        the windows back onto the input.
+ *
+ *        This class is non-copyable and non-movable.
+ */
+class MultiChannelConvLayer final : public Interface
+{
+public:
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] inputChannels Number of input channels. Must be at most ChannelBlock or a
+     *                          multiple of ChannelBlock.
+     * @param[in] outputChannels Number of output channels (filters). Same rules as the
+     *                           number of input channels.
+     * @param[in] inputSize Input size as a size_t. Must be > 0.
+     * @param[in] kernelSize Kernel size as a size_t. Must be > 0 and < input size.
+     * @param[in] actFuncType Activation function to use (default = none).
+     * @param[in] algorithm Convolution algorithm, direct convolution, im2col (lowering onto
+     *                      GEMM) or auto, which selects the faster one for the channel counts
+     *                      (default = auto).
+     * @param[in] mode Parameter mode (default = owned). In external mode the filters and the
+     *                 biases must be supplied via useParameters() or shareParameters() before
+     *                 use, and the gradients are allocated on first use.
+     *
+     * @throw std::invalid_argument If any of the arguments is invalid.
+     */
+    explicit MultiChannelConvLayer(std::size_t inputChannels, std::size_t outputChannels,
+                                   std::size_t inputSize, std::size_t kernelSize,
+                                   act_func::Type actFuncType = act_func::Type::None,
+                                   algorithm::Type algorithm = algorithm::Type::Auto,
+                                   ParameterMode mode = ParameterMode::Owned);
+
+    /**
+     * @brief Destructor.
+     */
+    ~MultiChannelConvLayer() noexcept override = default;
+
+    /**
+     * @brief Get the input size of the layer.
+     * 
+     * @return The input size of the layer.
+     */
+    std::size_t inputSize() const noexcept override;
+
+    /**
+     * @brief Get the output size of the layer.
+     * 
+     * @return The output size of the layer.
+     */
+    std::size_t outputSize() const noexcept override;
+
+    /**
+     * @brief Get the output of the layer.
+     * 
+     * @return Tensor holding the output of the layer.
+     */
+    const Tensor& output() const noexcept override;
+
+    /**
+     * @brief Get the input gradients of the layer.
+     * 
+     * @return Tensor holding the input gradients of the layer.
+     */
+    const Tensor& inputGradients() const noexcept override;
+
+    /**
+     * @brief Get the number of output channels of the layer.
+     * 
+     * @return The number of output channels.
+     */
+    std::size_t channelCount() const noexcept override;
+
+    /**
+     * @brief Get the type of the layer.
+     * 
+     * @return The layer type.
+     */
+    Type type() const noexcept override;
+
+    /**
+     * @brief Get the kernel size of the layer.
+     * 
+     * @return The kernel size of the layer.
+     */
+    std::size_t kernelSize() const noexcept override;
+
+    /**
+     * @brief Get the convolution algorithm of the layer.
+     * 
+     * @return The algorithm, direct convolution or im2col (never auto).
+     */
+    algorithm::Type algorithm() const noexcept { return myAlgorithm; }
+
+    /**
+     * @brief Get the activation function of the layer.
+     * 
+     * @return The activation function type.
+     */
+    act_func::Type actFunc() const noexcept override;
+
+    /**
+     * @brief Get the trainable parameters of the layer.
+     * 
+     * @return List of views of the filters and the biases.
+     */
+    TensorList parameters() override;
+
+    /**
+     * @brief Get the gradients of the trainable parameters of the layer.
+     * 
+     * @return List of views of the filter gradients and the bias gradients.
+     */
+    TensorList gradients() override;
+
+    /**
+     * @brief Share the trainable parameters of given layer.
+     * 
+     * @param[in] source Layer of the same type and size, must outlive this layer.
+     * 
+     * @return True on success, false if the layers don't match.
+     */
+    bool shareParameters(Interface& source) noexcept override;
+
+    /**
+     * @brief Use given tensors as the trainable parameters of the layer.
+     * 
+     * @param[in] parameters Tensors shaped and strided like the views returned by
+     *                       parameters(), in the same order. Must outlive this layer.
+     * 
+     * @return True on success, false if the tensors don't match the parameters.
+     */
+    bool useParameters(TensorList& parameters) noexcept override;
+
+    /**
+     * @brief Notify the layer that its parameters have been updated externally.
+     */
+    void invalidateParameters() noexcept override;
+
+    /**
+     * @brief Get the maximum number of samples per batch.
+     * 
+     * @return The maximum batch size.
+     */
+    std::size_t maxBatchSize() const noexcept override;
+
+    /**
+     * @brief Set the maximum number of samples per batch.
+     * 
+     * @param[in] batchSize The maximum batch size. Must be greater than 0.
+     * 
+     * @throw std::invalid_argument If the batch size is 0.
+     */
+    void setMaxBatchSize(std::size_t batchSize) override;
+
+    /**
+     * @brief Get the batch buffers of the layer, for memory planning.
+     * 
+     * @return List of the batch buffers, valid as long as the layer.
+     */
+    memory::BufferList buffers() noexcept override;
+
+    /**
+     * @brief Perform feedforward operation.
+     * 
+     * @param[in] input Tensor holding a single input sample or a batch of samples, in the
+     *                  channel-blocked layout (see ml/conv_layer/layout.h).
+     * 
+     * @return True on success, false on failure.
+     */
+    bool feedforward(const Tensor& input) noexcept override;
+
+    /**
+     * @brief Perform feedforward operation followed by max pooling, for inference only.
+     * 
+     *        Each output row is reduced into the pooled output while still in cache, and the
+     *        activation function is applied to the pooled values only, which is exact since
+     *        every activation function is non-decreasing. The input is not stored.
+     * 
+     * @param[in] input Tensor holding a single input sample or a batch of samples, in the
+     *                  channel-blocked layout (see ml/conv_layer/layout.h).
+     * @param[in] poolSize Pool size. Must divide the output size.
+     * @param[in,out] output Output batch of the pooling layer, replaced by a view of the
+     *                       pooled output on success.
+     * 
+     * @return True on success, false on failure.
+     */
+    bool feedforwardPooled(const Tensor& input, std::size_t poolSize, 
+                           Tensor& output) noexcept override;
+
+    /**
+     * @brief Perform feedforward operation of given layer followed by this layer.
+     * 
+     * @param[in] source The layer preceding this layer.
+     * @param[in] input Input of the source layer.
+     * 
+     * @return True on success, false on failure.
+     */
+    bool feedforwardFused(Interface& source, const Tensor& input) noexcept override;
+
+    /**
+     * @brief Perform backpropagation.
+     * 
+     * @param[in] outputGradients Tensor holding gradients from the next layer.
+     * 
+     * @return True on success, false on failure.
+     */
+    bool backpropagate(const Tensor& outputGradients) noexcept override;
+
+    /**
+     * @brief Perform optimization.
+     * 
+     * @param[in] learningRate Learning rate to use.
+     * 
+     * @return True on success, false on failure.
+     */
+    bool optimize(double learningRate) noexcept override;
+
+    /**
+     * @brief Delete the default constructor, delete copy and move constructors, delete operators.
+     */
+    MultiChannelConvLayer()                                        = delete;
+    MultiChannelConvLayer(const MultiChannelConvLayer&)            = delete;
+    MultiChannelConvLayer(MultiChannelConvLayer&&)                 = delete;
+    MultiChannelConvLayer& operator=(const MultiChannelConvLayer&) = delete;
+    MultiChannelConvLayer& operator=(MultiChannelConvLayer&&)      = delete;
+
+private:
+    void allocateGradients();
+    void forwardSample(const Scalar* input, Scalar* output, bool activate) noexcept;
+    void backpropagateLowered(const Tensor& deltas, Scalar scale) noexcept;
+    void lowerFilters() noexcept;
+
+    /** Latest input batch, in the channel-blocked layout. */
+    Tensor myInputBatch;
+
+    /** Input gradient batch. */
+    Tensor myInputGradientBatch;
+
+    /** View of the input gradients of the latest batch. */
+    Tensor myInputGradients;
+
+    /** Filters, shape (output blocks, input blocks, kernel size², input width, output width). */
+    Tensor myFilters;
+
+    /** Filter gradients, averaged over the latest batch. */
+    Tensor myFilterGradients;
+
+    /** Bias values, one per output channel. */
+    Tensor myBias;
+
+    /** Bias gradients, averaged over the latest batch. */
+    Tensor myBiasGradients;
+
+    /** Output batch. */
+    Tensor myOutputBatch;
+
+    /** View of the output of the latest batch. */
+    Tensor myOutput;
+
+    /** Output delta batch (output gradients times activation function derivative). */
+    Tensor myDeltaBatch;
+
+    /** Windows of the latest sample as rows, or their gradients, im2col only. Shape (size²,
+     *  input channels * kernel size²). */
+    Tensor myRows;
+
+    /** Outputs or output deltas of the latest sample, im2col only. Shape (size², output
+     *  channels). */
+    Tensor myPixels;
+
+    /** Filters as a matrix, im2col only. Shape (input channels * kernel size², output
+     *  channels). */
+    Tensor myLoweredFilters;
+
+    /** Gradients of the filters as a matrix, im2col only. */
+    Tensor myLoweredFilterGradients;
+
+    /** Number of input channels. */
+    std::size_t myInputChannels;
+
+    /** Number of output channels. */
+    std::size_t myOutputChannels;
+
+    /** Kernel size. */
+    std::size_t myKernelSize;
+
+    /** Number of samples in the latest batch. */
+    std::size_t myBatchSize;
+
+    /** Activation function kernels. */
+    act_func::Kernel myActFunc;
+
+    /** Convolution algorithm, direct convolution or im2col. */
+    algorithm::Type myAlgorithm;
+};
+} // namespace ml::conv_layer
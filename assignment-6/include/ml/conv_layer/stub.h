@@ -8,6 +8,9 @@
 
 #include "ml/act_func/type.h"
 #include "ml/conv_layer/interface.h"
+#include "ml/conv_layer/layout.h"
+#include "ml/memory/buffer.h"
+#include "ml/tensor.h"
 #include "ml/types.h"
 #include "ml/utils.h"
 
@@ -30,9 +33,15 @@ public:
      */
     explicit ConvStub(const std::size_t inputSize, const std::size_t kernelSize, 
                   const act_func::Type actFunc = act_func::Type::None)
-        : myInputGradients{}
+        : myInputGradientBatch{}
+        , myInputGradients{}
         , myKernel{}
+        , myKernelGradients{}
+        , myBias{}
+        , myBiasGradient{}
+        , myOutputBatch{}
         , myOutput{}
+        , myActFunc{actFunc}
     {
         // Throw exception if the kernel size is outside range [1, 11] or larger than the input size.
         if ((kMinKernelSize > kernelSize) || (kMaxKernelSize < kernelSize))
@@ -49,12 +58,12 @@ public:
         }
 
         // Initialize the matrices with zeros.
-        initMatrix(myInputGradients, inputSize);
-        initMatrix(myKernel, kernelSize);
-        initMatrix(myOutput, inputSize);
-
-        // Ignore activation function in this implementation.
-        (void) (actFunc);
+        myInputGradientBatch = Tensor{1U, inputSize, inputSize};
+        myKernel             = Tensor{kernelSize, kernelSize};
+        myKernelGradients    = Tensor{kernelSize, kernelSize};
+        myBias               = Tensor{1U};
+        myBiasGradient       = Tensor{1U};
+        setMaxBatchSize(1U);
     }
 
     /** 
@@ -67,57 +76,225 @@ public:
      * 
      * @return The input size of the layer.
      */
-    std::size_t inputSize() const noexcept override { return myInputGradients.size(); }
+    std::size_t inputSize() const noexcept override { return myInputGradientBatch.dim(1U); }
 
     /**
      * @brief Get the output size of the layer.
      * 
      * @return The output size of the layer.
      */
-    std::size_t outputSize() const noexcept override { return myOutput.size(); }
+    std::size_t outputSize() const noexcept override { return myOutputBatch.dim(1U); }
 
     /**
      * @brief Get the output of the layer.
      * 
-     * @return Matrix holding the output of the layer.
+     * @return Tensor holding the output of the layer.
      */
-    const Matrix2d& output() const noexcept override { return myOutput; }
+    const Tensor& output() const noexcept override { return myOutput; }
 
     /**
      * @brief Get the input gradients of the layer.
      * 
-     * @return Matrix holding the input gradients of the layer.
+     * @return Tensor holding the input gradients of the layer.
+     */
+    const Tensor& inputGradients() const noexcept override { return myInputGradients; }
+
+    /**
+     * @brief Get the number of output channels of the layer.
+     * 
+     * @return The number of output channels (always 1).
+     */
+    std::size_t channelCount() const noexcept override { return 1U; }
+
+    /**
+     * @brief Get the type of the layer.
+     * 
+     * @return The layer type.
+     */
+    Type type() const noexcept override { return Type::Conv; }
+
+    /**
+     * @brief Get the kernel size of the layer.
+     * 
+     * @return The kernel size of the layer.
+     */
+    std::size_t kernelSize() const noexcept override { return myKernel.dim(0U); }
+
+    /**
+     * @brief Get the activation function of the layer.
+     * 
+     * @return The activation function type.
+     */
+    act_func::Type actFunc() const noexcept override { return myActFunc; }
+
+    /**
+     * @brief Get the trainable parameters of the layer.
+     * 
+     * @return List of views of the kernel and the bias.
+     */
+    TensorList parameters() override
+    {
+        TensorList parameters{};
+        parameters.push_back(myKernel.view());
+        parameters.push_back(myBias.view());
+        return parameters;
+    }
+
+    /**
+     * @brief Get the gradients of the trainable parameters of the layer.
+     * 
+     * @return List of views of the kernel gradients and the bias gradient.
+     */
+    TensorList gradients() override
+    {
+        TensorList gradients{};
+        gradients.push_back(myKernelGradients.view());
+        gradients.push_back(myBiasGradient.view());
+        return gradients;
+    }
+
+    /**
+     * @brief Share the trainable parameters of given layer.
+     * 
+     * @param[in] source Layer of the same type and size, must outlive this layer.
+     * 
+     * @return True on success, false if the layers don't match.
+     */
+    bool shareParameters(Interface& source) noexcept override
+    {
+        // Return false unless the source is a convolutional stub with the same kernel size.
+        auto* const layer{dynamic_cast<ConvStub*>(&source)};
+        if ((nullptr == layer) || !myKernel.sameShape(layer->myKernel)) { return false; }
+
+        // Use views of the parameters of the source.
+        myKernel = layer->myKernel.view();
+        myBias   = layer->myBias.view();
+        return true;
+    }
+
+    /**
+     * @brief Use given tensors as the trainable parameters of the layer.
+     * 
+     * @param[in] parameters Tensors shaped like the views returned by parameters(), in the
+     *                       same order. Must outlive this layer.
+     * 
+     * @return True on success, false if the tensors don't match the parameters.
      */
-    const Matrix2d& inputGradients() const noexcept override { return myInputGradients; }
+    bool useParameters(TensorList& parameters) noexcept override
+    {
+        // Return false unless the tensors are a kernel of the same size and a single bias.
+        if ((2U != parameters.size()) || !parameters[0U].sameShape(myKernel)
+            || !parameters[1U].sameShape(myBias)) { return false; }
+
+        // Use views of the tensors.
+        myKernel = parameters[0U].view();
+        myBias   = parameters[1U].view();
+        return true;
+    }
+
+    /**
+     * @brief Notify the layer that its parameters have been updated externally.
+     */
+    void invalidateParameters() noexcept override {}
+
+    /**
+     * @brief Get the maximum number of samples per batch.
+     * 
+     * @return The maximum batch size.
+     */
+    std::size_t maxBatchSize() const noexcept override { return myOutputBatch.dim(0U); }
+
+    /**
+     * @brief Set the maximum number of samples per batch.
+     * 
+     * @param[in] batchSize The maximum batch size. Must be greater than 0.
+     * 
+     * @throw std::invalid_argument If the batch size is 0.
+     */
+    void setMaxBatchSize(const std::size_t batchSize) override
+    {
+        // Throw an exception if the batch size is invalid.
+        if (0U == batchSize) { throw std::invalid_argument("Batch size cannot be 0!"); }
+
+        // Reallocate the batch matrices, let the views refer to the first sample.
+        const std::size_t size{inputSize()};
+        myInputGradientBatch = Tensor{batchSize, size, size};
+        myOutputBatch        = Tensor{batchSize, size, size};
+        myInputGradients     = myInputGradientBatch.slice(0U);
+        myOutput             = myOutputBatch.slice(0U);
+    }
+
+    /**
+     * @brief Get the batch buffers of the layer, for memory planning.
+     * 
+     * @return Empty list, the stub keeps its own buffers.
+     */
+    memory::BufferList buffers() noexcept override { return memory::BufferList{}; }
 
     /**
      * @brief Perform feedforward operation.
      * 
-     * @param[in] input Matrix holding input data.
+     * @param[in] input Tensor holding input data.
      * 
      * @return True on success, false on failure.
      */
-    bool feedforward(const Matrix2d& input) noexcept override
+    bool feedforward(const Tensor& input) noexcept override
     {
-        // Return true if the input matches the expected (unpadded) output size.
+        // Return true if the input matches the expected input size.
         constexpr const char* opName{"feedforward in convolutional layer"};
-        return matchDimensions(myOutput.size(), input.size(), opName)
-            && isMatrixSquare(input, opName);
+        const std::size_t sampleCount{batchSize(input, myInputGradientBatch, opName)};
+        if (0U == sampleCount) { return false; }
+
+        // Let the views match the layout of the input.
+        const bool batched{input.rank() == myInputGradientBatch.rank()};
+        myOutput         = batchView(myOutputBatch, sampleCount, batched);
+        myInputGradients = batchView(myInputGradientBatch, sampleCount, batched);
+        return true;
+    }
+
+    /**
+     * @brief Perform feedforward operation followed by max pooling (not implemented).
+     * 
+     * @param[in] input Tensor holding input data.
+     * @param[in] poolSize Pool size.
+     * @param[in,out] output Output batch of the pooling layer.
+     * 
+     * @return False, so that the caller runs the layers one by one.
+     */
+    bool feedforwardPooled(const Tensor& input, const std::size_t poolSize, 
+                           Tensor& output) noexcept override
+    {
+        (void) (input);
+        (void) (poolSize);
+        (void) (output);
+        return false;
+    }
+
+    /**
+     * @brief Perform feedforward operation of given layer followed by this layer.
+     * 
+     * @param[in] source The layer preceding this layer.
+     * @param[in] input Input of the source layer.
+     * 
+     * @return True on success, false on failure.
+     */
+    bool feedforwardFused(Interface& source, const Tensor& input) noexcept override
+    {
+        return source.feedforward(input) && feedforward(source.output());
     }
 
     /**
      * @brief Perform backpropagation.
      * 
-     * @param[in] outputGradients Matrix holding gradients from the next layer.
+     * @param[in] outputGradients Tensor holding gradients from the next layer.
      * 
      * @return True on success, false on failure.
      */
-    bool backpropagate(const Matrix2d& outputGradients) noexcept override
+    bool backpropagate(const Tensor& outputGradients) noexcept override
     {
         // Return true if the output dimensions match.
         constexpr const char* opName{"backpropagation in convolutional layer"};
-        return matchDimensions(myOutput.size(), outputGradients.size(), opName)
-            && isMatrixSquare(outputGradients, opName);
+        return 0U != batchSize(outputGradients, myOutputBatch, opName);
     }
 
     /**
@@ -147,14 +324,388 @@ private:
     /** Minimum valid kernel size. */
     static constexpr std::size_t kMaxKernelSize{11U};
 
-    /** Input gradients. */
-    Matrix2d myInputGradients;
+    /** Input gradient batch. */
+    Tensor myInputGradientBatch;
+
+    /** View of the input gradients of the latest batch. */
+    Tensor myInputGradients;
 
     /** Kernel matrix. */
-    Matrix2d myKernel;
+    Tensor myKernel;
+
+    /** Kernel gradient matrix. */
+    Tensor myKernelGradients;
+
+    /** Bias value. */
+    Tensor myBias;
+
+    /** Bias gradient. */
+    Tensor myBiasGradient;
+
+    /** Output batch. */
+    Tensor myOutputBatch;
 
-    /** Output matrix. */
-    Matrix2d myOutput;
+    /** View of the output of the latest batch. */
+    Tensor myOutput;
+
+    /** Activation function type. */
+    act_func::Type myActFunc;
+};
+
+/**
+ * @brief Multi-channel convolutional layer stub.
+ * 
+ *        This class is non-copyable and non-movable.
+ */
+class MultiChannelStub final : public Interface
+{
+public:
+    /**
+     * @brief Constructor.
+     * 
+     * @param[in] inputChannels Number of input channels.
+     * @param[in] outputChannels Number of output channels (filters).
+     * @param[in] inputSize Input size. Must be greater than 0.
+     * @param[in] kernelSize Kernel size. Must be greater than 0 and smaller than the input size.
+     * @param[in] actFunc Activation function to use (default = none).
+     */
+    explicit MultiChannelStub(const std::size_t inputChannels, const std::size_t outputChannels,
+                              const std::size_t inputSize, const std::size_t kernelSize, 
+                              const act_func::Type actFunc = act_func::Type::None)
+        : myInputGradientBatch{}
+        , myInputGradients{}
+        , myFilters{}
+        , myFilterGradients{}
+        , myBias{}
+        , myBiasGradients{}
+        , myOutputBatch{}
+        , myOutput{}
+        , myInputChannels{inputChannels}
+        , myOutputChannels{outputChannels}
+        , myActFunc{actFunc}
+    {
+        // Throw an exception if the channel counts or the kernel size are invalid.
+        if (!isValidChannelCount(inputChannels) || !isValidChannelCount(outputChannels))
+        {
+            throw std::invalid_argument("Invalid channel count!");
+        }
+        else if ((kMinKernelSize > kernelSize) || (kMaxKernelSize < kernelSize) 
+            || (inputSize < kernelSize))
+        {
+            throw std::invalid_argument("Invalid kernel size!");
+        }
+
+        // Initialize the matrices with zeros.
+        const std::size_t inputWidth{blockWidth(inputChannels)};
+        const std::size_t outputWidth{blockWidth(outputChannels)};
+        myInputGradientBatch = featureMaps(1U, inputChannels, inputSize);
+        myFilters            = Tensor{outputChannels / outputWidth, inputChannels / inputWidth,
+                                      kernelSize * kernelSize, inputWidth, outputWidth};
+        myFilterGradients    = Tensor{myFilters.shape(), myFilters.rank()};
+        myBias               = Tensor{outputChannels};
+        myBiasGradients      = Tensor{outputChannels};
+        setMaxBatchSize(1U);
+    }
+
+    /** 
+     * @brief Destructor. 
+     */
+    ~MultiChannelStub() noexcept override = default;
+
+    /**
+     * @brief Get the input size of the layer.
+     * 
+     * @return The input size of the layer.
+     */
+    std::size_t inputSize() const noexcept override 
+    { 
+        return featureMapSize(myInputGradientBatch); 
+    }
+
+    /**
+     * @brief Get the output size of the layer.
+     * 
+     * @return The output size of the layer.
+     */
+    std::size_t outputSize() const noexcept override { return inputSize(); }
+
+    /**
+     * @brief Get the output of the layer.
+     * 
+     * @return Tensor holding the output of the layer.
+     */
+    const Tensor& output() const noexcept override { return myOutput; }
+
+    /**
+     * @brief Get the input gradients of the layer.
+     * 
+     * @return Tensor holding the input gradients of the layer.
+     */
+    const Tensor& inputGradients() const noexcept override { return myInputGradients; }
+
+    /**
+     * @brief Get the number of output channels of the layer.
+     * 
+     * @return The number of output channels.
+     */
+    std::size_t channelCount() const noexcept override { return myOutputChannels; }
+
+    /**
+     * @brief Get the type of the layer.
+     * 
+     * @return The layer type.
+     */
+    Type type() const noexcept override { return Type::MultiChannel; }
+
+    /**
+     * @brief Get the kernel size of the layer.
+     * 
+     * @return The kernel size of the layer.
+     */
+    std::size_t kernelSize() const noexcept override 
+    { 
+        const std::size_t kernelArea{myFilters.dim(2U)};
+        std::size_t kernelSize{1U};
+        while (kernelSize * kernelSize < kernelArea) { ++kernelSize; }
+        return kernelSize;
+    }
+
+    /**
+     * @brief Get the activation function of the layer.
+     * 
+     * @return The activation function type.
+     */
+    act_func::Type actFunc() const noexcept override { return myActFunc; }
+
+    /**
+     * @brief Get the trainable parameters of the layer.
+     * 
+     * @return List of views of the filters and the biases.
+     */
+    TensorList parameters() override
+    {
+        TensorList parameters{};
+        parameters.push_back(myFilters.view());
+        parameters.push_back(myBias.view());
+        return parameters;
+    }
+
+    /**
+     * @brief Get the gradients of the trainable parameters of the layer.
+     * 
+     * @return List of views of the filter gradients and the bias gradients.
+     */
+    TensorList gradients() override
+    {
+        TensorList gradients{};
+        gradients.push_back(myFilterGradients.view());
+        gradients.push_back(myBiasGradients.view());
+        return gradients;
+    }
+
+    /**
+     * @brief Share the trainable parameters of given layer.
+     * 
+     * @param[in] source Layer of the same type and size, must outlive this layer.
+     * 
+     * @return True on success, false if the layers don't match.
+     */
+    bool shareParameters(Interface& source) noexcept override
+    {
+        // Return false unless the source is a multi-channel stub with the same filter shape.
+        auto* const layer{dynamic_cast<MultiChannelStub*>(&source)};
+        if ((nullptr == layer) || !myFilters.sameShape(layer->myFilters)) { return false; }
+
+        // Use views of the parameters of the source.
+        myFilters = layer->myFilters.view();
+        myBias    = layer->myBias.view();
+        return true;
+    }
+
+    /**
+     * @brief Use given tensors as the trainable parameters of the layer.
+     * 
+     * @param[in] parameters Tensors shaped like the views returned by parameters(), in the
+     *                       same order. Must outlive this layer.
+     * 
+     * @return True on success, false if the tensors don't match the parameters.
+     */
+    bool useParameters(TensorList& parameters) noexcept override
+    {
+        // Return false unless the tensors are filters of the same shape and the biases.
+        if ((2U != parameters.size()) || !parameters[0U].sameShape(myFilters)
+            || !parameters[1U].sameShape(myBias)) { return false; }
+
+        // Use views of the tensors.
+        myFilters = parameters[0U].view();
+        myBias    = parameters[1U].view();
+        return true;
+    }
+
+    /**
+     * @brief Notify the layer that its parameters have been updated externally.
+     */
+    void invalidateParameters() noexcept override {}
+
+    /**
+     * @brief Get the maximum number of samples per batch.
+     * 
+     * @return The maximum batch size.
+     */
+    std::size_t maxBatchSize() const noexcept override { return myOutputBatch.dim(0U); }
+
+    /**
+     * @brief Set the maximum number of samples per batch.
+     * 
+     * @param[in] batchSize The maximum batch size. Must be greater than 0.
+     * 
+     * @throw std::invalid_argument If the batch size is 0.
+     */
+    void setMaxBatchSize(const std::size_t batchSize) override
+    {
+        // Throw an exception if the batch size is invalid.
+        if (0U == batchSize) { throw std::invalid_argument("Batch size cannot be 0!"); }
+
+        // Reallocate the batch matrices, let the views refer to the first sample.
+        const std::size_t size{inputSize()};
+        myInputGradientBatch = featureMaps(batchSize, myInputChannels, size);
+        myOutputBatch        = featureMaps(batchSize, myOutputChannels, size);
+        myInputGradients     = myInputGradientBatch.slice(0U);
+        myOutput             = myOutputBatch.slice(0U);
+    }
+
+    /**
+     * @brief Get the batch buffers of the layer, for memory planning.
+     * 
+     * @return Empty list, the stub keeps its own buffers.
+     */
+    memory::BufferList buffers() noexcept override { return memory::BufferList{}; }
+
+    /**
+     * @brief Perform feedforward operation.
+     * 
+     * @param[in] input Tensor holding input data.
+     * 
+     * @return True on success, false on failure.
+     */
+    bool feedforward(const Tensor& input) noexcept override
+    {
+        // Return true if the input matches the expected input size.
+        constexpr const char* opName{"feedforward in multi-channel convolutional layer"};
+        const std::size_t sampleCount{batchSize(input, myInputGradientBatch, opName)};
+        if (0U == sampleCount) { return false; }
+
+        // Let the views match the layout of the input.
+        const bool batched{input.rank() == myInputGradientBatch.rank()};
+        myOutput         = batchView(myOutputBatch, sampleCount, batched);
+        myInputGradients = batchView(myInputGradientBatch, sampleCount, batched);
+        return true;
+    }
+
+    /**
+     * @brief Perform feedforward operation followed by max pooling (not implemented).
+     * 
+     * @param[in] input Tensor holding input data.
+     * @param[in] poolSize Pool size.
+     * @param[in,out] output Output batch of the pooling layer.
+     * 
+     * @return False, so that the caller runs the layers one by one.
+     */
+    bool feedforwardPooled(const Tensor& input, const std::size_t poolSize, 
+                           Tensor& output) noexcept override
+    {
+        (void) (input);
+        (void) (poolSize);
+        (void) (output);
+        return false;
+    }
+
+    /**
+     * @brief Perform feedforward operation of given layer followed by this layer.
+     * 
+     * @param[in] source The layer preceding this layer.
+     * @param[in] input Input of the source layer.
+     * 
+     * @return True on success, false on failure.
+     */
+    bool feedforwardFused(Interface& source, const Tensor& input) noexcept override
+    {
+        return source.feedforward(input) && feedforward(source.output());
+    }
+
+    /**
+     * @brief Perform backpropagation.
+     * 
+     * @param[in] outputGradients Tensor holding gradients from the next layer.
+     * 
+     * @return True on success, false on failure.
+     */
+    bool backpropagate(const Tensor& outputGradients) noexcept override
+    {
+        // Return true if the output dimensions match.
+        constexpr const char* opName{"backpropagation in multi-channel convolutional layer"};
+        return 0U != batchSize(outputGradients, myOutputBatch, opName);
+    }
+
+    /**
+     * @brief Perform optimization.
+     * 
+     * @param[in] learningRate Learning rate to use.
+     * 
+     * @return True on success, false on failure.
+     */
+    bool optimize(const double learningRate) noexcept override
+    {
+        // Check the learning rate, return true if valid.
+        constexpr const char* opName{"optimization in multi-channel convolutional layer"};
+        return checkLearningRate(learningRate, opName);
+    }
+
+    MultiChannelStub()                                   = delete; // No default constructor.
+    MultiChannelStub(const MultiChannelStub&)            = delete; // No copy constructor.
+    MultiChannelStub(MultiChannelStub&&)                 = delete; // No move constructor.
+    MultiChannelStub& operator=(const MultiChannelStub&) = delete; // No copy assignment.
+    MultiChannelStub& operator=(MultiChannelStub&&)      = delete; // No move assignment.
+
+private:
+    /** Minimum valid kernel size. */
+    static constexpr std::size_t kMinKernelSize{1U};
+
+    /** Maximum valid kernel size. */
+    static constexpr std::size_t kMaxKernelSize{11U};
+
+    /** Input gradient batch. */
+    Tensor myInputGradientBatch;
+
+    /** View of the input gradients of the latest batch. */
+    Tensor myInputGradients;
+
+    /** Filters. */
+    Tensor myFilters;
+
+    /** Filter gradients. */
+    Tensor myFilterGradients;
+
+    /** Bias values, one per output channel. */
+    Tensor myBias;
+
+    /** Bias gradients. */
+    Tensor myBiasGradients;
+
+    /** Output batch. */
+    Tensor myOutputBatch;
+
+    /** View of the output of the latest batch. */
+    Tensor myOutput;
+
+    /** Number of input channels. */
+    std::size_t myInputChannels;
+
+    /** Number of output channels. */
+    std::size_t myOutputChannels;
+
+    /** Activation function type. */
+    act_func::Type myActFunc;
 };
 
 /**
@@ -168,11 +719,15 @@ public:
      * 
      * @param[in] inputSize Input size. Must be greater than 0.
      * @param[in] poolSize Pool size. Must divide the input size.
+     * @param[in] channelCount Number of channels (default = 1).
      */
-    explicit MaxPoolStub(const std::size_t inputSize, const std::size_t poolSize)
-        : myInput{}
+    explicit MaxPoolStub(const std::size_t inputSize, const std::size_t poolSize,
+                         const std::size_t channelCount = 1U)
+        : myInputGradientBatch{}
         , myInputGradients{}
+        , myOutputBatch{}
         , myOutput{}
+        , myChannelCount{channelCount}
     {
         // Check the pool dimensions, throw an exception if invalid.
         if (0U == inputSize)
@@ -191,12 +746,16 @@ public:
         {
             throw std::invalid_argument("Input size must be divisible by pool size!");
         }
+        else if (!isValidChannelCount(channelCount))
+        {
+            throw std::invalid_argument("Invalid channel count!");
+        }
 
         // Initialize the pool matrices.
         const std::size_t outputSize{inputSize / poolSize};
-        initMatrix(myInput, inputSize);
-        initMatrix(myInputGradients, inputSize);
-        initMatrix(myOutput, outputSize);
+        myInputGradientBatch = featureMaps(1U, channelCount, inputSize);
+        myOutputBatch        = featureMaps(1U, channelCount, outputSize);
+        setMaxBatchSize(1U);
     }
 
     /**
@@ -209,57 +768,207 @@ public:
      * 
      * @return The input size of the layer.
      */
-    std::size_t inputSize() const noexcept override { return myInputGradients.size(); }
+    std::size_t inputSize() const noexcept override 
+    { 
+        return featureMapSize(myInputGradientBatch); 
+    }
 
     /**
      * @brief Get the output size of the layer.
      * 
      * @return The output size of the layer.
      */
-    std::size_t outputSize() const noexcept override { return myOutput.size(); }
+    std::size_t outputSize() const noexcept override { return featureMapSize(myOutputBatch); }
 
     /**
      * @brief Get the output of the layer.
      * 
-     * @return Matrix holding the output of the layer.
+     * @return Tensor holding the output of the layer.
      */
-    const Matrix2d& output() const noexcept override { return myOutput; }
+    const Tensor& output() const noexcept override { return myOutput; }
 
     /**
      * @brief Get the input gradients of the layer.
      * 
-     * @return Matrix holding the input gradients of the layer.
+     * @return Tensor holding the input gradients of the layer.
+     */
+    const Tensor& inputGradients() const noexcept override { return myInputGradients; }
+
+    /**
+     * @brief Get the number of output channels of the layer.
+     * 
+     * @return The number of channels (same as the input).
+     */
+    std::size_t channelCount() const noexcept override { return myChannelCount; }
+
+    /**
+     * @brief Get the type of the layer.
+     * 
+     * @return The layer type.
+     */
+    Type type() const noexcept override { return Type::MaxPool; }
+
+    /**
+     * @brief Get the pool size of the layer.
+     * 
+     * @return The pool size of the layer.
+     */
+    std::size_t kernelSize() const noexcept override 
+    { 
+        return inputSize() / outputSize(); 
+    }
+
+    /**
+     * @brief Get the activation function of the layer.
+     * 
+     * @return The activation function type (always none).
+     */
+    act_func::Type actFunc() const noexcept override { return act_func::Type::None; }
+
+    /**
+     * @brief Get the trainable parameters of the layer.
+     * 
+     * @return An empty list, since pooling layers have no trainable parameters.
+     */
+    TensorList parameters() override { return TensorList{}; }
+
+    /**
+     * @brief Get the gradients of the trainable parameters of the layer.
+     * 
+     * @return An empty list, since pooling layers have no trainable parameters.
      */
-    const Matrix2d& inputGradients() const noexcept override { return myInputGradients; }
+    TensorList gradients() override { return TensorList{}; }
+
+    /**
+     * @brief Share the trainable parameters of given layer.
+     * 
+     * @param[in] source Layer of the same type and size.
+     * 
+     * @return True on success (pooling layers have no parameters), false if the layers 
+     *         don't match.
+     */
+    bool shareParameters(Interface& source) noexcept override
+    {
+        return Type::MaxPool == source.type();
+    }
+
+    /**
+     * @brief Use given tensors as the trainable parameters of the layer.
+     * 
+     * @param[in] parameters Tensors shaped like the views returned by parameters(), in the
+     *                       same order. Must outlive this layer.
+     * 
+     * @return True on success, false if the tensors don't match the parameters.
+     */
+    bool useParameters(TensorList& parameters) noexcept override
+    {
+        return parameters.empty();
+    }
+
+    /**
+     * @brief Notify the layer that its parameters have been updated externally.
+     */
+    void invalidateParameters() noexcept override {}
+
+    /**
+     * @brief Get the maximum number of samples per batch.
+     * 
+     * @return The maximum batch size.
+     */
+    std::size_t maxBatchSize() const noexcept override { return myOutputBatch.dim(0U); }
+
+    /**
+     * @brief Set the maximum number of samples per batch.
+     * 
+     * @param[in] batchSize The maximum batch size. Must be greater than 0.
+     * 
+     * @throw std::invalid_argument If the batch size is 0.
+     */
+    void setMaxBatchSize(const std::size_t batchSize) override
+    {
+        // Throw an exception if the batch size is invalid.
+        if (0U == batchSize) { throw std::invalid_argument("Batch size cannot be 0!"); }
+
+        // Reallocate the batch matrices, let the views refer to the first sample.
+        const std::size_t inputSize{this->inputSize()};
+        const std::size_t outputSize{this->outputSize()};
+        myInputGradientBatch = featureMaps(batchSize, myChannelCount, inputSize);
+        myOutputBatch        = featureMaps(batchSize, myChannelCount, outputSize);
+        myInputGradients     = myInputGradientBatch.slice(0U);
+        myOutput             = myOutputBatch.slice(0U);
+    }
+
+    /**
+     * @brief Get the batch buffers of the layer, for memory planning.
+     * 
+     * @return Empty list, the stub keeps its own buffers.
+     */
+    memory::BufferList buffers() noexcept override { return memory::BufferList{}; }
 
     /**
      * @brief Perform feedforward operation.
      * 
-     * @param[in] input Matrix holding input data.
+     * @param[in] input Tensor holding input data.
      * 
      * @return True on success, false on failure.
      */
-    bool feedforward(const Matrix2d& input) noexcept override
+    bool feedforward(const Tensor& input) noexcept override
     {
-        // Return true if the input matches the expected (unpadded) output size.
+        // Return true if the input matches the expected input size.
         constexpr const char* opName{"feedforward in max pooling layer"};
-        return matchDimensions(myInput.size(), input.size(), opName)
-            && isMatrixSquare(input, opName);
+        const std::size_t sampleCount{batchSize(input, myInputGradientBatch, opName)};
+        if (0U == sampleCount) { return false; }
+
+        // Let the views match the layout of the input.
+        const bool batched{input.rank() == myInputGradientBatch.rank()};
+        myOutput         = batchView(myOutputBatch, sampleCount, batched);
+        myInputGradients = batchView(myInputGradientBatch, sampleCount, batched);
+        return true;
+    }
+
+    /**
+     * @brief Perform feedforward operation followed by max pooling (not implemented).
+     * 
+     * @param[in] input Tensor holding input data.
+     * @param[in] poolSize Pool size.
+     * @param[in,out] output Output batch of the pooling layer.
+     * 
+     * @return False, so that the caller runs the layers one by one.
+     */
+    bool feedforwardPooled(const Tensor& input, const std::size_t poolSize, 
+                           Tensor& output) noexcept override
+    {
+        (void) (input);
+        (void) (poolSize);
+        (void) (output);
+        return false;
+    }
+
+    /**
+     * @brief Perform feedforward operation of given layer followed by this layer.
+     * 
+     * @param[in] source The layer preceding this layer.
+     * @param[in] input Input of the source layer.
+     * 
+     * @return True on success, false on failure.
+     */
+    bool feedforwardFused(Interface& source, const Tensor& input) noexcept override
+    {
+        return source.feedforward(input) && feedforward(source.output());
     }
 
     /**
      * @brief Perform backpropagation.
      * 
-     * @param[in] outputGradients Matrix holding gradients from the next layer.
+     * @param[in] outputGradients Tensor holding gradients from the next layer.
      * 
      * @return True on success, false on failure.
      */
-    bool backpropagate(const Matrix2d& outputGradients) noexcept override
+    bool backpropagate(const Tensor& outputGradients) noexcept override
     {
         // Return true if the output dimensions match.
         constexpr const char* opName{"backpropagation in max pooling layer"};
-        return matchDimensions(myOutput.size(), outputGradients.size(), opName)
-            && isMatrixSquare(outputGradients, opName);
+        return 0U != batchSize(outputGradients, myOutputBatch, opName);
     }
 
     /**
@@ -282,13 +991,19 @@ public:
     MaxPoolStub& operator=(MaxPoolStub&&)      = delete; // No move assignment.
 
 private:
-    /** Pool input. */
-    Matrix2d myInput;
+    /** Input gradient batch. */
+    Tensor myInputGradientBatch;
+
+    /** View of the input gradients of the latest batch. */
+    Tensor myInputGradients;
+
+    /** Pool output batch. */
+    Tensor myOutputBatch;
 
-    /** Input gradients. */
-    Matrix2d myInputGradients;
+    /** View of the output of the latest batch. */
+    Tensor myOutput;
 
-    /** Pool output. */
-    Matrix2d myOutput;
+    /** Number of channels. */
+    std::size_t myChannelCount;
 };
 } // namespace ml::conv_layer
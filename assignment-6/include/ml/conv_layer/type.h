@@ -0,0 +1,19 @@
+/**
+ * @brief Convolutional layer types.
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace ml::conv_layer
+{
+/**
+ * @brief Enumeration of convolutional layer types.
+ */
+enum class Type : std::uint8_t
+{
+    Conv,         ///< Convolutional layer.
+    MaxPool,      ///< Max pooling layer.
+    MultiChannel, ///< Multi-channel convolutional layer.
+};
+} // namespace ml::conv_layer
@@ -0,0 +1,28 @@
+/**
+ * @brief Random data augmentation settings.
+ */
+#pragma once
+
+#include <cstddef>
+
+#include "ml/scalar.h"
+
+namespace ml::dataset
+{
+/**
+ * @brief Random data augmentation settings, applied to each sample when a batch is assembled.
+ *
+ *        The default settings leave the samples unchanged.
+ */
+struct Augmentation
+{
+    /** Maximum shift in pixels along each axis, the vacated pixels are set to 0. */
+    std::size_t maxShift{};
+
+    /** Mirror half of the samples horizontally if true. */
+    bool flip{};
+
+    /** Standard deviation of the Gaussian noise added to each pixel, 0 for none. */
+    Scalar noise{};
+};
+} // namespace ml::dataset
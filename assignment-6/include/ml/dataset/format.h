@@ -0,0 +1,18 @@
+/**
+ * @brief Dataset file formats.
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace ml::dataset
+{
+/**
+ * @brief Enumeration of dataset file formats.
+ */
+enum class Format : std::uint8_t
+{
+    Idx, ///< IDX files, such as the MNIST files, with unsigned byte data.
+    Raw, ///< Headerless unsigned byte files with square images and one label per sample.
+};
+} // namespace ml::dataset
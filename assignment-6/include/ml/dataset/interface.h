@@ -0,0 +1,56 @@
+/**
+ * @brief Dataset interface.
+ */
+#pragma once
+
+#include "ml/tensor.h"
+#include "ml/types.h"
+
+namespace ml::dataset
+{
+/**
+ * @brief Dataset interface.
+ *
+ *        A dataset provides training samples on demand, i.e. each sample is decoded into a
+ *        batch buffer of the trainer when it's needed, so the whole dataset never needs to be
+ *        held in memory as tensors. Samples may be loaded concurrently by several threads.
+ */
+class Interface
+{
+public:
+    /**
+     * @brief Destructor.
+     */
+    virtual ~Interface() noexcept = default;
+
+    /**
+     * @brief Get the number of samples in the dataset.
+     * 
+     * @return The number of samples.
+     */
+    virtual std::size_t sampleCount() const noexcept = 0;
+
+    /**
+     * @brief Get the input size, i.e. the height and width of the square inputs.
+     * 
+     * @return The input size, 0 if the inputs aren't square.
+     */
+    virtual std::size_t inputSize() const noexcept = 0;
+
+    /**
+     * @brief Get the output size, i.e. the size of the targets.
+     * 
+     * @return The output size.
+     */
+    virtual std::size_t outputSize() const noexcept = 0;
+
+    /**
+     * @brief Load a sample.
+     * 
+     * @param[in] index Index of the sample. Must be less than the sample count.
+     * @param[out] input Input to load the sample into, shape (input size, input size).
+     * @param[out] target Target to load the sample into, shape (output size).
+     */
+    virtual void load(std::size_t index, Tensor& input, Tensor& target) const noexcept = 0;
+};
+} // namespace ml::dataset
@@ -0,0 +1,132 @@
+/**
+ * @brief Memory-mapped dataset of unsigned byte images and labels.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "ml/dataset/format.h"
+#include "ml/dataset/interface.h"
+#include "ml/memory/mapped_file.h"
+#include "ml/tensor.h"
+#include "ml/types.h"
+
+namespace ml::dataset
+{
+/**
+ * @brief Memory-mapped dataset of unsigned byte images and labels, such as MNIST.
+ * 
+ *        The image and label files are memory-mapped and never parsed up front: each sample
+ *        is decoded when loaded, whereby the pixels are normalized to the range [0, 1] and
+ *        the label is one-hot encoded. The dataset therefore only costs the page cache of the
+ *        samples read, i.e. one byte per pixel, regardless of the scalar type.
+ * 
+ *        Two formats are supported:
+ * 
+ *        - IDX: an image file with dimensions (sample count, rows, columns) and a label file
+ *          with dimension (sample count), both with unsigned byte data, as the MNIST files.
+ *        - Raw: an image file holding the square images back to back and a label file
+ *          holding one byte per sample, without headers. The image size is derived from the
+ *          file sizes.
+ * 
+ *        The files must not be modified while the dataset exists.
+ * 
+ *        This class is non-copyable and non-movable.
+ */
+class MappedDataset final : public Interface
+{
+public:
+    /**
+     * @brief Create a new dataset.
+     * 
+     * @param[in] imagePath Path to the image file.
+     * @param[in] labelPath Path to the label file.
+     * @param[in] classCount Number of classes, i.e. the output size.
+     * @param[in] format File format (default = IDX).
+     * 
+     * @throw std::runtime_error If the files cannot be mapped or are invalid, the images
+     *                           aren't square or a label exceeds the class count.
+     */
+    explicit MappedDataset(const std::string& imagePath, const std::string& labelPath,
+                           std::size_t classCount, Format format = Format::Idx);
+
+    /**
+     * @brief Get the number of samples in the dataset.
+     * 
+     * @return The number of samples.
+     */
+    std::size_t sampleCount() const noexcept override { return mySampleCount; }
+
+    /**
+     * @brief Get the input size, i.e. the height and width of the square images.
+     * 
+     * @return The input size.
+     */
+    std::size_t inputSize() const noexcept override { return myInputSize; }
+
+    /**
+     * @brief Get the output size, i.e. the number of classes.
+     * 
+     * @return The output size.
+     */
+    std::size_t outputSize() const noexcept override { return myOutputSize; }
+
+    /**
+     * @brief Get the file format of the dataset.
+     * 
+     * @return The file format.
+     */
+    Format format() const noexcept { return myFormat; }
+
+    /**
+     * @brief Get the label of a sample.
+     * 
+     * @param[in] index Index of the sample. Must be less than the sample count.
+     * 
+     * @return The label, i.e. the class of the sample.
+     */
+    std::size_t label(const std::size_t index) const noexcept { return myLabels[index]; }
+
+    /**
+     * @brief Load a sample.
+     * 
+     * @param[in] index Index of the sample. Must be less than the sample count.
+     * @param[out] input Input to load the normalized image into, shape (input size, 
+     *                   input size).
+     * @param[out] target Target to load the one-hot encoded label into, shape (output size).
+     */
+    void load(std::size_t index, Tensor& input, Tensor& target) const noexcept override;
+
+    MappedDataset()                                = delete; // No default constructor.
+    MappedDataset(const MappedDataset&)            = delete; // No copy constructor.
+    MappedDataset(MappedDataset&&)                 = delete; // No move constructor.
+    MappedDataset& operator=(const MappedDataset&) = delete; // No copy assignment.
+    MappedDataset& operator=(MappedDataset&&)      = delete; // No move assignment.
+
+private:
+    /** Mapped image file. */
+    memory::MappedFile myImageFile;
+
+    /** Mapped label file. */
+    memory::MappedFile myLabelFile;
+
+    /** Pointer to the first image in the image file. */
+    const std::uint8_t* myImages;
+
+    /** Pointer to the first label in the label file. */
+    const std::uint8_t* myLabels;
+
+    /** Number of samples. */
+    std::size_t mySampleCount;
+
+    /** Input size, i.e. the height and width of the images. */
+    std::size_t myInputSize;
+
+    /** Output size, i.e. the number of classes. */
+    std::size_t myOutputSize;
+
+    /** File format. */
+    Format myFormat;
+};
+} // namespace ml::dataset
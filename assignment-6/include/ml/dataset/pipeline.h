@@ -0,0 +1,207 @@
+/**
+ * @brief Background input pipeline.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "ml/dataset/augmentation.h"
+#include "ml/dataset/interface.h"
+#include "ml/tensor.h"
+#include "ml/types.h"
+
+namespace ml::dataset
+{
+/**
+ * @brief Waiting statistics of an input pipeline.
+ */
+struct PipelineStats
+{
+    /** Number of batches handed to the trainer. */
+    std::size_t batchCount;
+
+    /** Number of batches the trainer had to wait for, i.e. that weren't prefetched in time. */
+    std::size_t stallCount;
+
+    /** Total time the trainer spent waiting for batches in seconds. */
+    double stallSeconds;
+
+    /** Number of times a worker had to wait for a free buffer, i.e. was ahead of training. */
+    std::size_t workerWaitCount;
+};
+
+/**
+ * @brief Background input pipeline.
+ *
+ *        Worker threads prepare the batches of every epoch ahead of training: they shuffle
+ *        the sample order at the start of each epoch, load the samples of a batch from the
+ *        dataset, augment them and pack them into one of a few contiguous batch buffers. The
+ *        buffers form a bounded ring, which is handed between the workers and the trainer
+ *        via a sequence number per buffer, without locks. Only claiming the next batch, and
+ *        thereby its sample indices, takes a short lock.
+ *
+ *        The batches only depend on the random seed at construction, not on the number of
+ *        workers or their timing, so the results are deterministic for a fixed random seed.
+ *
+ *        This class is non-copyable and non-movable.
+ */
+class Pipeline final
+{
+public:
+    /**
+     * @brief Create a new pipeline and start prefetching.
+     *
+     * @param[in] dataset Dataset to read. Must outlive the pipeline.
+     * @param[in] batchSize Number of samples per batch. Must be greater than 0.
+     * @param[in] epochCount Number of epochs. Must be greater than 0.
+     * @param[in] workerCount Number of worker threads (default = 1).
+     * @param[in] bufferCount Number of batch buffers, i.e. double or triple buffering
+     *                        (default = 3).
+     * @param[in] augmentation Random augmentation of the samples (default = none).
+     *
+     * @throw std::invalid_argument If the dataset is empty, the batch size, the epoch count
+     *                              or the worker count is 0, or the buffer count is less
+     *                              than 2.
+     */
+    explicit Pipeline(const Interface& dataset, std::size_t batchSize, std::size_t epochCount,
+                      std::size_t workerCount = 1U, std::size_t bufferCount = 3U,
+                      const Augmentation& augmentation = Augmentation{});
+
+    /**
+     * @brief Stop the workers.
+     */
+    ~Pipeline() noexcept;
+
+    /**
+     * @brief Get the dataset read by the pipeline.
+     *
+     * @return Reference to the dataset.
+     */
+    const Interface& dataset() const noexcept { return myDataset; }
+
+    /**
+     * @brief Get the number of samples per batch.
+     *
+     * @return The batch size.
+     */
+    std::size_t batchSize() const noexcept { return myBatchSize; }
+
+    /**
+     * @brief Get the number of epochs.
+     *
+     * @return The epoch count.
+     */
+    std::size_t epochCount() const noexcept { return myEpochCount; }
+
+    /**
+     * @brief Get the total number of batches over all epochs.
+     *
+     * @return The batch count.
+     */
+    std::size_t batchCount() const noexcept { return myBatchCount; }
+
+    /**
+     * @brief Get the next batch.
+     *
+     *        The batch of the previous call is released, i.e. its buffer is handed back to
+     *        the workers. Must only be called from one thread.
+     *
+     * @param[out] inputs View of the inputs of the batch, shape (sample count, input size,
+     *                    input size). Valid until the next call.
+     * @param[out] targets View of the targets of the batch, shape (sample count, output
+     *                     size). Valid until the next call.
+     *
+     * @return True if a batch was retrieved, false if every batch has been retrieved.
+     */
+    bool next(Tensor& inputs, Tensor& targets) noexcept;
+
+    /**
+     * @brief Get the waiting statistics of the pipeline.
+     *
+     * @return The waiting statistics.
+     */
+    PipelineStats stats() const noexcept;
+
+    Pipeline()                           = delete; // No default constructor.
+    Pipeline(const Pipeline&)            = delete; // No copy constructor.
+    Pipeline(Pipeline&&)                 = delete; // No move constructor.
+    Pipeline& operator=(const Pipeline&) = delete; // No copy assignment.
+    Pipeline& operator=(Pipeline&&)      = delete; // No move assignment.
+
+private:
+    struct Slot;
+
+    std::size_t claim(std::vector<std::size_t>& indices);
+    void runWorker() noexcept;
+    void augment(const Tensor& sample, Tensor& input, std::mt19937& generator) const noexcept;
+
+    /** Dataset to read. */
+    const Interface& myDataset;
+
+    /** Number of samples per batch. */
+    const std::size_t myBatchSize;
+
+    /** Number of epochs. */
+    const std::size_t myEpochCount;
+
+    /** Number of batches per epoch. */
+    const std::size_t myEpochBatchCount;
+
+    /** Total number of batches. */
+    const std::size_t myBatchCount;
+
+    /** Random augmentation of the samples. */
+    const Augmentation myAugmentation;
+
+    /** Seed of the random augmentation, combined with the batch number. */
+    const std::uint32_t mySeed;
+
+    /** Ring of batch buffers. */
+    std::vector<std::unique_ptr<Slot>> mySlots;
+
+    /** Sample order of the current epoch. */
+    TrainOrderList myOrder;
+
+    /** Generator shuffling the sample order. */
+    std::mt19937 myOrderGenerator;
+
+    /** Number of the next batch to claim by a worker. */
+    std::size_t myNextClaim;
+
+    /** Mutex protecting the sample order and the next batch to claim. */
+    std::mutex myClaimMutex;
+
+    /** Number of the next batch to retrieve by the trainer. */
+    std::size_t myNextBatch;
+
+    /** Number of batches the trainer had to wait for. */
+    std::size_t myStallCount;
+
+    /** Total time the trainer spent waiting in seconds. */
+    double myStallSeconds;
+
+    /** Number of times a worker had to wait for a free buffer. */
+    std::atomic<std::size_t> myWorkerWaitCount;
+
+    /** Indicate whether the workers shall stop. */
+    std::atomic<bool> myStopped;
+
+    /** Worker threads. */
+    std::vector<std::thread> myWorkers;
+};
+
+/**
+ * @brief Print given pipeline statistics.
+ *
+ * @param[in] stats The statistics to print.
+ * @param[in] ostream Output stream (default = terminal print).
+ */
+void printStats(const PipelineStats& stats, std::ostream& ostream = std::cout) noexcept;
+} // namespace ml::dataset
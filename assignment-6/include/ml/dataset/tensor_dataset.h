@@ -0,0 +1,83 @@
+/**
+ * @brief Dataset of tensors held in memory.
+ */
+#pragma once
+
+#include "ml/dataset/interface.h"
+#include "ml/tensor.h"
+#include "ml/types.h"
+
+namespace ml::dataset
+{
+/**
+ * @brief Dataset of tensors held in memory.
+ * 
+ *        The dataset holds views of the given tensors, which must outlive the dataset.
+ */
+class TensorDataset final : public Interface
+{
+public:
+    /**
+     * @brief Create a new dataset.
+     * 
+     *        If the tensors don't have the shapes below, the input size is set to 0, which
+     *        lets training fail with an error message.
+     * 
+     * @param[in] inputs Input sets, shape (set count, input size, input size).
+     * @param[in] targets Target sets, shape (set count, output size).
+     */
+    explicit TensorDataset(const Tensor& inputs, const Tensor& targets) noexcept;
+
+    /**
+     * @brief Get the number of samples in the dataset.
+     * 
+     * @return The number of samples.
+     */
+    std::size_t sampleCount() const noexcept override { return mySampleCount; }
+
+    /**
+     * @brief Get the input size, i.e. the height and width of the square inputs.
+     * 
+     * @return The input size, 0 if the inputs aren't square.
+     */
+    std::size_t inputSize() const noexcept override { return myInputSize; }
+
+    /**
+     * @brief Get the output size, i.e. the size of the targets.
+     * 
+     * @return The output size.
+     */
+    std::size_t outputSize() const noexcept override { return myOutputSize; }
+
+    /**
+     * @brief Load a sample.
+     * 
+     * @param[in] index Index of the sample. Must be less than the sample count.
+     * @param[out] input Input to load the sample into, shape (input size, input size).
+     * @param[out] target Target to load the sample into, shape (output size).
+     */
+    void load(std::size_t index, Tensor& input, Tensor& target) const noexcept override;
+
+    TensorDataset()                                = delete; // No default constructor.
+    TensorDataset(const TensorDataset&)            = delete; // No copy constructor.
+    TensorDataset(TensorDataset&&)                 = delete; // No move constructor.
+    TensorDataset& operator=(const TensorDataset&) = delete; // No copy assignment.
+    TensorDataset& operator=(TensorDataset&&)      = delete; // No move assignment.
+
+private:
+    /** Input sets (view). */
+    const Tensor myInputs;
+
+    /** Target sets (view). */
+    const Tensor myTargets;
+
+    /** Number of samples. */
+    const std::size_t mySampleCount;
+
+    /** Input size. */
+    const std::size_t myInputSize;
+
+    /** Output size. */
+    const std::size_t myOutputSize;
+};
+} // namespace ml::dataset
@@ -3,8 +3,12 @@
  */
 #pragma once
 
+#include "ml/act_func/kernel.h"
 #include "ml/act_func/type.h"
 #include "ml/dense_layer/interface.h"
+#include "ml/memory/buffer.h"
+#include "ml/parameter_mode.h"
+#include "ml/tensor.h"
 #include "ml/types.h"
 
 namespace ml::dense_layer
@@ -12,6 +16,9 @@ namespace ml::dense_layer
 /**
  * @brief Dense layer implementation.
  * 
+ *        Single samples are processed via matrix-vector operations, while batches are 
+ *        processed via matrix-matrix operations (GEMM) with one weight update per batch.
+ * 
  *        This class is non-copyable and non-movable.
  */
 class Dense final : public Interface
@@ -23,9 +30,12 @@ public:
      * @param[in] inputSize Input size.
      * @param[in] outputSize Output size.
      * @param[in] actFunc Activation function to use for this layer (default = ReLU).
+     * @param[in] mode Parameter mode (default = owned). In external mode the weights and the
+     *                 bias must be supplied via useParameters() or shareParameters() before use.
      */
     explicit Dense(std::size_t inputSize, std::size_t outputSize, 
-                   act_func::Type actFunc = act_func::Type::Relu);
+                   act_func::Type actFunc = act_func::Type::Relu,
+                   ParameterMode mode = ParameterMode::Owned);
 
     /**
      * @brief Destructor.
@@ -49,44 +59,129 @@ public:
     /**
      * @brief Get the output values of the layer.
      * 
-     * @return Matrix holding the output values of the layer.
+     * @return Tensor holding the output values of the layer.
      */
-    const Matrix1d& output() const noexcept override;
+    const Tensor& output() const noexcept override;
 
     /**
      * @brief Get the input gradients of the layer.
      * 
-     * @return Matrix holding the input gradients of the layer.
+     * @return Tensor holding the input gradients of the layer.
+     */
+    const Tensor& inputGradients() const noexcept override;
+
+    /**
+     * @brief Get the activation function of the layer.
+     * 
+     * @return The activation function type.
+     */
+    act_func::Type actFunc() const noexcept override;
+
+    /**
+     * @brief Get the trainable parameters of the layer.
+     * 
+     * @return List of views of the weights (without row padding) and the bias values.
+     */
+    TensorList parameters() override;
+
+    /**
+     * @brief Get the gradients of the trainable parameters of the layer.
+     * 
+     *        The gradients are allocated on the first call.
+     * 
+     * @return List of views of the weight gradients (without row padding) and the bias 
+     *         gradients.
+     */
+    TensorList gradients() override;
+
+    /**
+     * @brief Share the trainable parameters of given layer.
+     * 
+     * @param[in] source Layer of the same type and size, must outlive this layer.
+     * 
+     * @return True on success, false if the layers don't match.
+     */
+    bool shareParameters(Interface& source) noexcept override;
+
+    /**
+     * @brief Use given tensors as the trainable parameters of the layer.
+     * 
+     * @param[in] parameters Tensors shaped and strided like the views returned by
+     *                       parameters(), in the same order. Must outlive this layer.
+     * 
+     * @return True on success, false if the tensors don't match the parameters.
+     */
+    bool useParameters(TensorList& parameters) noexcept override;
+
+    /**
+     * @brief Get the maximum number of samples per batch.
+     * 
+     * @return The maximum batch size.
      */
-    const Matrix1d& inputGradients() const noexcept override;
+    std::size_t maxBatchSize() const noexcept override;
+
+    /**
+     * @brief Set the maximum number of samples per batch.
+     * 
+     * @param[in] batchSize The maximum batch size. Must be greater than 0.
+     * 
+     * @throw std::invalid_argument If the batch size is 0.
+     */
+    void setMaxBatchSize(std::size_t batchSize) override;
+
+    /**
+     * @brief Get the batch buffers of the layer, for memory planning.
+     * 
+     * @return List of the batch buffers, valid as long as the layer.
+     */
+    memory::BufferList buffers() noexcept override;
 
     /**
      * @brief Perform feedforward operation.
      * 
-     * @param[in] input Matrix holding input data.
+     * @param[in] input Tensor holding a single input sample or a batch of samples.
      * 
      * @return True on success, false on failure.
      */
-    bool feedforward(const Matrix1d& input) noexcept override;
+    bool feedforward(const Tensor& input) noexcept override;
 
     /**
      * @brief Perform backpropagation.
      * 
-     * @param[in] outputGradients Matrix holding gradients from the next layer.
+     * @param[in] outputGradients Tensor holding gradients from the next layer, i.e. the
+     *                            negated loss derivatives with respect to the output.
      * 
      * @return True on success, false on failure.
      */
-    bool backpropagate(const Matrix1d& outputGradients) noexcept override;
+    bool backpropagate(const Tensor& outputGradients) noexcept override;
 
     /**
      * @brief Perform optimization.
      * 
-     * @param[in] input Matrix holding input data.
+     * @param[in] input Tensor holding the input data of the latest feedforward.
+     * @param[in] learningRate Learning rate to use.
+     * 
+     * @return True on success, false on failure.
+     */
+    bool optimize(const Tensor& input, double learningRate) noexcept override;
+
+    /**
+     * @brief Compute the parameter gradients of the latest batch, averaged over the batch.
+     * 
+     * @param[in] input Tensor holding the input data of the latest feedforward.
+     * 
+     * @return True on success, false on failure.
+     */
+    bool computeGradients(const Tensor& input) noexcept override;
+
+    /**
+     * @brief Adjust the parameters with the current gradients.
+     * 
      * @param[in] learningRate Learning rate to use.
      * 
      * @return True on success, false on failure.
      */
-    bool optimize(const Matrix1d& input, double learningRate) noexcept override;
+    bool applyGradients(double learningRate) noexcept override;
 
     Dense()                        = delete; // No default constructor.
     Dense(const Dense&)            = delete; // No copy constructor.
@@ -95,25 +190,47 @@ public:
     Dense& operator=(Dense&&)      = delete; // No move assignment.
 
 private:
+    bool hasGradients() const noexcept;
+    bool checkGradients(const char* opName) const noexcept;
     void checkParameters(std::size_t inputSize, std::size_t outputSize);
-    void initialize(std::size_t inputSize, std::size_t outputSize, act_func::Type actFunc);
+    void updateWeights(const Tensor& input, Scalar alpha, bool accumulate, Tensor& weights,
+                       std::size_t first, std::size_t last) noexcept;
+    void initialize(std::size_t inputSize, std::size_t outputSize, ParameterMode mode);
+
+    /** Input gradient batch, shape (max batch size, input size). */
+    Tensor myInputGradientBatch;
 
-    /** Input gradients. */
-    Matrix1d myInputGradients;
+    /** View of the input gradients of the latest batch. */
+    Tensor myInputGradients;
 
     /** Bias values. */
-    Matrix1d myBias;
+    Tensor myBias;
+
+    /** Weights for each node, each row padded to a multiple of 64 bytes. */
+    Tensor myWeights;
+
+    /** Bias gradients (allocated by gradients()). */
+    Tensor myBiasGradients;
+
+    /** Weight gradients, padded like the weights (allocated by gradients()). */
+    Tensor myWeightGradients;
+
+    /** Output batch, shape (max batch size, output size). */
+    Tensor myOutputBatch;
+
+    /** View of the output of the latest batch. */
+    Tensor myOutput;
 
-    /** Weights for each node. */
-    Matrix2d myWeights;
+    /** Error batch, shape (max batch size, output size). */
+    Tensor myErrorBatch;
 
-    /** Output matrix. */
-    Matrix1d myOutput;
+    /** Weighted sums of a batch, shape (output size, max batch size), i.e. transposed. */
+    Tensor mySumBatch;
 
-    /** Error values. */
-    Matrix1d myError;
+    /** Number of samples in the latest batch. */
+    std::size_t myBatchSize;
 
-    /** Activation function. */
-    ActFuncPtr myActFunc;
+    /** Activation function kernels. */
+    act_func::Kernel myActFunc;
 };
 } // namespace ml::dense_layer
\ No newline at end of file
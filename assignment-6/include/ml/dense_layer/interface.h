@@ -3,12 +3,19 @@
  */
 #pragma once
 
+#include "ml/act_func/type.h"
+#include "ml/memory/buffer.h"
+#include "ml/tensor.h"
 #include "ml/types.h"
 
 namespace ml::dense_layer
 {
 /**
  * @brief Dense layer interface.
+ *
+ *        Layers process either a single sample or a batch of samples stacked along the first
+ *        dimension, up to the max batch size (1 by default). The output and the gradients
+ *        are shaped like the latest input, i.e. with or without the batch dimension.
  */
 class Interface
 {
@@ -35,43 +42,151 @@ public:
     /**
      * @brief Get the output values of the layer.
      * 
-     * @return Matrix holding the output values of the layer.
+     * @return Tensor holding the output values of the layer.
      */
-    virtual const Matrix1d& output() const noexcept = 0;
+    virtual const Tensor& output() const noexcept = 0;
 
     /**
      * @brief Get the input gradients of the layer.
      * 
-     * @return Matrix holding the input gradients of the layer.
+     * @return Tensor holding the input gradients of the layer.
      */
-    virtual const Matrix1d& inputGradients() const noexcept = 0;
+    virtual const Tensor& inputGradients() const noexcept = 0;
+
+    /**
+     * @brief Get the activation function of the layer.
+     * 
+     * @return The activation function type.
+     */
+    virtual act_func::Type actFunc() const noexcept = 0;
+
+    /**
+     * @brief Get the trainable parameters of the layer.
+     * 
+     *        The list holds the weights, shape (output size, input size), followed by the bias
+     *        values, shape (output size).
+     * 
+     * @return List of views of the parameters, valid as long as the layer.
+     */
+    virtual TensorList parameters() = 0;
+
+    /**
+     * @brief Get the gradients of the trainable parameters of the layer.
+     * 
+     *        The gradients are computed by computeGradients() and applied by 
+     *        applyGradients(). They may be modified in between, e.g. to combine the 
+     *        gradients of several layers. The gradients may be allocated on the first call,
+     *        so this method must be called before computing or applying gradients.
+     * 
+     * @return List of views of the gradients, in the same order and with the same shapes as
+     *         the parameters.
+     */
+    virtual TensorList gradients() = 0;
+
+    /**
+     * @brief Share the trainable parameters of given layer.
+     * 
+     *        This layer stops using its own parameters and instead reads and updates the
+     *        parameters of the source layer, e.g. for lock-free asynchronous training.
+     * 
+     * @param[in] source Layer of the same type and size, must outlive this layer.
+     * 
+     * @return True on success, false if the layers don't match.
+     */
+    virtual bool shareParameters(Interface& source) noexcept = 0;
+
+    /**
+     * @brief Use given tensors as the trainable parameters of the layer.
+     * 
+     *        This layer stops using its own parameters and instead reads and updates the
+     *        given memory, e.g. a memory-mapped model file (see ml/cnn/model_file.h).
+     * 
+     * @param[in] parameters Tensors shaped and strided like the views returned by
+     *                       parameters(), in the same order. Must outlive this layer.
+     * 
+     * @return True on success, false if the tensors don't match the parameters.
+     */
+    virtual bool useParameters(TensorList& parameters) noexcept = 0;
+
+    /**
+     * @brief Get the maximum number of samples per batch.
+     * 
+     * @return The maximum batch size.
+     */
+    virtual std::size_t maxBatchSize() const noexcept = 0;
+
+    /**
+     * @brief Set the maximum number of samples per batch.
+     * 
+     *        The batch buffers are reallocated, i.e. the current output and gradients are lost.
+     * 
+     * @param[in] batchSize The maximum batch size. Must be greater than 0.
+     * 
+     * @throw std::invalid_argument If the batch size is 0.
+     */
+    virtual void setMaxBatchSize(std::size_t batchSize) = 0;
+
+    /**
+     * @brief Get the batch buffers of the layer, for memory planning.
+     * 
+     *        The owner of the layer may replace each buffer with a view of the same shape into
+     *        memory it owns, so that buffers that are never live at the same time can share
+     *        memory (see ml/memory/planner.h). The view of the latest batch is then reset to
+     *        the first sample, and the content of the buffers is lost. The buffers must be
+     *        collected again after each call to setMaxBatchSize.
+     * 
+     * @return List of the batch buffers, valid as long as the layer.
+     */
+    virtual memory::BufferList buffers() noexcept = 0;
 
     /**
      * @brief Perform feedforward operation.
      * 
-     * @param[in] input Matrix holding input data.
+     * @param[in] input Tensor holding a single input sample or a batch of samples.
      * 
      * @return True on success, false on failure.
      */
-    virtual bool feedforward(const Matrix1d& input) noexcept = 0;
+    virtual bool feedforward(const Tensor& input) noexcept = 0;
 
     /**
      * @brief Perform backpropagation.
      * 
-     * @param[in] outputGradients Matrix holding gradients from the next layer.
+     * @param[in] outputGradients Tensor holding gradients from the next layer.
      * 
      * @return True on success, false on failure.
      */
-    virtual bool backpropagate(const Matrix1d& outputGradients) noexcept = 0;
+    virtual bool backpropagate(const Tensor& outputGradients) noexcept = 0;
 
     /**
      * @brief Perform optimization.
      * 
-     * @param[in] input Matrix holding input data.
+     * @param[in] input Tensor holding input data.
+     * @param[in] learningRate Learning rate to use.
+     * 
+     * @return True on success, false on failure.
+     */
+    virtual bool optimize(const Tensor& input, double learningRate) noexcept = 0;
+
+    /**
+     * @brief Compute the parameter gradients of the latest batch, averaged over the batch.
+     * 
+     *        This is the first half of optimize(), which leaves the parameters unchanged.
+     * 
+     * @param[in] input Tensor holding the input data of the latest feedforward.
+     * 
+     * @return True on success, false on failure.
+     */
+    virtual bool computeGradients(const Tensor& input) noexcept = 0;
+
+    /**
+     * @brief Adjust the parameters with the current gradients.
+     * 
+     *        This is the second half of optimize().
+     * 
      * @param[in] learningRate Learning rate to use.
      * 
      * @return True on success, false on failure.
      */
-    virtual bool optimize(const Matrix1d& input, double learningRate) noexcept = 0;
+    virtual bool applyGradients(double learningRate) noexcept = 0;
 };
 } // namespace ml::dense_layer
\ No newline at end of file
@@ -7,6 +7,8 @@
 
 #include "ml/act_func/type.h"
 #include "ml/dense_layer/interface.h"
+#include "ml/memory/buffer.h"
+#include "ml/tensor.h"
 #include "ml/types.h"
 #include "ml/utils.h"
 
@@ -29,11 +31,15 @@ public:
      */
     explicit Stub(const std::size_t inputSize, const std::size_t outputSize, 
                    const act_func::Type actFunc = act_func::Type::Relu)
-        : myInputGradients{}
+        : myInputGradientBatch{}
+        , myInputGradients{}
         , myBias{}
         , myWeights{}
+        , myBiasGradients{}
+        , myWeightGradients{}
+        , myOutputBatch{}
         , myOutput{}
-        , myError{}
+        , myActFunc{actFunc}
     {
         // Throw exception if node count or the weight count is 0.
         if (0U == outputSize)
@@ -46,14 +52,11 @@ public:
         }
 
         // Initialize the matrices.
-        initMatrix(myInputGradients, inputSize);
-        initMatrix(myBias, outputSize);
-        initMatrix(myWeights, outputSize, inputSize);
-        initMatrix(myOutput, outputSize);
-        initMatrix(myError, outputSize);
-
-        // Ignore activation function in this implementation.
-        (void) (actFunc);
+        myBias            = Tensor{outputSize};
+        myWeights         = Tensor{outputSize, inputSize};
+        myBiasGradients   = Tensor{outputSize};
+        myWeightGradients = Tensor{outputSize, inputSize};
+        setMaxBatchSize(1U);
     }
 
     /**
@@ -68,7 +71,7 @@ public:
      */
     std::size_t inputSize() const noexcept override 
     {
-        return myWeights.empty() ? 0U : myWeights[0U].size(); 
+        return myWeights.dim(1U); 
     }
 
     /**
@@ -76,66 +79,206 @@ public:
      * 
      * @return The output size of the layer.
      */
-    std::size_t outputSize() const noexcept override { return myOutput.size(); }
+    std::size_t outputSize() const noexcept override { return myWeights.dim(0U); }
 
     /**
      * @brief Get the output values of the layer.
      * 
-     * @return Matrix holding the output values of the layer.
+     * @return Tensor holding the output values of the layer.
      */
-    const Matrix1d& output() const noexcept override { return myOutput; }
+    const Tensor& output() const noexcept override { return myOutput; }
 
     /**
      * @brief Get the input gradients of the layer.
      * 
-     * @return Matrix holding the input gradients of the layer.
+     * @return Tensor holding the input gradients of the layer.
      */
-    const Matrix1d& inputGradients() const noexcept override { return myInputGradients; }
+    const Tensor& inputGradients() const noexcept override { return myInputGradients; }
+
+    /**
+     * @brief Get the activation function of the layer.
+     * 
+     * @return The activation function type.
+     */
+    act_func::Type actFunc() const noexcept override { return myActFunc; }
+
+    /**
+     * @brief Get the trainable parameters of the layer.
+     * 
+     * @return List of views of the weights and the bias values.
+     */
+    TensorList parameters() override
+    {
+        TensorList parameters{};
+        parameters.push_back(myWeights.view());
+        parameters.push_back(myBias.view());
+        return parameters;
+    }
+
+    /**
+     * @brief Get the gradients of the trainable parameters of the layer.
+     * 
+     * @return List of views of the weight gradients and the bias gradients.
+     */
+    TensorList gradients() override
+    {
+        TensorList gradients{};
+        gradients.push_back(myWeightGradients.view());
+        gradients.push_back(myBiasGradients.view());
+        return gradients;
+    }
+
+    /**
+     * @brief Share the trainable parameters of given layer.
+     * 
+     * @param[in] source Layer of the same type and size, must outlive this layer.
+     * 
+     * @return True on success, false if the layers don't match.
+     */
+    bool shareParameters(Interface& source) noexcept override
+    {
+        // Return false unless the source is a dense stub of the same size.
+        auto* const layer{dynamic_cast<Stub*>(&source)};
+        if ((nullptr == layer) || !myWeights.sameShape(layer->myWeights)) { return false; }
+
+        // Use views of the parameters of the source.
+        myWeights = layer->myWeights.view();
+        myBias    = layer->myBias.view();
+        return true;
+    }
+
+    /**
+     * @brief Use given tensors as the trainable parameters of the layer.
+     * 
+     * @param[in] parameters Tensors shaped like the views returned by parameters(), in the
+     *                       same order. Must outlive this layer.
+     * 
+     * @return True on success, false if the tensors don't match the parameters.
+     */
+    bool useParameters(TensorList& parameters) noexcept override
+    {
+        // Return false unless the tensors are weights and biases of the same size.
+        if ((2U != parameters.size()) || !parameters[0U].sameShape(myWeights)
+            || !parameters[1U].sameShape(myBias)) { return false; }
+
+        // Use views of the tensors.
+        myWeights = parameters[0U].view();
+        myBias    = parameters[1U].view();
+        return true;
+    }
+
+    /**
+     * @brief Get the maximum number of samples per batch.
+     * 
+     * @return The maximum batch size.
+     */
+    std::size_t maxBatchSize() const noexcept override { return myOutputBatch.dim(0U); }
+
+    /**
+     * @brief Set the maximum number of samples per batch.
+     * 
+     * @param[in] batchSize The maximum batch size. Must be greater than 0.
+     * 
+     * @throw std::invalid_argument If the batch size is 0.
+     */
+    void setMaxBatchSize(const std::size_t batchSize) override
+    {
+        // Throw an exception if the batch size is invalid.
+        if (0U == batchSize) { throw std::invalid_argument("Batch size cannot be 0!"); }
+
+        // Reallocate the batch matrices, let the views refer to the first sample.
+        myInputGradientBatch = Tensor{batchSize, inputSize()};
+        myOutputBatch        = Tensor{batchSize, outputSize()};
+        myInputGradients     = myInputGradientBatch.slice(0U);
+        myOutput             = myOutputBatch.slice(0U);
+    }
+
+    /**
+     * @brief Get the batch buffers of the layer, for memory planning.
+     * 
+     * @return Empty list, the stub keeps its own buffers.
+     */
+    memory::BufferList buffers() noexcept override { return memory::BufferList{}; }
 
     /**
      * @brief Perform feedforward operation.
      * 
-     * @param[in] input Matrix holding input data.
+     * @param[in] input Tensor holding input data.
      * 
      * @return True on success, false on failure.
      */
-    bool feedforward(const Matrix1d& input) noexcept override
+    bool feedforward(const Tensor& input) noexcept override
     {
-        // Return true if the input dimensions match match.
+        // Return true if the input dimensions match.
         constexpr const char* opName{"feedforward in dense layer"};
-        return matchDimensions(inputSize(), input.size(), opName);
+        const std::size_t sampleCount{batchSize(input, myInputGradientBatch, opName)};
+        if (0U == sampleCount) { return false; }
+
+        // Let the views match the layout of the input.
+        const bool batched{input.rank() == myInputGradientBatch.rank()};
+        myOutput         = batchView(myOutputBatch, sampleCount, batched);
+        myInputGradients = batchView(myInputGradientBatch, sampleCount, batched);
+        return true;
     }
 
     /**
      * @brief Perform backpropagation.
      * 
-     * @param[in] outputGradients Matrix holding gradients from the next layer.
+     * @param[in] outputGradients Tensor holding gradients from the next layer.
      * 
      * @return True on success, false on failure.
      */
-    bool backpropagate(const Matrix1d& outputGradients) noexcept override
+    bool backpropagate(const Tensor& outputGradients) noexcept override
     {
         // Return false if the output dimensions don't match.
         constexpr const char* opName{"backpropagation in output dense layer"};
-        return matchDimensions(outputSize(), outputGradients.size(), opName);
+        return 0U != batchSize(outputGradients, myOutputBatch, opName);
     }
 
     /**
      * @brief Perform optimization.
      * 
-     * @param[in] input Matrix holding input data.
+     * @param[in] input Tensor holding input data.
      * @param[in] learningRate Learning rate to use.
      * 
      * @return True on success, false on failure.
      */
-    bool optimize(const Matrix1d& input, const double learningRate) noexcept override
+    bool optimize(const Tensor& input, const double learningRate) noexcept override
     {
         // Return true if the input dimensions match and the learning rate is valid.
         constexpr const char* opName{"optimization in dense layer"};
-        return matchDimensions(inputSize(), input.size(), opName) 
+        return (0U != batchSize(input, myInputGradientBatch, opName))
             && checkLearningRate(learningRate, opName);
     }
 
+    /**
+     * @brief Compute the parameter gradients of the latest batch.
+     * 
+     * @param[in] input Tensor holding input data.
+     * 
+     * @return True on success, false on failure.
+     */
+    bool computeGradients(const Tensor& input) noexcept override
+    {
+        // Return true if the input dimensions match.
+        constexpr const char* opName{"gradient computation in dense layer"};
+        return 0U != batchSize(input, myInputGradientBatch, opName);
+    }
+
+    /**
+     * @brief Adjust the parameters with the current gradients.
+     * 
+     * @param[in] learningRate Learning rate to use.
+     * 
+     * @return True on success, false on failure.
+     */
+    bool applyGradients(const double learningRate) noexcept override
+    {
+        // Return true if the learning rate is valid.
+        constexpr const char* opName{"optimization in dense layer"};
+        return checkLearningRate(learningRate, opName);
+    }
+
     Stub()                       = delete; // No default constructor.
     Stub(const Stub&)            = delete; // No copy constructor.
     Stub(Stub&&)                 = delete; // No move constructor.
@@ -143,19 +286,31 @@ public:
     Stub& operator=(Stub&&)      = delete; // No move assignment.
 
 private:
-    /** Input gradients. */
-    Matrix1d myInputGradients;
+    /** Input gradient batch. */
+    Tensor myInputGradientBatch;
+
+    /** View of the input gradients of the latest batch. */
+    Tensor myInputGradients;
 
     /** Bias values. */
-    Matrix1d myBias;
+    Tensor myBias;
 
     /** Weights for each node. */
-    Matrix2d myWeights;
+    Tensor myWeights;
+
+    /** Bias gradients. */
+    Tensor myBiasGradients;
+
+    /** Weight gradients. */
+    Tensor myWeightGradients;
+
+    /** Output batch. */
+    Tensor myOutputBatch;
 
-    /** Output matrix. */
-    Matrix1d myOutput;
+    /** View of the output of the latest batch. */
+    Tensor myOutput;
 
-    /** Error values. */
-    Matrix1d myError;
+    /** Activation function type. */
+    act_func::Type myActFunc;
 };
 } // namespace ml::dense_layer
\ No newline at end of file
@@ -40,11 +40,42 @@ public:
      * @param[in] inputSize Input size. Must be greater than 0.
      * @param[in] kernelSize Kernel size. Must be greater than 0 and smaller than the input size.
      * @param[in] actFunc Activation function to use.
+     * @param[in] algorithm Convolution algorithm to use.
+     * @param[in] mode Parameter mode, see ml::ParameterMode.
      * 
      * @return Pointer to the new convolutional layer.
      */
     ConvLayerPtr convLayer(std::size_t inputSize, std::size_t kernelSize, 
-                           act_func::Type actFunc) override;
+                           act_func::Type actFunc, conv_layer::algorithm::Type algorithm,
+                           ParameterMode mode) override;
+
+    /**
+     * @brief Create a multi-channel convolutional layer.
+     * 
+     * @param[in] inputChannels Number of input channels.
+     * @param[in] outputChannels Number of output channels (filters).
+     * @param[in] inputSize Input size. Must be greater than 0.
+     * @param[in] kernelSize Kernel size. Must be greater than 0 and smaller than the input size.
+     * @param[in] actFunc Activation function to use.
+     * @param[in] mode Parameter mode, see ml::ParameterMode.
+     * 
+     * @return Pointer to the new convolutional layer.
+     */
+    ConvLayerPtr multiChannelConvLayer(std::size_t inputChannels, std::size_t outputChannels,
+                                       std::size_t inputSize, std::size_t kernelSize,
+                                       act_func::Type actFunc, ParameterMode mode) override;
+
+    /**
+     * @brief Create a convolution algorithm.
+     * 
+     * @param[in] type The type of convolution algorithm to create.
+     * @param[in] inputSize Input size. Must be greater than 0.
+     * @param[in] kernelSize Kernel size. Must be greater than 0.
+     * 
+     * @return Pointer to the new convolution algorithm.
+     */
+    ConvAlgorithmPtr convAlgorithm(conv_layer::algorithm::Type type, std::size_t inputSize,
+                                   std::size_t kernelSize) override;
 
     /**
      * @brief Create a dense layer.
@@ -52,30 +83,34 @@ public:
      * @param[in] inputSize Input size. Must be greater than 0.
      * @param[in] outputSize Output size. Must be greater than 0.
      * @param[in] actFunc Activation function to use.
+     * @param[in] mode Parameter mode, see ml::ParameterMode.
      * 
      * @return Pointer to the new dense layer.
      */
     DenseLayerPtr denseLayer(std::size_t inputSize, std::size_t outputSize, 
-                             act_func::Type actFunc) override;
+                             act_func::Type actFunc, ParameterMode mode) override;
 
     /**
      * @brief Create a flatten layer.
      * 
      * @param[in] inputSize Input size. Must be greater than 0.
+     * @param[in] channelCount Number of input channels.
      * 
      * @return Pointer to the new flatten layer.
      */
-    FlattenLayerPtr flattenLayer(std::size_t inputSize) override;
+    FlattenLayerPtr flattenLayer(std::size_t inputSize, std::size_t channelCount) override;
 
     /**
      * @brief Create a max pooling layer.
      * 
      * @param[in] inputSize Input size. Must be greater than 0.
      * @param[in] poolSize Pool size. Must divide the input size.
+     * @param[in] channelCount Number of channels.
      * 
      * @return Pointer to the new max pooling layer.
      */
-    ConvLayerPtr maxPoolLayer(std::size_t inputSize, std::size_t poolSize) override;
+    ConvLayerPtr maxPoolLayer(std::size_t inputSize, std::size_t poolSize, 
+                              std::size_t channelCount) override;
 
     Factory(const Factory&)            = delete; // No copy constructor.
     Factory(Factory&&)                 = delete; // No move constructor.
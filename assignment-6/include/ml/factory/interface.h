@@ -5,9 +5,12 @@
 
 #include "ml/act_func/type.h"
 #include "ml/act_func/interface.h"
+#include "ml/conv_layer/algorithm/interface.h"
+#include "ml/conv_layer/algorithm/type.h"
 #include "ml/conv_layer/interface.h"
 #include "ml/dense_layer/interface.h"
 #include "ml/flatten_layer/interface.h"
+#include "ml/parameter_mode.h"
 #include "ml/types.h"
 
 namespace ml::factory
@@ -38,11 +41,44 @@ public:
      * @param[in] inputSize Input size. Must be greater than 0.
      * @param[in] kernelSize Kernel size. Must be greater than 0 and smaller than the input size.
      * @param[in] actFunc Activation function to use.
+     * @param[in] algorithm Convolution algorithm to use.
+     * @param[in] mode Parameter mode, see ml::ParameterMode.
      * 
      * @return Pointer to the new convolutional layer.
      */
     virtual ConvLayerPtr convLayer(std::size_t inputSize, std::size_t kernelSize, 
-                                   act_func::Type actFunc) = 0;
+                                   act_func::Type actFunc, 
+                                   conv_layer::algorithm::Type algorithm,
+                                   ParameterMode mode) = 0;
+
+    /**
+     * @brief Create a multi-channel convolutional layer.
+     * 
+     * @param[in] inputChannels Number of input channels.
+     * @param[in] outputChannels Number of output channels (filters).
+     * @param[in] inputSize Input size. Must be greater than 0.
+     * @param[in] kernelSize Kernel size. Must be greater than 0 and smaller than the input size.
+     * @param[in] actFunc Activation function to use.
+     * @param[in] mode Parameter mode, see ml::ParameterMode.
+     * 
+     * @return Pointer to the new convolutional layer.
+     */
+    virtual ConvLayerPtr multiChannelConvLayer(std::size_t inputChannels, 
+                                               std::size_t outputChannels, std::size_t inputSize,
+                                               std::size_t kernelSize, act_func::Type actFunc,
+                                               ParameterMode mode) = 0;
+
+    /**
+     * @brief Create a convolution algorithm.
+     * 
+     * @param[in] type The type of convolution algorithm to create.
+     * @param[in] inputSize Input size. Must be greater than 0.
+     * @param[in] kernelSize Kernel size. Must be greater than 0.
+     * 
+     * @return Pointer to the new convolution algorithm.
+     */
+    virtual ConvAlgorithmPtr convAlgorithm(conv_layer::algorithm::Type type, 
+                                           std::size_t inputSize, std::size_t kernelSize) = 0;
 
     /**
      * @brief Create a dense layer.
@@ -50,29 +86,33 @@ public:
      * @param[in] inputSize Input size. Must be greater than 0.
      * @param[in] outputSize Output size. Must be greater than 0.
      * @param[in] actFunc Activation function to use.
+     * @param[in] mode Parameter mode, see ml::ParameterMode.
      * 
      * @return Pointer to the new dense layer.
      */
     virtual DenseLayerPtr denseLayer(std::size_t inputSize, std::size_t outputSize, 
-                                     act_func::Type actFunc) = 0;
+                                     act_func::Type actFunc, ParameterMode mode) = 0;
 
     /**
      * @brief Create a flatten layer.
      * 
      * @param[in] inputSize Input size. Must be greater than 0.
+     * @param[in] channelCount Number of input channels.
      * 
      * @return Pointer to the new flatten layer.
      */
-    virtual FlattenLayerPtr flattenLayer(std::size_t inputSize) = 0;
+    virtual FlattenLayerPtr flattenLayer(std::size_t inputSize, std::size_t channelCount) = 0;
 
     /**
      * @brief Create a max pooling layer.
      * 
      * @param[in] inputSize Input size. Must be greater than 0.
      * @param[in] poolSize Pool size. Must divide the input size.
+     * @param[in] channelCount Number of channels.
      * 
      * @return Pointer to the new max pooling layer.
      */
-    virtual ConvLayerPtr maxPoolLayer(std::size_t inputSize, std::size_t poolSize) = 0;
+    virtual ConvLayerPtr maxPoolLayer(std::size_t inputSize, std::size_t poolSize, 
+                                      std::size_t channelCount) = 0;
 };
 } // namespace ml::factory
\ No newline at end of file
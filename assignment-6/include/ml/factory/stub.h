@@ -6,6 +6,7 @@
 #include <memory>
 
 #include "ml/act_func/none.h"
+#include "ml/conv_layer/algorithm/direct.h"
 #include "ml/conv_layer/stub.h"
 #include "ml/dense_layer/stub.h"
 #include "ml/factory/interface.h"
@@ -50,27 +51,76 @@ public:
      * @param[in] inputSize Input size. Must be greater than 0.
      * @param[in] kernelSize Kernel size. Must be greater than 0 and smaller than the input size.
      * @param[in] actFunc Activation function to use.
+     * @param[in] algorithm Convolution algorithm to use.
+     * @param[in] mode Parameter mode, see ml::ParameterMode.
      * 
      * @return Pointer to the new convolutional layer.
      */
     ConvLayerPtr convLayer(const std::size_t inputSize, const std::size_t kernelSize, 
-                           const act_func::Type actFunc) override
+                           const act_func::Type actFunc, 
+                           const conv_layer::algorithm::Type algorithm,
+                           const ParameterMode mode) override
     {
+        (void) (algorithm);
+        (void) (mode);
         return std::make_unique<conv_layer::ConvStub>(inputSize, kernelSize, actFunc);
     }
 
+    /**
+     * @brief Create a multi-channel convolutional layer.
+     * 
+     * @param[in] inputChannels Number of input channels.
+     * @param[in] outputChannels Number of output channels (filters).
+     * @param[in] inputSize Input size. Must be greater than 0.
+     * @param[in] kernelSize Kernel size. Must be greater than 0 and smaller than the input size.
+     * @param[in] actFunc Activation function to use.
+     * @param[in] mode Parameter mode, see ml::ParameterMode.
+     * 
+     * @return Pointer to the new convolutional layer.
+     */
+    ConvLayerPtr multiChannelConvLayer(const std::size_t inputChannels, 
+                                       const std::size_t outputChannels,
+                                       const std::size_t inputSize, const std::size_t kernelSize,
+                                       const act_func::Type actFunc,
+                                       const ParameterMode mode) override
+    {
+        (void) (mode);
+        return std::make_unique<conv_layer::MultiChannelStub>(inputChannels, outputChannels,
+                                                              inputSize, kernelSize, actFunc);
+    }
+
+    /**
+     * @brief Create a convolution algorithm.
+     * 
+     * @param[in] type The type of convolution algorithm to create.
+     * @param[in] inputSize Input size. Must be greater than 0.
+     * @param[in] kernelSize Kernel size. Must be greater than 0.
+     * 
+     * @return Pointer to the new convolution algorithm (always direct convolution).
+     */
+    ConvAlgorithmPtr convAlgorithm(const conv_layer::algorithm::Type type, 
+                                   const std::size_t inputSize,
+                                   const std::size_t kernelSize) override
+    {
+        (void) (type);
+        return std::make_unique<conv_layer::algorithm::Direct>(inputSize, kernelSize);
+    }
+
     /**
      * @brief Create a dense layer.
      * 
      * @param[in] inputSize Input size. Must be greater than 0.
      * @param[in] outputSize Output size. Must be greater than 0.
      * @param[in] actFunc Activation function to use.
+     * @param[in] mode Parameter mode, see ml::ParameterMode.
      * 
      * @return Pointer to the new dense layer.
      */
     DenseLayerPtr denseLayer(const std::size_t inputSize, const std::size_t outputSize, 
-                             const act_func::Type actFunc) override
+                             const act_func::Type actFunc, 
+                             const ParameterMode mode) override
     {
+        (void) (mode);
         return std::make_unique<dense_layer::Stub>(inputSize, outputSize, actFunc);
     }
 
@@ -78,12 +128,14 @@ public:
      * @brief Create a flatten layer.
      * 
      * @param[in] inputSize Input size. Must be greater than 0.
+     * @param[in] channelCount Number of input channels.
      * 
      * @return Pointer to the new flatten layer.
      */
-    FlattenLayerPtr flattenLayer(const std::size_t inputSize) override
+    FlattenLayerPtr flattenLayer(const std::size_t inputSize, 
+                                 const std::size_t channelCount) override
     {
-        return std::make_unique<flatten_layer::Stub>(inputSize);
+        return std::make_unique<flatten_layer::Stub>(inputSize, channelCount);
     }
 
     /**
@@ -91,12 +143,14 @@ public:
      * 
      * @param[in] inputSize Input size. Must be greater than 0.
      * @param[in] poolSize Pool size. Must divide the input size.
+     * @param[in] channelCount Number of channels.
      * 
      * @return Pointer to the new max pooling layer.
      */
-    ConvLayerPtr maxPoolLayer(const std::size_t inputSize, const std::size_t poolSize) override
+    ConvLayerPtr maxPoolLayer(const std::size_t inputSize, const std::size_t poolSize,
+                              const std::size_t channelCount) override
     {
-        return std::make_unique<conv_layer::MaxPoolStub>(inputSize, poolSize);
+        return std::make_unique<conv_layer::MaxPoolStub>(inputSize, poolSize, channelCount);
     }
 
     Stub(const Stub&)            = delete; // No copy constructor.
@@ -13,13 +13,18 @@
 
 //! @note Inte heller här används aktiveringsfunktioner, så denna rad kan tas bort.
 #include "ml/act_func/relu.h"
+#include "ml/tensor.h"
 #include "ml/types.h"
 #include "ml/utils.h"
 
 namespace ml::flatten_layer
 {
 /**
- * @brief Flatten layer interface.
+ * @brief Flatten layer implementation.
+ *
+ *        Flattening only changes the shape, so no data is copied: the output is a view of 
+ *        the (contiguous) input, and the input gradients are a view of the output gradients.
+ *        The views are valid as long as the viewed tensors.
  */
 class FlattenLayer final : public Interface
 {
@@ -28,8 +33,11 @@ public:
      * @brief Constructor.
      * 
      * @param[in] inputSize Input size. Must be greater than 0.
+     * @param[in] channelCount Number of input channels (default = 1). Must be at most
+     *                         ChannelBlock or a multiple of ChannelBlock
+     *                         (see ml/conv_layer/layout.h).
      */
-    explicit FlattenLayer(const std::size_t inputSize);
+    explicit FlattenLayer(const std::size_t inputSize, const std::size_t channelCount = 1U);
 
     /** 
      * @brief Destructor. 
@@ -53,34 +61,52 @@ public:
     /**
      * @brief Get the input gradients of the layer.
      * 
-     * @return Matrix holding the input gradients of the layer.
+     * @return Tensor holding the input gradients of the layer.
      */
-    const Matrix2d& inputGradients() const noexcept override;
+    const Tensor& inputGradients() const noexcept override;
 
     /**
      * @brief Get the flattened output of the layer.
      * 
-     * @return Matrix holding the output of the layer.
+     * @return Tensor holding the output of the layer.
+     */
+    const Tensor& output() const noexcept override;
+
+    /**
+     * @brief Get the maximum number of samples per batch.
+     * 
+     * @return The maximum batch size.
+     */
+    std::size_t maxBatchSize() const noexcept override;
+
+    /**
+     * @brief Set the maximum number of samples per batch.
+     * 
+     * @param[in] batchSize The maximum batch size. Must be greater than 0.
+     * 
+     * @throw std::invalid_argument If the batch size is 0.
      */
-    const Matrix1d& output() const noexcept override;
+    void setMaxBatchSize(std::size_t batchSize) override;
 
     /**
      * @brief Flatten the input from 2D to 1D.
      * 
-     * @param[in] input Matrix holding input data.
+     * @param[in] input Tensor holding a single input sample or a batch of samples. 
+     *                  Must be contiguous.
      * 
      * @return True on success, false on failure.
      */
-    bool feedforward(const Matrix2d& input) noexcept override;
+    bool feedforward(const Tensor& input) noexcept override;
 
      /**
      * @brief Unflatten the output gradients from 1D to 2D.
      * 
-     * @param[in] outputGradients Matrix holding output gradients.
+     * @param[in] outputGradients Tensor holding output gradients, shaped like the output.
+     *                            Must be contiguous.
      * 
      * @return True on success, false on failure.
      */
-    bool backpropagate(const Matrix1d& outputGradients) noexcept override;
+    bool backpropagate(const Tensor& outputGradients) noexcept override;
 
     /**
      * @brief Delete the default constructor, delete copy and move constructors, delete operators.
@@ -92,11 +118,24 @@ public:
     FlattenLayer& operator=(FlattenLayer&&)         = delete;
 
 private:
-    /** Unflattened input gradients (to pass to the previous layer). */
-    Matrix2d myInputGradients;
+    /** Unflattened view of the latest output gradients, in the channel-blocked layout
+     *  (to pass to the previous layer). */
+    Tensor myInputGradients;
+
+    /** Flattened view of the latest input (to pass to the next layer). */
+    Tensor myOutput;
+
+    /** Input size. */
+    std::size_t myInputSize;
+
+    /** Maximum number of samples per batch. */
+    std::size_t myMaxBatchSize;
+
+    /** Number of samples in the latest batch. */
+    std::size_t myBatchSize;
 
-    /** Flattened output (to pass to the next layer). */
-    Matrix1d myOutput;
+    /** Number of input channels. */
+    std::size_t myChannelCount;
 
     /** Relu. */
     //! @note Detta attribut bör tas bort!
@@ -6,12 +6,17 @@
 #include <cstdlib>
 #include <vector>
 
+#include "ml/tensor.h"
 #include "ml/types.h"
 
 namespace ml::flatten_layer
 {
 /**
  * @brief Flatten layer interface.
+ *
+ *        Layers process either a single sample or a batch of samples stacked along the first
+ *        dimension, up to the max batch size (1 by default). The output and the gradients
+ *        are shaped like the latest input, i.e. with or without the batch dimension.
  */
 class Interface
 {
@@ -38,33 +43,51 @@ public:
     /**
      * @brief Get the input gradients of the layer.
      * 
-     * @return Matrix holding the input gradients of the layer.
+     * @return Tensor holding the input gradients of the layer.
      */
-    virtual const Matrix2d& inputGradients() const noexcept = 0;
+    virtual const Tensor& inputGradients() const noexcept = 0;
 
     /**
      * @brief Get the flattened output of the layer.
      * 
-     * @return Matrix holding the output of the layer.
+     * @return Tensor holding the output of the layer.
      */
-    virtual const Matrix1d& output() const noexcept = 0;
+    virtual const Tensor& output() const noexcept = 0;
+
+    /**
+     * @brief Get the maximum number of samples per batch.
+     * 
+     * @return The maximum batch size.
+     */
+    virtual std::size_t maxBatchSize() const noexcept = 0;
+
+    /**
+     * @brief Set the maximum number of samples per batch.
+     * 
+     *        The batch buffers are reallocated, i.e. the current output and gradients are lost.
+     * 
+     * @param[in] batchSize The maximum batch size. Must be greater than 0.
+     * 
+     * @throw std::invalid_argument If the batch size is 0.
+     */
+    virtual void setMaxBatchSize(std::size_t batchSize) = 0;
 
     /**
      * @brief Flatten the input from 2D to 1D.
      * 
-     * @param[in] input Matrix holding input data.
+     * @param[in] input Tensor holding a single input sample or a batch of samples.
      * 
      * @return True on success, false on failure.
      */
-    virtual bool feedforward(const Matrix2d& input) noexcept = 0;
+    virtual bool feedforward(const Tensor& input) noexcept = 0;
 
      /**
      * @brief Unflatten the output gradients from 1D to 2D.
      * 
-     * @param[in] outputGradients Matrix holding output gradients.
+     * @param[in] outputGradients Tensor holding output gradients.
      * 
      * @return True on success, false on failure.
      */
-    virtual bool backpropagate(const Matrix1d& outputGradients) noexcept = 0;
+    virtual bool backpropagate(const Tensor& outputGradients) noexcept = 0;
 };
 } // namespace ml::flatten_layer
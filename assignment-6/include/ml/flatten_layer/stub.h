@@ -5,7 +5,9 @@
 
 #include <stdexcept>
 
+#include "ml/conv_layer/layout.h"
 #include "ml/flatten_layer/interface.h"
+#include "ml/tensor.h"
 #include "ml/types.h"
 #include "ml/utils.h"
 
@@ -23,21 +25,28 @@ public:
      * @brief Constructor.
      * 
      * @param[in] inputSize Input size. Must be greater than 0.
+     * @param[in] channelCount Number of input channels (default = 1).
      */
-    explicit Stub(const std::size_t inputSize)
-        : myInputGradients{}
+    explicit Stub(const std::size_t inputSize, const std::size_t channelCount = 1U)
+        : myInputGradientBatch{}
+        , myInputGradients{}
+        , myOutputBatch{}
         , myOutput{}
+        , myChannelCount{channelCount}
     {
         // Check the input size, throw an exception if invalid.
         if (0U == inputSize)
         {
             throw std::invalid_argument("Input size cannot be 0!");
         }
+        else if (!conv_layer::isValidChannelCount(channelCount))
+        {
+            throw std::invalid_argument("Invalid channel count!");
+        }
 
         // Initialize layer matrices.
-        const std::size_t outputSize{inputSize * inputSize};
-        initMatrix(myInputGradients, inputSize);
-        initMatrix(myOutput, outputSize);
+        myInputGradientBatch = conv_layer::featureMaps(1U, channelCount, inputSize);
+        setMaxBatchSize(1U);
     }
 
     /** 
@@ -50,56 +59,94 @@ public:
      * 
      * @return The input size of the layer.
      */
-    std::size_t inputSize() const noexcept override { return myInputGradients.size(); }
+    std::size_t inputSize() const noexcept override 
+    { 
+        return conv_layer::featureMapSize(myInputGradientBatch); 
+    }
 
     /**
      * @brief Get the output size of the layer.
      * 
      * @return The output size of the layer.
      */
-    std::size_t outputSize() const noexcept override { return myOutput.size(); }
+    std::size_t outputSize() const noexcept override 
+    { 
+        return myChannelCount * inputSize() * inputSize(); 
+    }
 
     /**
      * @brief Get the input gradients of the layer.
      * 
-     * @return Matrix holding the input gradients of the layer.
+     * @return Tensor holding the input gradients of the layer.
      */
-    const Matrix2d& inputGradients() const noexcept override { return myInputGradients; }
+    const Tensor& inputGradients() const noexcept override { return myInputGradients; }
 
     /**
      * @brief Get the flattened output of the layer.
      * 
-     * @return Matrix holding the output of the layer.
+     * @return Tensor holding the output of the layer.
+     */
+    const Tensor& output() const noexcept override { return myOutput; }
+
+    /**
+     * @brief Get the maximum number of samples per batch.
+     * 
+     * @return The maximum batch size.
+     */
+    std::size_t maxBatchSize() const noexcept override { return myInputGradientBatch.dim(0U); }
+
+    /**
+     * @brief Set the maximum number of samples per batch.
+     * 
+     * @param[in] batchSize The maximum batch size. Must be greater than 0.
+     * 
+     * @throw std::invalid_argument If the batch size is 0.
      */
-    const Matrix1d& output() const noexcept override { return myOutput; }
+    void setMaxBatchSize(const std::size_t batchSize) override
+    {
+        // Throw an exception if the batch size is invalid.
+        if (0U == batchSize) { throw std::invalid_argument("Batch size cannot be 0!"); }
+
+        // Reallocate the batch matrices, let the views refer to the first sample.
+        myInputGradientBatch = conv_layer::featureMaps(batchSize, myChannelCount, inputSize());
+        myOutputBatch        = Tensor{batchSize, outputSize()};
+        myInputGradients     = myInputGradientBatch.slice(0U);
+        myOutput             = myOutputBatch.slice(0U);
+    }
 
     /**
      * @brief Stub the input from 2D to 1D.
      * 
-     * @param[in] input Matrix holding input data.
+     * @param[in] input Tensor holding input data.
      * 
      * @return True on success, false on failure.
      */
-    bool feedforward(const Matrix2d& input) noexcept override
+    bool feedforward(const Tensor& input) noexcept override
     {
-        // Return true if the input matches the expected (unpadded) output size.
+        // Return true if the input matches the expected input size.
         constexpr const char* opName{"feedforward in flatten layer"};
-        return matchDimensions(myInputGradients.size(), input.size(), opName)
-            && isMatrixSquare(input, opName);
+        const std::size_t sampleCount{batchSize(input, myInputGradientBatch, opName)};
+        if (0U == sampleCount) { return false; }
+
+        // Let the views match the layout of the input.
+        const bool batched{input.rank() == myInputGradientBatch.rank()};
+        myOutput         = batchView(myOutputBatch, sampleCount, batched);
+        myInputGradients = batchView(myInputGradientBatch, sampleCount, batched);
+        return true;
     }
 
      /**
      * @brief Unflatten the output gradients from 1D to 2D.
      * 
-     * @param[in] outputGradients Matrix holding output gradients.
+     * @param[in] outputGradients Tensor holding output gradients.
      * 
      * @return True on success, false on failure.
      */
-    bool backpropagate(const Matrix1d& outputGradients) noexcept override
+    bool backpropagate(const Tensor& outputGradients) noexcept override
     {
          // Return true if the output dimensions match.
         constexpr const char* opName{"backpropagation in flatten layer"};
-        return matchDimensions(myOutput.size(), outputGradients.size(), opName);
+        return 0U != batchSize(outputGradients, myOutputBatch, opName);
     }
 
     Stub()                       = delete; // No default constructor.
@@ -109,10 +156,19 @@ public:
     Stub& operator=(Stub&&)      = delete; // No move assignment.
 
 private:
-    /** Input gradients. */
-    Matrix2d myInputGradients;
+    /** Input gradient batch. */
+    Tensor myInputGradientBatch;
+
+    /** View of the input gradients of the latest batch. */
+    Tensor myInputGradients;
+
+    /** Stubbed output batch. */
+    Tensor myOutputBatch;
+
+    /** View of the output of the latest batch. */
+    Tensor myOutput;
 
-    /** Stubed output. */
-    Matrix1d myOutput;
+    /** Number of input channels. */
+    std::size_t myChannelCount;
 };
 } // namespace ml::flatten_layer
@@ -0,0 +1,99 @@
+/**
+ * @brief Vectorized level 1 and level 2 BLAS-like kernels.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ml/linalg/gemm.h"
+
+namespace ml::linalg
+{
+/**
+ * @brief Compute the dot product x^T y.
+ *
+ *        Each kernel is available in single and double precision.
+ *
+ * @param[in] n Number of elements.
+ * @param[in] x Pointer to the first vector.
+ * @param[in] y Pointer to the second vector.
+ *
+ * @return The dot product.
+ */
+float dot(std::size_t n, const float* x, const float* y) noexcept;
+double dot(std::size_t n, const double* x, const double* y) noexcept;
+
+/**
+ * @brief Compute the dot product x^T y of two int8 vectors with int32 accumulation.
+ *
+ *        Used by quantized inference. The sum must fit in 32 bits, which holds for any
+ *        n < 2^17.
+ *
+ * @param[in] n Number of elements.
+ * @param[in] x Pointer to the first vector.
+ * @param[in] y Pointer to the second vector.
+ *
+ * @return The dot product.
+ */
+std::int32_t dot(std::size_t n, const std::int8_t* x, const std::int8_t* y) noexcept;
+
+/**
+ * @brief Compute y = alpha * x + y.
+ *
+ * @param[in] n Number of elements.
+ * @param[in] alpha Scale factor for x.
+ * @param[in] x Pointer to the vector to add.
+ * @param[in, out] y Pointer to the vector to update.
+ */
+void axpy(std::size_t n, float alpha, const float* x, float* y) noexcept;
+void axpy(std::size_t n, double alpha, const double* x, double* y) noexcept;
+
+/**
+ * @brief Compute y = alpha * x + y for an int8 vector x, accumulating into int32 vector y.
+ *
+ *        Used by quantized inference.
+ *
+ * @param[in] n Number of elements.
+ * @param[in] alpha Scale factor for x.
+ * @param[in] x Pointer to the vector to add.
+ * @param[in, out] y Pointer to the vector to update.
+ */
+void axpy(std::size_t n, std::int8_t alpha, const std::int8_t* x, std::int32_t* y) noexcept;
+
+/**
+ * @brief Compute y = op(A) * x + y for a row-major m x n matrix A.
+ *
+ *        Both variants traverse A row by row: without transpose each row is reduced with a
+ *        dot product, with transpose each row is scaled and accumulated into y.
+ *
+ * @param[in] trans Operation to apply to matrix A.
+ * @param[in] m Number of rows of A.
+ * @param[in] n Number of columns of A.
+ * @param[in] a Pointer to matrix A.
+ * @param[in] lda Row stride (leading dimension) of matrix A.
+ * @param[in] x Pointer to vector x (n elements without transpose, else m elements).
+ * @param[in, out] y Pointer to vector y (m elements without transpose, else n elements).
+ */
+void gemv(Transpose trans, std::size_t m, std::size_t n, const float* a, std::size_t lda,
+          const float* x, float* y) noexcept;
+void gemv(Transpose trans, std::size_t m, std::size_t n, const double* a, std::size_t lda,
+          const double* x, double* y) noexcept;
+
+/**
+ * @brief Perform the rank-1 update A = alpha * x * y^T + A for a row-major m x n matrix A.
+ *
+ * @param[in] m Number of rows of A (elements of x).
+ * @param[in] n Number of columns of A (elements of y).
+ * @param[in] alpha Scale factor.
+ * @param[in] x Pointer to vector x.
+ * @param[in] y Pointer to vector y.
+ * @param[in, out] a Pointer to matrix A.
+ * @param[in] lda Row stride (leading dimension) of matrix A.
+ */
+void ger(std::size_t m, std::size_t n, float alpha, const float* x, const float* y, float* a,
+         std::size_t lda) noexcept;
+void ger(std::size_t m, std::size_t n, double alpha, const double* x, const double* y, double* a,
+         std::size_t lda) noexcept;
+
+} // namespace ml::linalg
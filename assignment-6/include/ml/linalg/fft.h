@@ -0,0 +1,124 @@
+/**
+ * @brief Real-valued two-dimensional fast Fourier transform (FFT).
+ */
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+#include "ml/scalar.h"
+#include "ml/tensor.h"
+
+namespace ml::linalg
+{
+/** Complex number type used for spectra. */
+using Complex = std::complex<Scalar>;
+
+/**
+ * @brief Two-dimensional real-to-complex FFT of size N x N.
+ *
+ *        N must be even with no prime factors other than 2 and 3; the transforms are computed
+ *        with mixed radix-2/radix-3 Stockham passes, which need no bit-reversal reordering.
+ *
+ *        Since the input is real, the spectrum is Hermitian symmetric and only the N x (N/2 + 1)
+ *        non-redundant half (row-major) is stored. Each row is transformed by packing its even
+ *        and odd samples into one complex sequence of length N/2, after which the columns are
+ *        transformed with butterflies operating on whole spectrum rows at a time.
+ *
+ *        This class is non-copyable and non-movable.
+ */
+class RealFft2d
+{
+public:
+    /**
+     * @brief Constructor.
+     *
+     * @param[in] size Transform size N. Must be even with no prime factors above 3.
+     *
+     * @throw std::invalid_argument If the size isn't supported.
+     */
+    explicit RealFft2d(std::size_t size);
+
+    /**
+     * @brief Destructor.
+     */
+    ~RealFft2d() noexcept = default;
+
+    /**
+     * @brief Get the smallest supported transform size.
+     *
+     * @param[in] minSize The minimum transform size.
+     *
+     * @return The smallest supported size greater or equal to the minimum size.
+     */
+    static std::size_t nextSize(std::size_t minSize) noexcept;
+
+    /**
+     * @brief Get the transform size N.
+     *
+     * @return The transform size.
+     */
+    std::size_t size() const noexcept { return mySize; }
+
+    /**
+     * @brief Get the number of elements of a half spectrum, i.e. N * (N/2 + 1).
+     *
+     * @return The number of spectrum elements.
+     */
+    std::size_t spectrumSize() const noexcept { return mySize * mySpectrumCols; }
+
+    /**
+     * @brief Compute the half spectrum of given matrix, zero padded to N x N.
+     *
+     * @param[in] input Matrix to transform. Both dimensions must be less or equal to N.
+     * @param[out] spectrum Pointer to the spectrum, holding at least spectrumSize() elements.
+     */
+    void forward(const Tensor& input, Complex* spectrum) noexcept;
+
+    /**
+     * @brief Compute the (scaled) inverse transform of given half spectrum.
+     *
+     *        Only the window starting at given offset is stored, i.e.
+     *        output(i, j) = x((i + offset) mod N, (j + offset) mod N).
+     *
+     * @param[in, out] spectrum Pointer to the spectrum. Its content is destroyed.
+     * @param[in] offset Offset of the stored window.
+     * @param[out] output Tensor in which to store the window. Dimensions must not exceed N.
+     */
+    void inverse(Complex* spectrum, std::size_t offset, Tensor& output) noexcept;
+
+    RealFft2d()                            = delete; // No default constructor.
+    RealFft2d(const RealFft2d&)            = delete; // No copy constructor.
+    RealFft2d(RealFft2d&&)                 = delete; // No move constructor.
+    RealFft2d& operator=(const RealFft2d&) = delete; // No copy assignment.
+    RealFft2d& operator=(RealFft2d&&)      = delete; // No move assignment.
+
+private:
+    void transform(Complex* data, std::size_t length, std::size_t width,
+                   const std::vector<std::size_t>& factors, bool inverse) noexcept;
+    void transformRow(Complex* row, bool inverse) noexcept;
+
+    /** Twiddle factors exp(-2 pi i k / N) for k in [0, N). */
+    std::vector<Complex> myTwiddles;
+
+    /** Conjugated twiddle factors, used for inverse transforms. */
+    std::vector<Complex> myInverseTwiddles;
+
+    /** Radix of each pass for transforms of length N (columns). */
+    std::vector<std::size_t> myColumnFactors;
+
+    /** Radix of each pass for transforms of length N/2 (packed rows). */
+    std::vector<std::size_t> myRowFactors;
+
+    /** Work buffer for the Stockham passes. */
+    std::vector<Complex> myWork;
+
+    /** Transform size N. */
+    std::size_t mySize;
+
+    /** Number of stored spectrum columns, N/2 + 1. */
+    std::size_t mySpectrumCols;
+};
+
+} // namespace ml::linalg
@@ -0,0 +1,50 @@
+/**
+ * @brief General matrix multiplication (GEMM).
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ml/scalar.h"
+
+namespace ml::linalg
+{
+/**
+ * @brief Enumeration of matrix operations applied to GEMM operands.
+ */
+enum class Transpose : std::uint8_t
+{
+    No,  ///< Use the matrix as is.
+    Yes, ///< Use the transpose of the matrix.
+};
+
+/**
+ * @brief Compute C = alpha * op(A) * op(B) + beta * C for row-major matrices.
+ * 
+ *        The multiplication is cache blocked: panels of op(A) and op(B) are packed into
+ *        contiguous buffers sized for the L1/L2 caches, after which a register-blocked
+ *        microkernel computes small tiles of C. If C has few rows or columns the packed
+ *        panels are barely reused, so the large operand is then read in place instead:
+ *        A * B^T is computed as dot products of the rows of A and B, and B is not packed
+ *        if C has few rows.
+ * 
+ * @param[in] transA Operation to apply to matrix A.
+ * @param[in] transB Operation to apply to matrix B.
+ * @param[in] m Number of rows of op(A) and C.
+ * @param[in] n Number of columns of op(B) and C.
+ * @param[in] k Number of columns of op(A) and rows of op(B).
+ * @param[in] alpha Scale factor for op(A) * op(B).
+ * @param[in] a Pointer to matrix A.
+ * @param[in] lda Row stride (leading dimension) of matrix A.
+ * @param[in] b Pointer to matrix B.
+ * @param[in] ldb Row stride (leading dimension) of matrix B.
+ * @param[in] beta Scale factor for C. If 0, C doesn't need to be initialized.
+ * @param[in, out] c Pointer to matrix C.
+ * @param[in] ldc Row stride (leading dimension) of matrix C.
+ */
+void gemm(Transpose transA, Transpose transB, std::size_t m, std::size_t n, std::size_t k,
+          Scalar alpha, const Scalar* a, std::size_t lda, const Scalar* b, std::size_t ldb,
+          Scalar beta, Scalar* c, std::size_t ldc) noexcept;
+
+} // namespace ml::linalg
@@ -0,0 +1,56 @@
+/**
+ * @brief Runtime detection of SIMD instruction sets.
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace ml::linalg
+{
+/**
+ * @brief Enumeration of SIMD instruction set levels, in increasing order.
+ */
+enum class SimdLevel : std::uint8_t
+{
+    Scalar, ///< Portable scalar code.
+    Sse2,   ///< SSE2 (128-bit vectors).
+    Avx2,   ///< AVX2 with FMA (256-bit vectors).
+    Avx512, ///< AVX-512F (512-bit vectors).
+};
+
+/**
+ * @brief Detect the highest SIMD level supported by the CPU (via CPUID).
+ *
+ * @return The highest supported SIMD level.
+ */
+SimdLevel detectSimdLevel() noexcept;
+
+/**
+ * @brief Get the SIMD level used by the vectorized kernels.
+ *
+ *        Initially the highest level supported by the CPU.
+ *
+ * @return The active SIMD level.
+ */
+SimdLevel simdLevel() noexcept;
+
+/**
+ * @brief Set the SIMD level used by the vectorized kernels, for instance to compare the
+ *        vectorized kernels with the scalar fallback.
+ *
+ * @param[in] level The SIMD level to use.
+ *
+ * @return True on success, false if the level isn't supported by the CPU.
+ */
+bool setSimdLevel(SimdLevel level) noexcept;
+
+/**
+ * @brief Get the name of given SIMD level.
+ *
+ * @param[in] level The SIMD level.
+ *
+ * @return The name of the SIMD level as a string.
+ */
+const char* simdLevelName(SimdLevel level) noexcept;
+
+} // namespace ml::linalg
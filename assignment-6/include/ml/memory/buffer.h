@@ -0,0 +1,42 @@
+/**
+ * @brief Description of the batch buffers of a layer, for memory planning.
+ */
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "ml/tensor.h"
+
+namespace ml::memory
+{
+/**
+ * @brief Enumeration of batch buffer roles, which determine when a buffer is live.
+ */
+enum class Role : std::uint8_t
+{
+    Input,          ///< Copy of the input, written by feedforward, read by backpropagation.
+    Output,         ///< Written by feedforward, read by the next layer and backpropagation.
+    InputGradients, ///< Written by backpropagation, read by the previous layer.
+    Scratch,        ///< Written and read by backpropagation only.
+    Delta,          ///< Written by backpropagation, read until the parameters are optimized.
+};
+
+/**
+ * @brief Batch buffer of a layer.
+ */
+struct Buffer
+{
+    /** The buffer, shape (max batch size, ...) or the shape of a single sample. */
+    Tensor* batch;
+
+    /** View of the latest batch into the buffer, nullptr if none. */
+    Tensor* view;
+
+    /** Role of the buffer. */
+    Role role;
+};
+
+/** List of batch buffers. */
+using BufferList = std::vector<Buffer>;
+} // namespace ml::memory
@@ -0,0 +1,97 @@
+/**
+ * @brief Memory-mapped file.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ml::memory
+{
+/**
+ * @brief Enumeration of access modes of memory-mapped files.
+ */
+enum class Access : std::uint8_t
+{
+    ReadOnly,    ///< The pages can only be read, a write faults.
+    CopyOnWrite, ///< Writes copy the written pages into private memory of the process.
+};
+
+/**
+ * @brief Memory-mapped file.
+ *
+ *        The file is mapped privately, i.e. processes mapping the same file share the pages
+ *        of the page cache as long as they only read them. By default the mapping is
+ *        read-only, so an accidental write faults instead of silently giving the process its
+ *        own copy of the page. A copy-on-write mapping allows writes, which copy the written
+ *        pages into private memory of the process and never reach the file. The file must
+ *        not be modified while mapped.
+ *
+ *        This class is non-copyable and non-movable.
+ */
+class MappedFile
+{
+public:
+    /**
+     * @brief Map given file into memory.
+     *
+     * @param[in] path Path to the file.
+     * @param[in] access The access mode of the mapping (default = read-only).
+     *
+     * @throw std::runtime_error If the file cannot be opened or mapped, or is empty.
+     */
+    explicit MappedFile(const std::string& path, Access access = Access::ReadOnly);
+
+    /**
+     * @brief Unmap the file.
+     */
+    ~MappedFile() noexcept;
+
+    /**
+     * @brief Get a pointer to the first byte of the file, aligned to a page.
+     *
+     *        The bytes must only be written if the file is mapped copy-on-write.
+     *
+     * @return Pointer to the mapped file.
+     */
+    std::uint8_t* data() noexcept { return myData; }
+
+    /**
+     * @brief Get a pointer to the first byte of the file, aligned to a page.
+     *
+     * @return Pointer to the mapped file.
+     */
+    const std::uint8_t* data() const noexcept { return myData; }
+
+    /**
+     * @brief Get the size of the file.
+     *
+     * @return The file size in bytes.
+     */
+    std::size_t size() const noexcept { return mySize; }
+
+    /**
+     * @brief Get the access mode of the mapping.
+     *
+     * @return The access mode.
+     */
+    Access access() const noexcept { return myAccess; }
+
+    MappedFile()                             = delete; // No default constructor.
+    MappedFile(const MappedFile&)            = delete; // No copy constructor.
+    MappedFile(MappedFile&&)                 = delete; // No move constructor.
+    MappedFile& operator=(const MappedFile&) = delete; // No copy assignment.
+    MappedFile& operator=(MappedFile&&)      = delete; // No move assignment.
+
+private:
+    /** Pointer to the mapped file. */
+    std::uint8_t* myData;
+
+    /** File size in bytes. */
+    std::size_t mySize;
+
+    /** Access mode of the mapping. */
+    Access myAccess;
+};
+} // namespace ml::memory
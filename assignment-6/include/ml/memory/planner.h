@@ -0,0 +1,141 @@
+/**
+ * @brief Static memory planner for batch buffers.
+ */
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+namespace ml::memory
+{
+/**
+ * @brief Static memory planner.
+ *
+ *        Buffers are added with the range of steps during which they are live, after which
+ *        every buffer is assigned an offset in a single arena. Buffers that are never live
+ *        at the same time may share memory. The offsets are assigned greedily, largest
+ *        buffer first, to the lowest gap left by the overlapping buffers placed before it.
+ *        All offsets and sizes are counted in scalars, each offset is aligned like the
+ *        tensor storage.
+ */
+class Planner
+{
+public:
+    /** Offset of buffers that are never live. */
+    static constexpr std::size_t Unused{static_cast<std::size_t>(-1)};
+
+    /**
+     * @brief Create an empty plan.
+     */
+    Planner() noexcept;
+
+    /**
+     * @brief Remove all buffers.
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Add a buffer.
+     *
+     * @param[in] size The number of scalars in the buffer.
+     * @param[in] first The first step during which the buffer is live.
+     * @param[in] last The last step during which the buffer is live. Must be at least first.
+     *
+     * @return The index of the buffer.
+     *
+     * @throw std::invalid_argument If the last step precedes the first step.
+     */
+    std::size_t add(std::size_t size, std::size_t first, std::size_t last);
+
+    /**
+     * @brief Add a buffer that is never live, which gets no memory.
+     *
+     * @return The index of the buffer.
+     */
+    std::size_t addUnused();
+
+    /**
+     * @brief Assign an offset to every buffer.
+     */
+    void plan();
+
+    /**
+     * @brief Get the offset of given buffer.
+     *
+     * @param[in] buffer The index of the buffer.
+     *
+     * @return The offset in scalars, Unused if the buffer is never live.
+     */
+    std::size_t offset(std::size_t buffer) const noexcept;
+
+    /**
+     * @brief Get the number of buffers.
+     *
+     * @return The number of buffers.
+     */
+    std::size_t bufferCount() const noexcept { return myBuffers.size(); }
+
+    /**
+     * @brief Get the size of the arena, i.e. the end of the last buffer.
+     *
+     * @return The arena size in scalars.
+     */
+    std::size_t peakSize() const noexcept { return myPeakSize; }
+
+    /**
+     * @brief Get the total size of the buffers, i.e. the arena size without reuse.
+     *
+     * @return The total size in scalars.
+     */
+    std::size_t totalSize() const noexcept;
+
+private:
+    /**
+     * @brief Buffer of the plan.
+     */
+    struct Entry
+    {
+        /** Number of scalars, rounded up to the alignment. */
+        std::size_t size;
+
+        /** First step during which the buffer is live. */
+        std::size_t first;
+
+        /** Last step during which the buffer is live. */
+        std::size_t last;
+
+        /** Assigned offset. */
+        std::size_t offset;
+    };
+
+    /** Buffers of the plan. */
+    std::vector<Entry> myBuffers;
+
+    /** Arena size in scalars. */
+    std::size_t myPeakSize;
+};
+
+/**
+ * @brief Peak memory of the batch buffers of a model.
+ */
+struct Report
+{
+    /** Arena size of the inference plan in bytes. */
+    std::size_t inferenceBytes;
+
+    /** Arena size of the training plan in bytes. */
+    std::size_t trainingBytes;
+
+    /** Total size of the buffers in bytes, i.e. the memory without reuse. */
+    std::size_t totalBytes;
+};
+
+/**
+ * @brief Print given memory report.
+ *
+ * @param[in] report The report to print.
+ * @param[in] ostream Output stream (default = terminal print).
+ */
+void printReport(const Report& report, std::ostream& ostream = std::cout) noexcept;
+} // namespace ml::memory
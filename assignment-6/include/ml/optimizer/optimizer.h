@@ -0,0 +1,219 @@
+/**
+ * @brief Optimizers updating the parameters of a network from their gradients.
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "ml/optimizer/type.h"
+#include "ml/scalar.h"
+#include "ml/tensor.h"
+#include "ml/types.h"
+
+namespace ml::optimizer
+{
+/**
+ * @brief Optimizer settings.
+ *
+ *        The hyperparameters not used by the optimizer type are ignored:
+ *        - Momentum, Nesterov: beta1 is the momentum.
+ *        - RMSProp: beta2 is the decay rate of the squared gradient average.
+ *        - Adam: beta1 and beta2 are the decay rates of the first and second moments.
+ *        - AdamW: as Adam, plus the decoupled weight decay.
+ */
+struct Config
+{
+    /** Optimizer type. */
+    Type type{Type::Sgd};
+
+    /** Decay rate of the first moment (the momentum), in the range [0, 1). */
+    double beta1{0.9};
+
+    /** Decay rate of the second moment, in the range [0, 1). */
+    double beta2{0.999};
+
+    /** Term added to the root of the second moment to avoid division by zero. */
+    double epsilon{1e-8};
+
+    /** Decoupled weight decay per unit of learning rate (AdamW only). */
+    double weightDecay{0.01};
+};
+
+/**
+ * @brief Optimizer updating parameters from their gradients.
+ *
+ *        The gradients are descent directions, as computed by the layers, i.e. plain SGD
+ *        adds the gradients times the learning rate to the parameters. The state of the
+ *        optimizer (the moments) is held in a single contiguous buffer, with one region per
+ *        parameter tensor and moment, and every parameter tensor is updated in one fused pass
+ *        reading the parameters, the gradients and the moments once. The fused loops are
+ *        compiled for every SIMD level (see ml/linalg/simd.h) and split across the thread
+ *        pool for large tensors.
+ *
+ *        The state is bound to the parameters of the first step and reset whenever other
+ *        parameters are passed, e.g. after layers are added to the network.
+ */
+class Optimizer final
+{
+public:
+    /**
+     * @brief Create a new optimizer.
+     *
+     * @param[in] config Optimizer settings (default = plain SGD).
+     *
+     * @throw std::invalid_argument If any hyperparameter is out of range.
+     */
+    explicit Optimizer(const Config& config = Config{});
+
+    /**
+     * @brief Get the optimizer settings.
+     *
+     * @return The optimizer settings.
+     */
+    const Config& config() const noexcept { return myConfig; }
+
+    /**
+     * @brief Get the optimizer type.
+     *
+     * @return The optimizer type.
+     */
+    Type type() const noexcept { return myConfig.type; }
+
+    /**
+     * @brief Get the number of steps taken since the state was last reset.
+     *
+     * @return The step count.
+     */
+    std::size_t stepCount() const noexcept { return myStepCount; }
+
+    /**
+     * @brief Get the size of the optimizer state.
+     *
+     * @return The state size in bytes.
+     */
+    std::size_t stateBytes() const noexcept { return myState.size() * sizeof(Scalar); }
+
+    /**
+     * @brief Update parameters from their gradients.
+     *
+     * @param[in] parameters The parameters to update. Padded rows must have the same
+     *                       strides as the gradients.
+     * @param[in] gradients The gradients, one per parameter tensor with the same shape.
+     * @param[in] learningRate Learning rate, in the range (0, 1].
+     *
+     * @return True on success, false if the learning rate is invalid or the gradients don't
+     *         match the parameters.
+     */
+    bool step(TensorList& parameters, const TensorList& gradients, 
+              double learningRate) noexcept;
+
+    /**
+     * @brief Reset the optimizer state, i.e. the moments and the step count.
+     */
+    void reset() noexcept;
+
+    /**
+     * @brief Check whether the state is bound to given parameters and gradients.
+     *
+     * @param[in] parameters The parameters.
+     * @param[in] gradients The gradients.
+     *
+     * @return True if the state belongs to the tensors, i.e. they were updated by the
+     *         previous step, else false.
+     */
+    bool isBound(const TensorList& parameters, const TensorList& gradients) const noexcept;
+
+    /**
+     * @brief Copy the state of another optimizer, bound to parameters of the same layout.
+     *
+     *        Used to let a replica of a network continue with the moments and the step
+     *        count of the original, so that both take the same steps from the same gradients.
+     *
+     * @param[in] source Optimizer of the same type, whose state to copy.
+     * @param[in] parameters The parameters to bind the copied state to, with the same
+     *                       shapes as the parameters of the source.
+     * @param[in] gradients The gradients of the parameters.
+     *
+     * @return True on success, false if the types or the layouts don't match.
+     */
+    bool copyState(const Optimizer& source, TensorList& parameters,
+                   const TensorList& gradients) noexcept;
+
+    Optimizer(const Optimizer&)            = delete; // No copy constructor.
+    Optimizer(Optimizer&&)                 = delete; // No move constructor.
+    Optimizer& operator=(const Optimizer&) = delete; // No copy assignment.
+    Optimizer& operator=(Optimizer&&)      = delete; // No move assignment.
+
+    /**
+     * @brief Coefficients of an update step, shared by all parameters.
+     */
+    struct Coefficients
+    {
+        /** Learning rate. */
+        Scalar learningRate;
+
+        /** Decay rate of the first moment. */
+        Scalar beta1;
+
+        /** Decay rate of the second moment. */
+        Scalar beta2;
+
+        /** Term added to the root of the second moment. */
+        Scalar epsilon;
+
+        /** Learning rate divided by the bias correction of the first moment (Adam). */
+        Scalar firstScale;
+
+        /** Inverse root of the bias correction of the second moment (Adam). */
+        Scalar secondScale;
+
+        /** Factor by which the parameters decay in each step (AdamW). */
+        Scalar decay;
+    };
+
+    /** Fused update kernel: parameters, gradients, first moments, second moments. */
+    using Kernel = void (*)(std::size_t n, const Coefficients& c, Scalar* parameters,
+                            const Scalar* gradients, Scalar* first, Scalar* second) noexcept;
+
+private:
+    /**
+     * @brief Parameter tensor bound to the state.
+     */
+    struct Entry
+    {
+        /** Pointer to the parameters. */
+        Scalar* parameters;
+
+        /** Pointer to the gradients. */
+        const Scalar* gradients;
+
+        /** Number of scalars, including row padding. */
+        std::size_t size;
+
+        /** Offset of the moments of the tensor in each moment region. */
+        std::size_t offset;
+    };
+
+    bool bind(TensorList& parameters, const TensorList& gradients) noexcept;
+    Coefficients coefficients(double learningRate) const noexcept;
+
+    /** Optimizer settings. */
+    Config myConfig;
+
+    /** Fused update kernel of the optimizer type. */
+    Kernel myKernel;
+
+    /** Parameter tensors bound to the state. */
+    std::vector<Entry> myEntries;
+
+    /** Optimizer state, holding the first moments followed by the second moments. */
+    Tensor myState;
+
+    /** Size of each moment region in scalars. */
+    std::size_t myRegionSize;
+
+    /** Number of steps taken since the state was last reset. */
+    std::size_t myStepCount;
+};
+} // namespace ml::optimizer
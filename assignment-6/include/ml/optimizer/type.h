@@ -0,0 +1,22 @@
+/**
+ * @brief Optimizer types.
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace ml::optimizer
+{
+/**
+ * @brief Enumeration of optimizer types.
+ */
+enum class Type : std::uint8_t
+{
+    Sgd,      ///< Plain stochastic gradient descent.
+    Momentum, ///< Stochastic gradient descent with momentum.
+    Nesterov, ///< Stochastic gradient descent with Nesterov momentum.
+    RmsProp,  ///< RMSProp, scaling by a running average of the squared gradients.
+    Adam,     ///< Adam, with bias-corrected first and second moments.
+    AdamW,    ///< Adam with decoupled weight decay.
+};
+} // namespace ml::optimizer
@@ -0,0 +1,175 @@
+/**
+ * @brief Work-stealing thread pool for parallel loops inside layers.
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ml::parallel
+{
+/**
+ * @brief Work-stealing thread pool for parallel loops inside layers.
+ *
+ *        A parallel loop is split into chunks, which are distributed across one queue per
+ *        worker thread. Each worker runs the chunks of its own queue first and then steals
+ *        chunks from the back of the other queues. The calling thread takes part in the
+ *        work until every chunk of its loop is done.
+ *
+ *        Loops whose total cost is below twice the grain size run on the calling thread
+ *        without touching the pool, so tiny layers never pay for the synchronization.
+ *        Loops may be started from any thread, also concurrently, and may be nested.
+ *
+ *        The pool is shared by the whole library and uses a single thread (the caller)
+ *        by default. This class uses the singleton pattern and is non-copyable and
+ *        non-movable.
+ */
+class ThreadPool final
+{
+public:
+    /** Default minimum cost of a chunk, in scalar operations. */
+    static constexpr std::size_t DefaultGrainSize{16384U};
+
+    /**
+     * @brief Get singleton thread pool instance.
+     *
+     * @return Reference to the singleton thread pool instance.
+     */
+    static ThreadPool& getInstance() noexcept;
+
+    /**
+     * @brief Get the number of threads used for parallel loops (including the caller).
+     *
+     * @return The number of threads.
+     */
+    std::size_t threadCount() const noexcept { return myQueues.size() + 1U; }
+
+    /**
+     * @brief Set the number of threads used for parallel loops (including the caller).
+     *
+     *        Must not be called while a parallel loop is running.
+     *
+     * @param[in] threadCount The number of threads. Must be greater than 0.
+     *
+     * @throw std::invalid_argument If the thread count is 0.
+     */
+    void setThreadCount(std::size_t threadCount);
+
+    /**
+     * @brief Get the minimum cost of a chunk.
+     *
+     * @return The grain size, in scalar operations.
+     */
+    std::size_t grainSize() const noexcept { return myGrainSize; }
+
+    /**
+     * @brief Set the minimum cost of a chunk.
+     *
+     *        Larger values reduce the scheduling overhead, smaller values improve the load
+     *        balance.
+     *
+     * @param[in] grainSize The grain size, in scalar operations. Must be greater than 0.
+     *
+     * @throw std::invalid_argument If the grain size is 0.
+     */
+    void setGrainSize(std::size_t grainSize);
+
+    /**
+     * @brief Run body(begin, end) over disjoint ranges covering [0, count).
+     *
+     *        The ranges may run concurrently on different threads, in any order. The body
+     *        must not throw.
+     *
+     * @tparam Body Callable taking the first and the last (exclusive) index of a range.
+     *
+     * @param[in] count Number of items.
+     * @param[in] itemCost Approximate cost of a single item, in scalar operations.
+     * @param[in] body The loop body.
+     */
+    template <typename Body>
+    void parallelFor(const std::size_t count, const std::size_t itemCost,
+                     const Body& body) noexcept
+    {
+        const std::size_t chunkSize{this->chunkSize(count, itemCost)};
+
+        // Run small loops on the calling thread.
+        if (count <= chunkSize)
+        {
+            if (0U < count) { body(0U, count); }
+            return;
+        }
+        run(count, chunkSize, &body, [](const void* context, const std::size_t begin,
+                                         const std::size_t end)
+        {
+            (*static_cast<const Body*>(context))(begin, end);
+        });
+    }
+
+    ThreadPool(const ThreadPool&)            = delete; // No copy constructor.
+    ThreadPool(ThreadPool&&)                 = delete; // No move constructor.
+    ThreadPool& operator=(const ThreadPool&) = delete; // No copy assignment.
+    ThreadPool& operator=(ThreadPool&&)      = delete; // No move assignment.
+
+private:
+    /** Type-erased loop body. */
+    using Invoker = void (*)(const void* context, std::size_t begin, std::size_t end);
+
+    struct Job;
+    struct Task;
+    struct Queue;
+
+    ThreadPool() noexcept;
+    ~ThreadPool() noexcept;
+
+    std::size_t chunkSize(std::size_t count, std::size_t itemCost) const noexcept;
+    void run(std::size_t count, std::size_t chunkSize, const void* context,
+             Invoker invoker) noexcept;
+    bool runTask(std::size_t first) noexcept;
+    void runWorker(std::size_t index) noexcept;
+    void stop() noexcept;
+
+    /** Task queues, one per worker thread. */
+    std::vector<std::unique_ptr<Queue>> myQueues;
+
+    /** Worker threads. */
+    std::vector<std::thread> myThreads;
+
+    /** Mutex protecting the sleep of the workers. */
+    std::mutex myMutex;
+
+    /** Condition variable used to wake the workers. */
+    std::condition_variable myWakeup;
+
+    /** Number of queued tasks. */
+    std::atomic<std::size_t> myQueuedCount;
+
+    /** Queue to put the next chunk in. */
+    std::atomic<std::size_t> myNextQueue;
+
+    /** Minimum cost of a chunk, in scalar operations. */
+    std::size_t myGrainSize;
+
+    /** Indicate whether the workers shall stop. */
+    bool myStopped;
+};
+
+/**
+ * @brief Run body(begin, end) over disjoint ranges covering [0, count) on the shared pool.
+ *
+ * @tparam Body Callable taking the first and the last (exclusive) index of a range.
+ *
+ * @param[in] count Number of items.
+ * @param[in] itemCost Approximate cost of a single item, in scalar operations.
+ * @param[in] body The loop body, must not throw.
+ */
+template <typename Body>
+void parallelFor(const std::size_t count, const std::size_t itemCost, const Body& body) noexcept
+{
+    ThreadPool::getInstance().parallelFor(count, itemCost, body);
+}
+} // namespace ml::parallel
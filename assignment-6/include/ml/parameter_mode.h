@@ -0,0 +1,19 @@
+/**
+ * @brief Parameter modes of layers.
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace ml
+{
+/**
+ * @brief Enumeration of parameter modes, i.e. where the parameters of a layer come from.
+ */
+enum class ParameterMode : std::uint8_t
+{
+    Owned,    ///< The layer allocates its parameters and initializes them with random values.
+    External, ///< The parameters are supplied later via useParameters() or shareParameters(),
+              ///< the layer only records their shapes and allocates its batch buffers.
+};
+} // namespace ml
@@ -0,0 +1,59 @@
+/**
+ * @brief Accuracy comparison between a reference model and a (quantized) candidate model.
+ */
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+
+#include "ml/cnn/interface.h"
+#include "ml/tensor.h"
+
+namespace ml::quant
+{
+/**
+ * @brief Accuracy of a candidate model relative to a reference model.
+ */
+struct AccuracyReport
+{
+    /** Number of compared samples. */
+    std::size_t sampleCount;
+
+    /** Largest absolute output difference. */
+    double maxAbsError;
+
+    /** Mean absolute output difference. */
+    double meanAbsError;
+
+    /** Root mean square of the output differences. */
+    double rmsError;
+
+    /** 
+     * Fraction of samples for which both models predict the same class, i.e. the same index
+     * of the largest output. Single outputs are classified by whether they exceed 0.5.
+     */
+    double top1Agreement;
+};
+
+/**
+ * @brief Compare the predictions of two models on given inputs.
+ *
+ * @param[in] reference The reference model, for instance a double precision CNN.
+ * @param[in] candidate The model to evaluate, for instance a quantized version of the reference.
+ * @param[in] inputs Input sets, shape (set count, input size, input size).
+ *
+ * @return The accuracy report.
+ *
+ * @throw std::invalid_argument If the model sizes or the input dimensions mismatch.
+ */
+AccuracyReport compareAccuracy(cnn::Interface& reference, cnn::Interface& candidate,
+                               const Tensor& inputs);
+
+/**
+ * @brief Print given accuracy report.
+ *
+ * @param[in] report The report to print.
+ * @param[in] ostream Output stream (default = terminal print).
+ */
+void printReport(const AccuracyReport& report, std::ostream& ostream = std::cout) noexcept;
+} // namespace ml::quant
@@ -0,0 +1,183 @@
+/**
+ * @brief INT8 post-training quantized CNN (Convolutional Neural Network) implementation.
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "ml/cnn/interface.h"
+#include "ml/tensor.h"
+#include "ml/types.h"
+
+/** CNN implementation. */
+namespace ml::cnn { class Cnn; }
+
+namespace ml::quant
+{
+/**
+ * @brief Affine mapping between real values and int8 values: real = scale * (q - zeroPoint).
+ */
+struct QuantParams
+{
+    /** Real value of one quantization step. */
+    double scale;
+
+    /** The int8 value representing real 0. */
+    std::int32_t zeroPoint;
+};
+
+/**
+ * @brief Fixed-point multiplier: real multiplier = mantissa * 2^-shift, with mantissa in Q31.
+ */
+struct Multiplier
+{
+    /** Mantissa in range [2^30, 2^31) (or 0 for a zero multiplier). */
+    std::int32_t mantissa;
+
+    /** Right shift to apply to the product, in range [1, 62]. */
+    int shift;
+};
+
+/**
+ * @brief Inference-only INT8 version of a trained CNN.
+ *
+ *        The model is created via post-training quantization: the trained network is run on a
+ *        calibration set, while the range of each layer's pre- and post-activation values is
+ *        recorded. Activations are then quantized asymmetrically (scale and zero point), conv
+ *        weights symmetrically per tensor and dense weights symmetrically per output node.
+ *
+ *        Inference uses int8 operands with int32 accumulation. The accumulators are
+ *        requantized via fixed-point multipliers, after which the activation function is
+ *        applied via a 256-entry lookup table. Max pooling and flattening work directly on
+ *        int8 values. Only the network output is converted back to floating point.
+ *
+ *        The quantized model holds its own copy of all parameters, i.e. the original CNN
+ *        can be destroyed or trained further afterwards.
+ *
+ *        This class is non-copyable and non-movable.
+ */
+class QuantizedCnn final : public cnn::Interface
+{
+public:
+    /**
+     * @brief Create a quantized copy of given CNN.
+     *
+     * @param[in] cnn The trained CNN to quantize.
+     * @param[in] calibrationSet Representative inputs, shape (set count, input size, input size).
+     *
+     * @throw std::invalid_argument If the calibration set is empty or has invalid dimensions,
+     *                               or if the CNN has multi-channel layers.
+     */
+    explicit QuantizedCnn(cnn::Cnn& cnn, const Tensor& calibrationSet);
+
+    /**
+     * @brief Destructor.
+     */
+    ~QuantizedCnn() noexcept override;
+
+    /**
+     * @brief Get the input size of the CNN.
+     *
+     * @return The input size of the CNN.
+     */
+    std::size_t inputSize() const noexcept override;
+
+    /**
+     * @brief Get the output size of the CNN.
+     *
+     * @return The output size of the CNN.
+     */
+    std::size_t outputSize() const noexcept override;
+
+    /**
+     * @brief Predict based on the given input.
+     *
+     * @param[in] input Input for which to predict.
+     *
+     * @return The predicted (dequantized) output.
+     */
+    const Tensor& predict(const Tensor& input) noexcept override;
+
+    /**
+     * @brief Get the quantization parameters of the input.
+     *
+     * @return The input quantization parameters.
+     */
+    const QuantParams& inputParams() const noexcept { return myInputParams; }
+
+    QuantizedCnn()                               = delete; // No default constructor.
+    QuantizedCnn(const QuantizedCnn&)            = delete; // No copy constructor.
+    QuantizedCnn(QuantizedCnn&&)                 = delete; // No move constructor.
+    QuantizedCnn& operator=(const QuantizedCnn&) = delete; // No copy assignment.
+    QuantizedCnn& operator=(QuantizedCnn&&)      = delete; // No move assignment.
+
+private:
+    /** Quantized layer type. */
+    enum class StageType : std::uint8_t { Conv, MaxPool, Dense };
+
+    /** One quantized layer. */
+    struct Stage
+    {
+        /** Layer type. */
+        StageType type;
+
+        /** Input size (side length for conv/pool layers, element count for dense layers). */
+        std::size_t inputSize;
+
+        /** Output size (side length for conv/pool layers, element count for dense layers). */
+        std::size_t outputSize;
+
+        /** Kernel size (conv) or pool size (max pool). */
+        std::size_t kernelSize;
+
+        /** Quantized weights, (K x K) for conv layers, (output size x input size) for dense. */
+        std::vector<std::int8_t> weights;
+
+        /** Bias in accumulator scale, with the input zero point correction folded in. */
+        std::vector<std::int32_t> bias;
+
+        /** Zero point of the input (the padding value of conv layers). */
+        std::int32_t inputZeroPoint;
+
+        /** Accumulator to pre-activation requantization multiplier(s). */
+        std::vector<Multiplier> multipliers;
+
+        /** Zero point of the pre-activation values. */
+        std::int32_t preActZeroPoint;
+
+        /** Activation function, maps each pre-activation value (offset by 128) to the output. */
+        std::array<std::int8_t, 256U> actFunc;
+
+        /** Quantization parameters of the output. */
+        QuantParams output;
+    };
+
+    void runConv(const Stage& stage, const std::int8_t* input, std::int8_t* output) noexcept;
+    void runMaxPool(const Stage& stage, const std::int8_t* input,
+                    std::int8_t* output) const noexcept;
+    void runDense(const Stage& stage, const std::int8_t* input, std::int8_t* output) noexcept;
+
+    /** Quantized layers in forward order. */
+    std::vector<Stage> myStages;
+
+    /** Quantization parameters of the input. */
+    QuantParams myInputParams;
+
+    /** Ping-pong buffers holding the int8 activations between the layers. */
+    std::array<std::vector<std::int8_t>, 2U> myActivations;
+
+    /** Input padded with its zero point, used by the conv layers. */
+    std::vector<std::int8_t> myPaddedInput;
+
+    /** Int32 accumulators. */
+    std::vector<std::int32_t> myAccumulators;
+
+    /** Dequantized output. */
+    Tensor myOutput;
+
+    /** Input size of the CNN. */
+    std::size_t myInputSize;
+};
+} // namespace ml::quant
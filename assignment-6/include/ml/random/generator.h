@@ -53,6 +53,13 @@ public:
      */
     double float64(double min, double max) const noexcept override;
 
+    /**
+     * @brief Seed the random generator, e.g. to make training reproducible.
+     * 
+     * @param[in] value The seed to use.
+     */
+    void seed(std::uint32_t value) const noexcept override;
+
     Generator(const Generator&)            = delete; // No copy constructor.
     Generator(Generator&&)                 = delete; // No move constructor.
     Generator& operator=(const Generator&) = delete; // No copy assignment.
@@ -46,5 +46,12 @@ public:
      * @return Random double in the range [min, max).
      */
     virtual double float64(double min, double max) const noexcept = 0;
+
+    /**
+     * @brief Seed the random generator, e.g. to make training reproducible.
+     * 
+     * @param[in] value The seed to use.
+     */
+    virtual void seed(std::uint32_t value) const noexcept = 0;
 };
 } // namespace ml::random
@@ -0,0 +1,21 @@
+/**
+ * @brief Scalar type used for all network data.
+ */
+#pragma once
+
+namespace ml
+{
+/**
+ * @brief Scalar type of tensors, weights and activations.
+ *
+ *        Double precision by default. Define ML_FLOAT32 (see the makefile) to build the
+ *        network in single precision, which halves the memory traffic and doubles the number
+ *        of elements per SIMD vector.
+ */
+#ifdef ML_FLOAT32
+using Scalar = float;
+#else
+using Scalar = double;
+#endif
+
+} // namespace ml
@@ -0,0 +1,354 @@
+/**
+ * @brief Contiguous, strided tensor implementation.
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+
+#include "ml/scalar.h"
+
+namespace ml
+{
+/**
+ * @brief Row-major tensor of up to five dimensions.
+ *
+ *        All elements are stored in a single 64-byte aligned block, so whole activation maps
+ *        can be handed to vectorized kernels directly. A tensor either owns its storage or is
+ *        a view, i.e. a non-owning window into memory owned by someone else. Views are created
+ *        via the view(), reshape(), slice() and narrow() methods.
+ *
+ *        Copying a tensor always creates an owning deep copy, while moving a tensor transfers
+ *        the storage (or the view) to the destination.
+ */
+class Tensor
+{
+public:
+    /** Maximum number of dimensions. */
+    static constexpr std::size_t MaxRank{5U};
+
+    /** Alignment of the tensor storage in bytes. */
+    static constexpr std::size_t Alignment{64U};
+
+    /** Tensor shape/stride type. */
+    using Shape = std::array<std::size_t, MaxRank>;
+
+    /**
+     * @brief Create an empty tensor.
+     */
+    Tensor() noexcept;
+
+    /**
+     * @brief Create a tensor of the given shape, initialized with zeros.
+     *
+     * @param[in] shape The tensor shape, for instance {rowCount, colCount}.
+     *
+     * @throw std::invalid_argument If the rank exceeds MaxRank.
+     */
+    Tensor(std::initializer_list<std::size_t> shape);
+
+    /**
+     * @brief Create a tensor of the given shape, initialized with zeros.
+     *
+     * @param[in] shape The tensor shape.
+     * @param[in] rank The number of dimensions. Must be in range [0, MaxRank].
+     *
+     * @throw std::invalid_argument If the rank exceeds MaxRank.
+     */
+    Tensor(const Shape& shape, std::size_t rank);
+
+    /**
+     * @brief Create an owning deep copy of given tensor.
+     *
+     * @param[in] other The tensor to copy.
+     */
+    Tensor(const Tensor& other);
+
+    /**
+     * @brief Move the storage (or view) of given tensor into a new tensor.
+     *
+     * @param[in] other The tensor to move.
+     */
+    Tensor(Tensor&& other) noexcept;
+
+    /**
+     * @brief Destructor.
+     */
+    ~Tensor() noexcept = default;
+
+    /**
+     * @brief Replace the content with an owning deep copy of given tensor.
+     *
+     * @param[in] other The tensor to copy.
+     *
+     * @return Reference to this tensor.
+     */
+    Tensor& operator=(const Tensor& other);
+
+    /**
+     * @brief Move the storage (or view) of given tensor into this tensor.
+     *
+     * @param[in] other The tensor to move.
+     *
+     * @return Reference to this tensor.
+     */
+    Tensor& operator=(Tensor&& other) noexcept;
+
+    /**
+     * @brief Create a non-owning view of existing memory.
+     *
+     * @param[in] data Pointer to the first element. Must outlive the view.
+     * @param[in] shape The shape of the view (row-major, contiguous).
+     *
+     * @return The new view.
+     *
+     * @throw std::invalid_argument If the rank exceeds MaxRank.
+     */
+    static Tensor wrap(Scalar* data, std::initializer_list<std::size_t> shape);
+
+    /**
+     * @brief Create a non-owning view of existing memory.
+     *
+     * @param[in] data Pointer to the first element. Must outlive the view.
+     * @param[in] shape The shape of the view (row-major, contiguous).
+     * @param[in] rank The number of dimensions. Must be in range [0, MaxRank].
+     *
+     * @return The new view.
+     *
+     * @throw std::invalid_argument If the rank exceeds MaxRank.
+     */
+    static Tensor wrap(Scalar* data, const Shape& shape, std::size_t rank);
+
+    /**
+     * @brief Get the number of dimensions.
+     *
+     * @return The number of dimensions.
+     */
+    std::size_t rank() const noexcept { return myRank; }
+
+    /**
+     * @brief Get the total number of elements.
+     *
+     * @return The total number of elements.
+     */
+    std::size_t size() const noexcept { return mySize; }
+
+    /**
+     * @brief Check whether the tensor is empty.
+     *
+     * @return True if the tensor holds no elements, false otherwise.
+     */
+    bool empty() const noexcept { return 0U == mySize; }
+
+    /**
+     * @brief Get the extent of given dimension.
+     *
+     * @param[in] dim The dimension. Dimensions beyond the rank have extent 1.
+     *
+     * @return The extent of the dimension.
+     */
+    std::size_t dim(const std::size_t dim) const noexcept { return myShape[dim]; }
+
+    /**
+     * @brief Get the stride (in elements) of given dimension.
+     *
+     * @param[in] dim The dimension.
+     *
+     * @return The stride of the dimension.
+     */
+    std::size_t stride(const std::size_t dim) const noexcept { return myStrides[dim]; }
+
+    /**
+     * @brief Get the tensor shape.
+     *
+     * @return Array holding the extent of each dimension.
+     */
+    const Shape& shape() const noexcept { return myShape; }
+
+    /**
+     * @brief Check whether the tensor is a view of memory owned elsewhere.
+     *
+     * @return True if the tensor is a view, false if it owns its storage.
+     */
+    bool isView() const noexcept { return nullptr == myStorage; }
+
+    /**
+     * @brief Check whether the elements are stored contiguously in row-major order.
+     *
+     * @return True if the tensor is contiguous, false otherwise.
+     */
+    bool isContiguous() const noexcept;
+
+    /**
+     * @brief Check whether this tensor has the same shape as another tensor.
+     *
+     * @param[in] other The tensor to compare with.
+     *
+     * @return True if the shapes match, false otherwise.
+     */
+    bool sameShape(const Tensor& other) const noexcept;
+
+    /**
+     * @brief Get a pointer to the first element.
+     *
+     * @return Pointer to the first element.
+     */
+    Scalar* data() noexcept { return myData; }
+
+    /**
+     * @brief Get a pointer to the first element.
+     *
+     * @return Pointer to the first element.
+     */
+    const Scalar* data() const noexcept { return myData; }
+
+    /**
+     * @brief Get a pointer to the first element of given row (index of the first dimension).
+     *
+     * @param[in] row The row index.
+     *
+     * @return Pointer to the first element of the row.
+     */
+    Scalar* row(const std::size_t row) noexcept { return myData + row * myStrides[0U]; }
+
+    /**
+     * @brief Get a pointer to the first element of given row (index of the first dimension).
+     *
+     * @param[in] row The row index.
+     *
+     * @return Pointer to the first element of the row.
+     */
+    const Scalar* row(const std::size_t row) const noexcept
+    {
+        return myData + row * myStrides[0U];
+    }
+
+    /** Element access. */
+    Scalar& operator()(const std::size_t i) noexcept { return myData[i * myStrides[0U]]; }
+
+    Scalar operator()(const std::size_t i) const noexcept { return myData[i * myStrides[0U]]; }
+
+    Scalar& operator()(const std::size_t i, const std::size_t j) noexcept
+    {
+        return myData[i * myStrides[0U] + j * myStrides[1U]];
+    }
+
+    Scalar operator()(const std::size_t i, const std::size_t j) const noexcept
+    {
+        return myData[i * myStrides[0U] + j * myStrides[1U]];
+    }
+
+    Scalar& operator()(const std::size_t i, const std::size_t j, const std::size_t k) noexcept
+    {
+        return myData[i * myStrides[0U] + j * myStrides[1U] + k * myStrides[2U]];
+    }
+
+    Scalar operator()(const std::size_t i, const std::size_t j,
+                      const std::size_t k) const noexcept
+    {
+        return myData[i * myStrides[0U] + j * myStrides[1U] + k * myStrides[2U]];
+    }
+
+    /**
+     * @brief Set every element to given value.
+     *
+     * @param[in] value The value to assign.
+     */
+    void fill(Scalar value) noexcept;
+
+    /**
+     * @brief Set every element to zero.
+     */
+    void zero() noexcept { fill(0.0); }
+
+    /**
+     * @brief Copy the elements of another tensor of the same size into this tensor.
+     *
+     *        The storage of this tensor is kept, which makes this method suitable for views.
+     *
+     * @param[in] other The tensor to copy from.
+     *
+     * @return True on success, false on size mismatch.
+     */
+    bool copyFrom(const Tensor& other) noexcept;
+
+    /**
+     * @brief Create a non-owning view of the entire tensor.
+     *
+     * @return The new view.
+     */
+    Tensor view() const noexcept;
+
+    /**
+     * @brief Create a non-owning view of the tensor with a new shape.
+     *
+     * @param[in] shape The new shape. The number of elements must be unchanged.
+     *
+     * @return The new view.
+     *
+     * @throw std::invalid_argument If the tensor isn't contiguous or the sizes mismatch.
+     */
+    Tensor reshape(std::initializer_list<std::size_t> shape) const;
+
+    /**
+     * @brief Create a non-owning view of the index-th subtensor along the first dimension.
+     *
+     *        For instance, slicing a (N, H, W) tensor yields an (H, W) view of one sample.
+     *
+     * @param[in] index Index along the first dimension.
+     *
+     * @return The new view.
+     */
+    Tensor slice(std::size_t index) const noexcept;
+
+    /**
+     * @brief Create a non-owning view of a range of indices along given dimension.
+     *
+     *        For instance, narrowing the columns of a matrix with padded rows yields a view of
+     *        the unpadded part, keeping the row stride.
+     *
+     * @param[in] dim The dimension to narrow.
+     * @param[in] start Index of the first element along the dimension.
+     * @param[in] length Number of elements along the dimension.
+     *
+     * @return The new view.
+     *
+     * @throw std::invalid_argument If the range exceeds the extent of the dimension.
+     */
+    Tensor narrow(std::size_t dim, std::size_t start, std::size_t length) const;
+
+private:
+    /** Deleter for aligned storage. */
+    struct AlignedDelete
+    {
+        void operator()(Scalar* data) const noexcept
+        {
+            ::operator delete[](data, std::align_val_t{Alignment});
+        }
+    };
+
+    void setShape(const Shape& shape, std::size_t rank);
+    void allocate();
+
+    /** Owned storage (nullptr for views). */
+    std::unique_ptr<Scalar[], AlignedDelete> myStorage;
+
+    /** Pointer to the first element. */
+    Scalar* myData;
+
+    /** Extent of each dimension. */
+    Shape myShape;
+
+    /** Stride (in elements) of each dimension. */
+    Shape myStrides;
+
+    /** Number of dimensions. */
+    std::size_t myRank;
+
+    /** Total number of elements. */
+    std::size_t mySize;
+};
+} // namespace ml
@@ -6,12 +6,20 @@
 #include <memory>
 #include <vector>
 
+#include "ml/scalar.h"
+
+/** Tensor type. */
+namespace ml { class Tensor; }
+
 /** Activation function interface. */
 namespace ml::act_func { class Interface; }
 
 /** Convolutional layer interface. */
 namespace ml::conv_layer { class Interface; }
 
+/** Convolution algorithm interface. */
+namespace ml::conv_layer::algorithm { class Interface; }
+
 /** Dense layer interface. */
 namespace ml::dense_layer { class Interface; }
 
@@ -24,20 +32,22 @@ namespace ml::flatten_layer { class Interface; }
 namespace ml
 {
 /** Matrix types. */
-using Matrix1d = std::vector<double>;
+using Matrix1d = std::vector<Scalar>;
 using Matrix2d = std::vector<Matrix1d>;
 using Matrix3d = std::vector<Matrix2d>;
 
 /** Pointer types. */
-using ActFuncPtr      = std::unique_ptr<act_func::Interface>;
-using ConvLayerPtr    = std::unique_ptr<conv_layer::Interface>;
-using DenseLayerPtr   = std::unique_ptr<dense_layer::Interface>;
-using FactoryPtr      = std::unique_ptr<factory::Interface>;
-using FlattenLayerPtr = std::unique_ptr<flatten_layer::Interface>;
+using ActFuncPtr       = std::unique_ptr<act_func::Interface>;
+using ConvAlgorithmPtr = std::unique_ptr<conv_layer::algorithm::Interface>;
+using ConvLayerPtr     = std::unique_ptr<conv_layer::Interface>;
+using DenseLayerPtr    = std::unique_ptr<dense_layer::Interface>;
+using FactoryPtr       = std::unique_ptr<factory::Interface>;
+using FlattenLayerPtr  = std::unique_ptr<flatten_layer::Interface>;
 
 /** List types. */
 using ConvLayerList  = std::vector<ConvLayerPtr>;
 using DenseLayerList = std::vector<DenseLayerPtr>;
+using TensorList     = std::vector<Tensor>;
 using TrainOrderList = std::vector<std::size_t>;
 
 } // namespace ml
@@ -5,106 +5,116 @@
 
 #include <iostream>
 
+#include "ml/tensor.h"
 #include "ml/types.h"
 
 namespace ml
 {
 /**
- * @brief Initialize one-dimensional matrix with zeros.
+ * @brief Check whether given tensor is a square matrix. Print an error message if not.
  * 
- * @param[in] matrix The matrix to initialize.
- */
-void initMatrix(Matrix1d& matrix) noexcept;
-
-/**
- * @brief Initialize two-dimensional matrix with zeros.
+ * @param[in] matrix The tensor to check.
+ * @param[in] opName Operation name (default = none).
  * 
- * @param[in] matrix The matrix to initialize.
+ * @return True if given tensor is a square matrix, false otherwise.
  */
-void initMatrix(Matrix2d& matrix) noexcept;
+bool isMatrixSquare(const Tensor& matrix, const char* opName = nullptr) noexcept;
 
 /**
- * @brief Initialize one-dimensional matrix with zeros.
+ * @brief Print the contents of given tensor.
  * 
- *        Resize the matrix if necessary.
+ *        One-dimensional tensors are printed on a single line, two-dimensional tensors
+ *        row by row. Tensors of higher rank are printed as a list of their slices.
  * 
- * @param[in] matrix The matrix to initialize.
- * @param[in] size The desired size of the matrix.
+ * @param[in] tensor The tensor to print.
+ * @param[in] ostream Output stream (default = terminal print).
+ * @param[in] precision Decimal precision (default = 1 decimal).
  */
-void initMatrix(Matrix1d& matrix, std::size_t size);
+void printMatrix(const Tensor& tensor, std::ostream& ostream = std::cout,
+                 std::size_t precision = 1U) noexcept;
 
 /**
- * @brief Initialize two-dimensional matrix with zeros.
+ * @brief Create a one-dimensional tensor holding the content of given matrix.
  * 
- *        Resize the matrix if necessary.
+ * @param[in] matrix The matrix to convert.
  * 
- * @param[in] matrix The matrix to initialize.
- * @param[in] size The desired size of the matrix.
+ * @return The new tensor.
  */
-void initMatrix(Matrix2d& matrix, std::size_t size);
+Tensor toTensor(const Matrix1d& matrix);
 
 /**
- * @brief Initialize two-dimensional matrix with zeros.
+ * @brief Create a two-dimensional tensor holding the content of given matrix.
+ * 
+ * @param[in] matrix The matrix to convert. All rows must be of the same size.
+ * 
+ * @return The new tensor.
  * 
- * @param[in] matrix The matrix to initialize.
- * @param[in] rowCount The desired row count of the matrix.
- * @param[in] colCount The desired column count of the matrix.
+ * @throw std::invalid_argument If the rows are of different size.
  */
-void initMatrix(Matrix2d& matrix, std::size_t rowCount, std::size_t colCount);
+Tensor toTensor(const Matrix2d& matrix);
 
 /**
- * @brief Check whether given matrix is square. Print an error message if not.
+ * @brief Create a three-dimensional tensor holding the content of given matrix.
  * 
- * @param[in] matrix The matrix to check.
- * @param[in] opName Operation name (default = none).
+ * @param[in] matrix The matrix to convert. All submatrices must be of the same size.
+ * 
+ * @return The new tensor.
  * 
- * @return True if given matrix is square, false otherwise.
+ * @throw std::invalid_argument If the submatrices are of different size.
  */
-bool isMatrixSquare(const Matrix2d& matrix, const char* opName = nullptr) noexcept;
+Tensor toTensor(const Matrix3d& matrix);
 
 /**
- * @brief Check whether given matrix is square. Print an error message if not.
+ * @brief Match dimensions. Print an error message on mismatch.
  * 
- * @param[in] matrix The matrix to check.
- * @param[in] row The row to check.
+ * @param[in] expectedSize Expected size.
+ * @param[in] actualSize Actual size.
  * @param[in] opName Operation name (default = none).
  * 
- * @return True if given matrix is square, false otherwise.
+ * @return True if the dimensions match, false otherwise.
  */
-bool isMatrixSquare(const Matrix2d& matrix, std::size_t row, 
-                    const char* opName = nullptr) noexcept;
+bool matchDimensions(std::size_t expectedSize, std::size_t actualSize, 
+                     const char* opName = nullptr) noexcept;
 
 /**
- * @brief Print the contents of given one-dimensional matrix.
+ * @brief Get the number of samples held by a layer input or gradient tensor.
  * 
- * @param[in] matrix The matrix to print.
- * @param[in] ostream Output stream (default = terminal print).
- * @param[in] precision Decimal precision (default = 1 decimal).
+ *        The tensor holds either a single sample, shaped like one sample of given batch
+ *        storage, or a batch of such samples along its first dimension.
+ * 
+ * @param[in] tensor The tensor to check.
+ * @param[in] storage Batch storage of shape (max batch size, sample dimensions...).
+ * @param[in] opName Operation name, print an error message on mismatch if set (default = none).
+ * 
+ * @return The number of samples, or 0 if the shapes mismatch or the batch doesn't fit in
+ *         the storage.
  */
-void printMatrix(const ml::Matrix1d& matrix, std::ostream& ostream = std::cout,
-                 std::size_t precision = 1U) noexcept;
+std::size_t batchSize(const Tensor& tensor, const Tensor& storage, 
+                      const char* opName = nullptr) noexcept;
 
 /**
- * @brief Print the contents of given two-dimensional matrix.
+ * @brief Create a view of the first samples of given batch storage.
  * 
- * @param[in] matrix The matrix to print.
- * @param[in] ostream Output stream (default = terminal print).
- * @param[in] precision Decimal precision (default = 1 decimal).
+ * @param[in] storage Batch storage of shape (max batch size, sample dimensions...).
+ * @param[in] batchSize The number of samples.
+ * @param[in] batched True to keep the batch dimension, false to view a single sample.
+ * 
+ * @return The new view.
+ * 
+ * @throw std::invalid_argument If the batch size exceeds the max batch size.
  */
-void printMatrix(const ml::Matrix2d& matrix, std::ostream& ostream = std::cout,
-                 std::size_t precision = 1U) noexcept;
+Tensor batchView(const Tensor& storage, std::size_t batchSize, bool batched);
 
 /**
- * @brief Match dimensions. Print an error message on mismatch.
+ * @brief Create a view of one sample of a single sample or batch tensor.
  * 
- * @param[in] expectedSize Expected size.
- * @param[in] actualSize Actual size.
- * @param[in] opName Operation name (default = none).
+ * @param[in] tensor Tensor holding a single sample or a batch of samples.
+ * @param[in] sampleRank The rank of a single sample.
+ * @param[in] index Index of the sample (0 for a single sample).
  * 
- * @return True if the dimensions match, false otherwise.
+ * @return The new view.
  */
-bool matchDimensions(std::size_t expectedSize, std::size_t actualSize, 
-                     const char* opName = nullptr) noexcept;
+Tensor sampleView(const Tensor& tensor, std::size_t sampleRank, std::size_t index) noexcept;
 
 /**
  * @brief Check learning rate. Print an error message if invalid.
@@ -121,7 +131,7 @@ bool checkLearningRate(double learningRate, const char* opName = nullptr) noexce
  * 
  * @return Random value in the range [0.0, 1.0] (inclusive).
  */
-double randomStartVal() noexcept;
+Scalar randomStartVal() noexcept;
 
 /**
  * @brief Create a training order list.
@@ -0,0 +1,174 @@
+/**
+ * @brief Benchmark for the vectorized activation function kernels.
+ *
+ *        Compares the kernels with calling the activation functions once per element via
+ *        act_func::Interface, and measures the error of the tanh approximation and the
+ *        derivatives computed from the outputs.
+ *
+ *        Build and run via `make bench BENCH=activations`.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "ml/act_func/kernel.h"
+#include "ml/act_func/type.h"
+#include "ml/factory/factory.h"
+#include "ml/scalar.h"
+
+namespace
+{
+/** Clock used for the measurements. */
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Get the name of given activation function.
+ *
+ * @param[in] type The activation function type.
+ *
+ * @return The name of the activation function.
+ */
+const char* name(const ml::act_func::Type type) noexcept
+{
+    switch (type)
+    {
+        case ml::act_func::Type::Relu:
+            return "ReLU";
+        case ml::act_func::Type::Tanh:
+            return "Tanh";
+        case ml::act_func::Type::Sigmoid:
+            return "Sigmoid";
+        case ml::act_func::Type::LeakyRelu:
+            return "Leaky ReLU";
+        default:
+            return "None";
+    }
+}
+
+/**
+ * @brief Measure the time of given function, in nanoseconds per element.
+ *
+ * @param[in] elementCount Number of elements processed per call.
+ * @param[in] roundCount Number of calls.
+ * @param[in] function The function to measure.
+ *
+ * @return The time per element in nanoseconds.
+ */
+template <typename Function>
+double measure(const std::size_t elementCount, const std::size_t roundCount, Function&& function)
+{
+    const auto start{Clock::now()};
+    for (std::size_t round{}; round < roundCount; ++round) { function(); }
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count()
+        / (elementCount * roundCount);
+}
+} // namespace
+
+/**
+ * @brief Measure the activation function kernels and check their accuracy.
+ *
+ * @return 0 on success, error code -1 on failure.
+ */
+int main()
+{
+    constexpr std::size_t elementCount{1U << 14U};
+    constexpr std::size_t roundCount{500U};
+    constexpr ml::Scalar range{8};
+
+    // Inputs evenly spread over [-range, range].
+    std::vector<ml::Scalar> inputs(elementCount);
+    std::vector<ml::Scalar> outputs(elementCount);
+    std::vector<ml::Scalar> gradients(elementCount, ml::Scalar{1});
+    std::vector<ml::Scalar> delta(elementCount);
+
+    for (std::size_t i{}; i < elementCount; ++i)
+    {
+        inputs[i] = -range + 2 * range * i / (elementCount - 1U);
+    }
+
+    ml::factory::Factory factory{};
+    double maxDeltaError{};
+
+    for (const auto type : {ml::act_func::Type::Relu, ml::act_func::Type::LeakyRelu,
+                            ml::act_func::Type::Tanh, ml::act_func::Type::Sigmoid})
+    {
+        const auto actFunc{factory.actFunc(type)};
+        const ml::act_func::Kernel kernel{type};
+
+        // Apply the activation function once per element via the interface as reference.
+        const double reference{measure(elementCount, roundCount, [&]
+        {
+            for (std::size_t i{}; i < elementCount; ++i)
+            {
+                outputs[i] = actFunc->output(inputs[i]);
+            }
+        })};
+        const double forward{measure(elementCount, roundCount, [&]
+        {
+            kernel.forward(elementCount, inputs.data(), outputs.data());
+        })};
+        const double backward{measure(elementCount, roundCount, [&]
+        {
+            kernel.backwardFromOutput(elementCount, outputs.data(), gradients.data(),
+                                      delta.data());
+        })};
+
+        // Compare the outputs and the derivatives with the activation function.
+        double outputError{};
+        double deltaError{};
+
+        for (std::size_t i{}; i < elementCount; ++i)
+        {
+            outputError = std::max<double>(outputError,
+                                           std::abs(outputs[i] - actFunc->output(inputs[i])));
+            deltaError = std::max<double>(deltaError,
+                                          std::abs(delta[i] - actFunc->delta(inputs[i])));
+        }
+        maxDeltaError = std::max(maxDeltaError, deltaError);
+
+        std::cout << name(type) << ": interface " << reference << " ns, forward " << forward
+                  << " ns (" << reference / forward << "x), backward " << backward
+                  << " ns per element, max output error " << outputError
+                  << ", max delta error " << deltaError << "\n";
+    }
+
+    // Measure the tanh approximation on its own, also in double precision builds.
+    const double exact{measure(elementCount, roundCount, [&]
+    {
+        for (std::size_t i{}; i < elementCount; ++i) { outputs[i] = std::tanh(inputs[i]); }
+    })};
+    const double fast{measure(elementCount, roundCount, [&]
+    {
+        ml::act_func::fastTanh(elementCount, inputs.data(), outputs.data());
+    })};
+
+    double tanhError{};
+    for (std::size_t i{}; i < elementCount; ++i)
+    {
+        tanhError = std::max<double>(tanhError, std::abs(outputs[i] - std::tanh(inputs[i])));
+    }
+    std::cout << "Fast tanh: std::tanh " << exact << " ns, fast " << fast << " ns ("
+              << exact / fast << "x), max error " << tanhError << "\n";
+
+    // Check that the softmax outputs sum to 1 and that its gradient is zero for uniform
+    // output gradients (the outputs always sum to 1).
+    ml::act_func::softmax(elementCount, inputs.data(), outputs.data());
+    ml::act_func::softmaxBackwardFromOutput(elementCount, outputs.data(), gradients.data(),
+                                            delta.data());
+    double sum{};
+    double maxDelta{};
+
+    for (std::size_t i{}; i < elementCount; ++i)
+    {
+        sum += outputs[i];
+        maxDelta = std::max<double>(maxDelta, std::abs(delta[i]));
+    }
+    std::cout << "Softmax: sum " << sum << ", max delta for uniform gradients " << maxDelta
+              << "\n\n";
+
+    // The derivatives computed from the outputs must match the derivatives of the inputs.
+    constexpr double tolerance{1e-5};
+    return maxDeltaError < tolerance && tanhError < tolerance ? 0 : -1;
+}
@@ -0,0 +1,298 @@
+/**
+ * @brief Benchmark for the vectorized BLAS-like kernels.
+ *
+ *        Runs dot, axpy, gemv (with and without transpose), ger and gemm (every combination
+ *        of transposes) on operands whose sizes and row strides are no multiples of the
+ *        vector widths, once per SIMD level supported by the CPU. Checks that every level
+ *        matches the portable scalar kernels within tolerance, in single and double
+ *        precision, and that the int8 kernels match exactly. Then measures the throughput of
+ *        gemv and gemm per SIMD level.
+ *
+ *        Build and run via `make bench BENCH=blas`.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <type_traits>
+#include <vector>
+
+#include "ml/linalg/blas.h"
+#include "ml/linalg/gemm.h"
+#include "ml/linalg/simd.h"
+#include "ml/random/generator.h"
+#include "ml/scalar.h"
+#include "ml/utils.h"
+
+namespace
+{
+/** Clock used for the measurements. */
+using Clock = std::chrono::steady_clock;
+
+/** Number of rows of the matrices (rows of op(A) for gemm). */
+constexpr std::size_t RowCount{37U};
+
+/** Number of columns of the matrices (columns of op(B) for gemm). */
+constexpr std::size_t ColumnCount{131U};
+
+/** Inner dimension of gemm. */
+constexpr std::size_t InnerCount{67U};
+
+/** Row padding of the matrices, so that the rows don't start at vector boundaries. */
+constexpr std::size_t Padding{3U};
+
+/** Leading dimension of the matrices, large enough for every operand and transpose. */
+constexpr std::size_t Stride{ColumnCount + Padding};
+
+/**
+ * @brief Create a vector of random values in the range [-1, 1].
+ *
+ * @tparam T The element type.
+ *
+ * @param[in] size The number of elements.
+ *
+ * @return The new vector.
+ */
+template <typename T>
+std::vector<T> randomVector(const std::size_t size)
+{
+    std::vector<T> values(size);
+    for (auto& value : values) { value = static_cast<T>(2.0 * ml::randomStartVal() - 1.0); }
+    return values;
+}
+
+/**
+ * @brief Operands of the kernels.
+ *
+ * @tparam T The element type.
+ */
+template <typename T>
+struct Operands
+{
+    /** Vector with ColumnCount elements. */
+    std::vector<T> x{randomVector<T>(ColumnCount)};
+
+    /** Second vector with ColumnCount elements. */
+    std::vector<T> y{randomVector<T>(ColumnCount)};
+
+    /** Vector with RowCount elements. */
+    std::vector<T> z{randomVector<T>(RowCount)};
+
+    /** Matrix with Stride x Stride elements, used as A. */
+    std::vector<T> a{randomVector<T>(Stride * Stride)};
+
+    /** Matrix with Stride x Stride elements, used as B and C. */
+    std::vector<T> b{randomVector<T>(Stride * Stride)};
+};
+
+/**
+ * @brief Run every kernel with the active SIMD level.
+ *
+ * @tparam T The element type. Gemm only runs in the precision of ml::Scalar.
+ *
+ * @param[in] operands The operands of the kernels.
+ *
+ * @return The results of every kernel, one after another.
+ */
+template <typename T>
+std::vector<T> runKernels(const Operands<T>& operands)
+{
+    using ml::linalg::Transpose;
+    constexpr T alpha{static_cast<T>(0.75)};
+    std::vector<T> results{};
+    const auto append{[&](const std::vector<T>& values)
+    {
+        results.insert(results.end(), values.begin(), values.end());
+    }};
+
+    results.push_back(ml::linalg::dot(ColumnCount, operands.x.data(), operands.y.data()));
+
+    std::vector<T> y{operands.y};
+    ml::linalg::axpy(ColumnCount, alpha, operands.x.data(), y.data());
+    append(y);
+
+    std::vector<T> z{operands.z};
+    ml::linalg::gemv(Transpose::No, RowCount, ColumnCount, operands.a.data(), Stride,
+                     operands.x.data(), z.data());
+    append(z);
+
+    y = operands.y;
+    ml::linalg::gemv(Transpose::Yes, RowCount, ColumnCount, operands.a.data(), Stride,
+                     operands.z.data(), y.data());
+    append(y);
+
+    // The rank-1 update must also leave the row padding unchanged.
+    std::vector<T> a{operands.a};
+    ml::linalg::ger(RowCount, ColumnCount, alpha, operands.z.data(), operands.x.data(),
+                    a.data(), Stride);
+    append(a);
+
+    if constexpr (std::is_same_v<T, ml::Scalar>)
+    {
+        for (const Transpose transA : {Transpose::No, Transpose::Yes})
+        {
+            for (const Transpose transB : {Transpose::No, Transpose::Yes})
+            {
+                std::vector<T> c{operands.b};
+                ml::linalg::gemm(transA, transB, RowCount, ColumnCount, InnerCount, alpha,
+                                 operands.a.data(), Stride, operands.b.data(), Stride,
+                                 static_cast<T>(0.5), c.data(), Stride);
+                append(c);
+            }
+        }
+    }
+    return results;
+}
+
+/**
+ * @brief Get the largest relative difference between two result lists.
+ *
+ * @tparam T The element type.
+ *
+ * @param[in] results The results to check.
+ * @param[in] reference The reference results.
+ *
+ * @return The largest difference relative to the magnitude of the reference (at least 1).
+ */
+template <typename T>
+double maxRelativeError(const std::vector<T>& results, const std::vector<T>& reference)
+{
+    double maxError{};
+
+    for (std::size_t i{}; i < reference.size(); ++i)
+    {
+        const double magnitude{std::max(1.0, std::abs(static_cast<double>(reference[i])))};
+        const double error{std::abs(static_cast<double>(results[i]) - reference[i]) / magnitude};
+        maxError = std::max(maxError, error);
+    }
+    return maxError;
+}
+
+/**
+ * @brief Run the int8 kernels with the active SIMD level.
+ *
+ * @return The results of the int8 dot product and axpy, one after another.
+ */
+std::vector<std::int32_t> runInt8Kernels()
+{
+    // Cover the full int8 range with a fixed pattern.
+    std::vector<std::int8_t> x(ColumnCount);
+    std::vector<std::int8_t> y(ColumnCount);
+    for (std::size_t i{}; i < ColumnCount; ++i)
+    {
+        x[i] = static_cast<std::int8_t>((i * 73U + 11U) % 256U - 128U);
+        y[i] = static_cast<std::int8_t>((i * 151U + 5U) % 256U - 128U);
+    }
+
+    std::vector<std::int32_t> results(ColumnCount, 1000);
+    ml::linalg::axpy(ColumnCount, std::int8_t{-77}, x.data(), results.data());
+    results.push_back(ml::linalg::dot(ColumnCount, x.data(), y.data()));
+    return results;
+}
+
+/**
+ * @brief Measure the throughput of gemv and gemm with the active SIMD level.
+ *
+ * @param[out] gemvGflops The gemv throughput in GFLOP/s.
+ * @param[out] gemmGflops The gemm throughput in GFLOP/s.
+ */
+void measure(double& gemvGflops, double& gemmGflops)
+{
+    using ml::linalg::Transpose;
+    constexpr std::size_t size{256U};
+    constexpr std::size_t gemvRounds{2000U};
+    constexpr std::size_t gemmRounds{20U};
+    const std::vector<ml::Scalar> a{randomVector<ml::Scalar>(size * size)};
+    const std::vector<ml::Scalar> b{randomVector<ml::Scalar>(size * size)};
+    std::vector<ml::Scalar> c(size * size);
+    std::vector<ml::Scalar> y(size);
+
+    auto start{Clock::now()};
+    for (std::size_t round{}; round < gemvRounds; ++round)
+    {
+        ml::linalg::gemv(Transpose::No, size, size, a.data(), size, b.data(), y.data());
+    }
+    gemvGflops = 2.0 * size * size * gemvRounds
+        / std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    start = Clock::now();
+    for (std::size_t round{}; round < gemmRounds; ++round)
+    {
+        ml::linalg::gemm(Transpose::No, Transpose::No, size, size, size, 1.0, a.data(), size,
+                         b.data(), size, 0.0, c.data(), size);
+    }
+    gemmGflops = 2.0 * size * size * size * gemmRounds
+        / std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+} // namespace
+
+/**
+ * @brief Compare the kernels of every supported SIMD level with the scalar kernels.
+ *
+ * @return 0 on success, error code -1 on failure.
+ */
+int main()
+{
+    using ml::linalg::SimdLevel;
+    constexpr double floatTolerance{1e-5};
+    constexpr double doubleTolerance{1e-12};
+    ml::random::Generator::getInstance().seed(42U);
+
+    const Operands<float> floatOperands{};
+    const Operands<double> doubleOperands{};
+    const SimdLevel level{ml::linalg::simdLevel()};
+    const SimdLevel maxLevel{ml::linalg::detectSimdLevel()};
+
+    // Compute the reference results with the portable scalar kernels.
+    ml::linalg::setSimdLevel(SimdLevel::Scalar);
+    const std::vector<float> floatReference{runKernels(floatOperands)};
+    const std::vector<double> doubleReference{runKernels(doubleOperands)};
+    const std::vector<std::int32_t> int8Reference{runInt8Kernels()};
+    bool success{true};
+
+    std::cout << std::scientific << std::setprecision(2);
+    std::cout << "Max relative error against the scalar kernels (float / double / int8):\n";
+
+    for (auto l{static_cast<std::uint8_t>(SimdLevel::Sse2)};
+         l <= static_cast<std::uint8_t>(maxLevel); ++l)
+    {
+        ml::linalg::setSimdLevel(static_cast<SimdLevel>(l));
+        const double floatError{maxRelativeError(runKernels(floatOperands), floatReference)};
+        const double doubleError{maxRelativeError(runKernels(doubleOperands), doubleReference)};
+        const bool int8Exact{runInt8Kernels() == int8Reference};
+        const bool match{(floatError <= floatTolerance) && (doubleError <= doubleTolerance)
+                         && int8Exact};
+        success &= match;
+
+        std::cout << "  " << std::setw(7) << ml::linalg::simdLevelName(static_cast<SimdLevel>(l))
+                  << ": " << floatError << " / " << doubleError << " / "
+                  << (int8Exact ? "exact" : "MISMATCH") << (match ? "" : " (too large!)")
+                  << "\n";
+    }
+
+    // Measure the throughput per SIMD level.
+    std::cout << std::fixed << "\n256x256 operands: GFLOP/s (gemv / gemm)\n";
+
+    for (auto l{static_cast<std::uint8_t>(SimdLevel::Scalar)};
+         l <= static_cast<std::uint8_t>(maxLevel); ++l)
+    {
+        ml::linalg::setSimdLevel(static_cast<SimdLevel>(l));
+        double gemvGflops{};
+        double gemmGflops{};
+        measure(gemvGflops, gemmGflops);
+        std::cout << "  " << std::setw(7) << ml::linalg::simdLevelName(static_cast<SimdLevel>(l))
+                  << ": " << std::setw(7) << gemvGflops << " / " << std::setw(7) << gemmGflops
+                  << "\n";
+    }
+    ml::linalg::setSimdLevel(level);
+
+    // Return -1 if any SIMD level doesn't match the scalar kernels.
+    if (!success)
+    {
+        std::cerr << "The vectorized kernels don't match the scalar kernels!\n";
+        return -1;
+    }
+    return 0;
+}
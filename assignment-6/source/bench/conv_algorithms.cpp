@@ -0,0 +1,405 @@
+/**
+ * @brief Benchmark for the convolution algorithms.
+ *
+ *        Compares every convolution algorithm (im2col, Winograd F(2x2, 3x3) and F(4x4, 3x3),
+ *        FFT) with direct convolution: the output, the kernel gradients and the input
+ *        gradients, for input sizes that are no whole number of tiles. Then checks that the
+ *        cached kernel transforms are dropped, both when the algorithm is invalidated with a
+ *        new kernel and when a convolutional layer is optimized, by comparing a layer using
+ *        each algorithm with a layer using direct convolution over two training steps.
+ *        Finally measures the time per feedforward and backpropagation of each algorithm and
+ *        its speedup over direct convolution, and fails unless Winograd is the faster one.
+ *        The automatically selected algorithm is measured for every kernel size, and must be
+ *        faster than direct convolution wherever it selects another algorithm.
+ *
+ *        Build and run via `make bench BENCH=conv_algorithms`.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+#include "ml/act_func/type.h"
+#include "ml/conv_layer/algorithm/direct.h"
+#include "ml/conv_layer/algorithm/fft.h"
+#include "ml/conv_layer/algorithm/im2col.h"
+#include "ml/conv_layer/algorithm/interface.h"
+#include "ml/conv_layer/algorithm/type.h"
+#include "ml/conv_layer/algorithm/winograd.h"
+#include "ml/conv_layer/conv.h"
+#include "ml/factory/factory.h"
+#include "ml/random/generator.h"
+#include "ml/scalar.h"
+#include "ml/tensor.h"
+#include "ml/types.h"
+#include "ml/utils.h"
+
+namespace
+{
+/** Clock used for the measurements. */
+using Clock = std::chrono::steady_clock;
+
+/** Algorithm type. */
+using Type = ml::conv_layer::algorithm::Type;
+
+/**
+ * @brief Test case, i.e. an algorithm with given input and kernel size.
+ */
+struct Case
+{
+    /** The algorithm to compare with direct convolution. */
+    Type type;
+
+    /** The name of the algorithm. */
+    const char* name;
+
+    /** Input size. */
+    std::size_t inputSize;
+
+    /** Kernel size. */
+    std::size_t kernelSize;
+};
+
+/**
+ * @brief Fill given tensor with random values in the range [-1, 1].
+ *
+ * @param[in] tensor The tensor to fill.
+ */
+void randomize(ml::Tensor& tensor) noexcept
+{
+    for (std::size_t i{}; i < tensor.size(); ++i)
+    {
+        tensor.data()[i] = 2.0 * ml::randomStartVal() - 1.0;
+    }
+}
+
+/**
+ * @brief Get the largest difference between two tensors, relative to the reference.
+ *
+ * @param[in] tensor The tensor to check.
+ * @param[in] reference The reference tensor.
+ *
+ * @return The largest difference relative to the largest magnitude of the reference.
+ */
+double relativeError(const ml::Tensor& tensor, const ml::Tensor& reference) noexcept
+{
+    double maxDiff{};
+    double maxMagnitude{};
+
+    for (std::size_t i{}; i < reference.size(); ++i)
+    {
+        const double diff{std::abs(static_cast<double>(tensor.data()[i]) - reference.data()[i])};
+        maxDiff      = std::max(maxDiff, diff);
+        maxMagnitude = std::max(maxMagnitude, std::abs(static_cast<double>(reference.data()[i])));
+    }
+    return maxDiff / std::max(maxMagnitude, 1e-30);
+}
+
+/**
+ * @brief Errors of an algorithm compared with direct convolution.
+ */
+struct Errors
+{
+    /** Relative error of the output. */
+    double output;
+
+    /** Relative error of the kernel gradients. */
+    double kernelGradients;
+
+    /** Relative error of the input gradients. */
+    double inputGradients;
+
+    /** Relative error after the cached kernel data has been dropped. */
+    double invalidated;
+
+    /**
+     * @brief Get the largest error.
+     *
+     * @return The largest error.
+     */
+    double max() const noexcept
+    {
+        return std::max({output, kernelGradients, inputGradients, invalidated});
+    }
+};
+
+/**
+ * @brief Run feedforward and backpropagation with given algorithm.
+ *
+ * @param[in] algorithm The algorithm.
+ * @param[in] input The input.
+ * @param[in] kernel The kernel.
+ * @param[in] delta The output deltas.
+ * @param[out] output The output.
+ * @param[out] kernelGradients The kernel gradients.
+ * @param[out] inputGradients The input gradients.
+ */
+void run(ml::conv_layer::algorithm::Interface& algorithm, const ml::Tensor& input,
+         const ml::Tensor& kernel, const ml::Tensor& delta, ml::Tensor& output,
+         ml::Tensor& kernelGradients, ml::Tensor& inputGradients) noexcept
+{
+    algorithm.feedforward(input, kernel, 0.25, output);
+    algorithm.backpropagate(input, delta, kernel, kernelGradients, inputGradients);
+}
+
+/**
+ * @brief Compare an algorithm with direct convolution.
+ *
+ *        The algorithm is first run with one kernel, then invalidated and run with another
+ *        kernel, which must not use the cached transforms of the first kernel.
+ *
+ * @param[in] testCase The test case.
+ *
+ * @return The errors of the algorithm.
+ */
+Errors compareAlgorithm(const Case& testCase)
+{
+    ml::factory::Factory factory{};
+    const std::size_t n{testCase.inputSize};
+    const std::size_t k{testCase.kernelSize};
+    auto direct{factory.convAlgorithm(Type::Direct, n, k)};
+    auto algorithm{factory.convAlgorithm(testCase.type, n, k)};
+
+    ml::Tensor input{n, n};
+    ml::Tensor delta{n, n};
+    ml::Tensor kernel{k, k};
+    randomize(input);
+    randomize(delta);
+    randomize(kernel);
+
+    ml::Tensor output{n, n}, kernelGradients{k, k}, inputGradients{n, n};
+    ml::Tensor refOutput{n, n}, refKernelGradients{k, k}, refInputGradients{n, n};
+    run(*direct, input, kernel, delta, refOutput, refKernelGradients, refInputGradients);
+    run(*algorithm, input, kernel, delta, output, kernelGradients, inputGradients);
+
+    Errors errors{relativeError(output, refOutput),
+                  relativeError(kernelGradients, refKernelGradients),
+                  relativeError(inputGradients, refInputGradients), 0.0};
+
+    // Use another kernel, the algorithm must drop the transforms of the old one.
+    randomize(kernel);
+    algorithm->invalidate();
+    run(*direct, input, kernel, delta, refOutput, refKernelGradients, refInputGradients);
+    run(*algorithm, input, kernel, delta, output, kernelGradients, inputGradients);
+    errors.invalidated = std::max(relativeError(output, refOutput),
+                                  relativeError(inputGradients, refInputGradients));
+    return errors;
+}
+
+/**
+ * @brief Compare a layer using given algorithm with a layer using direct convolution.
+ *
+ *        Both layers start with the same parameters and take two training steps. The
+ *        outputs and input gradients after the first step are only correct if the layer
+ *        drops the cached kernel transforms in optimize().
+ *
+ * @param[in] testCase The test case.
+ *
+ * @return The largest relative error of the outputs and input gradients.
+ */
+double compareLayer(const Case& testCase)
+{
+    constexpr double learningRate{0.1};
+    const std::size_t n{testCase.inputSize};
+    ml::conv_layer::ConvLayer direct{n, testCase.kernelSize, ml::act_func::Type::Tanh,
+                                     Type::Direct};
+    ml::conv_layer::ConvLayer layer{n, testCase.kernelSize, ml::act_func::Type::Tanh,
+                                    testCase.type};
+
+    // Let both layers start with the same parameters.
+    ml::TensorList source{direct.parameters()};
+    ml::TensorList destination{layer.parameters()};
+    for (std::size_t i{}; i < source.size(); ++i) { destination[i].copyFrom(source[i]); }
+    layer.invalidateParameters();
+
+    ml::Tensor input{n, n};
+    ml::Tensor outputGradients{n, n};
+    randomize(input);
+    randomize(outputGradients);
+    double maxError{};
+
+    for (std::size_t step{}; step < 2U; ++step)
+    {
+        direct.feedforward(input);
+        layer.feedforward(input);
+        direct.backpropagate(outputGradients);
+        layer.backpropagate(outputGradients);
+        maxError = std::max({maxError, relativeError(layer.output(), direct.output()),
+                             relativeError(layer.inputGradients(), direct.inputGradients())});
+        direct.optimize(learningRate);
+        layer.optimize(learningRate);
+    }
+    return maxError;
+}
+
+/**
+ * @brief Get the name of given algorithm.
+ *
+ * @param[in] algorithm The algorithm.
+ *
+ * @return The name of the algorithm.
+ */
+const char* name(const ml::conv_layer::algorithm::Interface& algorithm) noexcept
+{
+    using namespace ml::conv_layer::algorithm;
+    if (nullptr != dynamic_cast<const Im2col*>(&algorithm)) { return "im2col"; }
+    if (nullptr != dynamic_cast<const Winograd2x2*>(&algorithm)) { return "winograd2x2"; }
+    if (nullptr != dynamic_cast<const Winograd4x4*>(&algorithm)) { return "winograd4x4"; }
+    if (nullptr != dynamic_cast<const Fft*>(&algorithm)) { return "fft"; }
+    return "direct";
+}
+
+/**
+ * @brief Measure the time per feedforward and backpropagation of given algorithm.
+ *
+ *        The rounds are run in several repetitions, of which the fastest is used to suppress
+ *        noise from other processes.
+ *
+ * @param[in] type The algorithm.
+ * @param[in] inputSize The input size.
+ * @param[in] kernelSize The kernel size.
+ *
+ * @return The time per feedforward and backpropagation in microseconds.
+ */
+double measure(const Type type, const std::size_t inputSize, const std::size_t kernelSize)
+{
+    constexpr std::size_t repetitionCount{4U};
+    constexpr std::size_t roundCount{50U};
+    ml::factory::Factory factory{};
+    auto algorithm{factory.convAlgorithm(type, inputSize, kernelSize)};
+    ml::Tensor input{inputSize, inputSize}, delta{inputSize, inputSize};
+    ml::Tensor kernel{kernelSize, kernelSize}, kernelGradients{kernelSize, kernelSize};
+    ml::Tensor output{inputSize, inputSize}, inputGradients{inputSize, inputSize};
+    randomize(input);
+    randomize(delta);
+    randomize(kernel);
+
+    double minTime{};
+    for (std::size_t repetition{}; repetition < repetitionCount; ++repetition)
+    {
+        const auto start{Clock::now()};
+        for (std::size_t round{}; round < roundCount; ++round)
+        {
+            run(*algorithm, input, kernel, delta, output, kernelGradients, inputGradients);
+        }
+        const double time{std::chrono::duration<double, std::micro>(Clock::now() - start).count()
+            / roundCount};
+        minTime = (0U == repetition) ? time : std::min(minTime, time);
+    }
+    return minTime;
+}
+} // namespace
+
+/**
+ * @brief Compare every convolution algorithm with direct convolution.
+ *
+ * @return 0 on success, error code -1 on failure.
+ */
+int main()
+{
+    const double tolerance{sizeof(ml::Scalar) == sizeof(float) ? 1e-3 : 1e-9};
+    ml::random::Generator::getInstance().seed(42U);
+
+    const std::vector<Case> cases{
+        {Type::Im2col, "im2col", 13U, 3U},      {Type::Im2col, "im2col", 16U, 5U},
+        {Type::Winograd2x2, "winograd2x2", 13U, 3U}, {Type::Winograd2x2, "winograd2x2", 16U, 3U},
+        {Type::Winograd4x4, "winograd4x4", 13U, 3U}, {Type::Winograd4x4, "winograd4x4", 16U, 3U},
+        {Type::Fft, "fft", 13U, 3U},            {Type::Fft, "fft", 16U, 5U},
+        {Type::Fft, "fft", 20U, 7U},
+    };
+    bool success{true};
+
+    std::cout << std::scientific << std::setprecision(2);
+    std::cout << "Relative error against direct convolution (output / kernel gradients / "
+              << "input gradients / new kernel / layer after optimize):\n";
+
+    for (const auto& testCase : cases)
+    {
+        const Errors errors{compareAlgorithm(testCase)};
+        const double layerError{compareLayer(testCase)};
+        const bool match{(errors.max() <= tolerance) && (layerError <= tolerance)};
+        success &= match;
+
+        std::cout << "  " << std::setw(11) << testCase.name << ", " << std::setw(2)
+                  << testCase.inputSize << "x" << testCase.inputSize << ", kernel "
+                  << testCase.kernelSize << ": " << errors.output << " / "
+                  << errors.kernelGradients << " / " << errors.inputGradients << " / "
+                  << errors.invalidated << " / " << layerError << (match ? "" : " (too large!)")
+                  << "\n";
+    }
+
+    // Measure the time per feedforward and backpropagation of a 64x64 input, and the speedup
+    // compared with direct convolution.
+    constexpr std::size_t size{64U};
+    const double direct3{measure(Type::Direct, size, 3U)};
+    const double direct7{measure(Type::Direct, size, 7U)};
+    bool winogradFaster{true};
+    std::cout << std::fixed << "\n" << size << "x" << size << ", microseconds per "
+              << "feedforward and backpropagation (speedup over direct), kernel 3 / kernel 7:\n";
+
+    for (const auto& [type, name] : {std::pair{Type::Direct, "direct"},
+                                     std::pair{Type::Im2col, "im2col"},
+                                     std::pair{Type::Winograd2x2, "winograd2x2"},
+                                     std::pair{Type::Winograd4x4, "winograd4x4"},
+                                     std::pair{Type::Fft, "fft"}})
+    {
+        const bool winograd{(Type::Winograd2x2 == type) || (Type::Winograd4x4 == type)};
+        const double time3{Type::Direct == type ? direct3 : measure(type, size, 3U)};
+        std::cout << "  " << std::setw(11) << name << ": " << std::setw(8) << time3 << " ("
+                  << std::setw(4) << direct3 / time3 << "x) / ";
+        winogradFaster &= !winograd || (time3 < direct3);
+
+        if (winograd) { std::cout << std::setw(8) << "-" << "\n"; }
+        else
+        {
+            const double time7{Type::Direct == type ? direct7 : measure(type, size, 7U)};
+            std::cout << std::setw(8) << time7 << " (" << std::setw(4) << direct7 / time7
+                      << "x)\n";
+        }
+    }
+
+    // Measure the automatically selected algorithm for every kernel size.
+    ml::factory::Factory factory{};
+    bool autoFaster{true};
+
+    for (const std::size_t autoSize : {28U, 64U})
+    {
+        std::cout << "\n" << autoSize << "x" << autoSize << ", microseconds per feedforward "
+                  << "and backpropagation, direct / auto (selected algorithm):\n";
+
+        for (std::size_t kernelSize{1U}; kernelSize <= 11U; ++kernelSize)
+        {
+            const auto algorithm{factory.convAlgorithm(Type::Auto, autoSize, kernelSize)};
+            const char* selected{name(*algorithm)};
+            const double direct{measure(Type::Direct, autoSize, kernelSize)};
+            const double automatic{measure(Type::Auto, autoSize, kernelSize)};
+            std::cout << "  kernel " << std::setw(2) << kernelSize << ": " << std::setw(8)
+                      << direct << " / " << std::setw(8) << automatic << " (" << selected
+                      << ")\n";
+
+            // Another algorithm is only selected where it beats direct convolution.
+            autoFaster &= (std::string_view{"direct"} == selected) || (automatic < direct);
+        }
+    }
+
+    // Return -1 if any algorithm doesn't match direct convolution or Winograd is slower.
+    if (!success)
+    {
+        std::cerr << "A convolution algorithm doesn't match direct convolution!\n";
+        return -1;
+    }
+    else if (!winogradFaster)
+    {
+        std::cerr << "Winograd convolution is slower than direct convolution!\n";
+        return -1;
+    }
+    else if (!autoFaster)
+    {
+        std::cerr << "The automatically selected algorithm is slower than direct convolution!\n";
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,276 @@
+/**
+ * @brief Benchmark for memory-mapped datasets.
+ *
+ *        Writes a synthetic MNIST-sized dataset as IDX and raw files, then compares parsing
+ *        the files into tensors with mapping them as datasets: the startup time, the memory
+ *        held and the training time. Checks that the mapped datasets decode every sample
+ *        exactly like the parsed tensors, and that training on a mapped dataset gives the
+ *        same network as training on the tensors.
+ *
+ *        Build and run via `make bench BENCH=dataset`.
+ */
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ml/cnn/cnn.h"
+#include "ml/dataset/format.h"
+#include "ml/dataset/mapped_dataset.h"
+#include "ml/factory/factory.h"
+#include "ml/random/generator.h"
+#include "ml/scalar.h"
+#include "ml/tensor.h"
+
+namespace
+{
+/** Clock used for the measurements. */
+using Clock = std::chrono::steady_clock;
+
+/** Number of samples in the dataset. */
+constexpr std::size_t SampleCount{12000U};
+
+/** Height and width of the images. */
+constexpr std::size_t ImageSize{28U};
+
+/** Number of classes. */
+constexpr std::size_t ClassCount{10U};
+
+/**
+ * @brief Get the number of milliseconds since given start time.
+ *
+ * @param[in] start The start time.
+ *
+ * @return The elapsed time in milliseconds.
+ */
+double elapsedMs(const Clock::time_point start) noexcept
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/**
+ * @brief Write a big-endian 32-bit integer.
+ *
+ * @param[in] file The file to write to.
+ * @param[in] value The value to write.
+ */
+void writeBigEndian(std::ofstream& file, const std::uint32_t value)
+{
+    const char bytes[]{static_cast<char>(value >> 24U), static_cast<char>(value >> 16U),
+                       static_cast<char>(value >> 8U), static_cast<char>(value)};
+    file.write(bytes, sizeof(bytes));
+}
+
+/**
+ * @brief Write a synthetic dataset, where the class of each image is given by the row of a
+ *        bright band on a noisy background.
+ *
+ * @param[in] directory Directory in which to write the IDX and raw files.
+ */
+void writeDataset(const std::filesystem::path& directory)
+{
+    std::vector<std::uint8_t> images(SampleCount * ImageSize * ImageSize);
+    std::vector<std::uint8_t> labels(SampleCount);
+    auto& generator{ml::random::Generator::getInstance()};
+
+    for (std::size_t i{}; i < SampleCount; ++i)
+    {
+        labels[i] = static_cast<std::uint8_t>(generator.uint32(ClassCount));
+        const std::size_t band{2U + labels[i] * 2U};
+
+        for (std::size_t y{}; y < ImageSize; ++y)
+        {
+            for (std::size_t x{}; x < ImageSize; ++x)
+            {
+                const bool bright{(band <= y) && (y < band + 3U)};
+                images[(i * ImageSize + y) * ImageSize + x] =
+                    static_cast<std::uint8_t>((bright ? 160U : 0U) + generator.uint32(96U));
+            }
+        }
+    }
+
+    std::ofstream idxImages{directory / "images.idx", std::ios::binary};
+    std::ofstream idxLabels{directory / "labels.idx", std::ios::binary};
+    writeBigEndian(idxImages, 0x00000803U);
+    for (const std::size_t dim : {SampleCount, ImageSize, ImageSize}) { writeBigEndian(idxImages, dim); }
+    writeBigEndian(idxLabels, 0x00000801U);
+    writeBigEndian(idxLabels, SampleCount);
+
+    for (auto* file : {&idxImages, &idxLabels})
+    {
+        const auto& data{file == &idxImages ? images : labels};
+        file->write(reinterpret_cast<const char*>(data.data()), data.size());
+    }
+    std::ofstream{directory / "images.raw", std::ios::binary}.write(
+        reinterpret_cast<const char*>(images.data()), images.size());
+    std::ofstream{directory / "labels.raw", std::ios::binary}.write(
+        reinterpret_cast<const char*>(labels.data()), labels.size());
+}
+
+/**
+ * @brief Parse the IDX files into tensors, as needed without a dataset.
+ *
+ * @param[in] directory Directory holding the IDX files.
+ * @param[out] inputs Tensor in which to store the normalized images.
+ * @param[out] targets Tensor in which to store the one-hot encoded labels.
+ */
+void parseDataset(const std::filesystem::path& directory, ml::Tensor& inputs,
+                  ml::Tensor& targets)
+{
+    std::ifstream images{directory / "images.idx", std::ios::binary};
+    std::ifstream labels{directory / "labels.idx", std::ios::binary};
+    images.seekg(16);
+    labels.seekg(8);
+    inputs  = ml::Tensor{SampleCount, ImageSize, ImageSize};
+    targets = ml::Tensor{SampleCount, ClassCount};
+    std::vector<std::uint8_t> image(ImageSize * ImageSize);
+
+    for (std::size_t i{}; i < SampleCount; ++i)
+    {
+        images.read(reinterpret_cast<char*>(image.data()), image.size());
+        for (std::size_t j{}; j < image.size(); ++j)
+        {
+            inputs.data()[i * image.size() + j] = image[j] * static_cast<ml::Scalar>(1.0 / 255.0);
+        }
+        targets(i, static_cast<std::size_t>(labels.get())) = ml::Scalar{1};
+    }
+}
+
+/**
+ * @brief Check that a dataset decodes every sample exactly like the parsed tensors.
+ *
+ * @param[in] dataset The dataset to check.
+ * @param[in] inputs The parsed images.
+ * @param[in] targets The parsed labels.
+ *
+ * @return True if every sample matches, else false.
+ */
+bool matches(const ml::dataset::Interface& dataset, const ml::Tensor& inputs,
+             const ml::Tensor& targets)
+{
+    ml::Tensor input{ImageSize, ImageSize};
+    ml::Tensor target{ClassCount};
+    if (SampleCount != dataset.sampleCount()) { return false; }
+
+    for (std::size_t i{}; i < SampleCount; ++i)
+    {
+        dataset.load(i, input, target);
+        const ml::Tensor expectedInput{inputs.slice(i)};
+        const ml::Tensor expectedTarget{targets.slice(i)};
+
+        for (std::size_t j{}; j < input.size(); ++j)
+        {
+            if (input.data()[j] != expectedInput.data()[j]) { return false; }
+        }
+        for (std::size_t j{}; j < target.size(); ++j)
+        {
+            if (target.data()[j] != expectedTarget.data()[j]) { return false; }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Train a network with fixed initial weights and training order.
+ *
+ * @param[in] train Function training the network.
+ * @param[in] inputs Inputs to predict after training.
+ * @param[out] outputs Tensor in which to store the predictions.
+ *
+ * @return The training time in milliseconds.
+ */
+template <typename TrainFunc>
+double trainNetwork(const TrainFunc& train, const ml::Tensor& inputs, ml::Tensor& outputs)
+{
+    ml::random::Generator::getInstance().seed(42U);
+    ml::factory::Factory factory{};
+    ml::cnn::Cnn cnn{factory, ImageSize, {{8U, 3U, ml::act_func::Type::Relu, 2U}}, ClassCount,
+                     ml::act_func::Type::Sigmoid};
+
+    const auto start{Clock::now()};
+    train(cnn);
+    const double trainMs{elapsedMs(start)};
+
+    outputs = ml::Tensor{inputs.dim(0U), ClassCount};
+    cnn.predictBatch(inputs, outputs, inputs.dim(0U));
+    return trainMs;
+}
+} // namespace
+
+/**
+ * @brief Compare parsed tensors with memory-mapped datasets.
+ *
+ * @return 0 on success, error code -1 on failure.
+ */
+int main()
+{
+    constexpr double kib{1024.0};
+    constexpr std::size_t batchSize{32U};
+    constexpr double learningRate{0.1};
+    const auto directory{std::filesystem::temp_directory_path() / "ml_dataset_bench"};
+    std::filesystem::create_directories(directory);
+    writeDataset(directory);
+
+    // Compare the startup time and the memory held.
+    ml::Tensor inputs{};
+    ml::Tensor targets{};
+    auto start{Clock::now()};
+    parseDataset(directory, inputs, targets);
+    const double parseMs{elapsedMs(start)};
+
+    start = Clock::now();
+    const ml::dataset::MappedDataset idx{(directory / "images.idx").string(),
+                                         (directory / "labels.idx").string(), ClassCount};
+    const double mapMs{elapsedMs(start)};
+    const ml::dataset::MappedDataset raw{(directory / "images.raw").string(),
+                                         (directory / "labels.raw").string(), ClassCount,
+                                         ml::dataset::Format::Raw};
+
+    const double tensorKib{(inputs.size() + targets.size()) * sizeof(ml::Scalar) / kib};
+    const double fileKib{(SampleCount * (ImageSize * ImageSize + 1U)) / kib};
+    std::cout << std::fixed << std::setprecision(2) << SampleCount << " samples, " << ImageSize
+              << "x" << ImageSize << ":\n"
+              << "  Parsed tensors: " << std::setw(8) << parseMs << " ms, " << std::setw(9)
+              << tensorKib << " KiB held\n"
+              << "  Mapped dataset: " << std::setw(8) << mapMs << " ms, " << std::setw(9)
+              << fileKib << " KiB mapped (page cache, shared)\n";
+
+    // Check the decoded samples.
+    bool success{matches(idx, inputs, targets) && matches(raw, inputs, targets)};
+    std::cout << "  Decoded samples: " << (success ? "identical" : "MISMATCH") << "\n";
+
+    // Train on the tensors and on the dataset with the same weights and training order.
+    const ml::Tensor testInputs{inputs.narrow(0U, 0U, 256U)};
+    ml::Tensor tensorOutputs{};
+    ml::Tensor datasetOutputs{};
+    const double tensorMs{trainNetwork([&](ml::cnn::Cnn& cnn)
+    {
+        cnn.train(inputs, targets, 1U, learningRate, batchSize);
+    }, testInputs, tensorOutputs)};
+    const double datasetMs{trainNetwork([&](ml::cnn::Cnn& cnn)
+    {
+        cnn.train(idx, 1U, learningRate, batchSize);
+    }, testInputs, datasetOutputs)};
+
+    bool trained{true};
+    for (std::size_t i{}; i < tensorOutputs.size(); ++i)
+    {
+        trained &= tensorOutputs.data()[i] == datasetOutputs.data()[i];
+    }
+    std::cout << "  Training one epoch: " << tensorMs << " ms (tensors), " << datasetMs
+              << " ms (dataset), " << (trained ? "identical networks" : "MISMATCH") << "\n";
+    std::filesystem::remove_all(directory);
+
+    // Return -1 if the dataset doesn't match the tensors.
+    if (!success || !trained)
+    {
+        std::cerr << "The mapped dataset doesn't match the parsed tensors!\n";
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,126 @@
+/**
+ * @brief Benchmark for the flatten layer.
+ *
+ *        Checks that the flatten layer views the conv output and the dense input gradients
+ *        instead of copying them, and compares its time per batch with flattening and
+ *        unflattening by copy.
+ *
+ *        Build and run via `make bench BENCH=flatten`.
+ */
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+#include "ml/conv_layer/layout.h"
+#include "ml/flatten_layer/flatten.h"
+#include "ml/random/generator.h"
+#include "ml/scalar.h"
+#include "ml/tensor.h"
+
+namespace
+{
+/** Clock used for the measurements. */
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Fill given tensor with random values in range [-1, 1].
+ *
+ * @param[in] tensor The tensor to fill.
+ */
+void randomize(ml::Tensor& tensor)
+{
+    auto& generator{ml::random::Generator::getInstance()};
+    for (std::size_t i{}; i < tensor.size(); ++i)
+    {
+        tensor.data()[i] = static_cast<ml::Scalar>(generator.float64(-1.0, 1.0));
+    }
+}
+
+/**
+ * @brief Measure the time of a flatten and unflatten pass.
+ *
+ * @param[in] pass The pass to measure.
+ *
+ * @return The time per pass in microseconds.
+ */
+template <typename Pass>
+double passTime(const Pass& pass)
+{
+    constexpr double minSeconds{0.2};
+    std::size_t roundCount{};
+    const auto start{Clock::now()};
+    double seconds{};
+
+    while (seconds < minSeconds)
+    {
+        pass();
+        ++roundCount;
+        seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+    return seconds / roundCount * 1e6;
+}
+} // namespace
+
+/**
+ * @brief Check the flatten layer and compare it with flattening by copy.
+ *
+ * @return 0 on success, error code -1 on failure.
+ */
+int main()
+{
+    constexpr std::size_t batchSize{32U};
+    constexpr std::size_t channelCount{4U * ml::conv_layer::ChannelBlock};
+    constexpr std::size_t size{14U};
+    constexpr std::size_t outputSize{channelCount * size * size};
+    ml::random::Generator::getInstance().seed(42U);
+
+    // The conv output and the dense input gradients, as they are laid out in the layers.
+    ml::Tensor convOutput{ml::conv_layer::featureMaps(batchSize, channelCount, size)};
+    ml::Tensor denseInputGradients{batchSize, outputSize};
+    randomize(convOutput);
+    randomize(denseInputGradients);
+
+    ml::flatten_layer::FlattenLayer layer{size, channelCount};
+    layer.setMaxBatchSize(batchSize);
+    layer.feedforward(convOutput);
+    layer.backpropagate(denseInputGradients);
+
+    // The output must be the conv output and the input gradients the dense input gradients.
+    const bool outputShared{(layer.output().data() == convOutput.data())
+        && (layer.output().dim(1U) == outputSize)};
+    const bool gradientsShared{(layer.inputGradients().data() == denseInputGradients.data())
+        && layer.inputGradients().sameShape(convOutput)};
+
+    // Flatten and unflatten the same batch by copy, as buffers owned by the layer would.
+    ml::Tensor flattened{batchSize, outputSize};
+    ml::Tensor unflattened{ml::conv_layer::featureMaps(batchSize, channelCount, size)};
+    const double copyTime{passTime([&]()
+    {
+        flattened.copyFrom(convOutput);
+        unflattened.copyFrom(denseInputGradients);
+    })};
+    const double viewTime{passTime([&]()
+    {
+        layer.feedforward(convOutput);
+        layer.backpropagate(denseInputGradients);
+    })};
+    const double copiedBytes{2.0 * batchSize * outputSize * sizeof(ml::Scalar)};
+
+    std::cout << "Output is a view of the conv output: " << (outputShared ? "yes" : "no") << "\n";
+    std::cout << "Input gradients are a view of the dense input gradients: "
+              << (gradientsShared ? "yes" : "no") << "\n\n";
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Batch of " << batchSize << ", " << channelCount << " channels, " << size << "x"
+              << size << ":\n";
+    std::cout << "  Copy: " << std::setw(8) << copyTime << " us per batch, "
+              << copiedBytes / 1024.0 << " KiB copied\n";
+    std::cout << "  View: " << std::setw(8) << viewTime << " us per batch, 0.00 KiB copied\n";
+
+    // Return -1 if the layer copies.
+    if (!outputShared || !gradientsShared)
+    {
+        std::cerr << "The flatten layer doesn't view its input and output gradients!\n";
+        return -1;
+    }
+    return 0;
+}
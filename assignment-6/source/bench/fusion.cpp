@@ -0,0 +1,158 @@
+/**
+ * @brief Benchmark for fused, tiled batch prediction.
+ *
+ *        Checks that batch prediction, which runs the fused inference plan tile by tile,
+ *        matches predicting the samples one by one, and measures the prediction throughput
+ *        for different batch sizes. Fails if any batch size is slower than single samples.
+ *
+ *        Build and run via `make bench BENCH=fusion`.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+#include "ml/cnn/cnn.h"
+#include "ml/factory/factory.h"
+#include "ml/scalar.h"
+#include "ml/tensor.h"
+#include "ml/utils.h"
+
+namespace
+{
+/** Clock used for the measurements. */
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Compare batch prediction with predicting the samples one by one.
+ *
+ * @param[in] cnn The network to check.
+ * @param[in] inputs The inputs to predict.
+ *
+ * @return The maximum relative error.
+ */
+double checkBatch(ml::cnn::Cnn& cnn, const ml::Tensor& inputs)
+{
+    ml::Tensor outputs{inputs.dim(0U), cnn.outputSize()};
+    cnn.predictBatch(inputs, outputs, inputs.dim(0U));
+    double maxError{};
+
+    for (std::size_t i{}; i < inputs.dim(0U); ++i)
+    {
+        const ml::Tensor& expected{cnn.predict(inputs.slice(i))};
+
+        for (std::size_t j{}; j < expected.size(); ++j)
+        {
+            const double error{std::abs(static_cast<double>(outputs(i, j)) - expected.data()[j])};
+            maxError = std::max(maxError, error / (1.0 + std::abs(expected.data()[j])));
+        }
+    }
+    return maxError;
+}
+
+/** Batch sizes to measure. */
+constexpr std::size_t BatchSizes[]{1U, 16U, 64U, 256U};
+
+/** Number of batch sizes to measure. */
+constexpr std::size_t BatchSizeCount{sizeof(BatchSizes) / sizeof(BatchSizes[0U])};
+
+/**
+ * @brief Measure the batch prediction throughput for every batch size.
+ *
+ *        The batch sizes take turns predicting the inputs, and the fastest round of each is
+ *        used, so that noise from other processes affects every batch size alike.
+ *
+ * @param[in] cnn The network to measure.
+ * @param[in] inputs The inputs to predict.
+ * @param[out] throughputs The number of predicted samples per second for each batch size.
+ */
+void measureThroughputs(ml::cnn::Cnn& cnn, const ml::Tensor& inputs,
+                        double (&throughputs)[BatchSizeCount])
+{
+    constexpr double measureSeconds{3.0};
+    ml::Tensor outputs{inputs.dim(0U), cnn.outputSize()};
+    for (const auto batchSize : BatchSizes) { cnn.predictBatch(inputs, outputs, batchSize); }
+
+    double minSeconds[BatchSizeCount]{};
+    double totalSeconds{};
+
+    while (totalSeconds < measureSeconds)
+    {
+        for (std::size_t i{}; i < BatchSizeCount; ++i)
+        {
+            const auto start{Clock::now()};
+            cnn.predictBatch(inputs, outputs, BatchSizes[i]);
+            const double time{std::chrono::duration<double>(Clock::now() - start).count()};
+            minSeconds[i] = (0.0 == minSeconds[i]) ? time : std::min(minSeconds[i], time);
+            totalSeconds += time;
+        }
+    }
+    for (std::size_t i{}; i < BatchSizeCount; ++i)
+    {
+        throughputs[i] = inputs.dim(0U) / minSeconds[i];
+    }
+}
+} // namespace
+
+/**
+ * @brief Check fused, tiled batch prediction and measure its throughput.
+ *
+ * @return 0 on success, error code -1 on failure.
+ */
+int main()
+{
+    constexpr std::size_t setCount{256U};
+    const double tolerance{sizeof(ml::Scalar) == sizeof(float) ? 1e-4 : 1e-10};
+
+    // A single-channel network with a large dense layer and a multi-channel network.
+    ml::factory::Factory factory{};
+    ml::cnn::Cnn classic{factory, 64U, 5U, ml::act_func::Type::Relu, 2U, 256U,
+                         ml::act_func::Type::Relu, ml::conv_layer::algorithm::Type::Auto};
+    ml::cnn::Cnn multi{factory, 32U, {{16U, 3U, ml::act_func::Type::Relu, 2U},
+                                      {32U, 3U, ml::act_func::Type::Relu, 2U}},
+                       10U, ml::act_func::Type::Sigmoid};
+    double maxError{};
+    bool batchesFaster{true};
+
+    for (auto* cnn : {&classic, &multi})
+    {
+        const std::size_t size{cnn->inputSize()};
+        ml::Tensor inputs{setCount, size, size};
+        for (std::size_t i{}; i < inputs.size(); ++i) { inputs.data()[i] = ml::randomStartVal(); }
+
+        const double error{checkBatch(*cnn, inputs)};
+        maxError = std::max(maxError, error);
+
+        std::cout << std::scientific << std::setprecision(2);
+        std::cout << (cnn == &classic ? "Single-channel" : "Multi-channel") << " network, "
+                  << size << "x" << size << ", max relative error (batch vs single): " << error
+                  << "\n";
+        std::cout << std::fixed << std::setprecision(0);
+
+        double throughputs[BatchSizeCount]{};
+        measureThroughputs(*cnn, inputs, throughputs);
+
+        for (std::size_t i{}; i < BatchSizeCount; ++i)
+        {
+            std::cout << "  Batch size " << std::setw(3) << BatchSizes[i] << ": " << std::setw(8)
+                      << throughputs[i] << " samples/s\n";
+
+            // Allow some noise, batching must never lose to single samples.
+            batchesFaster &= throughputs[i] >= 0.9 * throughputs[0U];
+        }
+    }
+
+    // Return -1 if batch prediction doesn't match or is slower than single samples.
+    if (maxError > tolerance)
+    {
+        std::cerr << "Batch prediction doesn't match single prediction!\n";
+        return -1;
+    }
+    else if (!batchesFaster)
+    {
+        std::cerr << "Batch prediction is slower than predicting single samples!\n";
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,211 @@
+/**
+ * @brief Convergence and throughput benchmark for Hogwild-style asynchronous training.
+ *
+ *        Compares the synchronous Cnn::train with the lock-free asynchronous mode of
+ *        ml::cnn::ParallelTrainer on a network dominated by wide dense layers.
+ *
+ *        Build and run via `make bench BENCH=hogwild`.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include "ml/cnn/cnn.h"
+#include "ml/cnn/parallel_trainer.h"
+#include "ml/cnn/train_mode.h"
+#include "ml/dense_layer/interface.h"
+#include "ml/factory/factory.h"
+#include "ml/random/generator.h"
+#include "ml/scalar.h"
+#include "ml/tensor.h"
+#include "ml/utils.h"
+
+namespace
+{
+/** Clock used for the measurements. */
+using Clock = std::chrono::steady_clock;
+
+/** Training function, training given network one epoch. */
+using TrainFunc = std::function<bool(ml::cnn::Cnn&)>;
+
+/** Seed used for every training run. */
+constexpr std::uint32_t Seed{7U};
+
+/**
+ * @brief Create a labeled data set of noisy images, where the class is given by the position of
+ *        a bright horizontal bar.
+ *
+ * @param[out] inputs Tensor in which to store the images, shape (set count, size, size).
+ * @param[out] outputs Tensor in which to store the one-hot labels, shape (set count, classes).
+ */
+void createDataSet(ml::Tensor& inputs, ml::Tensor& outputs) noexcept
+{
+    const std::size_t size{inputs.dim(1U)};
+    const std::size_t classCount{outputs.dim(1U)};
+
+    for (std::size_t s{}; s < inputs.dim(0U); ++s)
+    {
+        const std::size_t label{s % classCount};
+        const std::size_t barRow{label * size / classCount};
+
+        for (std::size_t i{}; i < size; ++i)
+        {
+            for (std::size_t j{}; j < size; ++j)
+            {
+                const ml::Scalar noise{ml::randomStartVal() * ml::Scalar{0.3}};
+                inputs(s, i, j) = (i == barRow) || (i == barRow + 1U) ? 1 - noise : noise;
+            }
+        }
+        outputs(s, label) = 1;
+    }
+}
+
+/**
+ * @brief Rescale the initial dense layer weights from [0, 1] / input size (see
+ *        Dense::initialize) to [-1, 1] / sqrt(input size), so that the ReLU layers start
+ *        with both signs and the wide layers don't saturate the output activation function.
+ *
+ * @param[in] cnn The network.
+ */
+void rescaleDenseWeights(ml::cnn::Cnn& cnn)
+{
+    for (const auto& layer : cnn.denseLayers())
+    {
+        const auto inputSize{static_cast<ml::Scalar>(layer->inputSize())};
+        const ml::Scalar scale{1 / std::sqrt(inputSize)};
+        ml::Tensor rescaled{layer->parameters()[0U]};
+
+        for (std::size_t i{}; i < rescaled.size(); ++i)
+        {
+            rescaled.data()[i] = (2 * rescaled.data()[i] * inputSize - 1) * scale;
+        }
+        layer->parameters()[0U].copyFrom(rescaled);
+    }
+}
+
+/**
+ * @brief Compute the mean squared error of given network over a data set.
+ *
+ * @param[in] cnn The network.
+ * @param[in] inputs Input sets.
+ * @param[in] outputs Expected output sets.
+ *
+ * @return The mean squared error.
+ */
+double meanSquaredError(ml::cnn::Cnn& cnn, const ml::Tensor& inputs, const ml::Tensor& outputs)
+{
+    double sum{};
+
+    for (std::size_t s{}; s < inputs.dim(0U); ++s)
+    {
+        const ml::Tensor& prediction{cnn.predict(inputs.slice(s))};
+
+        for (std::size_t i{}; i < prediction.size(); ++i)
+        {
+            const double error{prediction(i) - outputs(s, i)};
+            sum += error * error;
+        }
+    }
+    return sum / static_cast<double>(outputs.size());
+}
+
+/**
+ * @brief Train a freshly seeded network epoch by epoch, printing the loss and the time.
+ *
+ * @param[in] name Name of the training method.
+ * @param[in] train Function training the network one epoch.
+ * @param[in] inputs Training input sets.
+ * @param[in] outputs Training output sets.
+ * @param[in] epochCount Number of epochs.
+ *
+ * @return True on success, false on failure.
+ */
+bool run(const char* name, const TrainFunc& train, const ml::Tensor& inputs,
+         const ml::Tensor& outputs, const std::size_t epochCount)
+{
+    // Network parameters, the dense layers hold most of the parameters.
+    constexpr std::size_t kernelSize{3U};
+    constexpr std::size_t poolSize{2U};
+    constexpr std::size_t hiddenSize{512U};
+
+    // Create the network from the same seed for every method.
+    ml::random::Generator::getInstance().seed(Seed);
+    ml::factory::Factory factory{};
+    ml::cnn::Cnn cnn{factory, inputs.dim(1U), kernelSize, ml::act_func::Type::Relu, poolSize,
+                     hiddenSize, ml::act_func::Type::Relu};
+    cnn.addDenseLayer(hiddenSize, ml::act_func::Type::Relu);
+    cnn.addDenseLayer(outputs.dim(1U), ml::act_func::Type::Tanh);
+    rescaleDenseWeights(cnn);
+
+    std::cout << name << "\n";
+    double seconds{};
+
+    for (std::size_t epoch{1U}; epoch <= epochCount; ++epoch)
+    {
+        const auto start{Clock::now()};
+        if (!train(cnn)) { return false; }
+        seconds += std::chrono::duration<double>(Clock::now() - start).count();
+
+        std::cout << "  epoch " << std::setw(2) << epoch << ": loss " << std::scientific
+                  << std::setprecision(3) << meanSquaredError(cnn, inputs, outputs)
+                  << std::defaultfloat << ", " << std::setprecision(4)
+                  << epoch * inputs.dim(0U) / seconds << " samples/s\n";
+    }
+    return true;
+}
+} // namespace
+
+/**
+ * @brief Compare the convergence and the throughput of synchronous and asynchronous training.
+ *
+ * @return 0 on success, error code -1 on failure.
+ */
+int main()
+{
+    // Data and training parameters.
+    constexpr std::size_t inputSize{16U};
+    constexpr std::size_t classCount{4U};
+    constexpr std::size_t setCount{512U};
+    constexpr std::size_t epochCount{8U};
+    constexpr std::size_t syncBatchSize{16U};
+    constexpr double learningRate{0.01};
+
+    const std::size_t threadCount{
+        std::clamp<std::size_t>(std::thread::hardware_concurrency(), 2U, 8U)};
+
+    // Create the training data.
+    ml::random::Generator::getInstance().seed(Seed);
+    ml::Tensor inputs{setCount, inputSize, inputSize};
+    ml::Tensor outputs{setCount, classCount};
+    createDataSet(inputs, outputs);
+
+    std::cout << "Threads: " << threadCount << "\n";
+
+    // Train per sample with a single thread.
+    const bool success{run("Cnn::train (1 thread, batch size 1)", [&](ml::cnn::Cnn& cnn)
+    {
+        return cnn.train(inputs, outputs, 1U, learningRate);
+    }, inputs, outputs, epochCount)
+
+    // Train with synchronized mini-batches across all threads.
+    && run("Synchronous (batch size 16)", [&](ml::cnn::Cnn& cnn)
+    {
+        ml::cnn::ParallelTrainer trainer{cnn, threadCount, ml::cnn::TrainMode::Synchronous};
+        return trainer.train(inputs, outputs, 1U, learningRate, syncBatchSize);
+    }, inputs, outputs, epochCount)
+
+    // Train per sample with lock-free updates of the shared parameters.
+    && run("Hogwild (batch size 1 per thread)", [&](ml::cnn::Cnn& cnn)
+    {
+        ml::cnn::ParallelTrainer trainer{cnn, threadCount, ml::cnn::TrainMode::Hogwild};
+        return trainer.train(inputs, outputs, 1U, learningRate, 1U);
+    }, inputs, outputs, epochCount)};
+
+    std::cout << "\n";
+    return success ? 0 : -1;
+}
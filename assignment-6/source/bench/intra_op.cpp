@@ -0,0 +1,142 @@
+/**
+ * @brief Benchmark for parallel loops inside the layers (intra-operator parallelism).
+ *
+ *        Measures single-image inference and training on a large network for an increasing
+ *        number of threads, and checks that every thread count gives the same results.
+ *
+ *        Build and run via `make bench BENCH=intra_op`.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+
+#include "ml/cnn/cnn.h"
+#include "ml/factory/factory.h"
+#include "ml/random/generator.h"
+#include "ml/scalar.h"
+#include "ml/tensor.h"
+#include "ml/utils.h"
+
+namespace
+{
+/** Clock used for the measurements. */
+using Clock = std::chrono::steady_clock;
+
+/** Seed used for every network. */
+constexpr std::uint32_t Seed{11U};
+
+/**
+ * @brief Fill given tensor with random values in the range [0, 1].
+ *
+ * @param[in] tensor The tensor to fill.
+ */
+void randomize(ml::Tensor& tensor) noexcept
+{
+    for (std::size_t i{}; i < tensor.size(); ++i) { tensor.data()[i] = ml::randomStartVal(); }
+}
+
+/**
+ * @brief Measure inference and training with given number of threads.
+ *
+ * @param[in] factory Machine learning factory.
+ * @param[in] inputs Input sets.
+ * @param[in] outputs Output sets.
+ * @param[in] threadCount Number of threads.
+ * @param[out] predictions Tensor in which to store the predictions after training.
+ * @param[out] inferenceRate Number of predictions per second.
+ * @param[out] trainRate Number of trained samples per second.
+ *
+ * @return True on success, false on failure.
+ */
+bool measure(ml::factory::Interface& factory, const ml::Tensor& inputs,
+             const ml::Tensor& outputs, const std::size_t threadCount,
+             ml::Tensor& predictions, double& inferenceRate, double& trainRate)
+{
+    // Network and training parameters.
+    constexpr std::size_t kernelSize{5U};
+    constexpr std::size_t poolSize{2U};
+    constexpr std::size_t hiddenSize{1024U};
+    constexpr std::size_t repeatCount{4U};
+    constexpr std::size_t batchSize{8U};
+    constexpr double learningRate{0.001};
+
+    ml::random::Generator::getInstance().seed(Seed);
+    ml::cnn::Cnn cnn{factory, inputs.dim(1U), kernelSize, ml::act_func::Type::Relu, poolSize,
+                     hiddenSize, ml::act_func::Type::Relu};
+    cnn.addDenseLayer(hiddenSize, ml::act_func::Type::Relu);
+    cnn.addDenseLayer(outputs.dim(1U), ml::act_func::Type::Tanh);
+    cnn.setThreadCount(threadCount);
+
+    // Predict one image at a time.
+    auto start{Clock::now()};
+
+    for (std::size_t r{}; r < repeatCount; ++r)
+    {
+        for (std::size_t s{}; s < inputs.dim(0U); ++s) { cnn.predict(inputs.slice(s)); }
+    }
+    inferenceRate = repeatCount * inputs.dim(0U)
+        / std::chrono::duration<double>(Clock::now() - start).count();
+
+    // Train in mini-batches, the training order is given by the seed.
+    ml::random::Generator::getInstance().seed(Seed);
+    start = Clock::now();
+    if (!cnn.train(inputs, outputs, 1U, learningRate, batchSize)) { return false; }
+    trainRate = inputs.dim(0U) / std::chrono::duration<double>(Clock::now() - start).count();
+
+    for (std::size_t s{}; s < inputs.dim(0U); ++s)
+    {
+        predictions.slice(s).copyFrom(cnn.predict(inputs.slice(s)));
+    }
+    return true;
+}
+} // namespace
+
+/**
+ * @brief Measure inference and training throughput for an increasing number of threads.
+ *
+ * @return 0 on success, error code -1 on failure.
+ */
+int main()
+{
+    // Data parameters.
+    constexpr std::size_t inputSize{128U};
+    constexpr std::size_t outputSize{10U};
+    constexpr std::size_t setCount{32U};
+
+    ml::Tensor inputs{setCount, inputSize, inputSize};
+    ml::Tensor outputs{setCount, outputSize};
+    randomize(inputs);
+    randomize(outputs);
+
+    ml::factory::Factory factory{};
+    const std::size_t maxThreadCount{std::max(1U, std::thread::hardware_concurrency())};
+    ml::Tensor reference{setCount, outputSize};
+    double baseline{};
+    bool identical{true};
+
+    for (std::size_t threadCount{1U}; threadCount <= std::min<std::size_t>(maxThreadCount, 16U);
+         threadCount *= 2U)
+    {
+        ml::Tensor predictions{setCount, outputSize};
+        double inferenceRate{}, trainRate{};
+
+        if (!measure(factory, inputs, outputs, threadCount, predictions, inferenceRate,
+                     trainRate)) { return -1; }
+        if (1U == threadCount)
+        {
+            reference = predictions;
+            baseline  = inferenceRate;
+        }
+        const bool same{std::equal(predictions.data(), predictions.data() + predictions.size(),
+                                   reference.data())};
+        identical &= same;
+
+        std::cout << "Threads: " << threadCount << ", inference: " << inferenceRate
+                  << " images/s (" << inferenceRate / baseline << "x), training: "
+                  << trainRate << " samples/s" << (same ? "" : " (mismatch!)") << "\n";
+    }
+    std::cout << "Identical results: " << (identical ? "yes" : "no") << "\n\n";
+    return identical ? 0 : -1;
+}
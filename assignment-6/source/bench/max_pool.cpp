@@ -0,0 +1,300 @@
+/**
+ * @brief Benchmark for max pooling.
+ *
+ *        Checks the recorded max value positions against a rescan of the input, checks that
+ *        the fused convolution and pooling matches the layers run one by one, and measures
+ *        the inference time of both paths for a single-channel layer and multi-channel layers
+ *        using direct convolution and im2col. Fails if the fused path is slower.
+ *
+ *        Build and run via `make bench BENCH=max_pool`.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <utility>
+
+#include "ml/conv_layer/algorithm/interface.h"
+#include "ml/conv_layer/conv.h"
+#include "ml/conv_layer/interface.h"
+#include "ml/conv_layer/layout.h"
+#include "ml/conv_layer/max_pool.h"
+#include "ml/conv_layer/multi_channel.h"
+#include "ml/random/generator.h"
+#include "ml/scalar.h"
+#include "ml/tensor.h"
+
+namespace
+{
+/** Clock used for the measurements. */
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Fill given tensor with random values in range [-1, 1].
+ *
+ * @param[in] tensor The tensor to fill.
+ */
+void randomize(ml::Tensor& tensor)
+{
+    auto& generator{ml::random::Generator::getInstance()};
+    for (std::size_t i{}; i < tensor.size(); ++i)
+    {
+        tensor.data()[i] = static_cast<ml::Scalar>(generator.float64(-1.0, 1.0));
+    }
+}
+
+/**
+ * @brief Check the input gradients of a max pooling layer against a rescan of the input.
+ *
+ * @param[in] channelCount The number of channels.
+ * @param[in] size The input size.
+ * @param[in] poolSize The pool size.
+ * @param[in] batchSize The number of samples per batch.
+ *
+ * @return The number of mismatching input gradients.
+ */
+std::size_t checkBackward(const std::size_t channelCount, const std::size_t size,
+                          const std::size_t poolSize, const std::size_t batchSize)
+{
+    ml::conv_layer::MaxPoolLayer layer{size, poolSize, channelCount};
+    layer.setMaxBatchSize(batchSize);
+    ml::Tensor input{ml::conv_layer::featureMaps(batchSize, channelCount, size)};
+    ml::Tensor outputGradients{
+        ml::conv_layer::featureMaps(batchSize, channelCount, size / poolSize)};
+    randomize(input);
+    randomize(outputGradients);
+
+    // Quantize the input, so that the pools contain ties (the first max value gets the gradient).
+    for (std::size_t i{}; i < input.size(); ++i)
+    {
+        input.data()[i] = std::round(input.data()[i] * 4);
+    }
+    layer.feedforward(input);
+    layer.backpropagate(outputGradients);
+
+    // Every input gradient is either 0 or the gradient of the first max value of its pool.
+    const std::size_t width{ml::conv_layer::blockWidth(channelCount)};
+    const std::size_t outputSize{size / poolSize};
+    const ml::Tensor& inputGradients{layer.inputGradients()};
+    std::size_t mismatchCount{};
+
+    for (std::size_t offset{}; offset < input.size(); ++offset)
+    {
+        // Decompose the offset (sample, block, row, column, channel).
+        const std::size_t c{offset % width};
+        const std::size_t x{offset / width % size};
+        const std::size_t y{offset / (width * size) % size};
+        const std::size_t sampleBlock{offset / (width * size * size)};
+        const std::size_t first{((sampleBlock * size + y / poolSize * poolSize) * size
+            + x / poolSize * poolSize) * width + c};
+
+        // Rescan the pool for the first max value.
+        std::size_t maxOffset{first};
+        for (std::size_t pi{}; pi < poolSize; ++pi)
+        {
+            for (std::size_t pj{}; pj < poolSize; ++pj)
+            {
+                const std::size_t candidate{first + (pi * size + pj) * width};
+                if (input.data()[candidate] > input.data()[maxOffset]) { maxOffset = candidate; }
+            }
+        }
+        const std::size_t outOffset{((sampleBlock * outputSize + y / poolSize) * outputSize
+            + x / poolSize) * width + c};
+        const ml::Scalar expected{
+            offset == maxOffset ? outputGradients.data()[outOffset] : ml::Scalar{}};
+        if (inputGradients.data()[offset] != expected) { ++mismatchCount; }
+    }
+    return mismatchCount;
+}
+
+/**
+ * @brief Compare the fused convolution and pooling with the layers run one by one.
+ *
+ * @param[in] conv The convolutional layer.
+ * @param[in] pool The max pooling layer following the convolutional layer.
+ * @param[in] input The input of the convolutional layer.
+ *
+ * @return The maximum relative error.
+ */
+double checkFused(ml::conv_layer::Interface& conv, ml::conv_layer::Interface& pool,
+                  const ml::Tensor& input)
+{
+    conv.feedforward(input);
+    pool.feedforward(conv.output());
+    const ml::Tensor expected{pool.output()};
+
+    pool.feedforwardFused(conv, input);
+    const ml::Tensor& actual{pool.output()};
+    double maxError{};
+
+    for (std::size_t i{}; i < expected.size(); ++i)
+    {
+        const double error{std::abs(static_cast<double>(actual.data()[i]) - expected.data()[i])};
+        maxError = std::max(maxError, error / (1.0 + std::abs(expected.data()[i])));
+    }
+    return maxError;
+}
+
+/**
+ * @brief Measure the inference time of a convolutional layer followed by a pooling layer,
+ *        with the layers run one by one and fused.
+ *
+ *        Both paths take turns and the fastest pass of each is used, so that noise from other
+ *        processes affects both alike.
+ *
+ * @param[in] conv The convolutional layer.
+ * @param[in] pool The max pooling layer following the convolutional layer.
+ * @param[in] input The input of the convolutional layer.
+ * @param[out] unfused The time per pass in microseconds with the layers run one by one.
+ * @param[out] fused The time per pass in microseconds with the layers fused.
+ */
+void inferenceTimes(ml::conv_layer::Interface& conv, ml::conv_layer::Interface& pool,
+                    const ml::Tensor& input, double& unfused, double& fused)
+{
+    constexpr double minSeconds{0.5};
+    double seconds{};
+    unfused = 0.0;
+    fused   = 0.0;
+
+    while (seconds < minSeconds)
+    {
+        const auto start{Clock::now()};
+        conv.feedforward(input) && pool.feedforward(conv.output());
+        const auto middle{Clock::now()};
+        pool.feedforwardFused(conv, input);
+        const auto end{Clock::now()};
+
+        const double unfusedTime{std::chrono::duration<double, std::micro>(middle - start).count()};
+        const double fusedTime{std::chrono::duration<double, std::micro>(end - middle).count()};
+        unfused = (0.0 == unfused) ? unfusedTime : std::min(unfused, unfusedTime);
+        fused   = (0.0 == fused) ? fusedTime : std::min(fused, fusedTime);
+        seconds += (unfusedTime + fusedTime) * 1e-6;
+    }
+}
+
+/**
+ * @brief Measure the training time of a max pooling layer.
+ *
+ * @param[in] channelCount The number of channels.
+ * @param[in] size The input size.
+ * @param[in] poolSize The pool size.
+ * @param[in] batchSize The number of samples per batch.
+ *
+ * @return The time per feedforward and backpropagation pass in microseconds.
+ */
+double trainingTime(const std::size_t channelCount, const std::size_t size,
+                    const std::size_t poolSize, const std::size_t batchSize)
+{
+    constexpr double minSeconds{0.2};
+    ml::conv_layer::MaxPoolLayer layer{size, poolSize, channelCount};
+    layer.setMaxBatchSize(batchSize);
+    ml::Tensor input{ml::conv_layer::featureMaps(batchSize, channelCount, size)};
+    ml::Tensor outputGradients{
+        ml::conv_layer::featureMaps(batchSize, channelCount, size / poolSize)};
+    randomize(input);
+    randomize(outputGradients);
+
+    std::size_t roundCount{};
+    const auto start{Clock::now()};
+    double seconds{};
+
+    while (seconds < minSeconds)
+    {
+        layer.feedforward(input);
+        layer.backpropagate(outputGradients);
+        ++roundCount;
+        seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+    return seconds / roundCount * 1e6;
+}
+} // namespace
+
+/**
+ * @brief Check max pooling and the fused convolution and pooling, and measure their speed.
+ *
+ * @return 0 on success, error code -1 on failure.
+ */
+int main()
+{
+    using ml::conv_layer::ChannelBlock;
+    const double tolerance{sizeof(ml::Scalar) == sizeof(float) ? 1e-5 : 1e-12};
+    ml::random::Generator::getInstance().seed(42U);
+
+    // Check the backpropagation with single and blocked channels, and a batch.
+    std::size_t mismatchCount{};
+    mismatchCount += checkBackward(1U, 12U, 2U, 1U);
+    mismatchCount += checkBackward(3U, 12U, 3U, 2U);
+    mismatchCount += checkBackward(2U * ChannelBlock, 8U, 4U, 3U);
+    std::cout << "Input gradient mismatches (argmax scatter vs rescan): " << mismatchCount
+              << "\n";
+
+    // Check the fused path with both convolutional layer types, both multi-channel algorithms,
+    // single samples and batches.
+    constexpr std::size_t size{28U};
+    constexpr std::size_t channels{4U * ChannelBlock};
+    constexpr std::size_t batchSize{8U};
+    ml::conv_layer::ConvLayer conv{size, 3U, ml::act_func::Type::Tanh};
+    ml::conv_layer::MaxPoolLayer pool{size, 2U};
+    conv.setMaxBatchSize(batchSize);
+    pool.setMaxBatchSize(batchSize);
+    ml::Tensor input{ml::conv_layer::featureMaps(batchSize, 1U, size)};
+    randomize(input);
+
+    double maxError{};
+    maxError = std::max(maxError, checkFused(conv, pool, input.slice(0U)));
+    maxError = std::max(maxError, checkFused(conv, pool, input));
+
+    // Measure the inference time with and without fusion, the fused path must never lose.
+    double unfused{}, fused{};
+    bool fusedFaster{true};
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Inference, batch of " << batchSize << ", " << size << "x" << size
+              << ", pool 2x2: us (unfused) / us (fused)\n";
+    inferenceTimes(conv, pool, input, unfused, fused);
+    std::cout << "     1 ->    1 channels (single-channel): " << std::setw(8) << unfused << " / "
+              << std::setw(8) << fused << "\n";
+    fusedFaster &= fused <= unfused;
+
+    // Measure a single input channel, a full input block and many channels.
+    using Channels = std::pair<std::size_t, std::size_t>;
+    for (const auto& [inputChannels, outputChannels] : {Channels{1U, channels},
+                                                         Channels{ChannelBlock, channels},
+                                                         Channels{channels, 2U * channels}})
+    {
+        ml::conv_layer::MultiChannelConvLayer multiConv{inputChannels, outputChannels, size, 3U,
+                                                        ml::act_func::Type::Relu};
+        ml::conv_layer::MaxPoolLayer multiPool{size, 2U, outputChannels};
+        multiConv.setMaxBatchSize(batchSize);
+        multiPool.setMaxBatchSize(batchSize);
+        ml::Tensor multiInput{ml::conv_layer::featureMaps(batchSize, inputChannels, size)};
+        randomize(multiInput);
+
+        maxError = std::max(maxError, checkFused(multiConv, multiPool, multiInput.slice(0U)));
+        maxError = std::max(maxError, checkFused(multiConv, multiPool, multiInput));
+        inferenceTimes(multiConv, multiPool, multiInput, unfused, fused);
+        const bool lowered{ml::conv_layer::algorithm::Type::Im2col == multiConv.algorithm()};
+        std::cout << "  " << std::setw(4) << inputChannels << " -> " << std::setw(4)
+                  << outputChannels << " channels (" << (lowered ? "im2col" : "direct")
+                  << "):        " << std::setw(8) << unfused << " / " << std::setw(8) << fused
+                  << "\n";
+        fusedFaster &= fused <= unfused;
+    }
+    std::cout << "Max relative error (fused vs unfused): " << std::defaultfloat << maxError
+              << std::fixed << "\n";
+    std::cout << "Max pooling feedforward + backpropagation, " << channels << " channels: "
+              << trainingTime(channels, size, 2U, batchSize) << " us\n";
+
+    // Return -1 if any check failed or if fusion is slower than running the layers one by one.
+    if ((0U != mismatchCount) || (maxError > tolerance))
+    {
+        std::cerr << "Max pooling doesn't match the reference!\n";
+        return -1;
+    }
+    else if (!fusedFaster)
+    {
+        std::cerr << "The fused convolution and pooling is slower than the layers one by one!\n";
+        return -1;
+    }
+    return 0;
+}
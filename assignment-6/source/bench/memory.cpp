@@ -0,0 +1,97 @@
+/**
+ * @brief Benchmark for the memory plans of the batch buffers.
+ *
+ *        Reports the arena size of the inference and training plans of two networks for
+ *        different batch sizes, compared with the memory of the buffers without reuse, and
+ *        checks that the plans never need more memory than the buffers themselves.
+ *
+ *        Build and run via `make bench BENCH=memory`.
+ */
+#include <iomanip>
+#include <iostream>
+
+#include "ml/cnn/cnn.h"
+#include "ml/factory/factory.h"
+#include "ml/memory/planner.h"
+#include "ml/tensor.h"
+#include "ml/utils.h"
+
+namespace
+{
+/**
+ * @brief Fill given tensor with random values in the range [0, 1].
+ *
+ * @param[in] tensor The tensor to fill.
+ */
+void randomize(ml::Tensor& tensor) noexcept
+{
+    for (std::size_t i{}; i < tensor.size(); ++i) { tensor.data()[i] = ml::randomStartVal(); }
+}
+
+/**
+ * @brief Print the memory report of given network for different batch sizes.
+ *
+ * @param[in] cnn The network.
+ * @param[in] name The name of the network.
+ *
+ * @return True if every plan fits in the buffers without reuse, else false.
+ */
+bool report(ml::cnn::Cnn& cnn, const char* name)
+{
+    constexpr std::size_t batchSizes[]{1U, 16U, 64U};
+    constexpr double kib{1024.0};
+    const std::size_t size{cnn.inputSize()};
+    ml::Tensor inputs{batchSizes[2U], size, size};
+    ml::Tensor targets{batchSizes[2U], cnn.outputSize()};
+    randomize(inputs);
+    randomize(targets);
+    bool success{true};
+
+    std::cout << name << ", " << size << "x" << size << ": KiB (inference / training / "
+              << "without reuse)\n" << std::fixed << std::setprecision(1);
+
+    for (const auto batchSize : batchSizes)
+    {
+        // Train a single batch, which lets the layers hold a batch of this size.
+        const ml::Tensor batchIn{inputs.narrow(0U, 0U, batchSize)};
+        const ml::Tensor batchOut{targets.narrow(0U, 0U, batchSize)};
+        cnn.train(batchIn, batchOut, 1U, 0.01, batchSize);
+
+        const auto memory{cnn.memoryReport()};
+        std::cout << "  Batch size " << std::setw(2) << batchSize << ": " << std::setw(8)
+                  << memory.inferenceBytes / kib << " / " << std::setw(8)
+                  << memory.trainingBytes / kib << " / " << std::setw(8)
+                  << memory.totalBytes / kib << "\n";
+        success &= (memory.inferenceBytes <= memory.trainingBytes)
+            && (memory.trainingBytes <= memory.totalBytes);
+    }
+    return success;
+}
+} // namespace
+
+/**
+ * @brief Report the memory plans of a single-channel and a multi-channel network.
+ *
+ * @return 0 on success, error code -1 on failure.
+ */
+int main()
+{
+    ml::factory::Factory factory{};
+    ml::cnn::Cnn classic{factory, 64U, 5U, ml::act_func::Type::Relu, 2U, 256U,
+                         ml::act_func::Type::Relu, ml::conv_layer::algorithm::Type::Auto};
+    classic.addDenseLayer(10U, ml::act_func::Type::Tanh);
+    ml::cnn::Cnn multi{factory, 32U, {{16U, 3U, ml::act_func::Type::Relu, 2U},
+                                      {32U, 3U, ml::act_func::Type::Relu, 2U}},
+                       10U, ml::act_func::Type::Sigmoid};
+
+    bool success{report(classic, "Single-channel network")};
+    success &= report(multi, "Multi-channel network");
+
+    // Return -1 if any plan needs more memory than the buffers without reuse.
+    if (!success)
+    {
+        std::cerr << "A memory plan exceeds the buffers without reuse!\n";
+        return -1;
+    }
+    return 0;
+}
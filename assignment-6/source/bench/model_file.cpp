@@ -0,0 +1,259 @@
+/**
+ * @brief Benchmark for binary model files.
+ *
+ *        Saves two trained networks to model files, loads them via memory mapping and checks
+ *        that the loaded networks predict exactly like the saved ones. Checks that a network
+ *        loaded read-only cannot be trained and that a write to a read-only mapping faults.
+ *        Then trains a network loaded copy-on-write and checks that the model file is left
+ *        unchanged, i.e. that a reloaded network still matches the saved one. Reports the
+ *        file sizes and the time to construct, save and load each network. Finally checks
+ *        that files with a swapped byte order or with layer records of the wrong kind are
+ *        rejected.
+ *
+ *        Build and run via `make bench BENCH=model_file`.
+ */
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "ml/cnn/cnn.h"
+#include "ml/cnn/model_file.h"
+#include "ml/conv_layer/type.h"
+#include "ml/factory/factory.h"
+#include "ml/memory/mapped_file.h"
+#include "ml/tensor.h"
+#include "ml/utils.h"
+
+namespace
+{
+/** Clock used for the measurements. */
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Get the number of milliseconds since given start time.
+ *
+ * @param[in] start The start time.
+ *
+ * @return The elapsed time in milliseconds.
+ */
+double elapsedMs(const Clock::time_point start) noexcept
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/**
+ * @brief Fill given tensor with random values in the range [0, 1].
+ *
+ * @param[in] tensor The tensor to fill.
+ */
+void randomize(ml::Tensor& tensor) noexcept
+{
+    for (std::size_t i{}; i < tensor.size(); ++i) { tensor.data()[i] = ml::randomStartVal(); }
+}
+
+/**
+ * @brief Check whether two networks predict given inputs exactly alike.
+ *
+ * @param[in] a The first network.
+ * @param[in] b The second network.
+ * @param[in] inputs The inputs to predict.
+ *
+ * @return True if the predictions are identical, else false.
+ */
+bool predictAlike(ml::cnn::Cnn& a, ml::cnn::Cnn& b, const ml::Tensor& inputs)
+{
+    ml::Tensor outputsA{inputs.dim(0U), a.outputSize()};
+    ml::Tensor outputsB{inputs.dim(0U), b.outputSize()};
+    a.predictBatch(inputs, outputsA, inputs.dim(0U));
+    b.predictBatch(inputs, outputsB, inputs.dim(0U));
+
+    for (std::size_t i{}; i < outputsA.size(); ++i)
+    {
+        if (outputsA.data()[i] != outputsB.data()[i]) { return false; }
+    }
+    return true;
+}
+
+/**
+ * @brief Save, load and check given network.
+ *
+ * @param[in] factory The factory of the network.
+ * @param[in] cnn The network.
+ * @param[in] name The name of the network.
+ * @param[in] constructMs The time it took to construct the network in milliseconds.
+ * @param[in] path Path to the model file to use.
+ *
+ * @return True if the loaded networks match the saved network, else false.
+ */
+bool check(ml::factory::Interface& factory, ml::cnn::Cnn& cnn, const char* name,
+           const double constructMs, const std::string& path)
+{
+    constexpr std::size_t setCount{64U};
+    const std::size_t size{cnn.inputSize()};
+    ml::Tensor inputs{setCount, size, size};
+    ml::Tensor targets{setCount, cnn.outputSize()};
+    randomize(inputs);
+    randomize(targets);
+    cnn.train(inputs, targets, 1U, 0.01, 16U);
+
+    auto start{Clock::now()};
+    if (!ml::cnn::saveModel(cnn, path)) { return false; }
+    const double saveMs{elapsedMs(start)};
+
+    start = Clock::now();
+    auto loaded{ml::cnn::loadModel(factory, path)};
+    const double loadMs{elapsedMs(start)};
+    bool success{predictAlike(cnn, *loaded, inputs)};
+
+    // A network loaded read-only must refuse to train.
+    std::cout << "Training a network loaded read-only (must fail): ";
+    success &= !loaded->train(inputs, targets, 1U, 0.01, 16U);
+
+    // Train a network loaded copy-on-write, which must neither affect the file nor the saved
+    // network.
+    auto trained{ml::cnn::loadModel(factory, path, ml::memory::Access::CopyOnWrite)};
+    trained->train(inputs, targets, 1U, 0.01, 16U);
+    auto reloaded{ml::cnn::loadModel(factory, path)};
+    success &= predictAlike(cnn, *reloaded, inputs) && !predictAlike(cnn, *trained, inputs);
+
+    std::cout << std::fixed << std::setprecision(2) << name << ", " << size << "x" << size
+              << ": " << std::filesystem::file_size(path) / 1024.0 << " KiB, construct "
+              << constructMs << " ms, save " << saveMs << " ms, load " << loadMs << " ms, "
+              << (success ? "identical predictions" : "MISMATCH") << "\n";
+    return success;
+}
+
+/**
+ * @brief Check that a write to a read-only mapping faults.
+ *
+ *        The write is done in a child process, which must be killed by a segmentation fault.
+ *
+ * @param[in] path Path to the file to map.
+ *
+ * @return True if the write faults, else false.
+ */
+bool writeFaults(const std::string& path)
+{
+    const pid_t child{::fork()};
+    if (0 > child) { return false; }
+
+    if (0 == child)
+    {
+        ml::memory::MappedFile file{path};
+        *static_cast<volatile std::uint8_t*>(file.data()) = 0U;
+        ::_exit(0);
+    }
+    int status{};
+    ::waitpid(child, &status, 0);
+    const bool success{WIFSIGNALED(status) && (SIGSEGV == WTERMSIG(status))};
+    std::cout << "Write to a read-only mapping: " << (success ? "faults" : "ALLOWED") << "\n";
+    return success;
+}
+
+/**
+ * @brief Check that a modified copy of a model file is rejected when loading.
+ *
+ * @param[in] factory The factory of the saved network.
+ * @param[in] file The content of the saved model file.
+ * @param[in] offset Offset of the bytes to modify.
+ * @param[in] value The bytes to write at the offset.
+ * @param[in] path Path to the model file to use.
+ *
+ * @return True if loading the modified file fails, else false.
+ */
+bool rejected(ml::factory::Interface& factory, std::vector<char> file, 
+              const std::size_t offset, const std::vector<char>& value, const std::string& path)
+{
+    std::memcpy(file.data() + offset, value.data(), value.size());
+    std::ofstream{path, std::ios::binary | std::ios::trunc}.write(file.data(), file.size());
+
+    try { ml::cnn::loadModel(factory, path); }
+    catch (const std::runtime_error&) { return true; }
+    return false;
+}
+
+/**
+ * @brief Check that invalid model files are rejected, given a saved multi-channel network.
+ *
+ *        The header holds the layer counts at offset 24 and the byte order mark at offset 40,
+ *        the 16-byte layer records start at offset 64 with the layer type.
+ *
+ * @param[in] factory The factory of the saved network.
+ * @param[in] path Path to the saved model file.
+ *
+ * @return True if every invalid file is rejected, else false.
+ */
+bool checkRejected(ml::factory::Interface& factory, const std::string& path)
+{
+    std::ifstream stream{path, std::ios::binary};
+    const std::vector<char> file{std::istreambuf_iterator<char>{stream}, 
+                                 std::istreambuf_iterator<char>{}};
+    std::uint32_t convLayerCount{};
+    std::memcpy(&convLayerCount, file.data() + 24U, sizeof(convLayerCount));
+
+    constexpr std::size_t records{64U};
+    constexpr char maxPool{static_cast<char>(ml::conv_layer::Type::MaxPool)};
+    constexpr char multiChannel{static_cast<char>(ml::conv_layer::Type::MultiChannel)};
+
+    const std::vector<char> swapped{file[43U], file[42U], file[41U], file[40U]};
+
+    const bool success{rejected(factory, file, 40U, swapped, path)
+        && rejected(factory, file, records, {maxPool}, path)
+        && rejected(factory, file, records + 32U, {maxPool}, path)
+        && rejected(factory, file, records + 16U * convLayerCount, {multiChannel}, path)};
+    std::cout << "Swapped byte order and misplaced layer records: "
+              << (success ? "rejected" : "ACCEPTED") << "\n";
+    return success;
+}
+} // namespace
+
+/**
+ * @brief Save and load a single-channel and a multi-channel network.
+ *
+ * @return 0 on success, error code -1 on failure.
+ */
+int main()
+{
+    const std::string path{(std::filesystem::temp_directory_path() / "ml_model_bench.bin").string()};
+    ml::factory::Factory factory{};
+
+    auto start{Clock::now()};
+    ml::cnn::Cnn classic{factory, 64U, 5U, ml::act_func::Type::Relu, 2U, 256U,
+                         ml::act_func::Type::Relu, ml::conv_layer::algorithm::Type::Auto};
+    classic.addDenseLayer(10U, ml::act_func::Type::Tanh);
+    const double classicMs{elapsedMs(start)};
+
+    start = Clock::now();
+    ml::cnn::Cnn multi{factory, 32U, {{16U, 3U, ml::act_func::Type::Relu, 2U},
+                                      {32U, 3U, ml::act_func::Type::Relu, 2U}},
+                       10U, ml::act_func::Type::Sigmoid};
+    const double multiMs{elapsedMs(start)};
+
+    bool success{check(factory, classic, "Single-channel network", classicMs, path)};
+    success &= check(factory, multi, "Multi-channel network", multiMs, path);
+    success &= writeFaults(path);
+    success &= checkRejected(factory, path);
+    std::remove(path.c_str());
+
+    // Return -1 if any loaded network doesn't match the saved network.
+    if (!success)
+    {
+        std::cerr << "A loaded network doesn't match the saved network!\n";
+        return -1;
+    }
+    return 0;
+}
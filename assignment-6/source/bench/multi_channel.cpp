@@ -0,0 +1,352 @@
+/**
+ * @brief Benchmark for the multi-channel convolutional layer.
+ *
+ *        Checks the output against a naive convolution over all channel pairs, checks the
+ *        gradients against finite differences, checks copying and filling strided views of
+ *        rank-5 (channel-blocked batch) tensors, and measures the throughput for several
+ *        channel counts with the inner loops of the active SIMD level and the portable ones,
+ *        and with the convolution lowered onto GEMM (im2col). Fails unless the algorithm
+ *        selected automatically is the faster one.
+ *
+ *        Build and run via `make bench BENCH=multi_channel`.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+#include "ml/conv_layer/layout.h"
+#include "ml/conv_layer/multi_channel.h"
+#include "ml/linalg/simd.h"
+#include "ml/random/generator.h"
+#include "ml/scalar.h"
+#include "ml/tensor.h"
+#include "ml/types.h"
+
+namespace
+{
+/** Clock used for the measurements. */
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Get the offset of a pixel in a channel-blocked feature map.
+ *
+ * @param[in] channelCount The number of channels.
+ * @param[in] size The size of the feature map.
+ * @param[in] c The channel.
+ * @param[in] y The row.
+ * @param[in] x The column.
+ *
+ * @return The offset of the pixel.
+ */
+std::size_t pixel(const std::size_t channelCount, const std::size_t size, const std::size_t c,
+                  const std::size_t y, const std::size_t x) noexcept
+{
+    const std::size_t width{ml::conv_layer::blockWidth(channelCount)};
+    return (((c / width) * size + y) * size + x) * width + c % width;
+}
+
+/**
+ * @brief Get the offset of a filter weight.
+ *
+ * @param[in] filters The filters of the layer.
+ * @param[in] kernelSize The kernel size.
+ * @param[in] out The output channel.
+ * @param[in] in The input channel.
+ * @param[in] ky The kernel row.
+ * @param[in] kx The kernel column.
+ *
+ * @return The offset of the weight.
+ */
+std::size_t weight(const ml::Tensor& filters, const std::size_t kernelSize, const std::size_t out,
+                   const std::size_t in, const std::size_t ky, const std::size_t kx) noexcept
+{
+    const std::size_t inputWidth{filters.dim(3U)};
+    const std::size_t outputWidth{filters.dim(4U)};
+    const std::size_t block{(out / outputWidth) * filters.dim(1U) + in / inputWidth};
+    const std::size_t tap{ky * kernelSize + kx};
+    return ((block * filters.dim(2U) + tap) * inputWidth + in % inputWidth) * outputWidth
+        + out % outputWidth;
+}
+
+/**
+ * @brief Fill given tensor with random values in range [-1, 1].
+ *
+ * @param[in] tensor The tensor to fill.
+ */
+void randomize(ml::Tensor& tensor)
+{
+    auto& generator{ml::random::Generator::getInstance()};
+    for (std::size_t i{}; i < tensor.size(); ++i)
+    {
+        tensor.data()[i] = static_cast<ml::Scalar>(generator.float64(-1.0, 1.0));
+    }
+}
+
+/**
+ * @brief Compute the loss sum(weights * output) of the layer for given input.
+ *
+ * @param[in] layer The layer.
+ * @param[in] input The input.
+ * @param[in] weights The weights of the output values.
+ *
+ * @return The loss.
+ */
+double loss(ml::conv_layer::MultiChannelConvLayer& layer, const ml::Tensor& input,
+            const ml::Tensor& weights)
+{
+    layer.feedforward(input);
+    double sum{};
+    for (std::size_t i{}; i < weights.size(); ++i)
+    {
+        sum += static_cast<double>(weights.data()[i]) * layer.output().data()[i];
+    }
+    return sum;
+}
+
+/**
+ * @brief Check the output and the gradients of a layer without activation function.
+ *
+ * @param[in] inputChannels The number of input channels.
+ * @param[in] outputChannels The number of output channels.
+ * @param[in] size The input size.
+ * @param[in] kernelSize The kernel size.
+ * @param[in] algorithm The convolution algorithm.
+ *
+ * @return The maximum relative error.
+ */
+double check(const std::size_t inputChannels, const std::size_t outputChannels,
+             const std::size_t size, const std::size_t kernelSize,
+             const ml::conv_layer::algorithm::Type algorithm)
+{
+    ml::conv_layer::MultiChannelConvLayer layer{inputChannels, outputChannels, size, kernelSize,
+                                                ml::act_func::Type::None, algorithm};
+    // Use batches of a single sample, the layer accepts both layouts.
+    ml::Tensor input{ml::conv_layer::featureMaps(1U, inputChannels, size)};
+    ml::Tensor outputWeights{ml::conv_layer::featureMaps(1U, outputChannels, size)};
+    randomize(input);
+    randomize(outputWeights);
+
+    ml::TensorList parameters{layer.parameters()};
+    ml::Tensor& filters{parameters[0U]};
+    const ml::Tensor& bias{parameters[1U]};
+    const std::size_t pad{kernelSize / 2U};
+    double maxError{};
+
+    // Compare the output with a naive convolution (zero padding, same output size).
+    layer.feedforward(input);
+    for (std::size_t out{}; out < outputChannels; ++out)
+    {
+        for (std::size_t y{}; y < size; ++y)
+        {
+            for (std::size_t x{}; x < size; ++x)
+            {
+                double sum{bias(out)};
+                for (std::size_t in{}; in < inputChannels; ++in)
+                {
+                    for (std::size_t ky{}; ky < kernelSize; ++ky)
+                    {
+                        for (std::size_t kx{}; kx < kernelSize; ++kx)
+                        {
+                            const std::size_t row{y + ky - pad};
+                            const std::size_t col{x + kx - pad};
+                            if ((row >= size) || (col >= size)) { continue; }
+                            sum += input.data()[pixel(inputChannels, size, in, row, col)]
+                                * filters.data()[weight(filters, kernelSize, out, in, ky, kx)];
+                        }
+                    }
+                }
+                const double value{layer.output().data()[pixel(outputChannels, size, out, y, x)]};
+                maxError = std::max(maxError, std::abs(value - sum) / (1.0 + std::abs(sum)));
+            }
+        }
+    }
+
+    // The layer is linear, so the gradients of the loss equal the backpropagated gradients.
+    layer.backpropagate(outputWeights);
+    const ml::Tensor inputGradients{layer.inputGradients()};
+    const ml::Tensor filterGradients{layer.gradients()[0U]};
+    const double step{sizeof(ml::Scalar) == sizeof(float) ? 1e-2 : 1e-5};
+
+    for (std::size_t i{}; i < input.size(); i += 7U)
+    {
+        const ml::Scalar original{input.data()[i]};
+        input.data()[i] = original + static_cast<ml::Scalar>(step);
+        const double upper{loss(layer, input, outputWeights)};
+        input.data()[i] = original - static_cast<ml::Scalar>(step);
+        const double lower{loss(layer, input, outputWeights)};
+        input.data()[i] = original;
+        const double expected{(upper - lower) / (2.0 * step)};
+        maxError = std::max(maxError, std::abs(inputGradients.data()[i] - expected)
+            / (1.0 + std::abs(expected)));
+    }
+    for (std::size_t i{}; i < filters.size(); i += 5U)
+    {
+        const ml::Scalar original{filters.data()[i]};
+        filters.data()[i] = original + static_cast<ml::Scalar>(step);
+        const double upper{loss(layer, input, outputWeights)};
+        filters.data()[i] = original - static_cast<ml::Scalar>(step);
+        const double lower{loss(layer, input, outputWeights)};
+        filters.data()[i] = original;
+        const double expected{(upper - lower) / (2.0 * step)};
+        maxError = std::max(maxError, std::abs(filterGradients.data()[i] - expected)
+            / (1.0 + std::abs(expected)));
+    }
+    return maxError;
+}
+
+/**
+ * @brief Check copying and filling a strided view of a rank-5 tensor, shaped like a batch
+ *        of channel-blocked feature maps (batch, blocks, height, width, block width).
+ *
+ * @return True if every element of the view is copied and filled, else false.
+ */
+bool checkStridedViews()
+{
+    // Narrow the innermost dimension, so that no dimension of the view is contiguous.
+    constexpr std::size_t width{3U};
+    ml::Tensor source{2U, 2U, 2U, 2U, width};
+    for (std::size_t i{}; i < source.size(); ++i) { source.data()[i] = static_cast<ml::Scalar>(i + 1U); }
+    const ml::Tensor view{source.narrow(4U, 1U, 2U)};
+
+    // Copy via copyFrom() and via the copy constructor, then compare in row-major order.
+    ml::Tensor copied{2U, 2U, 2U, 2U, 2U};
+    bool success{copied.copyFrom(view)};
+    const ml::Tensor constructed{view};
+
+    for (std::size_t i{}; i < copied.size(); ++i)
+    {
+        const auto expected{static_cast<ml::Scalar>(i / 2U * width + i % 2U + 2U)};
+        success &= (expected == copied.data()[i]) && (expected == constructed.data()[i]);
+    }
+
+    // Fill the view, which must leave exactly the first element of each block untouched.
+    source.narrow(4U, 1U, 2U).fill(ml::Scalar{});
+
+    for (std::size_t i{}; i < source.size(); ++i)
+    {
+        const bool inView{0U != i % width};
+        success &= inView ? (ml::Scalar{} == source.data()[i])
+                          : (static_cast<ml::Scalar>(i + 1U) == source.data()[i]);
+    }
+    return success;
+}
+
+/**
+ * @brief Measure the feedforward throughput of a layer.
+ *
+ * @param[in] inputChannels The number of input channels.
+ * @param[in] outputChannels The number of output channels.
+ * @param[in] size The input size.
+ * @param[in] kernelSize The kernel size.
+ * @param[in] algorithm The convolution algorithm.
+ *
+ * @return The throughput in GFLOP/s.
+ */
+double throughput(const std::size_t inputChannels, const std::size_t outputChannels,
+                  const std::size_t size, const std::size_t kernelSize,
+                  const ml::conv_layer::algorithm::Type algorithm)
+{
+    constexpr double minSeconds{0.2};
+    ml::conv_layer::MultiChannelConvLayer layer{inputChannels, outputChannels, size, kernelSize,
+                                                ml::act_func::Type::None, algorithm};
+    ml::Tensor input{ml::conv_layer::featureMaps(1U, inputChannels, size)};
+    randomize(input);
+
+    std::size_t roundCount{};
+    const auto start{Clock::now()};
+    double seconds{};
+
+    while (seconds < minSeconds)
+    {
+        layer.feedforward(input);
+        ++roundCount;
+        seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+    const double flops{2.0 * size * size * kernelSize * kernelSize * inputChannels
+        * outputChannels};
+    return flops * roundCount / seconds * 1e-9;
+}
+} // namespace
+
+/**
+ * @brief Check the multi-channel convolutional layer and measure its throughput.
+ *
+ * @return 0 on success, error code -1 on failure.
+ */
+int main()
+{
+    using ml::conv_layer::ChannelBlock;
+    using Algorithm = ml::conv_layer::algorithm::Type;
+    const double tolerance{sizeof(ml::Scalar) == sizeof(float) ? 1e-2 : 1e-6};
+    ml::random::Generator::getInstance().seed(42U);
+
+    // Check channel counts below, equal to and above the block width, and even kernels.
+    double maxError{};
+    for (const auto algorithm : {Algorithm::Direct, Algorithm::Im2col})
+    {
+        maxError = std::max(maxError, check(1U, 3U, 7U, 3U, algorithm));
+        maxError = std::max(maxError, check(3U, ChannelBlock, 6U, 4U, algorithm));
+        maxError = std::max(maxError, check(ChannelBlock, 2U * ChannelBlock, 5U, 5U, algorithm));
+        maxError = std::max(maxError, check(2U * ChannelBlock, ChannelBlock, 9U, 1U, algorithm));
+    }
+
+    std::cout << "SIMD level: " << ml::linalg::simdLevelName(ml::linalg::simdLevel()) << "\n";
+    std::cout << "Max relative error (output and gradients): " << maxError << "\n";
+    const bool viewsCopied{checkStridedViews()};
+    std::cout << "Rank-5 strided copy and fill: " << (viewsCopied ? "correct" : "MISMATCH")
+              << "\n\n";
+
+    // Measure the throughput of direct convolution with the active SIMD level and the
+    // portable loops and of im2col, then check the algorithm selected automatically.
+    constexpr std::size_t size{28U};
+    const ml::linalg::SimdLevel level{ml::linalg::simdLevel()};
+    bool autoFast{true};
+    std::cout << std::fixed << std::setprecision(2);
+
+    for (const std::size_t kernelSize : {3U, 5U})
+    {
+        std::cout << "Channels (in -> out), " << size << "x" << size << ", kernel "
+                  << kernelSize << "x" << kernelSize << ": GFLOP/s direct (active / portable)"
+                  << " / GFLOP/s im2col / auto\n";
+
+        for (const std::size_t channels : {ChannelBlock / 2U, ChannelBlock, 2U * ChannelBlock,
+                                           4U * ChannelBlock, 8U * ChannelBlock})
+        {
+            const std::size_t inputChannels{channels == ChannelBlock / 2U ? 1U : channels};
+            const double active{throughput(inputChannels, channels, size, kernelSize,
+                                           Algorithm::Direct)};
+            ml::linalg::setSimdLevel(ml::linalg::SimdLevel::Scalar);
+            const double portable{throughput(inputChannels, channels, size, kernelSize,
+                                             Algorithm::Direct)};
+            ml::linalg::setSimdLevel(level);
+            const double im2col{throughput(inputChannels, channels, size, kernelSize,
+                                           Algorithm::Im2col)};
+            const ml::conv_layer::MultiChannelConvLayer layer{inputChannels, channels, size,
+                                                              kernelSize};
+            const bool lowered{Algorithm::Im2col == layer.algorithm()};
+            std::cout << std::setw(4) << inputChannels << " -> " << std::setw(4) << channels
+                      << ": " << std::setw(8) << active << " / " << std::setw(8) << portable
+                      << " / " << std::setw(8) << im2col << " / "
+                      << (lowered ? "im2col" : "direct") << "\n";
+
+            // Auto must pick the faster algorithm, allow some noise for close calls.
+            autoFast &= lowered ? (im2col >= 0.9 * active) : (active >= 0.9 * im2col);
+        }
+        std::cout << "\n";
+    }
+
+    // Return -1 if the layer doesn't match the reference or if auto is slower than direct.
+    if ((maxError > tolerance) || !viewsCopied)
+    {
+        std::cerr << "Multi-channel convolution doesn't match the reference!\n";
+        return -1;
+    }
+    else if (!autoFast)
+    {
+        std::cerr << "The automatically selected algorithm isn't the faster one!\n";
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,390 @@
+/**
+ * @brief Benchmark for the optimizers.
+ *
+ *        Trains the same network with fixed initial weights with every optimizer type on a
+ *        synthetic dataset and reports the loss after each epoch, then measures the update
+ *        throughput of the fused optimizer steps against Adam written as three separate
+ *        passes, and checks that both give the same parameters. Also checks that synchronous
+ *        parallel training keeps the optimizer state across several training calls, i.e.
+ *        gives the same network as serial training.
+ *
+ *        Build and run via `make bench BENCH=optimizer`.
+ */
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "ml/cnn/cnn.h"
+#include "ml/cnn/parallel_trainer.h"
+#include "ml/factory/factory.h"
+#include "ml/optimizer/optimizer.h"
+#include "ml/optimizer/type.h"
+#include "ml/random/generator.h"
+#include "ml/scalar.h"
+#include "ml/tensor.h"
+#include "ml/types.h"
+#include "ml/utils.h"
+
+namespace
+{
+/** Clock used for the measurements. */
+using Clock = std::chrono::steady_clock;
+
+/** Number of samples in the dataset. */
+constexpr std::size_t SampleCount{1024U};
+
+/** Height and width of the inputs. */
+constexpr std::size_t InputSize{8U};
+
+/** Number of classes. */
+constexpr std::size_t ClassCount{4U};
+
+/** Number of samples per batch. */
+constexpr std::size_t BatchSize{8U};
+
+/** Number of epochs to train. */
+constexpr std::size_t EpochCount{5U};
+
+/** Number of parameters updated per step in the throughput measurement. */
+constexpr std::size_t ParameterCount{1U << 20U};
+
+/** Number of steps in the throughput measurement. */
+constexpr std::size_t StepCount{50U};
+
+/**
+ * @brief Optimizer configuration to train with.
+ */
+struct Setup
+{
+    /** Name of the configuration. */
+    const char* name;
+
+    /** Optimizer type. */
+    ml::optimizer::Type type;
+
+    /** Learning rate to use during training. */
+    double learningRate;
+};
+
+/** Optimizer configurations to train with, with learning rates suited to the type. */
+constexpr Setup Setups[]{{"SGD", ml::optimizer::Type::Sgd, 0.1},
+                         {"Momentum", ml::optimizer::Type::Momentum, 0.01},
+                         {"Nesterov", ml::optimizer::Type::Nesterov, 0.01},
+                         {"RMSProp", ml::optimizer::Type::RmsProp, 0.001},
+                         {"Adam", ml::optimizer::Type::Adam, 0.001},
+                         {"AdamW", ml::optimizer::Type::AdamW, 0.001}};
+
+/**
+ * @brief Get the number of milliseconds since given start time.
+ *
+ * @param[in] start The start time.
+ *
+ * @return The elapsed time in milliseconds.
+ */
+double elapsedMs(const Clock::time_point start) noexcept
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/**
+ * @brief Create a synthetic dataset, where the class of each input is given by the row of a
+ *        bright band on a noisy background.
+ *
+ * @param[out] inputs Tensor in which to store the inputs.
+ * @param[out] targets Tensor in which to store the one-hot encoded targets.
+ */
+void createDataset(ml::Tensor& inputs, ml::Tensor& targets)
+{
+    auto& generator{ml::random::Generator::getInstance()};
+    inputs  = ml::Tensor{SampleCount, InputSize, InputSize};
+    targets = ml::Tensor{SampleCount, ClassCount};
+
+    for (std::size_t i{}; i < SampleCount; ++i)
+    {
+        const std::size_t label{generator.uint32(ClassCount)};
+        targets(i, label) = ml::Scalar{1};
+
+        for (std::size_t y{}; y < InputSize; ++y)
+        {
+            for (std::size_t x{}; x < InputSize; ++x)
+            {
+                const bool bright{(label * 2U <= y) && (y < label * 2U + 2U)};
+                inputs(i, y, x) = (bright ? ml::Scalar{0.8} : ml::Scalar{})
+                    + ml::Scalar{0.2} * generator.uint32(256U) / ml::Scalar{255};
+            }
+        }
+    }
+}
+
+/**
+ * @brief Compute the mean squared error of the network on a dataset.
+ *
+ * @param[in] cnn The network.
+ * @param[in] inputs The inputs.
+ * @param[in] targets The targets.
+ *
+ * @return The mean squared error.
+ */
+double loss(ml::cnn::Cnn& cnn, const ml::Tensor& inputs, const ml::Tensor& targets)
+{
+    ml::Tensor outputs{SampleCount, ClassCount};
+    cnn.predictBatch(inputs, outputs, SampleCount);
+    double sum{};
+
+    for (std::size_t i{}; i < outputs.size(); ++i)
+    {
+        const double error{outputs.data()[i] - targets.data()[i]};
+        sum += error * error;
+    }
+    return sum / outputs.size();
+}
+
+/**
+ * @brief Create the network to train, with fixed initial weights.
+ *
+ * @param[in] factory The factory to use.
+ * @param[in] type The optimizer type to use.
+ *
+ * @return The network.
+ */
+std::unique_ptr<ml::cnn::Cnn> createNetwork(ml::factory::Interface& factory,
+                                            const ml::optimizer::Type type)
+{
+    ml::random::Generator::getInstance().seed(42U);
+    auto cnn{std::make_unique<ml::cnn::Cnn>(factory, InputSize, std::vector<ml::cnn::ConvStage>{
+        {2U, 3U, ml::act_func::Type::Relu, 2U}}, ClassCount, ml::act_func::Type::Tanh)};
+    ml::optimizer::Config config{};
+    config.type = type;
+    cnn->setOptimizer(config);
+    return cnn;
+}
+
+/**
+ * @brief Train the network with fixed initial weights and print the loss before training
+ *        and after each epoch.
+ *
+ * @param[in] setup The optimizer configuration.
+ * @param[in] inputs The inputs.
+ * @param[in] targets The targets.
+ *
+ * @return True on success, else false.
+ */
+bool train(const Setup& setup, const ml::Tensor& inputs, const ml::Tensor& targets)
+{
+    ml::factory::Factory factory{};
+    auto cnnPtr{createNetwork(factory, setup.type)};
+    ml::cnn::Cnn& cnn{*cnnPtr};
+    bool success{true};
+    double trainMs{};
+    std::cout << std::left << std::setw(10) << setup.name << std::right << std::fixed
+              << std::setprecision(4) << std::setw(9) << loss(cnn, inputs, targets);
+
+    for (std::size_t epoch{}; epoch < EpochCount; ++epoch)
+    {
+        const auto start{Clock::now()};
+        success &= cnn.train(inputs, targets, 1U, setup.learningRate, BatchSize);
+        trainMs += elapsedMs(start);
+        std::cout << std::setw(9) << loss(cnn, inputs, targets);
+    }
+    std::cout << std::setprecision(1) << std::setw(10) << trainMs << " ms, state "
+              << cnn.optimizer().stateBytes() << " B\n";
+    return success;
+}
+
+/**
+ * @brief Update the parameters with Adam in three separate passes, as a reference.
+ *
+ * @param[in, out] parameters The parameters.
+ * @param[in] gradients The gradients.
+ * @param[in, out] first The first moments.
+ * @param[in, out] second The second moments.
+ * @param[in] learningRate The learning rate.
+ * @param[in] step The number of the step, starting at 1.
+ */
+void adamReference(ml::Tensor& parameters, const ml::Tensor& gradients, ml::Tensor& first,
+                   ml::Tensor& second, const double learningRate, const std::size_t step)
+{
+    const ml::optimizer::Config config{};
+    const auto b1{static_cast<ml::Scalar>(config.beta1)};
+    const auto b2{static_cast<ml::Scalar>(config.beta2)};
+    const auto epsilon{static_cast<ml::Scalar>(config.epsilon)};
+    const auto firstScale{static_cast<ml::Scalar>(
+        learningRate / (1.0 - std::pow(config.beta1, static_cast<double>(step))))};
+    const auto secondScale{static_cast<ml::Scalar>(
+        1.0 / std::sqrt(1.0 - std::pow(config.beta2, static_cast<double>(step))))};
+    const std::size_t n{parameters.size()};
+    ml::Scalar* p{parameters.data()};
+    const ml::Scalar* g{gradients.data()};
+    ml::Scalar* m{first.data()};
+    ml::Scalar* v{second.data()};
+
+    for (std::size_t i{}; i < n; ++i) { m[i] = b1 * m[i] + (ml::Scalar{1} - b1) * g[i]; }
+    for (std::size_t i{}; i < n; ++i) { v[i] = b2 * v[i] + (ml::Scalar{1} - b2) * g[i] * g[i]; }
+    for (std::size_t i{}; i < n; ++i)
+    {
+        p[i] += firstScale * m[i] / (std::sqrt(v[i]) * secondScale + epsilon);
+    }
+}
+
+/**
+ * @brief Measure the update throughput of each optimizer type.
+ *
+ * @return True if the fused Adam steps match the reference, else false.
+ */
+bool measureSteps()
+{
+    constexpr double learningRate{0.001};
+    ml::TensorList gradients{};
+    gradients.push_back(ml::Tensor{ParameterCount});
+    for (std::size_t i{}; i < ParameterCount; ++i) { gradients[0U].data()[i] = ml::randomStartVal(); }
+
+    std::cout << "\nUpdate throughput, " << ParameterCount << " parameters:\n";
+    const auto print{[](const char* name, const double ms)
+    {
+        std::cout << "  " << std::left << std::setw(20) << name << std::right << std::fixed
+                  << std::setprecision(2) << std::setw(8) << ms * 1e6 / (StepCount * ParameterCount)
+                  << " ns/parameter\n";
+    }};
+
+    // Measure the fused steps of each optimizer type.
+    ml::TensorList adamParameters{};
+    adamParameters.push_back(ml::Tensor{ParameterCount});
+
+    for (const auto& setup : Setups)
+    {
+        ml::optimizer::Config config{};
+        config.type = setup.type;
+        ml::optimizer::Optimizer optimizer{config};
+        ml::TensorList parameters{};
+        parameters.push_back(ml::Tensor{ParameterCount});
+
+        const auto start{Clock::now()};
+        for (std::size_t i{}; i < StepCount; ++i) { optimizer.step(parameters, gradients, learningRate); }
+        print(setup.name, elapsedMs(start));
+        if (ml::optimizer::Type::Adam == setup.type) { adamParameters[0U].copyFrom(parameters[0U]); }
+    }
+
+    // Measure Adam in three passes, which reads the moments twice and the gradients twice.
+    ml::Tensor parameters{ParameterCount};
+    ml::Tensor first{ParameterCount};
+    ml::Tensor second{ParameterCount};
+    const auto start{Clock::now()};
+
+    for (std::size_t i{}; i < StepCount; ++i)
+    {
+        adamReference(parameters, gradients[0U], first, second, learningRate, i + 1U);
+    }
+    print("Adam (three passes)", elapsedMs(start));
+
+    // Check that the fused steps give the same parameters, up to rounding.
+    double maxError{};
+    for (std::size_t i{}; i < ParameterCount; ++i)
+    {
+        const double error{std::abs(parameters.data()[i] - adamParameters[0U].data()[i])};
+        if (error > maxError) { maxError = error; }
+    }
+    const bool matches{1e-4 * learningRate * StepCount > maxError};
+    std::cout << "  Fused vs three-pass Adam: max difference " << std::scientific
+              << std::setprecision(2) << maxError << (matches ? "" : " MISMATCH") << "\n";
+    return matches;
+}
+
+/**
+ * @brief Check that synchronous parallel training gives the same network as serial training
+ *        when the training is split into several calls, which requires the replicas of the
+ *        workers to continue with the optimizer state of the network.
+ *
+ *        Every sample is the same, so the shards of the workers have the same gradients as
+ *        the whole batch, whichever order the samples are trained in.
+ *
+ * @param[in] inputs The inputs, of which the first one is used.
+ * @param[in] targets The targets, of which the first one is used.
+ *
+ * @return True if the networks match, else false.
+ */
+bool checkParallel(const ml::Tensor& inputs, const ml::Tensor& targets)
+{
+    constexpr std::size_t sampleCount{16U};
+    constexpr std::size_t callCount{3U};
+    constexpr double learningRate{0.001};
+    ml::Tensor sameInputs{sampleCount, InputSize, InputSize};
+    ml::Tensor sameTargets{sampleCount, ClassCount};
+
+    for (std::size_t i{}; i < sampleCount; ++i)
+    {
+        sameInputs.slice(i).copyFrom(inputs.slice(0U));
+        sameTargets.slice(i).copyFrom(targets.slice(0U));
+    }
+
+    // Train serially and with two synchronous workers, one epoch per call.
+    bool success{true};
+    double maxError{};
+    std::cout << "\nSynchronous training on 2 threads vs serial, " << callCount
+              << " training calls:\n";
+
+    for (const auto type : {ml::optimizer::Type::Momentum, ml::optimizer::Type::Adam})
+    {
+        ml::factory::Factory factory{};
+        auto serial{createNetwork(factory, type)};
+        auto parallel{createNetwork(factory, type)};
+        ml::cnn::ParallelTrainer trainer{*parallel, 2U};
+
+        for (std::size_t i{}; i < callCount; ++i)
+        {
+            success &= serial->train(sameInputs, sameTargets, 1U, learningRate, BatchSize);
+            success &= trainer.train(sameInputs, sameTargets, 1U, learningRate, BatchSize);
+        }
+
+        ml::Tensor serialOutputs{SampleCount, ClassCount};
+        ml::Tensor parallelOutputs{SampleCount, ClassCount};
+        serial->predictBatch(inputs, serialOutputs, SampleCount);
+        parallel->predictBatch(inputs, parallelOutputs, SampleCount);
+
+        for (std::size_t i{}; i < serialOutputs.size(); ++i)
+        {
+            const double error{std::abs(serialOutputs.data()[i] - parallelOutputs.data()[i])};
+            if (error > maxError) { maxError = error; }
+        }
+        success &= (parallel->optimizer().stepCount() == serial->optimizer().stepCount());
+    }
+
+    const double tolerance{sizeof(ml::Scalar) == sizeof(float) ? 1e-6 : 1e-12};
+    const bool matches{success && (tolerance >= maxError)};
+    std::cout << "  Max prediction difference " << std::scientific << std::setprecision(2)
+              << maxError << (matches ? "" : " MISMATCH") << "\n";
+    return matches;
+}
+} // namespace
+
+/**
+ * @brief Compare the optimizers.
+ *
+ * @return 0 on success, error code -1 on failure.
+ */
+int main()
+{
+    ml::Tensor inputs{};
+    ml::Tensor targets{};
+    createDataset(inputs, targets);
+
+    // Train with each optimizer type.
+    std::cout << "Loss (MSE) before training and after each of " << EpochCount << " epochs, " << SampleCount
+              << " samples, batch size " << BatchSize << ":\n";
+    bool success{true};
+    for (const auto& setup : Setups) { success &= train(setup, inputs, targets); }
+
+    success &= measureSteps();
+    success &= checkParallel(inputs, targets);
+
+    // Return -1 if training failed or the fused steps don't match the reference.
+    if (!success)
+    {
+        std::cerr << "Training failed or doesn't match the reference!\n";
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,162 @@
+/**
+ * @brief Throughput and determinism benchmark for data-parallel CNN training.
+ *
+ *        Build and run via `make bench BENCH=parallel`.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+#include "ml/cnn/cnn.h"
+#include "ml/cnn/parallel_trainer.h"
+#include "ml/conv_layer/interface.h"
+#include "ml/dense_layer/interface.h"
+#include "ml/factory/factory.h"
+#include "ml/random/generator.h"
+#include "ml/scalar.h"
+#include "ml/tensor.h"
+#include "ml/utils.h"
+
+namespace
+{
+/** Clock used for the measurements. */
+using Clock = std::chrono::steady_clock;
+
+/** Seed used for every training run. */
+constexpr std::uint32_t Seed{42U};
+
+/**
+ * @brief Get the number of seconds elapsed since given start time.
+ *
+ * @param[in] start The start time.
+ *
+ * @return The elapsed time in seconds.
+ */
+double secondsSince(const Clock::time_point start) noexcept
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/**
+ * @brief Fill given tensor with random values in the range [0, 1].
+ *
+ * @param[in] tensor The tensor to fill.
+ */
+void randomize(ml::Tensor& tensor) noexcept
+{
+    for (std::size_t i{}; i < tensor.size(); ++i) { tensor.data()[i] = ml::randomStartVal(); }
+}
+
+/**
+ * @brief Compute a checksum of the parameters of given network.
+ *
+ * @param[in] cnn The network.
+ *
+ * @return The sum of all parameters, weighted by their position.
+ */
+double checksum(const ml::cnn::Cnn& cnn)
+{
+    double sum{};
+    std::size_t position{};
+
+    const auto add{[&](const ml::TensorList& parameters)
+    {
+        for (const auto& parameter : parameters)
+        {
+            const ml::Tensor values{parameter};
+
+            for (std::size_t i{}; i < values.size(); ++i)
+            {
+                sum += values.data()[i] * static_cast<double>(++position % 7U + 1U);
+            }
+        }
+    }};
+    for (const auto& layer : cnn.convLayers()) { add(layer->parameters()); }
+    for (const auto& layer : cnn.denseLayers()) { add(layer->parameters()); }
+    return sum;
+}
+
+/**
+ * @brief Train a freshly seeded network with given number of threads.
+ *
+ * @param[in] factory Machine learning factory.
+ * @param[in] inputs Training input sets.
+ * @param[in] outputs Training output sets.
+ * @param[in] threadCount Number of worker threads.
+ * @param[out] seconds The training time in seconds.
+ *
+ * @return The checksum of the trained parameters.
+ */
+double trainSeeded(ml::factory::Interface& factory, const ml::Tensor& inputs,
+                   const ml::Tensor& outputs, const std::size_t threadCount, double& seconds)
+{
+    // Network and training parameters.
+    constexpr std::size_t kernelSize{5U};
+    constexpr std::size_t poolSize{2U};
+    constexpr std::size_t hiddenSize{256U};
+    constexpr std::size_t epochCount{3U};
+    constexpr std::size_t batchSize{64U};
+    constexpr double learningRate{0.001};
+
+    // Seed the generator before creating the network, so that every run starts from the
+    // same weights and uses the same training order.
+    ml::random::Generator::getInstance().seed(Seed);
+    ml::cnn::Cnn cnn{factory, inputs.dim(1U), kernelSize, ml::act_func::Type::Relu, poolSize,
+                     hiddenSize, ml::act_func::Type::Relu, ml::conv_layer::algorithm::Type::Auto};
+    cnn.addDenseLayer(outputs.dim(1U), ml::act_func::Type::Tanh);
+
+    ml::cnn::ParallelTrainer trainer{cnn, threadCount};
+    const auto start{Clock::now()};
+    if (!trainer.train(inputs, outputs, epochCount, learningRate, batchSize)) { return 0.0; }
+    seconds = secondsSince(start);
+    return checksum(cnn);
+}
+} // namespace
+
+/**
+ * @brief Measure the training throughput for an increasing number of threads, and check
+ *        that repeated runs with the same seed and thread count give identical results.
+ *
+ * @return 0 on success, error code -1 on failure.
+ */
+int main()
+{
+    // Data parameters.
+    constexpr std::size_t inputSize{64U};
+    constexpr std::size_t outputSize{10U};
+    constexpr std::size_t setCount{256U};
+    constexpr std::size_t epochCount{3U};
+
+    // Create random training data.
+    ml::Tensor inputs{setCount, inputSize, inputSize};
+    ml::Tensor outputs{setCount, outputSize};
+    randomize(inputs);
+    randomize(outputs);
+
+    ml::factory::Factory factory{};
+    const std::size_t maxThreadCount{std::max(1U, std::thread::hardware_concurrency())};
+    bool deterministic{true};
+    double baseline{};
+
+    for (std::size_t threadCount{1U}; threadCount <= std::min<std::size_t>(maxThreadCount, 16U);
+         threadCount *= 2U)
+    {
+        double seconds{}, repeatSeconds{};
+        const double sum{trainSeeded(factory, inputs, outputs, threadCount, seconds)};
+        const double repeatSum{trainSeeded(factory, inputs, outputs, threadCount, repeatSeconds)};
+        if (0.0 == seconds) { return -1; }
+
+        const double throughput{epochCount * setCount / std::min(seconds, repeatSeconds)};
+        if (1U == threadCount) { baseline = throughput; }
+        deterministic &= sum == repeatSum;
+
+        std::cout << "Threads: " << threadCount << ", training: " << throughput
+                  << " samples/s (" << throughput / baseline << "x), checksum: " << sum
+                  << (sum == repeatSum ? "" : " (mismatch!)") << "\n";
+    }
+    std::cout << "Deterministic: " << (deterministic ? "yes" : "no") << "\n\n";
+    return deterministic ? 0 : -1;
+}
@@ -0,0 +1,170 @@
+/**
+ * @brief Benchmark for the background input pipeline.
+ *
+ *        Checks that the batches of a pipeline only depend on the random seed, not on the
+ *        number of workers or buffers, then compares training with inline data loading to
+ *        training on pipelines with and without augmentation, and reports how often the
+ *        trainer had to wait for data.
+ *
+ *        Build and run via `make bench BENCH=pipeline`.
+ */
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "ml/cnn/cnn.h"
+#include "ml/dataset/augmentation.h"
+#include "ml/dataset/pipeline.h"
+#include "ml/dataset/tensor_dataset.h"
+#include "ml/factory/factory.h"
+#include "ml/random/generator.h"
+#include "ml/scalar.h"
+#include "ml/tensor.h"
+#include "ml/utils.h"
+
+namespace
+{
+/** Clock used for the measurements. */
+using Clock = std::chrono::steady_clock;
+
+/** Height and width of the inputs. */
+constexpr std::size_t InputSize{28U};
+
+/** Number of classes. */
+constexpr std::size_t ClassCount{10U};
+
+/** Number of samples per batch. */
+constexpr std::size_t BatchSize{32U};
+
+/** Number of epochs to train. */
+constexpr std::size_t EpochCount{2U};
+
+/** Learning rate to use during training. */
+constexpr double LearningRate{0.1};
+
+/**
+ * @brief Get the number of milliseconds since given start time.
+ *
+ * @param[in] start The start time.
+ *
+ * @return The elapsed time in milliseconds.
+ */
+double elapsedMs(const Clock::time_point start) noexcept
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/**
+ * @brief Compute a checksum of every batch of a pipeline, which depends on the batch order.
+ *
+ * @param[in] pipeline The pipeline to read.
+ *
+ * @return The checksum.
+ */
+double checksum(ml::dataset::Pipeline& pipeline)
+{
+    ml::Tensor inputs{};
+    ml::Tensor targets{};
+    double result{};
+
+    for (std::size_t batch{1U}; pipeline.next(inputs, targets); ++batch)
+    {
+        for (std::size_t i{}; i < inputs.size(); ++i) { result += batch * i * inputs.data()[i]; }
+        for (std::size_t i{}; i < targets.size(); ++i) { result += batch * i * targets.data()[i]; }
+    }
+    return result;
+}
+
+/**
+ * @brief Create the network to train, with fixed initial weights.
+ *
+ * @param[in] factory The factory to use.
+ *
+ * @return The network.
+ */
+std::unique_ptr<ml::cnn::Cnn> createNetwork(ml::factory::Interface& factory)
+{
+    ml::random::Generator::getInstance().seed(42U);
+    return std::make_unique<ml::cnn::Cnn>(factory, InputSize, std::vector<ml::cnn::ConvStage>{
+        {8U, 3U, ml::act_func::Type::Relu, 2U}}, ClassCount, ml::act_func::Type::Sigmoid);
+}
+
+/**
+ * @brief Train a network on a pipeline and print the time and the waiting statistics.
+ *
+ * @param[in] dataset The dataset to train on.
+ * @param[in] name The name of the configuration.
+ * @param[in] workerCount The number of workers.
+ * @param[in] augmentation The augmentation to apply.
+ *
+ * @return True on success, else false.
+ */
+bool trainPipeline(const ml::dataset::Interface& dataset, const char* name,
+                   const std::size_t workerCount, const ml::dataset::Augmentation& augmentation)
+{
+    ml::factory::Factory factory{};
+    auto cnn{createNetwork(factory)};
+    ml::dataset::Pipeline pipeline{dataset, BatchSize, EpochCount, workerCount, 3U, augmentation};
+
+    const auto start{Clock::now()};
+    const bool success{cnn->train(pipeline, LearningRate)};
+    std::cout << std::fixed << std::setprecision(1) << name << ": " << elapsedMs(start)
+              << " ms\n";
+    ml::dataset::printStats(pipeline.stats());
+    return success;
+}
+} // namespace
+
+/**
+ * @brief Check and measure the input pipeline.
+ *
+ * @return 0 on success, error code -1 on failure.
+ */
+int main()
+{
+    constexpr std::size_t sampleCount{4096U};
+    const ml::dataset::Augmentation augmentation{2U, true, ml::Scalar{0.05}};
+
+    // Create a random dataset with one-hot targets.
+    ml::Tensor inputs{sampleCount, InputSize, InputSize};
+    ml::Tensor targets{sampleCount, ClassCount};
+    for (std::size_t i{}; i < inputs.size(); ++i) { inputs.data()[i] = ml::randomStartVal(); }
+    for (std::size_t i{}; i < sampleCount; ++i)
+    {
+        targets(i, ml::random::Generator::getInstance().uint32(ClassCount)) = ml::Scalar{1};
+    }
+    const ml::dataset::TensorDataset dataset{inputs, targets};
+
+    // Check that the batches don't depend on the number of workers or buffers.
+    ml::random::Generator::getInstance().seed(7U);
+    ml::dataset::Pipeline single{dataset, BatchSize, EpochCount, 1U, 2U, augmentation};
+    const double expected{checksum(single)};
+    ml::random::Generator::getInstance().seed(7U);
+    ml::dataset::Pipeline multiple{dataset, BatchSize, EpochCount, 3U, 3U, augmentation};
+    const bool deterministic{expected == checksum(multiple)};
+    std::cout << "Batches with 1 and 3 workers: " << (deterministic ? "identical" : "MISMATCH")
+              << "\n";
+
+    // Train with inline data loading, then on pipelines.
+    ml::factory::Factory factory{};
+    auto cnn{createNetwork(factory)};
+    const auto start{Clock::now()};
+    bool success{cnn->train(dataset, EpochCount, LearningRate, BatchSize)};
+    std::cout << std::fixed << std::setprecision(1) << "Inline loading: " << elapsedMs(start)
+              << " ms\n";
+
+    success &= trainPipeline(dataset, "Pipeline, 1 worker", 1U, ml::dataset::Augmentation{});
+    success &= trainPipeline(dataset, "Pipeline, 1 worker, augmented", 1U, augmentation);
+    success &= trainPipeline(dataset, "Pipeline, 2 workers, augmented", 2U, augmentation);
+
+    // Return -1 if training failed or the batches aren't deterministic.
+    if (!success || !deterministic)
+    {
+        std::cerr << "The pipeline isn't deterministic or training failed!\n";
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,142 @@
+/**
+ * @brief Accuracy and throughput benchmark for INT8 post-training quantization.
+ *
+ *        Build and run via `make bench BENCH=quantized`.
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+#include "ml/cnn/cnn.h"
+#include "ml/factory/factory.h"
+#include "ml/linalg/simd.h"
+#include "ml/quant/accuracy.h"
+#include "ml/quant/quantized_cnn.h"
+#include "ml/scalar.h"
+#include "ml/tensor.h"
+#include "ml/utils.h"
+
+namespace
+{
+/** Clock used for the measurements. */
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Get the number of seconds elapsed since given start time.
+ *
+ * @param[in] start The start time.
+ *
+ * @return The elapsed time in seconds.
+ */
+double secondsSince(const Clock::time_point start) noexcept
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/**
+ * @brief Create a labeled data set of noisy images, where the class is given by the position of
+ *        a bright horizontal bar.
+ *
+ * @param[out] inputs Tensor in which to store the images, shape (set count, size, size).
+ * @param[out] outputs Tensor in which to store the one-hot labels, shape (set count, classes).
+ */
+void createDataSet(ml::Tensor& inputs, ml::Tensor& outputs) noexcept
+{
+    const std::size_t size{inputs.dim(1U)};
+    const std::size_t classCount{outputs.dim(1U)};
+
+    for (std::size_t s{}; s < inputs.dim(0U); ++s)
+    {
+        const std::size_t label{s % classCount};
+        const std::size_t barRow{label * size / classCount};
+
+        for (std::size_t i{}; i < size; ++i)
+        {
+            for (std::size_t j{}; j < size; ++j)
+            {
+                const ml::Scalar noise{ml::randomStartVal() * ml::Scalar{0.3}};
+                inputs(s, i, j) = (i == barRow) || (i == barRow + 1U) ? 1 - noise : noise;
+            }
+        }
+        outputs(s, label) = 1;
+    }
+}
+
+/**
+ * @brief Measure the prediction throughput of given model.
+ *
+ * @param[in] model The model to measure.
+ * @param[in] inputs Input sets to predict with.
+ * @param[in] roundCount Number of passes over the input sets.
+ *
+ * @return The throughput in samples per second.
+ */
+double predictThroughput(ml::cnn::Interface& model, const ml::Tensor& inputs,
+                         const std::size_t roundCount) noexcept
+{
+    const auto start{Clock::now()};
+
+    for (std::size_t round{}; round < roundCount; ++round)
+    {
+        for (std::size_t i{}; i < inputs.dim(0U); ++i) { model.predict(inputs.slice(i)); }
+    }
+    return roundCount * inputs.dim(0U) / secondsSince(start);
+}
+} // namespace
+
+/**
+ * @brief Train a CNN, quantize it and compare accuracy and throughput of both versions.
+ *
+ * @return 0 on success, error code -1 on failure.
+ */
+int main()
+{
+    // CNN parameters.
+    constexpr std::size_t inputSize{32U};
+    constexpr std::size_t kernelSize{3U};
+    constexpr std::size_t poolSize{2U};
+    constexpr std::size_t classCount{8U};
+
+    // Benchmark parameters.
+    constexpr std::size_t trainCount{256U};
+    constexpr std::size_t calibrationCount{64U};
+    constexpr std::size_t testCount{256U};
+    constexpr std::size_t epochCount{20U};
+    constexpr double learningRate{0.01};
+    constexpr std::size_t predictRounds{20U};
+
+    // Create and train the CNN.
+    ml::factory::Factory factory{};
+    ml::cnn::Cnn cnn{factory, inputSize, kernelSize, ml::act_func::Type::Tanh, poolSize,
+                     classCount, ml::act_func::Type::Tanh};
+
+    ml::Tensor trainIn{trainCount, inputSize, inputSize};
+    ml::Tensor trainOut{trainCount, classCount};
+    ml::Tensor testIn{testCount, inputSize, inputSize};
+    ml::Tensor testOut{testCount, classCount};
+    createDataSet(trainIn, trainOut);
+    createDataSet(testIn, testOut);
+    if (!cnn.train(trainIn, trainOut, epochCount, learningRate)) { return -1; }
+
+    // Quantize the CNN, calibrate with the first training sets.
+    const ml::Tensor calibrationSet{trainIn.narrow(0U, 0U, calibrationCount)};
+    ml::quant::QuantizedCnn quantized{cnn, calibrationSet};
+
+    std::cout << "Scalar type: " << (sizeof(ml::Scalar) == sizeof(float) ? "float32" : "float64")
+              << ", SIMD level: " << ml::linalg::simdLevelName(ml::linalg::simdLevel()) << "\n\n";
+
+    // Compare the predictions on the held-out test sets.
+    std::cout << "INT8 vs floating point predictions on " << testCount << " held-out samples:\n";
+    ml::quant::printReport(ml::quant::compareAccuracy(cnn, quantized, testIn));
+
+    // Compare the prediction throughput.
+    const double floatThroughput{predictThroughput(cnn, testIn, predictRounds)};
+    const double int8Throughput{predictThroughput(quantized, testIn, predictRounds)};
+    std::cout << std::fixed << std::setprecision(0) << "\nPrediction (float): "
+              << floatThroughput << " samples/s\n"
+              << "Prediction (int8):  " << int8Throughput << " samples/s\n"
+              << std::setprecision(2) << "Speedup:            "
+              << int8Throughput / floatThroughput << "x\n\n";
+    return 0;
+}
@@ -0,0 +1,140 @@
+/**
+ * @brief Benchmark for concurrent inference via execution contexts sharing one network.
+ *
+ *        Build and run via `make bench BENCH=serving`.
+ */
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "ml/cnn/cnn.h"
+#include "ml/cnn/inference_context.h"
+#include "ml/factory/factory.h"
+#include "ml/scalar.h"
+#include "ml/tensor.h"
+#include "ml/utils.h"
+
+namespace
+{
+/** Clock used for the measurements. */
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Fill given tensor with random values in the range [0, 1].
+ *
+ * @param[in] tensor The tensor to fill.
+ */
+void randomize(ml::Tensor& tensor) noexcept
+{
+    for (std::size_t i{}; i < tensor.size(); ++i) { tensor.data()[i] = ml::randomStartVal(); }
+}
+
+/**
+ * @brief Predict every input with given number of threads, each using its own context.
+ *
+ * @param[in] cnn The network holding the parameters.
+ * @param[in] inputs Input sets.
+ * @param[in] threadCount Number of threads.
+ * @param[in] roundCount Number of times to predict every input.
+ * @param[out] predictions Tensor in which to store the predictions.
+ *
+ * @return The number of predictions per second.
+ */
+double serve(ml::cnn::Cnn& cnn, const ml::Tensor& inputs, const std::size_t threadCount,
+             const std::size_t roundCount, ml::Tensor& predictions)
+{
+    // Create the contexts up front, the network must not change while they are created.
+    std::vector<std::unique_ptr<ml::cnn::InferenceContext>> contexts{};
+    std::vector<std::thread> threads{};
+
+    for (std::size_t t{}; t < threadCount; ++t)
+    {
+        contexts.push_back(std::make_unique<ml::cnn::InferenceContext>(cnn));
+    }
+
+    // Let each thread predict every threadCount-th input.
+    const auto start{Clock::now()};
+
+    for (std::size_t t{}; t < threadCount; ++t)
+    {
+        threads.emplace_back([&, t]
+        {
+            for (std::size_t round{}; round < roundCount; ++round)
+            {
+                for (std::size_t s{t}; s < inputs.dim(0U); s += threadCount)
+                {
+                    predictions.slice(s).copyFrom(contexts[t]->predict(inputs.slice(s)));
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) { thread.join(); }
+    return roundCount * inputs.dim(0U)
+        / std::chrono::duration<double>(Clock::now() - start).count();
+}
+} // namespace
+
+/**
+ * @brief Measure concurrent inference throughput and check the results against the network.
+ *
+ * @return 0 on success, error code -1 on failure.
+ */
+int main()
+{
+    // Network and benchmark parameters.
+    constexpr std::size_t inputSize{64U};
+    constexpr std::size_t kernelSize{5U};
+    constexpr std::size_t poolSize{2U};
+    constexpr std::size_t hiddenSize{512U};
+    constexpr std::size_t outputSize{10U};
+    constexpr std::size_t setCount{64U};
+    constexpr std::size_t roundCount{20U};
+
+    ml::factory::Factory factory{};
+    auto start{Clock::now()};
+    ml::cnn::Cnn cnn{factory, inputSize, kernelSize, ml::act_func::Type::Relu, poolSize,
+                     hiddenSize, ml::act_func::Type::Relu, ml::conv_layer::algorithm::Type::Auto};
+    cnn.addDenseLayer(outputSize, ml::act_func::Type::Tanh);
+    const double constructMs{std::chrono::duration<double, std::milli>(Clock::now() - start)
+                                 .count()};
+
+    // Create a context, whose layers only allocate their buffers.
+    start = Clock::now();
+    { ml::cnn::InferenceContext context{cnn}; }
+    const double contextMs{std::chrono::duration<double, std::milli>(Clock::now() - start)
+                               .count()};
+    std::cout << "Network construction: " << constructMs << " ms, context creation: " 
+              << contextMs << " ms\n";
+
+    ml::Tensor inputs{setCount, inputSize, inputSize};
+    randomize(inputs);
+
+    // Predict via the network itself as reference.
+    ml::Tensor reference{setCount, outputSize};
+    if (!cnn.predictBatch(inputs, reference)) { return -1; }
+
+    const std::size_t maxThreadCount{std::max(1U, std::thread::hardware_concurrency())};
+    double baseline{};
+    bool identical{true};
+
+    for (std::size_t threadCount{1U}; threadCount <= std::min<std::size_t>(maxThreadCount, 16U);
+         threadCount *= 2U)
+    {
+        ml::Tensor predictions{setCount, outputSize};
+        const double throughput{serve(cnn, inputs, threadCount, roundCount, predictions)};
+        if (1U == threadCount) { baseline = throughput; }
+
+        const bool same{std::equal(predictions.data(), predictions.data() + predictions.size(),
+                                   reference.data())};
+        identical &= same;
+
+        std::cout << "Threads: " << threadCount << ", inference: " << throughput
+                  << " images/s (" << throughput / baseline << "x)"
+                  << (same ? "" : " (mismatch!)") << "\n";
+    }
+    std::cout << "Identical results: " << (identical ? "yes" : "no") << "\n\n";
+    return identical ? 0 : -1;
+}
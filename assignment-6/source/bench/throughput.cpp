@@ -0,0 +1,177 @@
+/**
+ * @brief Throughput benchmark for CNN prediction and training.
+ *
+ *        Build and run via `make bench`, or via `make bench-precision` to compare the double
+ *        precision build with the single precision (ML_FLOAT32) build. Fails if predicting
+ *        or training in batches is slower than processing one sample at a time.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+
+#include "ml/cnn/cnn.h"
+#include "ml/factory/factory.h"
+#include "ml/linalg/simd.h"
+#include "ml/scalar.h"
+#include "ml/tensor.h"
+#include "ml/utils.h"
+
+namespace
+{
+/** Clock used for the measurements. */
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Get the number of seconds elapsed since given start time.
+ *
+ * @param[in] start The start time.
+ *
+ * @return The elapsed time in seconds.
+ */
+double secondsSince(const Clock::time_point start) noexcept
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/**
+ * @brief Fill given tensor with random values in the range [0, 1].
+ *
+ * @param[in] tensor The tensor to fill.
+ */
+void randomize(ml::Tensor& tensor) noexcept
+{
+    for (std::size_t i{}; i < tensor.size(); ++i) { tensor.data()[i] = ml::randomStartVal(); }
+}
+} // namespace
+
+/**
+ * @brief Measure the prediction and training throughput of a CNN.
+ *
+ * @return 0 on success, error code -1 on failure.
+ */
+int main()
+{
+    // CNN parameters.
+    constexpr std::size_t inputSize{64U};
+    constexpr std::size_t kernelSize{5U};
+    constexpr std::size_t poolSize{2U};
+    constexpr std::size_t hiddenSize{256U};
+    constexpr std::size_t outputSize{10U};
+
+    // Benchmark parameters.
+    constexpr std::size_t setCount{64U};
+    constexpr std::size_t roundCount{20U};
+    constexpr double learningRate{0.001};
+    constexpr std::size_t batchSizes[]{1U, 16U};
+    constexpr std::size_t predictBatchSizes[]{1U, 16U, 64U};
+
+    // Create a CNN with a large hidden dense layer, so that both the convolution and the
+    // weight matrices contribute to the runtime.
+    ml::factory::Factory factory{};
+    ml::cnn::Cnn cnn{factory, inputSize, kernelSize, ml::act_func::Type::Relu, poolSize,
+                     hiddenSize, ml::act_func::Type::Relu, ml::conv_layer::algorithm::Type::Auto};
+    cnn.addDenseLayer(outputSize, ml::act_func::Type::Tanh);
+
+    // Create random training data.
+    ml::Tensor inputs{setCount, inputSize, inputSize};
+    ml::Tensor outputs{setCount, outputSize};
+    randomize(inputs);
+    randomize(outputs);
+
+    std::cout << "Scalar type: " << (sizeof(ml::Scalar) == sizeof(float) ? "float32" : "float64")
+              << ", SIMD level: " << ml::linalg::simdLevelName(ml::linalg::simdLevel()) << "\n";
+
+    // Compute reference predictions one sample at a time.
+    ml::Tensor predictions{setCount, outputSize};
+
+    for (std::size_t i{}; i < setCount; ++i) 
+    { 
+        predictions.slice(i).copyFrom(cnn.predict(inputs.slice(i))); 
+    }
+
+    // Check that the batched predictions match the single predictions.
+    ml::Tensor batchPredictions{setCount, outputSize};
+
+    for (const auto batchSize : predictBatchSizes)
+    {
+        if (!cnn.predictBatch(inputs, batchPredictions, batchSize)) { return -1; }
+        double maxError{};
+
+        for (std::size_t i{}; i < predictions.size(); ++i)
+        {
+            maxError = std::max(maxError, static_cast<double>(
+                std::abs(predictions.data()[i] - batchPredictions.data()[i])));
+        }
+        std::cout << "Prediction (batch size " << batchSize << "), max error: " << maxError 
+                  << "\n";
+    }
+
+    // Measure the prediction and training throughput, per sample and in batches. Interleave
+    // the variants round by round and keep the fastest round of each, so that a noisy 
+    // machine affects every variant alike.
+    double predictTime{1.0e9};
+    double batchPredictTimes[std::size(predictBatchSizes)]{};
+    double trainTimes[std::size(batchSizes)]{};
+    std::fill(std::begin(batchPredictTimes), std::end(batchPredictTimes), 1.0e9);
+    std::fill(std::begin(trainTimes), std::end(trainTimes), 1.0e9);
+
+    for (std::size_t round{}; round < roundCount; ++round)
+    {
+        const auto predictStart{Clock::now()};
+        for (std::size_t i{}; i < setCount; ++i) { cnn.predict(inputs.slice(i)); }
+        predictTime = std::min(predictTime, secondsSince(predictStart));
+
+        for (std::size_t j{}; j < std::size(predictBatchSizes); ++j)
+        {
+            const auto batchStart{Clock::now()};
+            if (!cnn.predictBatch(inputs, batchPredictions, predictBatchSizes[j])) { return -1; }
+            batchPredictTimes[j] = std::min(batchPredictTimes[j], secondsSince(batchStart));
+        }
+
+        for (std::size_t j{}; j < std::size(batchSizes); ++j)
+        {
+            const auto trainStart{Clock::now()};
+            if (!cnn.train(inputs, outputs, 1U, learningRate, batchSizes[j])) { return -1; }
+            trainTimes[j] = std::min(trainTimes[j], secondsSince(trainStart));
+        }
+    }
+
+    // Print the throughputs, fail if a batched variant is slower than its per-sample loop.
+    std::cout << "Prediction: " << setCount / predictTime << " samples/s\n";
+
+    for (std::size_t j{}; j < std::size(predictBatchSizes); ++j)
+    {
+        std::cout << "Prediction (batch size " << predictBatchSizes[j] << "): " 
+                  << setCount / batchPredictTimes[j] << " samples/s\n";
+    }
+
+    for (std::size_t j{}; j < std::size(batchSizes); ++j)
+    {
+        std::cout << "Training (batch size " << batchSizes[j] << "): " 
+                  << setCount / trainTimes[j] << " samples/s\n";
+    }
+
+    for (std::size_t j{1U}; j < std::size(predictBatchSizes); ++j)
+    {
+        if (batchPredictTimes[j] > predictTime)
+        {
+            std::cerr << "Batched prediction (batch size " << predictBatchSizes[j] 
+                      << ") is slower than predicting one sample at a time!\n";
+            return -1;
+        }
+    }
+
+    for (std::size_t j{1U}; j < std::size(batchSizes); ++j)
+    {
+        if (trainTimes[j] > trainTimes[0U])
+        {
+            std::cerr << "Training with batch size " << batchSizes[j] 
+                      << " is slower than training one sample at a time!\n";
+            return -1;
+        }
+    }
+    std::cout << "\n";
+    return 0;
+}
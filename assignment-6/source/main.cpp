@@ -3,6 +3,7 @@
  */
 #include "ml/cnn/cnn.h"
 #include "ml/factory/factory.h"
+#include "ml/tensor.h"
 #include "ml/types.h"
 #include "ml/utils.h"
 
@@ -21,17 +22,17 @@ constexpr bool UseStubs{false};
  * @param[in] cnn The CNN with which to predict.
  * @param[in] inputs Input sets to predict with.
  */
-void predictAndPrint(ml::cnn::Interface& cnn, const ml::Matrix3d& inputs) noexcept
+void predictAndPrint(ml::cnn::Interface& cnn, const ml::Tensor& inputs) noexcept
 {
     // Terminate function if no input sets are available.
     if (inputs.empty()) { return; }
-    const auto* last{&inputs[inputs.size() - 1U]};
 
     std::cout << "--------------------------------------------------------------------------------\n";
 
     // Perform prediction with each input set, print the predicted output in the terminal.
-    for (const auto& input : inputs)
+    for (std::size_t i{}; i < inputs.dim(0U); ++i)
     {
+        const ml::Tensor input{inputs.slice(i)};
         std::cout << "Input:\n";
         ml::printMatrix(input);
 
@@ -39,7 +40,7 @@ void predictAndPrint(ml::cnn::Interface& cnn, const ml::Matrix3d& inputs) noexce
         ml::printMatrix(cnn.predict(input));
 
         // Add a blank line before the next print.
-        if (&input != last)  {std::cout << "\n";}
+        if (i + 1U < inputs.dim(0U))  {std::cout << "\n";}
     }
     std::cout << "--------------------------------------------------------------------------------\n\n";
 }
@@ -65,7 +66,7 @@ int main()
     constexpr double learningRate{0.025};
 
     // Input data for training (digits 0 - 1).
-    const ml::Matrix3d inputs{
+    const ml::Tensor inputs{ml::toTensor(ml::Matrix3d{
         {{1, 1, 1, 1},
          {1, 0, 0, 1},
          {1, 0, 0, 1},
@@ -74,9 +75,9 @@ int main()
          {0, 1, 0, 0},
          {0, 1, 0, 0},
          {0, 1, 0, 0}},
-    };
+    })};
     // Output data for training (the corresponding numbers).
-    const ml::Matrix2d outputs{{0}, {1}};
+    const ml::Tensor outputs{ml::toTensor(ml::Matrix2d{{0}, {1}})};
 
     // Create a machine learning factory.
     auto factory{ml::factory::create(UseStubs)};
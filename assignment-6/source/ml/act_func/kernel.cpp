@@ -0,0 +1,266 @@
+/**
+ * @brief Activation function kernel implementation details.
+ *
+ *        Each kernel exists in a default version and, on x86, in AVX2 and AVX-512 versions
+ *        compiled via function target attributes, so the compiler vectorizes the loops for
+ *        the wider registers. The version matching the active SIMD level
+ *        (see ml/linalg/simd.h) is selected when the kernel object is created.
+ */
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+#include "ml/act_func/kernel.h"
+#include "ml/act_func/leaky_relu.h"
+#include "ml/act_func/type.h"
+#include "ml/linalg/simd.h"
+#include "ml/scalar.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ML_X86_KERNELS
+#endif
+
+namespace ml::act_func
+{
+namespace
+{
+// -----------------------------------------------------------------------------
+template <typename T>
+T rationalTanh(const T input) noexcept
+{
+    // Beyond this magnitude tanh rounds to +-1 in single precision.
+    constexpr T clamp{static_cast<T>(7.90531110763549805)};
+
+    // Coefficients of the numerator (odd powers) and the denominator (even powers).
+    constexpr T a1{static_cast<T>(4.89352455891786e-03)};
+    constexpr T a3{static_cast<T>(6.37261928875436e-04)};
+    constexpr T a5{static_cast<T>(1.48572235717979e-05)};
+    constexpr T a7{static_cast<T>(5.12229709037114e-08)};
+    constexpr T a9{static_cast<T>(-8.60467152213735e-11)};
+    constexpr T a11{static_cast<T>(2.00018790482477e-13)};
+    constexpr T a13{static_cast<T>(-2.76076847742355e-16)};
+    constexpr T b0{static_cast<T>(4.89352518554385e-03)};
+    constexpr T b2{static_cast<T>(2.26843463243900e-03)};
+    constexpr T b4{static_cast<T>(1.18534705686654e-04)};
+    constexpr T b6{static_cast<T>(1.19825839466702e-06)};
+
+    // Use ternaries rather than branches, so the loops calling this function vectorize.
+    const T x{input < -clamp ? -clamp : (clamp < input ? clamp : input)};
+    const T x2{x * x};
+
+    const T p{x * (a1 + x2 * (a3 + x2 * (a5 + x2 * (a7 + x2 * (a9 + x2 * (a11 + x2 * a13))))))};
+    const T q{b0 + x2 * (b2 + x2 * (b4 + x2 * b6))};
+    return p / q;
+}
+
+// -----------------------------------------------------------------------------
+Scalar tanhOf(const Scalar x) noexcept
+{
+    // Approximate in single precision only, where the error is within a few ulp.
+    if constexpr (std::is_same_v<Scalar, float>) { return rationalTanh(x); }
+    else { return std::tanh(x); }
+}
+
+/**
+ * @brief Activation function operations, computing the derivatives from the outputs.
+ */
+struct NoneOp
+{
+    static Scalar output(const Scalar x) noexcept { return x; }
+    static Scalar deltaFromOutput(const Scalar) noexcept { return Scalar{1}; }
+};
+
+struct ReluOp
+{
+    static Scalar output(const Scalar x) noexcept { return Scalar{} < x ? x : Scalar{}; }
+    static Scalar deltaFromOutput(const Scalar y) noexcept
+    {
+        return Scalar{} < y ? Scalar{1} : Scalar{};
+    }
+};
+
+struct LeakyReluOp
+{
+    static Scalar output(const Scalar x) noexcept
+    {
+        return Scalar{} < x ? x : LeakyRelu::Slope * x;
+    }
+    static Scalar deltaFromOutput(const Scalar y) noexcept
+    {
+        return Scalar{} < y ? Scalar{1} : LeakyRelu::Slope;
+    }
+};
+
+struct TanhOp
+{
+    static Scalar output(const Scalar x) noexcept { return tanhOf(x); }
+    static Scalar deltaFromOutput(const Scalar y) noexcept { return Scalar{1} - y * y; }
+};
+
+struct SigmoidOp
+{
+    static Scalar output(const Scalar x) noexcept
+    {
+        // In single precision, use sigmoid(x) = (1 + tanh(x / 2)) / 2 via the approximation.
+        constexpr Scalar half{static_cast<Scalar>(0.5)};
+        if constexpr (std::is_same_v<Scalar, float>) { return half + half * tanhOf(half * x); }
+        else { return Scalar{1} / (Scalar{1} + std::exp(-x)); }
+    }
+    static Scalar deltaFromOutput(const Scalar y) noexcept { return y * (Scalar{1} - y); }
+};
+
+struct FastTanhOp
+{
+    static Scalar output(const Scalar x) noexcept { return rationalTanh(x); }
+};
+
+/**
+ * @brief Define the activation function loops with given name suffix and attributes.
+ */
+#define ML_ACT_FUNC_LOOPS(suffix, attributes)                                                   \
+    template <typename Op>                                                                      \
+    attributes void forward##suffix(const std::size_t n, const Scalar* in, Scalar* out) noexcept \
+    {                                                                                           \
+        for (std::size_t i{}; i < n; ++i) { out[i] = Op::output(in[i]); }                       \
+    }                                                                                           \
+                                                                                                \
+    template <typename Op>                                                                      \
+    attributes void forwardBias##suffix(const std::size_t n, const Scalar bias,                 \
+                                        Scalar* data) noexcept                                  \
+    {                                                                                           \
+        for (std::size_t i{}; i < n; ++i) { data[i] = Op::output(data[i] + bias); }             \
+    }                                                                                           \
+                                                                                                \
+    template <typename Op>                                                                      \
+    attributes void forwardBiases##suffix(const std::size_t n, const Scalar* bias,              \
+                                          Scalar* data) noexcept                                \
+    {                                                                                           \
+        for (std::size_t i{}; i < n; ++i) { data[i] = Op::output(data[i] + bias[i]); }          \
+    }                                                                                           \
+                                                                                                \
+    template <typename Op>                                                                      \
+    attributes void backward##suffix(const std::size_t n, const Scalar* out,                    \
+                                     const Scalar* gradients, Scalar* delta) noexcept           \
+    {                                                                                           \
+        for (std::size_t i{}; i < n; ++i)                                                       \
+        {                                                                                       \
+            delta[i] = gradients[i] * Op::deltaFromOutput(out[i]);                              \
+        }                                                                                       \
+    }
+
+ML_ACT_FUNC_LOOPS(Default, )
+
+#ifdef ML_X86_KERNELS
+ML_ACT_FUNC_LOOPS(Avx2, __attribute__((target("avx2,fma"))))
+ML_ACT_FUNC_LOOPS(Avx512, __attribute__((target("avx512f"))))
+#endif
+
+#undef ML_ACT_FUNC_LOOPS
+} // namespace
+
+// -----------------------------------------------------------------------------
+Kernel::Kernel(const Type type) noexcept
+    : myType{type}
+    , myForward{&forwardDefault<NoneOp>}
+    , myForwardBias{&forwardBiasDefault<NoneOp>}
+    , myForwardBiases{&forwardBiasesDefault<NoneOp>}
+    , myBackward{&backwardDefault<NoneOp>}
+{
+    // Select the kernels corresponding to the activation function.
+    switch (type)
+    {
+        case Type::Relu:
+            select<ReluOp>();
+            break;
+        case Type::Tanh:
+            select<TanhOp>();
+            break;
+        case Type::Sigmoid:
+            select<SigmoidOp>();
+            break;
+        case Type::LeakyRelu:
+            select<LeakyReluOp>();
+            break;
+        default:
+            myType = Type::None;
+            select<NoneOp>();
+            break;
+    }
+}
+
+// -----------------------------------------------------------------------------
+template <typename Op>
+void Kernel::select() noexcept
+{
+#ifdef ML_X86_KERNELS
+    switch (linalg::simdLevel())
+    {
+        case linalg::SimdLevel::Avx512:
+            myForward       = &forwardAvx512<Op>;
+            myForwardBias   = &forwardBiasAvx512<Op>;
+            myForwardBiases = &forwardBiasesAvx512<Op>;
+            myBackward      = &backwardAvx512<Op>;
+            return;
+        case linalg::SimdLevel::Avx2:
+            myForward       = &forwardAvx2<Op>;
+            myForwardBias   = &forwardBiasAvx2<Op>;
+            myForwardBiases = &forwardBiasesAvx2<Op>;
+            myBackward      = &backwardAvx2<Op>;
+            return;
+        default:
+            break;
+    }
+#endif
+    myForward       = &forwardDefault<Op>;
+    myForwardBias   = &forwardBiasDefault<Op>;
+    myForwardBiases = &forwardBiasesDefault<Op>;
+    myBackward      = &backwardDefault<Op>;
+}
+
+// -----------------------------------------------------------------------------
+void fastTanh(const std::size_t n, const Scalar* in, Scalar* out) noexcept
+{
+#ifdef ML_X86_KERNELS
+    switch (linalg::simdLevel())
+    {
+        case linalg::SimdLevel::Avx512:
+            forwardAvx512<FastTanhOp>(n, in, out);
+            return;
+        case linalg::SimdLevel::Avx2:
+            forwardAvx2<FastTanhOp>(n, in, out);
+            return;
+        default:
+            break;
+    }
+#endif
+    forwardDefault<FastTanhOp>(n, in, out);
+}
+
+// -----------------------------------------------------------------------------
+void softmax(const std::size_t n, const Scalar* in, Scalar* out) noexcept
+{
+    // Subtract the maximum input, so the exponentials are at most 1.
+    Scalar max{in[0U]};
+    for (std::size_t i{1U}; i < n; ++i) { max = max < in[i] ? in[i] : max; }
+
+    Scalar sum{};
+    for (std::size_t i{}; i < n; ++i)
+    {
+        out[i] = std::exp(in[i] - max);
+        sum += out[i];
+    }
+
+    const Scalar scale{Scalar{1} / sum};
+    for (std::size_t i{}; i < n; ++i) { out[i] *= scale; }
+}
+
+// -----------------------------------------------------------------------------
+void softmaxBackwardFromOutput(const std::size_t n, const Scalar* out, const Scalar* gradients,
+                               Scalar* delta) noexcept
+{
+    // The Jacobian is diag(y) - y * y^T, so the product only needs the sum below.
+    Scalar sum{};
+    for (std::size_t i{}; i < n; ++i) { sum += gradients[i] * out[i]; }
+    for (std::size_t i{}; i < n; ++i) { delta[i] = out[i] * (gradients[i] - sum); }
+}
+} // namespace ml::act_func
@@ -3,33 +3,134 @@
  */
 #include <algorithm>
 #include <iostream>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <vector>
 
 #include "ml/cnn/cnn.h"
+#include "ml/dataset/pipeline.h"
+#include "ml/dataset/tensor_dataset.h"
 #include "ml/factory/interface.h"
+#include "ml/linalg/blas.h"
+#include "ml/parallel/thread_pool.h"
+#include "ml/tensor.h"
 #include "ml/types.h"
 #include "ml/utils.h"
 
 namespace ml::cnn
 {
+namespace
+{
+/** Bytes of layer outputs per inference tile, a fraction of a typical L2 cache. */
+constexpr std::size_t InferenceTileBytes{512U * 1024U};
+} // namespace
+
 // -----------------------------------------------------------------------------
 Cnn::Cnn(factory::Interface& factory, const std::size_t convInput, const std::size_t convKernel, 
          const act_func::Type convFunc, const std::size_t poolSize, 
-         const std::size_t denseOutput, const act_func::Type denseFunc)
+         const std::size_t denseOutput, const act_func::Type denseFunc,
+         const conv_layer::algorithm::Type convAlgorithm)
+    : Cnn{ParameterMode::Owned, factory, convInput, convKernel, convFunc, poolSize, 
+          denseOutput, denseFunc, convAlgorithm}
+{}
+
+// -----------------------------------------------------------------------------
+Cnn::Cnn(factory::Interface& factory, const std::size_t inputSize, 
+         const std::vector<ConvStage>& stages, const std::size_t denseOutput, 
+         const act_func::Type denseFunc)
+    : Cnn{ParameterMode::Owned, factory, inputSize, stages, denseOutput, denseFunc}
+{}
+
+// -----------------------------------------------------------------------------
+Cnn::Cnn(const ParameterMode mode, factory::Interface& factory, const std::size_t convInput, 
+         const std::size_t convKernel, const act_func::Type convFunc, 
+         const std::size_t poolSize, const std::size_t denseOutput, 
+         const act_func::Type denseFunc, const conv_layer::algorithm::Type convAlgorithm)
     : myConvLayers{}
     , myDenseLayers{}
     , myFlattenLayer{nullptr}
+    , myOutputGradientBatch{}
+    , myInferencePlan{}
+    , myTileSize{1U}
+    , myBuffers{}
+    , myInferenceMemory{}
+    , myTrainingMemory{}
+    , myArena{}
+    , myMemoryPlan{nullptr}
+    , myModelFile{nullptr}
+    , myOptimizer{std::make_unique<optimizer::Optimizer>()}
+    , myConvAlgorithm{convAlgorithm}
     , myFactory{factory}
 {
     // Initialize the convolutional layers.
-    myConvLayers.emplace_back(factory.convLayer(convInput, convKernel, convFunc));
-    myConvLayers.emplace_back(factory.maxPoolLayer(convOutputSize(), poolSize));
+    myConvLayers.emplace_back(factory.convLayer(convInput, convKernel, convFunc, convAlgorithm,
+                                                mode));
+    myConvLayers.emplace_back(factory.maxPoolLayer(convOutputSize(), poolSize, 1U));
+
+    // Initialize the flatten layer.
+    myFlattenLayer = factory.flattenLayer(convOutputSize(), 1U);
+
+    // Initialize the dense layer.
+    const std::size_t denseInput{myFlattenLayer->outputSize()};
+    myDenseLayers.emplace_back(factory.denseLayer(denseInput, denseOutput, denseFunc, mode));
+    myOutputGradientBatch = Tensor{1U, denseOutput};
+    planInference();
+    planMemory();
+}
+
+// -----------------------------------------------------------------------------
+Cnn::Cnn(const ParameterMode mode, factory::Interface& factory, const std::size_t inputSize, 
+         const std::vector<ConvStage>& stages, const std::size_t denseOutput, 
+         const act_func::Type denseFunc)
+    : myConvLayers{}
+    , myDenseLayers{}
+    , myFlattenLayer{nullptr}
+    , myOutputGradientBatch{}
+    , myInferencePlan{}
+    , myTileSize{1U}
+    , myBuffers{}
+    , myInferenceMemory{}
+    , myTrainingMemory{}
+    , myArena{}
+    , myMemoryPlan{nullptr}
+    , myModelFile{nullptr}
+    , myOptimizer{std::make_unique<optimizer::Optimizer>()}
+    , myConvAlgorithm{conv_layer::algorithm::Type::Direct}
+    , myFactory{factory}
+{
+    // Throw an exception if there are no stages.
+    if (stages.empty())
+    {
+        throw std::invalid_argument("Cannot create CNN: at least one stage is required!");
+    }
+
+    // Initialize the convolutional layers, each stage takes the channels of the previous one.
+    std::size_t size{inputSize};
+    std::size_t channelCount{1U};
+
+    for (const auto& stage : stages)
+    {
+        myConvLayers.emplace_back(factory.multiChannelConvLayer(
+            channelCount, stage.channelCount, size, stage.kernelSize, stage.actFunc, mode));
+        channelCount = stage.channelCount;
+
+        if (1U < stage.poolSize)
+        {
+            myConvLayers.emplace_back(factory.maxPoolLayer(size, stage.poolSize, channelCount));
+        }
+        size = convOutputSize();
+    }
 
     // Initialize the flatten layer.
-    myFlattenLayer = factory.flattenLayer(convOutputSize());
+    myFlattenLayer = factory.flattenLayer(size, channelCount);
 
     // Initialize the dense layer.
     const std::size_t denseInput{myFlattenLayer->outputSize()};
-    myDenseLayers.emplace_back(factory.denseLayer(denseInput, denseOutput, denseFunc));
+    myDenseLayers.emplace_back(factory.denseLayer(denseInput, denseOutput, denseFunc, mode));
+    myOutputGradientBatch = Tensor{1U, denseOutput};
+    planInference();
+    planMemory();
 }
 
 // -----------------------------------------------------------------------------
@@ -49,74 +150,367 @@ std::size_t Cnn::outputSize() const noexcept
 }
 
 // -----------------------------------------------------------------------------
-const Matrix1d& Cnn::predict(const Matrix2d& input) noexcept 
+const Tensor& Cnn::predict(const Tensor& input) noexcept 
 {
-    feedforward(input);
+    feedforward(input, true);
     return output();
 }
 
+// -----------------------------------------------------------------------------
+bool Cnn::predictBatch(const Tensor& inputs, Tensor& outputs, const std::size_t batchSize)
+{
+    // Check the input arguments, return false on failure.
+    if (0U == batchSize)
+    {
+        std::cerr << "Failed to predict: invalid batch size " << batchSize << "!\n";
+        return false;
+    }
+    else if ((3U != inputs.rank()) || (2U != outputs.rank()) 
+        || (inputSize() != inputs.dim(1U)) || (inputSize() != inputs.dim(2U))
+        || (inputs.dim(0U) != outputs.dim(0U)) || (outputSize() != outputs.dim(1U)))
+    {
+        std::cerr << "Failed to predict: invalid input or output dimensions!\n";
+        return false;
+    }
+
+    // Let the layers hold a full batch (unless they already hold a larger one). Batches 
+    // are limited to a tile (see planInference), so that the outputs of every layer stay
+    // cached from one layer to the next.
+    const std::size_t setCount{inputs.dim(0U)};
+    const std::size_t maxBatchSize{std::min({batchSize, myTileSize, setCount})};
+    if (this->maxBatchSize() < maxBatchSize) { setMaxBatchSize(maxBatchSize); }
+
+    // Feed the inputs through the network batch by batch, store the outputs of each batch.
+    for (std::size_t first{}; first < setCount; first += maxBatchSize)
+    {
+        const std::size_t sampleCount{std::min(maxBatchSize, setCount - first)};
+        if (!feedforward(inputs.narrow(0U, first, sampleCount), true)) { return false; }
+
+        Tensor batchOutputs{outputs.narrow(0U, first, sampleCount)};
+        batchOutputs.copyFrom(output());
+    }
+    // Return true on success.
+    return true;
+}
+
 // -----------------------------------------------------------------------------
 void Cnn::addDenseLayer(const std::size_t outputSize, const act_func::Type actFunc)
 {
-    myDenseLayers.emplace_back(myFactory.denseLayer(this->outputSize(), outputSize, actFunc));
+    addDenseLayer(outputSize, actFunc, ParameterMode::Owned);
+}
+
+// -----------------------------------------------------------------------------
+void Cnn::addDenseLayer(const std::size_t outputSize, const act_func::Type actFunc,
+                        const ParameterMode mode)
+{
+    const std::size_t batchSize{maxBatchSize()};
+    myDenseLayers.emplace_back(myFactory.denseLayer(this->outputSize(), outputSize, actFunc,
+                                                    mode));
+
+    // Let the new layer hold as many samples as the existing layers.
+    myDenseLayers.back()->setMaxBatchSize(batchSize);
+    myOutputGradientBatch = Tensor{batchSize, outputSize};
+    planInference();
+    planMemory();
+}
+
+// -----------------------------------------------------------------------------
+memory::Report Cnn::memoryReport() const noexcept
+{
+    // Every buffer is live at some point of a training step, so the training plan holds all.
+    return memory::Report{myInferenceMemory.peakSize() * sizeof(Scalar),
+                          myTrainingMemory.peakSize() * sizeof(Scalar),
+                          myTrainingMemory.totalSize() * sizeof(Scalar)};
 }
 
 // -----------------------------------------------------------------------------
-bool Cnn::train(const Matrix3d& trainIn, const Matrix2d& trainOut, const std::size_t epochCount,
-                const double learningRate)
+void Cnn::setOptimizer(const optimizer::Config& config)
+{
+    // Replace the optimizer, which throws an exception if any hyperparameter is invalid.
+    myOptimizer = std::make_unique<optimizer::Optimizer>(config);
+}
+
+// -----------------------------------------------------------------------------
+std::size_t Cnn::threadCount() const noexcept 
+{ 
+    return parallel::ThreadPool::getInstance().threadCount(); 
+}
+
+// -----------------------------------------------------------------------------
+void Cnn::setThreadCount(const std::size_t threadCount)
+{
+    parallel::ThreadPool::getInstance().setThreadCount(threadCount);
+}
+
+// -----------------------------------------------------------------------------
+bool Cnn::train(const Tensor& trainIn, const Tensor& trainOut, const std::size_t epochCount,
+                const double learningRate, const std::size_t batchSize)
+{
+    // Train on a dataset holding views of the training sets.
+    const dataset::TensorDataset dataset{trainIn, trainOut};
+    return train(dataset, epochCount, learningRate, batchSize);
+}
+
+// -----------------------------------------------------------------------------
+bool Cnn::train(const dataset::Interface& dataset, const std::size_t epochCount,
+                const double learningRate, const std::size_t batchSize)
 {
     // Check the input arguments, return false on failure.
+    const std::size_t setCount{checkTrainArgs(dataset, epochCount, learningRate, batchSize)};
+    if (0U == setCount) { return false; }
+
+    // Let the layers hold a full batch, and create contiguous batch buffers.
+    const std::size_t maxBatchSize{std::min(batchSize, setCount)};
+    if (this->maxBatchSize() < maxBatchSize) { setMaxBatchSize(maxBatchSize); }
+    Tensor inputs{maxBatchSize, inputSize(), inputSize()};
+    Tensor targets{maxBatchSize, outputSize()};
+
+    // Create a training order list.
+    TrainOrderList trainOrder{createTrainOrderList(setCount)};
+
+    // Train the network the specified number of epochs.
+    for (std::size_t i{}; i < epochCount; ++i)
+    {
+        // Shuffle the training order list at the start of each epoch.
+        shuffleTrainOrderList(trainOrder);
+
+        // Iterate through the training sets batch by batch, return false on failure.
+        for (std::size_t first{}; first < setCount; first += maxBatchSize)
+        {
+            const std::size_t sampleCount{std::min(maxBatchSize, setCount - first)};
+
+            // Load the training sets of the batch.
+            for (std::size_t j{}; j < sampleCount; ++j)
+            {
+                Tensor input{inputs.slice(j)};
+                Tensor target{targets.slice(j)};
+                dataset.load(trainOrder[first + j], input, target);
+            }
+            const Tensor input{inputs.narrow(0U, 0U, sampleCount)};
+            const Tensor target{targets.narrow(0U, 0U, sampleCount)};
+
+            const bool success{feedforward(input) && backpropagate(target) 
+                && optimize(learningRate)};
+            if (!success) { return false; }
+        }
+    }
+    // Return true on success.
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool Cnn::train(dataset::Pipeline& pipeline, const double learningRate)
+{
+    // Check the input arguments, return false on failure.
+    const std::size_t setCount{checkTrainArgs(pipeline.dataset(), pipeline.epochCount(), 
+                                              learningRate, pipeline.batchSize())};
+    if (0U == setCount) { return false; }
+
+    // Let the layers hold a full batch.
+    const std::size_t maxBatchSize{std::min(pipeline.batchSize(), setCount)};
+    if (this->maxBatchSize() < maxBatchSize) { setMaxBatchSize(maxBatchSize); }
+
+    // Train on the batches of the pipeline, return false on failure.
+    Tensor input{};
+    Tensor target{};
+
+    while (pipeline.next(input, target))
+    {
+        const bool success{feedforward(input) && backpropagate(target) 
+            && optimize(learningRate)};
+        if (!success) { return false; }
+    }
+    // Return true on success.
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t Cnn::checkTrainArgs(const dataset::Interface& dataset, const std::size_t epochCount,
+                                const double learningRate, 
+                                const std::size_t batchSize) const noexcept
+{
+    // Check the input arguments, return 0 on failure.
     if ((0.0 >= learningRate) || (1.0 < learningRate))
     {
         std::cerr << "Failed to train CNN: invalid learning rate " << learningRate << "!\n";
-        return false;   
+        return 0U;   
     }
     else if (0U == epochCount)
     {
         std::cerr << "Failed to train CNN: invalid epoch count " << epochCount << "!\n";
-        return false;  
+        return 0U;  
+    }
+    else if (0U == batchSize)
+    {
+        std::cerr << "Failed to train CNN: invalid batch size " << batchSize << "!\n";
+        return 0U;  
+    }
+    else if ((inputSize() != dataset.inputSize()) || (outputSize() != dataset.outputSize()))
+    {
+        std::cerr << "Failed to train CNN: invalid training set dimensions!\n";
+        return 0U;
+    }
+    else if ((nullptr != myModelFile) && (memory::Access::ReadOnly == myModelFile->access()))
+    {
+        std::cerr << "Failed to train CNN: the parameters are mapped read-only!\n";
+        return 0U;
     }
 
-    const std::size_t setCount{std::min(trainIn.size(), trainOut.size())};
+    const std::size_t setCount{dataset.sampleCount()};
 
     if (0U == setCount)
     {
         std::cerr << "Failed to train CNN: invalid set count " << setCount << "!\n";
-        return false;
     }
+    return setCount;
+}
 
-    // Create a training order list.
-    TrainOrderList trainOrder{createTrainOrderList(setCount)};
+// -----------------------------------------------------------------------------
+std::unique_ptr<Cnn> Cnn::replicate(const bool shared)
+{
+    // Create a network with the same layers. Layers sharing the parameters of this network
+    // don't need own parameters, the others get a copy of the parameters.
+    std::unique_ptr<Cnn> replica{replicateLayers(shared ? ParameterMode::External 
+                                                        : ParameterMode::Owned)};
 
-    // Train the network the specified number of epochs.
-    for (std::size_t i{}; i < epochCount; ++i)
+    // Share the parameters if requested, else copy them, return a null pointer on failure.
+    TensorList source{parameters()};
+    TensorList destination{replica->parameters()};
+
+    if (shared)
     {
-        // Shuffle the training order list at the start of each epoch.
-        shuffleTrainOrderList(trainOrder);
+        if (!replica->shareParameters(*this)) { return nullptr; }
+        destination = replica->parameters();
+    }
+    else
+    {
+        for (std::size_t i{}; i < source.size(); ++i) { destination[i].copyFrom(source[i]); }
+    }
 
-        // Iterate through the training sets, return false on failure.
-        for (auto& j : trainOrder)
+    // Use the same optimizer settings and state, so that the replica takes the same steps as
+    // this network from the same gradients, return a null pointer on failure. Plain SGD is
+    // applied by the layers and has no state.
+    replica->setOptimizer(myOptimizer->config());
+    if (optimizer::Type::Sgd == myOptimizer->type()) { return replica; }
+    const TensorList sourceGradients{gradients()};
+
+    if (myOptimizer->isBound(source, sourceGradients))
+    {
+        const TensorList replicaGradients{replica->gradients()};
+        if (!replica->myOptimizer->copyState(*myOptimizer, destination, replicaGradients))
         {
-            const Matrix2d& input{trainIn[j]};
-            const Matrix1d& output{trainOut[j]};
+            return nullptr;
+        }
+    }
+    return replica;
+}
 
-            const bool success{feedforward(input) && backpropagate(output) && optimize(learningRate)};
-            if (!success) { return false; }
+// -----------------------------------------------------------------------------
+std::unique_ptr<Cnn> Cnn::replicateLayers(const ParameterMode mode)
+{
+    // Create a network with the same layers, starting with the convolutional layers.
+    const auto& conv{*myConvLayers[0U]};
+    const auto& dense{*myDenseLayers[0U]};
+    std::unique_ptr<Cnn> replica{};
+
+    if (conv_layer::Type::Conv == conv.type())
+    {
+        const auto& pool{*myConvLayers[1U]};
+        replica.reset(new Cnn{mode, myFactory, conv.inputSize(), conv.kernelSize(), 
+                              conv.actFunc(), pool.kernelSize(), dense.outputSize(),
+                              dense.actFunc(), myConvAlgorithm});
+    }
+    else
+    {
+        // Derive the stages from the layers, a pooling layer belongs to the previous stage.
+        std::vector<ConvStage> stages{};
+
+        for (const auto& layer : myConvLayers)
+        {
+            if (conv_layer::Type::MaxPool == layer->type())
+            {
+                stages.back().poolSize = layer->kernelSize();
+            }
+            else
+            {
+                stages.push_back(ConvStage{layer->channelCount(), layer->kernelSize(),
+                                           layer->actFunc(), 1U});
+            }
         }
+        replica.reset(new Cnn{mode, myFactory, conv.inputSize(), stages, dense.outputSize(),
+                              dense.actFunc()});
     }
-    // Return true on success.
-    return true;
+
+    for (std::size_t i{1U}; i < myDenseLayers.size(); ++i)
+    {
+        const auto& layer{*myDenseLayers[i]};
+        replica->addDenseLayer(layer.outputSize(), layer.actFunc(), mode);
+    }
+    return replica;
+}
+
+// -----------------------------------------------------------------------------
+TensorList Cnn::parameters()
+{
+    TensorList parameters{};
+
+    for (auto& layer : myConvLayers)
+    {
+        for (auto& parameter : layer->parameters()) { parameters.push_back(parameter.view()); }
+    }
+    for (auto& layer : myDenseLayers)
+    {
+        for (auto& parameter : layer->parameters()) { parameters.push_back(parameter.view()); }
+    }
+    return parameters;
 }
 
 // -----------------------------------------------------------------------------
-const Matrix1d& Cnn::output() const noexcept
+TensorList Cnn::gradients()
+{
+    TensorList gradients{};
+
+    for (auto& layer : myConvLayers)
+    {
+        for (auto& gradient : layer->gradients()) { gradients.push_back(gradient.view()); }
+    }
+    for (auto& layer : myDenseLayers)
+    {
+        for (auto& gradient : layer->gradients()) { gradients.push_back(gradient.view()); }
+    }
+    return gradients;
+}
+
+// -----------------------------------------------------------------------------
+bool Cnn::shareParameters(Cnn& source) noexcept
+{
+    // Return false unless the networks have the same number of layers.
+    if ((myConvLayers.size() != source.myConvLayers.size()) 
+        || (myDenseLayers.size() != source.myDenseLayers.size())) { return false; }
+
+    bool success{true};
+
+    // Share the parameters layer by layer, return false on mismatch.
+    for (std::size_t i{}; i < myConvLayers.size(); ++i)
+    {
+        success &= myConvLayers[i]->shareParameters(*source.myConvLayers[i]);
+    }
+    for (std::size_t i{}; i < myDenseLayers.size(); ++i)
+    {
+        success &= myDenseLayers[i]->shareParameters(*source.myDenseLayers[i]);
+    }
+    return success;
+}
+
+// -----------------------------------------------------------------------------
+const Tensor& Cnn::output() const noexcept
 {
     const std::size_t last{myDenseLayers.size() - 1U};
     return myDenseLayers[last]->output();
 }
 
 // -----------------------------------------------------------------------------
-const Matrix2d& Cnn::convOutput() const noexcept
+const Tensor& Cnn::convOutput() const noexcept
 {
     const std::size_t last{myConvLayers.size() - 1U};
     return myConvLayers[last]->output();
@@ -130,19 +524,182 @@ std::size_t Cnn::convOutputSize() const noexcept
 }
 
 // -----------------------------------------------------------------------------
-bool Cnn::feedforward(const Matrix2d& input) noexcept
+std::size_t Cnn::maxBatchSize() const noexcept { return myOutputGradientBatch.dim(0U); }
+
+// -----------------------------------------------------------------------------
+void Cnn::setMaxBatchSize(const std::size_t batchSize)
 {
-    bool success{true};
+    // Resize the batch buffers of every layer.
+    for (auto& layer : myConvLayers) { layer->setMaxBatchSize(batchSize); }
+    myFlattenLayer->setMaxBatchSize(batchSize);
+    for (auto& layer : myDenseLayers) { layer->setMaxBatchSize(batchSize); }
+    myOutputGradientBatch = Tensor{batchSize, outputSize()};
+    planMemory();
+}
 
-    // Run feedforward operation in the convolutional layers, return false on failure.
+// -----------------------------------------------------------------------------
+void Cnn::planInference()
+{
+    // Fuse each layer with the pooling layer after it, so that the output before pooling is
+    // never stored, and sum the output sizes of a sample.
+    std::size_t sampleSize{inputSize() * inputSize()};
+    myInferencePlan.clear();
+
+    for (std::size_t i{}; i < myConvLayers.size(); ++i)
     {
-        success = myConvLayers[0U]->feedforward(input);
-    
-        for (std::size_t i{1U}; i < myConvLayers.size(); ++i)
+        const bool pooled{(i + 1U < myConvLayers.size()) 
+            && (conv_layer::Type::MaxPool != myConvLayers[i]->type())
+            && (conv_layer::Type::MaxPool == myConvLayers[i + 1U]->type())};
+        myInferencePlan.push_back(InferenceStep{i, pooled});
+
+        for (std::size_t j{i}; j <= i + (pooled ? 1U : 0U); ++j)
+        {
+            const auto& layer{*myConvLayers[j]};
+            sampleSize += layer.channelCount() * layer.outputSize() * layer.outputSize();
+        }
+        if (pooled) { ++i; }
+    }
+    // The flatten layer is a view, so only the dense outputs remain.
+    for (const auto& layer : myDenseLayers) { sampleSize += layer->outputSize(); }
+
+    // Let the outputs of all layers for a tile of samples fit in the cache budget.
+    myTileSize = std::max<std::size_t>(1U, InferenceTileBytes / (sampleSize * sizeof(Scalar)));
+}
+
+// -----------------------------------------------------------------------------
+void Cnn::planMemory()
+{
+    // Number the steps of training: the feedforward operation of each layer in forward order,
+    // the backpropagation of each layer in reverse order, then the optimization.
+    const std::size_t convCount{myConvLayers.size()};
+    const std::size_t layerCount{convCount + myDenseLayers.size()};
+    const std::size_t optimizeStep{2U * layerCount};
+
+    // Number the steps of inference by the inference plan, where a fused layer shares its 
+    // step with the pooling layer after it. The dense layers follow the plan.
+    std::vector<std::size_t> inferenceSteps(layerCount + 1U);
+
+    for (std::size_t i{}; i < myInferencePlan.size(); ++i)
+    {
+        const auto& step{myInferencePlan[i]};
+        inferenceSteps[step.layer] = i;
+        if (step.pooled) { inferenceSteps[step.layer + 1U] = i; }
+    }
+    for (std::size_t i{convCount}; i <= layerCount; ++i)
+    {
+        inferenceSteps[i] = myInferencePlan.size() + i - convCount;
+    }
+
+    myBuffers.clear();
+    myInferenceMemory.clear();
+    myTrainingMemory.clear();
+    myMemoryPlan = nullptr;
+
+    // Let each buffer be live from the step writing it to the last step reading it.
+    auto addBuffers{[&](const std::size_t layer, const memory::BufferList& buffers)
+    {
+        const std::size_t forward{inferenceSteps[layer]};
+        const std::size_t next{inferenceSteps[layer + 1U]};
+        const std::size_t trainForward{layer};
+        const std::size_t trainBackward{optimizeStep - 1U - layer};
+
+        // Dense layers read their input again when they are optimized.
+        const bool readByDense{(convCount <= layer + 1U) && (layer + 1U < layerCount)};
+
+        for (const auto& buffer : buffers)
+        {
+            const std::size_t size{buffer.batch->size()};
+            myBuffers.push_back(buffer);
+
+            switch (buffer.role)
+            {
+                case memory::Role::Input:
+                    myInferenceMemory.add(size, forward, forward);
+                    myTrainingMemory.add(size, trainForward, trainBackward);
+                    break;
+                case memory::Role::Output:
+                    myInferenceMemory.add(size, forward, next);
+                    myTrainingMemory.add(size, trainForward, 
+                                         readByDense ? optimizeStep : trainBackward);
+                    break;
+                case memory::Role::InputGradients:
+                    myInferenceMemory.addUnused();
+                    myTrainingMemory.add(size, trainBackward, trainBackward + 1U);
+                    break;
+                case memory::Role::Scratch:
+                    myInferenceMemory.addUnused();
+                    myTrainingMemory.add(size, trainBackward, trainBackward);
+                    break;
+                case memory::Role::Delta:
+                    myInferenceMemory.addUnused();
+                    myTrainingMemory.add(size, trainBackward, optimizeStep);
+                    break;
+            }
+        }
+    }};
+
+    // The flatten layer only holds views, so it has no buffers.
+    for (std::size_t i{}; i < convCount; ++i) { addBuffers(i, myConvLayers[i]->buffers()); }
+
+    for (std::size_t i{}; i < myDenseLayers.size(); ++i)
+    {
+        addBuffers(convCount + i, myDenseLayers[i]->buffers());
+    }
+
+    // The output gradients are computed and read when the backpropagation starts.
+    myBuffers.push_back(memory::Buffer{&myOutputGradientBatch, nullptr, 
+                                       memory::Role::InputGradients});
+    myInferenceMemory.addUnused();
+    myTrainingMemory.add(myOutputGradientBatch.size(), layerCount, layerCount);
+
+    myInferenceMemory.plan();
+    myTrainingMemory.plan();
+}
+
+// -----------------------------------------------------------------------------
+bool Cnn::useMemoryPlan(const bool inference) noexcept
+{
+    // Return true if the plan is already in use.
+    const memory::Planner& plan{inference ? myInferenceMemory : myTrainingMemory};
+    if (&plan == myMemoryPlan) { return true; }
+
+    // Grow the arena to fit the plan, return false if the memory cannot be allocated.
+    if (myArena.size() < plan.peakSize())
+    {
+        try { myArena = Tensor{plan.peakSize()}; }
+        catch (const std::bad_alloc&)
         {
-            auto& prevLayer{*(myConvLayers[i - 1U])};
-            success &= myConvLayers[i]->feedforward(prevLayer.output());
+            std::cerr << "Failed to allocate " << plan.peakSize() * sizeof(Scalar) 
+                      << " bytes for the batch buffers!\n";
+            return false;
         }
+    }
+
+    // Replace each buffer with a view of its place in the arena. Buffers that are never 
+    // live in this plan keep their shape only, since they are never read or written.
+    for (std::size_t i{}; i < myBuffers.size(); ++i)
+    {
+        const auto& buffer{myBuffers[i]};
+        const std::size_t offset{plan.offset(i)};
+        Scalar* const data{memory::Planner::Unused == offset ? nullptr : myArena.data() + offset};
+
+        *buffer.batch = Tensor::wrap(data, buffer.batch->shape(), buffer.batch->rank());
+        if (nullptr != buffer.view) { *buffer.view = buffer.batch->slice(0U); }
+    }
+    myMemoryPlan = &plan;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool Cnn::feedforward(const Tensor& input, const bool inference) noexcept
+{
+    // Place the batch buffers according to the plan of the operation, return false on failure.
+    if (!useMemoryPlan(inference)) { return false; }
+    bool success{true};
+
+    // Run feedforward operation in the convolutional layers, return false on failure.
+    {
+        success = feedforwardConv(input, inference);
         if (!success) { return false; }
     }
 
@@ -167,14 +724,65 @@ bool Cnn::feedforward(const Matrix2d& input) noexcept
 }
 
 // -----------------------------------------------------------------------------
-bool Cnn::backpropagate(const Matrix1d& output) noexcept
+bool Cnn::feedforwardConv(const Tensor& input, const bool inference) noexcept
+{
+    bool success{true};
+    const Tensor* layerInput{&input};
+
+    // Follow the inference plan for inference, else run every layer, so that the outputs
+    // are stored for backpropagation.
+    if (inference)
+    {
+        for (const auto& step : myInferencePlan)
+        {
+            auto& layer{*(myConvLayers[step.layer])};
+
+            if (step.pooled)
+            {
+                auto& pool{*(myConvLayers[step.layer + 1U])};
+                success &= pool.feedforwardFused(layer, *layerInput);
+                layerInput = &pool.output();
+            }
+            else
+            {
+                success &= layer.feedforward(*layerInput);
+                layerInput = &layer.output();
+            }
+        }
+    }
+    else
+    {
+        for (auto& layer : myConvLayers)
+        {
+            success &= layer->feedforward(*layerInput);
+            layerInput = &layer->output();
+        }
+    }
+    // Return true on success.
+    return success;
+}
+
+// -----------------------------------------------------------------------------
+bool Cnn::backpropagate(const Tensor& target) noexcept
 {
+    // Check the target, return false on dimension mismatch.
+    const Tensor& output{this->output()};
+    const std::size_t sampleCount{batchSize(target, myOutputGradientBatch)};
+    if ((0U == sampleCount) || (target.size() != output.size())) { return false; }
+
+    // Compute the output gradients, i.e. the negated derivatives of the squared error 
+    // (target - output), laid out like the output.
+    const bool batched{output.rank() == myOutputGradientBatch.rank()};
+    Tensor gradients{batchView(myOutputGradientBatch, sampleCount, batched)};
+    gradients.copyFrom(target);
+    linalg::axpy(gradients.size(), -1.0, output.data(), gradients.data());
+
     bool success{true};
 
     // Backpropagate through the dense layers, return false on failure.
     {
         const std::size_t last{myDenseLayers.size() - 1U};
-        success = myDenseLayers[last]->backpropagate(output);
+        success = myDenseLayers[last]->backpropagate(gradients);
         
         for (std::size_t i{last}; i > 0U; --i)
         {
@@ -206,6 +814,9 @@ bool Cnn::backpropagate(const Matrix1d& output) noexcept
 // -----------------------------------------------------------------------------
 bool Cnn::optimize(const double learningRate) noexcept
 {
+    // Let the optimizer update the parameters unless plain SGD is used, which is fused with
+    // the gradient computation in the layers.
+    if (optimizer::Type::Sgd != myOptimizer->type()) { return stepOptimizer(learningRate, true); }
     bool success{true};
 
     // Optimize the convolutional layers, return false on failure.
@@ -232,4 +843,67 @@ bool Cnn::optimize(const double learningRate) noexcept
     // Return true on success.
     return success;
 }
-} // namespace ml::cnn
\ No newline at end of file
+
+// -----------------------------------------------------------------------------
+bool Cnn::computeGradients() noexcept
+{
+    // The convolutional layers compute their gradients during backpropagation, so only the
+    // dense layers remain, return false on failure.
+    bool success{myDenseLayers[0U]->computeGradients(myFlattenLayer->output())};
+
+    for (std::size_t i{1U}; i < myDenseLayers.size(); ++i)
+    {
+        auto& prevLayer{*(myDenseLayers[i - 1U])};
+        success &= myDenseLayers[i]->computeGradients(prevLayer.output());
+    }
+    // Return true on success.
+    return success;
+}
+
+// -----------------------------------------------------------------------------
+bool Cnn::applyGradients(const double learningRate) noexcept
+{
+    // Let the optimizer update the parameters unless plain SGD is used.
+    if (optimizer::Type::Sgd != myOptimizer->type()) { return stepOptimizer(learningRate, false); }
+    bool success{true};
+
+    // Optimize the convolutional layers with their current gradients.
+    for (auto& layer : myConvLayers) { success &= layer->optimize(learningRate); }
+
+    // Adjust the parameters of the dense layers with their current gradients.
+    for (auto& layer : myDenseLayers) { success &= layer->applyGradients(learningRate); }
+
+    // Return true on success.
+    return success;
+}
+
+// -----------------------------------------------------------------------------
+bool Cnn::stepOptimizer(const double learningRate, const bool compute) noexcept
+{
+    // Collect the parameters and the gradients, which allocates the dense layer gradients on
+    // the first call, return false if the memory cannot be allocated.
+    TensorList parameters{};
+    TensorList gradients{};
+
+    try
+    {
+        parameters = this->parameters();
+        gradients  = this->gradients();
+    }
+    catch (const std::bad_alloc&)
+    {
+        std::cerr << "Failed to allocate the gradients for the optimizer!\n";
+        return false;
+    }
+
+    // Compute the dense layer gradients unless already done, return false on failure.
+    if (compute && !computeGradients()) { return false; }
+
+    // Update every parameter in one fused pass per tensor.
+    const bool success{myOptimizer->step(parameters, gradients, learningRate)};
+
+    // Let the convolutional layers drop data derived from the old parameters.
+    for (auto& layer : myConvLayers) { layer->invalidateParameters(); }
+    return success;
+}
+} // namespace ml::cnn
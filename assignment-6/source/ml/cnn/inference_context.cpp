@@ -0,0 +1,56 @@
+/**
+ * @brief Execution context implementation details.
+ */
+#include <memory>
+#include <stdexcept>
+
+#include "ml/cnn/cnn.h"
+#include "ml/cnn/inference_context.h"
+#include "ml/parameter_mode.h"
+#include "ml/tensor.h"
+
+namespace ml::cnn
+{
+// -----------------------------------------------------------------------------
+InferenceContext::InferenceContext(Cnn& cnn)
+    : myCnn{cnn}
+    , myReplica{cnn.replicateLayers(ParameterMode::External)}
+{
+    // Let the layers share the parameters, they neither own parameters nor an optimizer
+    // state. Throw an exception if the layers failed to share the parameters.
+    if (!myReplica->shareParameters(cnn))
+    {
+        throw std::runtime_error(
+            "Failed to create inference context: cannot share the network parameters!");
+    }
+}
+
+// -----------------------------------------------------------------------------
+InferenceContext::~InferenceContext() noexcept = default;
+
+// -----------------------------------------------------------------------------
+std::size_t InferenceContext::inputSize() const noexcept { return myReplica->inputSize(); }
+
+// -----------------------------------------------------------------------------
+std::size_t InferenceContext::outputSize() const noexcept { return myReplica->outputSize(); }
+
+// -----------------------------------------------------------------------------
+const Tensor& InferenceContext::predict(const Tensor& input) noexcept
+{
+    return myReplica->predict(input);
+}
+
+// -----------------------------------------------------------------------------
+bool InferenceContext::predictBatch(const Tensor& inputs, Tensor& outputs,
+                                    const std::size_t batchSize)
+{
+    return myReplica->predictBatch(inputs, outputs, batchSize);
+}
+
+// -----------------------------------------------------------------------------
+bool InferenceContext::refresh() noexcept
+{
+    // Share the parameters anew, which drops the cached data.
+    return myReplica->shareParameters(myCnn);
+}
+} // namespace ml::cnn
@@ -0,0 +1,363 @@
+/**
+ * @brief Binary model file implementation details.
+ */
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "ml/act_func/type.h"
+#include "ml/cnn/cnn.h"
+#include "ml/cnn/model_file.h"
+#include "ml/conv_layer/algorithm/type.h"
+#include "ml/conv_layer/interface.h"
+#include "ml/conv_layer/type.h"
+#include "ml/dense_layer/interface.h"
+#include "ml/memory/mapped_file.h"
+#include "ml/parameter_mode.h"
+#include "ml/tensor.h"
+#include "ml/types.h"
+
+namespace ml::cnn
+{
+namespace
+{
+/** Magic bytes at the start of a model file. */
+constexpr std::array<char, 8U> Magic{'M', 'L', 'C', 'N', 'N', 'M', 'D', 'L'};
+
+/** Byte order mark, reads as SwappedByteOrderMark on a host of the other byte order. */
+constexpr std::uint32_t ByteOrderMark{0x01020304U};
+
+/** Byte order mark as read on a host of the other byte order. */
+constexpr std::uint32_t SwappedByteOrderMark{0x04030201U};
+
+/**
+ * @brief Header of a model file.
+ */
+struct Header
+{
+    /** Magic bytes. */
+    std::array<char, 8U> magic;
+
+    /** Format version. */
+    std::uint32_t version;
+
+    /** Size of a scalar in bytes. */
+    std::uint32_t scalarSize;
+
+    /** Input size of the network. */
+    std::uint32_t inputSize;
+
+    /** Convolution algorithm of single-channel convolutional layers. */
+    std::uint32_t convAlgorithm;
+
+    /** Number of convolutional layers, including the pooling layers. */
+    std::uint32_t convLayerCount;
+
+    /** Number of dense layers. */
+    std::uint32_t denseLayerCount;
+
+    /** File size in bytes. */
+    std::uint64_t fileSize;
+
+    /** Byte order mark (ByteOrderMark in the byte order of the saving host). */
+    std::uint32_t byteOrder;
+
+    /** Reserved, zero. */
+    std::array<std::uint8_t, 20U> reserved;
+};
+
+/**
+ * @brief Record of a layer in a model file.
+ */
+struct LayerRecord
+{
+    /** Layer type (conv_layer::Type), zero for dense layers. */
+    std::uint8_t type;
+
+    /** Activation function (act_func::Type). */
+    std::uint8_t actFunc;
+
+    /** Reserved, zero. */
+    std::uint16_t reserved;
+
+    /** Number of output channels, the output size for dense layers. */
+    std::uint32_t size;
+
+    /** Kernel size, the pool size for pooling layers, zero for dense layers. */
+    std::uint32_t kernelSize;
+
+    /** Reserved, zero. */
+    std::uint32_t padding;
+};
+
+static_assert(64U == sizeof(Header), "The model file header must be 64 bytes!");
+static_assert(16U == sizeof(LayerRecord), "The model file layer records must be 16 bytes!");
+
+// -----------------------------------------------------------------------------
+constexpr std::size_t alignedOffset(const std::size_t offset) noexcept
+{
+    return (offset + ModelFileAlignment - 1U) / ModelFileAlignment * ModelFileAlignment;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t storedSize(const Tensor& parameter) noexcept
+{
+    // Rows are stored with their padding, i.e. up to the stride of the first dimension.
+    return parameter.empty() ? 0U : parameter.dim(0U) * parameter.stride(0U);
+}
+
+// -----------------------------------------------------------------------------
+std::size_t parameterSize(const TensorList& parameters, std::size_t offset) noexcept
+{
+    // Add the aligned size of each parameter to given offset.
+    for (const auto& parameter : parameters)
+    {
+        offset = alignedOffset(offset) + storedSize(parameter) * sizeof(Scalar);
+    }
+    return offset;
+}
+
+// -----------------------------------------------------------------------------
+void writePadding(std::ofstream& file, const std::size_t offset)
+{
+    // Write zeros up to the next aligned offset.
+    static constexpr std::array<char, ModelFileAlignment> zeros{};
+    file.write(zeros.data(), alignedOffset(offset) - offset);
+}
+
+// -----------------------------------------------------------------------------
+[[noreturn]] void invalidFile(const std::string& path, const char* reason)
+{
+    throw std::runtime_error("Cannot load model file " + path + ": " + reason + "!");
+}
+
+// -----------------------------------------------------------------------------
+bool validRecord(const std::vector<LayerRecord>& records, const std::size_t index,
+                 const std::size_t convLayerCount) noexcept
+{
+    // Return false unless the activation function is valid.
+    const auto& record{records[index]};
+    if (static_cast<std::uint8_t>(act_func::Type::LeakyRelu) < record.actFunc) { return false; }
+
+    // Dense layers are stored with type zero and no kernel size.
+    if (convLayerCount <= index) { return (0U == record.type) && (0U == record.kernelSize); }
+
+    // A single-channel network has a convolutional layer followed by a pooling layer, else
+    // every multi-channel layer may be followed by a single pooling layer.
+    const auto type{static_cast<conv_layer::Type>(record.type)};
+    const auto first{static_cast<conv_layer::Type>(records[0U].type)};
+
+    if (conv_layer::Type::Conv == first)
+    {
+        return (2U == convLayerCount)
+            && (((0U == index) && (conv_layer::Type::Conv == type))
+                || ((1U == index) && (conv_layer::Type::MaxPool == type)));
+    }
+    if (conv_layer::Type::MultiChannel == type) { return true; }
+    if ((conv_layer::Type::MaxPool != type) || (0U == index)) { return false; }
+    const auto previous{static_cast<conv_layer::Type>(records[index - 1U].type)};
+    return conv_layer::Type::MultiChannel == previous;
+}
+
+// -----------------------------------------------------------------------------
+Tensor parameterView(std::uint8_t* data, const Tensor& parameter)
+{
+    // Contiguous parameters are views of the same shape, else the rows are padded.
+    auto* const values{reinterpret_cast<Scalar*>(data)};
+    if (parameter.isContiguous()) { return Tensor::wrap(values, parameter.shape(), parameter.rank()); }
+
+    const Tensor rows{Tensor::wrap(values, {parameter.dim(0U), parameter.stride(0U)})};
+    return rows.narrow(1U, 0U, parameter.dim(1U));
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+bool saveModel(Cnn& cnn, const std::string& path)
+{
+    // Return false if the file cannot be created.
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    if (!file)
+    {
+        std::cerr << "Failed to save model: cannot create file " << path << "!\n";
+        return false;
+    }
+
+    // Collect the layer records and the parameters in forward order.
+    std::vector<LayerRecord> records{};
+    std::vector<TensorList> parameters{};
+
+    for (auto& layer : cnn.myConvLayers)
+    {
+        records.push_back(LayerRecord{static_cast<std::uint8_t>(layer->type()),
+                                      static_cast<std::uint8_t>(layer->actFunc()), 0U,
+                                      static_cast<std::uint32_t>(layer->channelCount()),
+                                      static_cast<std::uint32_t>(layer->kernelSize()), 0U});
+        parameters.push_back(layer->parameters());
+    }
+    for (auto& layer : cnn.myDenseLayers)
+    {
+        records.push_back(LayerRecord{0U, static_cast<std::uint8_t>(layer->actFunc()), 0U,
+                                      static_cast<std::uint32_t>(layer->outputSize()), 0U, 0U});
+        parameters.push_back(layer->parameters());
+    }
+
+    // Compute the file size, so that a truncated file can be detected when loading.
+    const std::size_t recordEnd{sizeof(Header) + records.size() * sizeof(LayerRecord)};
+    std::size_t fileSize{recordEnd};
+    for (const auto& layerParameters : parameters)
+    {
+        fileSize = parameterSize(layerParameters, fileSize);
+    }
+
+    const Header header{Magic, ModelFileVersion, sizeof(Scalar),
+                        static_cast<std::uint32_t>(cnn.inputSize()),
+                        static_cast<std::uint32_t>(cnn.myConvAlgorithm),
+                        static_cast<std::uint32_t>(cnn.myConvLayers.size()),
+                        static_cast<std::uint32_t>(cnn.myDenseLayers.size()), fileSize,
+                        ByteOrderMark, {}};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(records.data()),
+               records.size() * sizeof(LayerRecord));
+
+    // Write the parameters, each at an aligned offset, including the row padding.
+    std::size_t offset{recordEnd};
+
+    for (const auto& layerParameters : parameters)
+    {
+        for (const auto& parameter : layerParameters)
+        {
+            writePadding(file, offset);
+            const std::size_t size{storedSize(parameter) * sizeof(Scalar)};
+            file.write(reinterpret_cast<const char*>(parameter.data()), size);
+            offset = alignedOffset(offset) + size;
+        }
+    }
+
+    // Return false if any write failed.
+    file.flush();
+    if (!file)
+    {
+        std::cerr << "Failed to save model: cannot write file " << path << "!\n";
+        return false;
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+std::unique_ptr<Cnn> loadModel(factory::Interface& factory, const std::string& path,
+                               const memory::Access access)
+{
+    auto file{std::make_unique<memory::MappedFile>(path, access)};
+
+    // Check the header, throw an exception if the file is invalid.
+    Header header{};
+    if (sizeof(Header) > file->size()) { invalidFile(path, "the file is too small"); }
+    std::memcpy(&header, file->data(), sizeof(Header));
+
+    if (Magic != header.magic) { invalidFile(path, "not a model file"); }
+    if (SwappedByteOrderMark == header.byteOrder) { invalidFile(path, "byte order mismatch"); }
+    if ((ModelFileVersion != header.version) || (ByteOrderMark != header.byteOrder))
+    {
+        invalidFile(path, "unsupported version");
+    }
+    if (sizeof(Scalar) != header.scalarSize) { invalidFile(path, "scalar type mismatch"); }
+    if (file->size() != header.fileSize) { invalidFile(path, "the file size doesn't match"); }
+    if ((0U == header.convLayerCount) || (0U == header.denseLayerCount)
+        || (static_cast<std::uint32_t>(conv_layer::algorithm::Type::Auto) < header.convAlgorithm))
+    {
+        invalidFile(path, "invalid topology");
+    }
+
+    const std::size_t layerCount{std::size_t{header.convLayerCount} + header.denseLayerCount};
+    const std::size_t recordEnd{sizeof(Header) + layerCount * sizeof(LayerRecord)};
+    if (recordEnd > file->size()) { invalidFile(path, "the layer records are truncated"); }
+
+    std::vector<LayerRecord> records(layerCount);
+    std::memcpy(records.data(), file->data() + sizeof(Header),
+                layerCount * sizeof(LayerRecord));
+
+    // Check the layer records, each layer type must be valid at its position.
+    for (std::size_t i{}; i < layerCount; ++i)
+    {
+        if (!validRecord(records, i, header.convLayerCount))
+        {
+            invalidFile(path, "invalid layer type");
+        }
+    }
+
+    // Create the network, as Cnn::replicate does from the layers. The layers only record the
+    // shapes of their parameters, since they use the parameters of the file.
+    const auto& first{records[0U]};
+    const auto& dense{records[header.convLayerCount]};
+    constexpr ParameterMode mode{ParameterMode::External};
+    std::unique_ptr<Cnn> cnn{};
+
+    if (static_cast<std::uint8_t>(conv_layer::Type::Conv) == first.type)
+    {
+        const auto& pool{records[1U]};
+        cnn.reset(new Cnn{mode, factory, header.inputSize, first.kernelSize,
+                          static_cast<act_func::Type>(first.actFunc), pool.kernelSize,
+                          dense.size, static_cast<act_func::Type>(dense.actFunc),
+                          static_cast<conv_layer::algorithm::Type>(header.convAlgorithm)});
+    }
+    else
+    {
+        // A pooling layer belongs to the previous stage.
+        std::vector<ConvStage> stages{};
+
+        for (std::size_t i{}; i < header.convLayerCount; ++i)
+        {
+            const auto& record{records[i]};
+
+            if (static_cast<std::uint8_t>(conv_layer::Type::MaxPool) != record.type)
+            {
+                stages.push_back(ConvStage{record.size, record.kernelSize,
+                                           static_cast<act_func::Type>(record.actFunc), 1U});
+            }
+            else { stages.back().poolSize = record.kernelSize; }
+        }
+        cnn.reset(new Cnn{mode, factory, header.inputSize, stages, dense.size,
+                          static_cast<act_func::Type>(dense.actFunc)});
+    }
+
+    for (std::size_t i{header.convLayerCount + 1U}; i < layerCount; ++i)
+    {
+        cnn->addDenseLayer(records[i].size, static_cast<act_func::Type>(records[i].actFunc),
+                           mode);
+    }
+    if (cnn->myConvLayers.size() != header.convLayerCount)
+    {
+        invalidFile(path, "invalid topology");
+    }
+
+    // Let the layers use their parameters in place.
+    std::size_t offset{recordEnd};
+
+    auto useParameters{[&](auto& layer)
+    {
+        TensorList views{};
+
+        for (const auto& parameter : layer.parameters())
+        {
+            offset = alignedOffset(offset);
+            const std::size_t size{storedSize(parameter) * sizeof(Scalar)};
+            if (offset + size > file->size()) { invalidFile(path, "the parameters are truncated"); }
+
+            views.push_back(parameterView(file->data() + offset, parameter));
+            offset += size;
+        }
+        if (!layer.useParameters(views)) { invalidFile(path, "layer implementation mismatch"); }
+    }};
+
+    for (auto& layer : cnn->myConvLayers) { useParameters(*layer); }
+    for (auto& layer : cnn->myDenseLayers) { useParameters(*layer); }
+
+    // Let the network keep the file mapped as long as the layers use it.
+    cnn->myModelFile = std::move(file);
+    return cnn;
+}
+} // namespace ml::cnn
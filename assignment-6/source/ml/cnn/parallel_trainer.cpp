@@ -0,0 +1,402 @@
+/**
+ * @brief Data-parallel trainer implementation details.
+ */
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "ml/cnn/cnn.h"
+#include "ml/cnn/parallel_trainer.h"
+#include "ml/cnn/train_mode.h"
+#include "ml/dataset/tensor_dataset.h"
+#include "ml/linalg/blas.h"
+#include "ml/tensor.h"
+#include "ml/types.h"
+#include "ml/utils.h"
+
+namespace ml::cnn
+{
+/**
+ * @brief Reusable barrier, blocking each worker until all workers have arrived.
+ */
+class ParallelTrainer::Barrier final
+{
+public:
+    /**
+     * @brief Create a new barrier.
+     *
+     * @param[in] count Number of workers to wait for.
+     */
+    explicit Barrier(const std::size_t count) noexcept
+        : myMutex{}
+        , myCondition{}
+        , myCount{count}
+        , myArrived{}
+        , myGeneration{}
+    {}
+
+    /**
+     * @brief Block until all workers have arrived.
+     */
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock{myMutex};
+        const std::size_t generation{myGeneration};
+
+        // Release the other workers if this is the last one to arrive, else wait for it.
+        if (myCount == ++myArrived)
+        {
+            myArrived = 0U;
+            ++myGeneration;
+            myCondition.notify_all();
+        }
+        else
+        {
+            myCondition.wait(lock, [&]() { return generation != myGeneration; });
+        }
+    }
+
+private:
+    /** Mutex protecting the counters. */
+    std::mutex myMutex;
+
+    /** Condition signaled when the last worker arrives. */
+    std::condition_variable myCondition;
+
+    /** Number of workers to wait for. */
+    const std::size_t myCount;
+
+    /** Number of workers arrived in the current generation. */
+    std::size_t myArrived;
+
+    /** Generation, incremented each time the barrier is released. */
+    std::size_t myGeneration;
+};
+
+/**
+ * @brief State shared by the workers during training.
+ */
+struct ParallelTrainer::Job
+{
+    /**
+     * @brief Create a new job.
+     *
+     * @param[in] dataset Training dataset.
+     * @param[in] epochCount Number of epochs to train the model.
+     * @param[in] learningRate Learning rate to use during training.
+     * @param[in] batchSize Number of training sets per batch.
+     * @param[in] setCount Number of training sets.
+     * @param[in] workerCount Number of workers.
+     */
+    Job(const dataset::Interface& dataset, const std::size_t epochCount,
+        const double learningRate, const std::size_t batchSize, const std::size_t setCount,
+        const std::size_t workerCount)
+        : dataset{dataset}
+        , epochCount{epochCount}
+        , learningRate{learningRate}
+        , batchSize{batchSize}
+        , setCount{setCount}
+        , trainOrder{createTrainOrderList(setCount)}
+        , barrier{workerCount}
+        , failed{false}
+    {}
+
+    /** Training dataset. */
+    const dataset::Interface& dataset;
+
+    /** Number of epochs to train the model. */
+    const std::size_t epochCount;
+
+    /** Learning rate to use during training. */
+    const double learningRate;
+
+    /** Number of training sets per batch. */
+    const std::size_t batchSize;
+
+    /** Number of training sets. */
+    const std::size_t setCount;
+
+    /** Training order, shuffled by the first worker at the start of each epoch. */
+    TrainOrderList trainOrder;
+
+    /** Barrier synchronizing the workers. */
+    Barrier barrier;
+
+    /** Indicate whether any worker has failed. */
+    std::atomic<bool> failed;
+};
+
+/**
+ * @brief Worker state, i.e. a network replica and its buffers.
+ */
+struct ParallelTrainer::Worker
+{
+    /** Replica owned by the worker (none for the first worker, which uses the network). */
+    std::unique_ptr<Cnn> replica;
+
+    /** Network trained by the worker. */
+    Cnn* cnn;
+
+    /** Input batch of the current shard. */
+    Tensor inputs;
+
+    /** Target batch of the current shard. */
+    Tensor targets;
+
+    /** Views of the gradients of the network. */
+    TensorList gradients;
+
+    /** Gradients packed into a single buffer for the all-reduce. */
+    Tensor gradientBuffer;
+};
+
+// -----------------------------------------------------------------------------
+ParallelTrainer::ParallelTrainer(Cnn& cnn, const std::size_t threadCount, 
+                                 const TrainMode mode)
+    : myCnn{cnn}
+    , myThreadCount{threadCount}
+    , myMode{mode}
+    , myWorkers{}
+{
+    // Throw an exception if the thread count is invalid.
+    if (0U == threadCount)
+    {
+        throw std::invalid_argument(
+            "Failed to create parallel trainer: thread count cannot be 0!");
+    }
+}
+
+// -----------------------------------------------------------------------------
+ParallelTrainer::~ParallelTrainer() noexcept = default;
+
+// -----------------------------------------------------------------------------
+bool ParallelTrainer::train(const Tensor& trainIn, const Tensor& trainOut,
+                            const std::size_t epochCount, const double learningRate,
+                            const std::size_t batchSize)
+{
+    // Train on a dataset holding views of the training sets.
+    const dataset::TensorDataset dataset{trainIn, trainOut};
+    return train(dataset, epochCount, learningRate, batchSize);
+}
+
+// -----------------------------------------------------------------------------
+bool ParallelTrainer::train(const dataset::Interface& dataset, const std::size_t epochCount,
+                            const double learningRate, const std::size_t batchSize)
+{
+    // Check the input arguments, return false on failure.
+    const std::size_t setCount{
+        myCnn.checkTrainArgs(dataset, epochCount, learningRate, batchSize)};
+    if (0U == setCount) { return false; }
+
+    // Split every batch across the workers in synchronous mode, while every worker trains
+    // on its own batches in Hogwild mode.
+    const bool hogwild{TrainMode::Hogwild == myMode};
+    const std::size_t workerSetCount{(setCount + myThreadCount - 1U) / myThreadCount};
+    const std::size_t maxBatchSize{std::min(batchSize, hogwild ? workerSetCount : setCount)};
+    const std::size_t maxShardSize{
+        hogwild ? maxBatchSize : (maxBatchSize + myThreadCount - 1U) / myThreadCount};
+
+    // Let the network hold a full shard, then create a replica for every other worker.
+    if (myCnn.maxBatchSize() < maxShardSize) { myCnn.setMaxBatchSize(maxShardSize); }
+    myWorkers.clear();
+
+    for (std::size_t i{}; i < myThreadCount; ++i)
+    {
+        auto worker{std::make_unique<Worker>()};
+
+        if (0U < i)
+        {
+            worker->replica = myCnn.replicate(hogwild);
+            if (nullptr == worker->replica)
+            {
+                myWorkers.clear();
+                return false;
+            }
+            worker->replica->setMaxBatchSize(maxShardSize);
+        }
+        worker->cnn     = 0U < i ? worker->replica.get() : &myCnn;
+        worker->inputs  = Tensor{maxShardSize, myCnn.inputSize(), myCnn.inputSize()};
+        worker->targets = Tensor{maxShardSize, myCnn.outputSize()};
+
+        // Create the gradient buffers for the all-reduce in synchronous mode.
+        if (!hogwild)
+        {
+            worker->gradients = worker->cnn->gradients();
+            std::size_t gradientCount{};
+            for (const auto& gradient : worker->gradients) { gradientCount += gradient.size(); }
+            worker->gradientBuffer = Tensor{gradientCount};
+        }
+        myWorkers.push_back(std::move(worker));
+    }
+
+    // Run the workers, using the calling thread as the first worker.
+    Job job{dataset, epochCount, learningRate, maxBatchSize, setCount, myThreadCount};
+    const auto run{[this, &job, hogwild](const std::size_t index)
+    {
+        return hogwild ? runHogwildWorker(job, index) : runWorker(job, index);
+    }};
+    std::vector<std::thread> threads{};
+    threads.reserve(myThreadCount - 1U);
+
+    for (std::size_t i{1U}; i < myThreadCount; ++i) { threads.emplace_back(run, i); }
+    run(0U);
+    for (auto& thread : threads) { thread.join(); }
+
+    // Release the replicas, return true on success.
+    myWorkers.clear();
+    return !job.failed;
+}
+
+// -----------------------------------------------------------------------------
+bool ParallelTrainer::runWorker(Job& job, const std::size_t index)
+{
+    Worker& worker{*myWorkers[index]};
+    Cnn& cnn{*worker.cnn};
+    Scalar* buffer{worker.gradientBuffer.data()};
+
+    // Train the network the specified number of epochs.
+    for (std::size_t i{}; i < job.epochCount; ++i)
+    {
+        // Shuffle the training order list at the start of each epoch (first worker only).
+        if (0U == index) { shuffleTrainOrderList(job.trainOrder); }
+        job.barrier.wait();
+
+        // Iterate through the training sets batch by batch.
+        for (std::size_t first{}; first < job.setCount; first += job.batchSize)
+        {
+            // Select the shard of this worker.
+            const std::size_t batchSize{std::min(job.batchSize, job.setCount - first)};
+            const std::size_t begin{first + batchSize * index / myThreadCount};
+            const std::size_t end{first + batchSize * (index + 1U) / myThreadCount};
+            const std::size_t sampleCount{end - begin};
+
+            if (0U < sampleCount)
+            {
+                // Compute the gradients of the shard.
+                const bool success{propagate(worker, job, begin, sampleCount) 
+                    && cnn.computeGradients()};
+                if (!success) { job.failed = true; }
+
+                // Pack the gradients, weighted by the share of the batch in this shard.
+                std::size_t offset{};
+
+                for (const auto& gradient : worker.gradients)
+                {
+                    Tensor packed{Tensor::wrap(buffer + offset, {gradient.size()})};
+                    packed.copyFrom(gradient);
+                    offset += gradient.size();
+                }
+                const Scalar weight{static_cast<Scalar>(sampleCount) / batchSize};
+                for (std::size_t j{}; j < offset; ++j) { buffer[j] *= weight; }
+            }
+            else { worker.gradientBuffer.zero(); }
+
+            // Wait for the other workers, stop if any of them has failed.
+            job.barrier.wait();
+            if (job.failed) { return false; }
+
+            // Sum the gradients of all workers and apply them to the replica.
+            allReduce(job, index);
+            std::size_t offset{};
+
+            for (auto& gradient : worker.gradients)
+            {
+                gradient.copyFrom(Tensor::wrap(buffer + offset, {gradient.size()}));
+                offset += gradient.size();
+            }
+            if (!cnn.applyGradients(job.learningRate)) { job.failed = true; }
+        }
+    }
+    // Return true on success.
+    return !job.failed;
+}
+
+// -----------------------------------------------------------------------------
+bool ParallelTrainer::runHogwildWorker(Job& job, const std::size_t index)
+{
+    Worker& worker{*myWorkers[index]};
+
+    // Select the part of every epoch trained by this worker.
+    const std::size_t begin{job.setCount * index / myThreadCount};
+    const std::size_t end{job.setCount * (index + 1U) / myThreadCount};
+
+    // Train the network the specified number of epochs.
+    for (std::size_t i{}; i < job.epochCount; ++i)
+    {
+        // Shuffle the training order list at the start of each epoch (first worker only),
+        // stop if any worker has failed.
+        if (0U == index) { shuffleTrainOrderList(job.trainOrder); }
+        job.barrier.wait();
+        if (job.failed) { return false; }
+
+        // Update the shared parameters after every batch, without waiting for the others.
+        for (std::size_t first{begin}; first < end; first += job.batchSize)
+        {
+            const std::size_t sampleCount{std::min(job.batchSize, end - first)};
+            const bool success{propagate(worker, job, first, sampleCount) 
+                && worker.cnn->optimize(job.learningRate)};
+            if (!success) { job.failed = true; }
+        }
+        // Let all workers finish the epoch before the training order is shuffled again.
+        job.barrier.wait();
+    }
+    // Return true on success.
+    return !job.failed;
+}
+
+// -----------------------------------------------------------------------------
+bool ParallelTrainer::propagate(Worker& worker, const Job& job, const std::size_t first,
+                                const std::size_t sampleCount) noexcept
+{
+    // Load the training sets.
+    for (std::size_t j{}; j < sampleCount; ++j)
+    {
+        Tensor input{worker.inputs.slice(j)};
+        Tensor target{worker.targets.slice(j)};
+        job.dataset.load(job.trainOrder[first + j], input, target);
+    }
+    const Tensor input{worker.inputs.narrow(0U, 0U, sampleCount)};
+    const Tensor target{worker.targets.narrow(0U, 0U, sampleCount)};
+
+    // Run feedforward and backpropagation, return true on success.
+    return worker.cnn->feedforward(input) && worker.cnn->backpropagate(target);
+}
+
+// -----------------------------------------------------------------------------
+void ParallelTrainer::allReduce(Job& job, const std::size_t index)
+{
+    // The buffers are split into one chunk per worker. Each worker only reads from the
+    // previous worker in the ring, which is always working on another chunk.
+    const std::size_t count{myThreadCount};
+    const std::size_t size{myWorkers[index]->gradientBuffer.size()};
+    const std::size_t chunkSize{(size + count - 1U) / count};
+    const Scalar* previous{myWorkers[(index + count - 1U) % count]->gradientBuffer.data()};
+    Scalar* own{myWorkers[index]->gradientBuffer.data()};
+
+    // Reduce-scatter: in each step, add the partial sum of one chunk from the previous
+    // worker. Afterwards, this worker holds the full sum of chunk (index + 1) % count.
+    for (std::size_t step{}; step + 1U < count; ++step)
+    {
+        const std::size_t chunk{(index + 2U * count - 1U - step) % count};
+        const std::size_t begin{std::min(chunk * chunkSize, size)};
+        const std::size_t end{std::min(begin + chunkSize, size)};
+        linalg::axpy(end - begin, 1.0, previous + begin, own + begin);
+        job.barrier.wait();
+    }
+
+    // All-gather: in each step, copy one fully summed chunk from the previous worker.
+    for (std::size_t step{}; step + 1U < count; ++step)
+    {
+        const std::size_t chunk{(index + count - step) % count};
+        const std::size_t begin{std::min(chunk * chunkSize, size)};
+        const std::size_t end{std::min(begin + chunkSize, size)};
+        std::copy(previous + begin, previous + end, own + begin);
+        job.barrier.wait();
+    }
+}
+} // namespace ml::cnn
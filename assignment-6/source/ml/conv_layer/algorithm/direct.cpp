@@ -0,0 +1,188 @@
+/**
+ * @brief Direct convolution algorithm implementation details.
+ */
+#include <algorithm>
+#include <cstdlib>
+
+#include "ml/conv_layer/algorithm/direct.h"
+#include "ml/parallel/thread_pool.h"
+#include "ml/tensor.h"
+
+namespace ml::conv_layer::algorithm
+{
+namespace
+{
+// -----------------------------------------------------------------------------
+constexpr std::size_t windowFirst(const std::size_t pos, const std::size_t pad) noexcept
+{
+    // First kernel index that maps output position pos onto the input.
+    return pos < pad ? pad - pos : 0U;
+}
+
+// -----------------------------------------------------------------------------
+constexpr std::size_t windowLast(const std::size_t pos, const std::size_t pad,
+                                 const std::size_t size, const std::size_t kernelSize) noexcept
+{
+    // One past the last kernel index that maps output position pos onto the input.
+    const std::size_t last{size + pad - pos};
+    return last < kernelSize ? last : kernelSize;
+}
+} // namespace
+
+//--------------------------------------------------------------------------------
+Direct::Direct(const std::size_t inputSize, const std::size_t kernelSize)
+    : myPadOffset{kernelSize / 2U}
+{
+    // Nothing is allocated, the kernel window is clipped at the border instead.
+    (void) (inputSize);
+}
+
+//--------------------------------------------------------------------------------
+void Direct::feedforward(const Tensor& input, const Tensor& kernel, const Scalar bias,
+                         Tensor& output) noexcept
+{
+    // Run feedforward; accumulate bias and contributions from the input and the kernel.
+    const std::size_t outputSize{output.dim(0U)};
+    const std::size_t kernelSize{kernel.dim(0U)};
+    const std::size_t pad{myPadOffset};
+
+    // Columns in range [interiorFirst, interiorLast) have the whole kernel window inside the
+    // input, so only the border columns need a clipped window.
+    const std::size_t interiorFirst{std::min(pad, outputSize)};
+    const std::size_t interiorLast{
+        std::max(interiorFirst, std::min(outputSize, outputSize + pad + 1U - kernelSize))};
+
+    // The output rows are independent, split them across the thread pool.
+    parallel::parallelFor(outputSize, outputSize * kernelSize * kernelSize,
+                          [&](const std::size_t first, const std::size_t last)
+    {
+        for (std::size_t i{first}; i < last; ++i)
+        {
+            const std::size_t kiFirst{windowFirst(i, pad)};
+            const std::size_t kiLast{windowLast(i, pad, outputSize, kernelSize)};
+            Scalar* outputRow{output.row(i)};
+
+            // Add the bias value and the input * kernel values inside given kernel columns.
+            auto convolve{[&](const std::size_t j, const std::size_t kjFirst,
+                              const std::size_t kjLast)
+            {
+                auto sum{bias};
+
+                for (std::size_t ki{kiFirst}; ki < kiLast; ++ki)
+                {
+                    const Scalar* inputRow{input.row(i + ki - pad)};
+                    const Scalar* kernelRow{kernel.row(ki)};
+
+                    for (std::size_t kj{kjFirst}; kj < kjLast; ++kj)
+                    {
+                        sum += inputRow[j + kj - pad] * kernelRow[kj];
+                    }
+                }
+                outputRow[j] = sum;
+            }};
+
+            for (std::size_t j{}; j < interiorFirst; ++j)
+            {
+                convolve(j, windowFirst(j, pad), windowLast(j, pad, outputSize, kernelSize));
+            }
+            for (std::size_t j{interiorFirst}; j < interiorLast; ++j)
+            {
+                convolve(j, 0U, kernelSize);
+            }
+            for (std::size_t j{interiorLast}; j < outputSize; ++j)
+            {
+                convolve(j, windowFirst(j, pad), windowLast(j, pad, outputSize, kernelSize));
+            }
+        }
+    });
+}
+
+//--------------------------------------------------------------------------------
+void Direct::backpropagate(const Tensor& input, const Tensor& delta, const Tensor& kernel,
+                           Tensor& kernelGradients, Tensor& inputGradients) noexcept
+{
+    const std::size_t outputSize{delta.dim(0U)};
+    const std::size_t kernelSize{kernel.dim(0U)};
+    const std::size_t pad{myPadOffset};
+
+    // Each kernel gradient sums input * delta over the outputs whose window covers the input,
+    // i.e. over a rectangle of output rows and columns.
+    for (std::size_t ki{}; ki < kernelSize; ++ki)
+    {
+        const std::size_t iFirst{windowFirst(ki, pad)};
+        const std::size_t iLast{std::min(outputSize, outputSize + pad - ki)};
+
+        for (std::size_t kj{}; kj < kernelSize; ++kj)
+        {
+            const std::size_t jFirst{windowFirst(kj, pad)};
+            const std::size_t jLast{std::min(outputSize, outputSize + pad - kj)};
+            Scalar sum{};
+
+            for (std::size_t i{iFirst}; i < iLast; ++i)
+            {
+                const Scalar* inputRow{input.row(i + ki - pad)};
+                const Scalar* deltaRow{delta.row(i)};
+
+                for (std::size_t j{jFirst}; j < jLast; ++j)
+                {
+                    sum += inputRow[j + kj - pad] * deltaRow[j];
+                }
+            }
+            kernelGradients(ki, kj) = sum;
+        }
+    }
+
+    // Input (r, c) contributes to output (r + pad - ki, c + pad - kj), so the columns in range
+    // [interiorFirst, interiorLast) reach all kernel columns.
+    const std::size_t inputSize{inputGradients.dim(0U)};
+    const std::size_t interiorFirst{std::min(kernelSize - 1U - pad, inputSize)};
+    const std::size_t interiorLast{std::max(interiorFirst, inputSize - pad)};
+
+    // The input gradient rows are independent, split them across the thread pool.
+    parallel::parallelFor(inputSize, inputSize * kernelSize * kernelSize,
+                          [&](const std::size_t first, const std::size_t last)
+    {
+        for (std::size_t r{first}; r < last; ++r)
+        {
+            // Kernel rows mapping input row r onto an output row.
+            const std::size_t kiFirst{r + pad + 1U > outputSize ? r + pad + 1U - outputSize : 0U};
+            const std::size_t kiLast{std::min(kernelSize, r + pad + 1U)};
+            Scalar* gradientRow{inputGradients.row(r)};
+
+            // Add the kernel * delta values inside given kernel columns.
+            auto gather{[&](const std::size_t c, const std::size_t kjFirst,
+                            const std::size_t kjLast)
+            {
+                Scalar sum{};
+
+                for (std::size_t ki{kiFirst}; ki < kiLast; ++ki)
+                {
+                    const Scalar* deltaRow{delta.row(r + pad - ki)};
+                    const Scalar* kernelRow{kernel.row(ki)};
+
+                    for (std::size_t kj{kjFirst}; kj < kjLast; ++kj)
+                    {
+                        sum += kernelRow[kj] * deltaRow[c + pad - kj];
+                    }
+                }
+                gradientRow[c] = sum;
+            }};
+
+            // Kernel columns mapping input column c onto an output column.
+            auto clipped{[&](const std::size_t c)
+            {
+                const std::size_t kjFirst{
+                    c + pad + 1U > outputSize ? c + pad + 1U - outputSize : 0U};
+                gather(c, kjFirst, std::min(kernelSize, c + pad + 1U));
+            }};
+
+            for (std::size_t c{}; c < interiorFirst; ++c) { clipped(c); }
+            for (std::size_t c{interiorFirst}; c < interiorLast; ++c)
+            {
+                gather(c, 0U, kernelSize);
+            }
+            for (std::size_t c{interiorLast}; c < inputSize; ++c) { clipped(c); }
+        }
+    });
+}
+} // namespace ml::conv_layer::algorithm
@@ -0,0 +1,114 @@
+/**
+ * @brief FFT convolution algorithm implementation details.
+ */
+#include <cstdlib>
+#include <vector>
+
+#include "ml/conv_layer/algorithm/fft.h"
+#include "ml/linalg/fft.h"
+#include "ml/tensor.h"
+
+namespace ml::conv_layer::algorithm
+{
+namespace
+{
+// -----------------------------------------------------------------------------
+std::size_t transformSize(const std::size_t inputSize, const std::size_t kernelSize) noexcept
+{
+    // Use the smallest supported size for which the circular wrap-around of the convolution
+    // doesn't reach the stored outputs, i.e. the input size plus the larger padding side.
+    const std::size_t padBefore{kernelSize / 2U};
+    const std::size_t padAfter{kernelSize - 1U - padBefore};
+    return linalg::RealFft2d::nextSize(inputSize + (padBefore > padAfter ? padBefore : padAfter));
+}
+
+// -----------------------------------------------------------------------------
+void multiply(const std::vector<linalg::Complex>& a, const std::vector<linalg::Complex>& b,
+              const bool conjugate, std::vector<linalg::Complex>& product) noexcept
+{
+    // Compute product = a * b (or a * conj(b)) element-wise.
+    const Scalar sign{conjugate ? Scalar{-1} : Scalar{1}};
+
+    for (std::size_t i{}; i < product.size(); ++i)
+    {
+        const Scalar ar{a[i].real()}, ai{a[i].imag()};
+        const Scalar br{b[i].real()}, bi{sign * b[i].imag()};
+        product[i] = linalg::Complex{ar * br - ai * bi, ar * bi + ai * br};
+    }
+}
+} // namespace
+
+//--------------------------------------------------------------------------------
+Fft::Fft(const std::size_t inputSize, const std::size_t kernelSize)
+    : myFft{transformSize(inputSize, kernelSize)}
+    , myInputSpectrum(myFft.spectrumSize())
+    , myDeltaSpectrum(myFft.spectrumSize())
+    , myKernelSpectrum(myFft.spectrumSize())
+    , myRotatedKernelSpectrum(myFft.spectrumSize())
+    , myProduct(myFft.spectrumSize())
+    , myRotatedKernel{kernelSize, kernelSize}
+    , myPadOffset{kernelSize / 2U}
+    , myKernelValid{false}
+{}
+
+//--------------------------------------------------------------------------------
+void Fft::feedforward(const Tensor& input, const Tensor& kernel, const Scalar bias,
+                      Tensor& output) noexcept
+{
+    // Transform the kernel unless valid spectra are cached, then transform the input.
+    if (!myKernelValid) { updateKernelSpectra(kernel); }
+    myFft.forward(input, myInputSpectrum.data());
+
+    // Convolve with the rotated kernel, i.e. correlate with the kernel. Output (i, j) is
+    // located at (i + kernel size - 1 - pad offset, j + ...) in the linear convolution.
+    multiply(myInputSpectrum, myRotatedKernelSpectrum, false, myProduct);
+    myFft.inverse(myProduct.data(), kernel.dim(0U) - 1U - myPadOffset, output);
+
+    // Add the bias value.
+    for (std::size_t i{}; i < output.dim(0U); ++i)
+    {
+        Scalar* row{output.row(i)};
+        for (std::size_t j{}; j < output.dim(1U); ++j) { row[j] += bias; }
+    }
+}
+
+//--------------------------------------------------------------------------------
+void Fft::backpropagate(const Tensor& input, const Tensor& delta, const Tensor& kernel,
+                        Tensor& kernelGradients, Tensor& inputGradients) noexcept
+{
+    if (!myKernelValid) { updateKernelSpectra(kernel); }
+    myFft.forward(input, myInputSpectrum.data());
+    myFft.forward(delta, myDeltaSpectrum.data());
+
+    // Input gradient (i, j) is located at (i + pad offset, j + pad offset) in the linear
+    // convolution of the deltas with the kernel.
+    multiply(myDeltaSpectrum, myKernelSpectrum, false, myProduct);
+    myFft.inverse(myProduct.data(), myPadOffset, inputGradients);
+
+    // Kernel gradient (ki, kj) is the correlation of the input with the deltas at lag
+    // (ki - pad offset, kj - pad offset); negative lags wrap around.
+    multiply(myInputSpectrum, myDeltaSpectrum, true, myProduct);
+    myFft.inverse(myProduct.data(), myFft.size() - myPadOffset, kernelGradients);
+}
+
+//--------------------------------------------------------------------------------
+void Fft::invalidate() noexcept { myKernelValid = false; }
+
+//--------------------------------------------------------------------------------
+void Fft::updateKernelSpectra(const Tensor& kernel) noexcept
+{
+    const std::size_t kernelSize{kernel.dim(0U)};
+
+    for (std::size_t ki{}; ki < kernelSize; ++ki)
+    {
+        for (std::size_t kj{}; kj < kernelSize; ++kj)
+        {
+            myRotatedKernel(ki, kj) = kernel(kernelSize - 1U - ki, kernelSize - 1U - kj);
+        }
+    }
+    myFft.forward(kernel, myKernelSpectrum.data());
+    myFft.forward(myRotatedKernel, myRotatedKernelSpectrum.data());
+    myKernelValid = true;
+}
+
+} // namespace ml::conv_layer::algorithm
@@ -0,0 +1,131 @@
+/**
+ * @brief Im2col convolution algorithm implementation details.
+ */
+#include <algorithm>
+#include <cstdlib>
+
+#include "ml/conv_layer/algorithm/im2col.h"
+#include "ml/linalg/gemm.h"
+#include "ml/tensor.h"
+
+namespace ml::conv_layer::algorithm
+{
+//--------------------------------------------------------------------------------
+Im2col::Im2col(const std::size_t inputSize, const std::size_t kernelSize)
+    : myColumns{kernelSize * kernelSize, inputSize * inputSize}
+    , myColumnGradients{kernelSize * kernelSize, inputSize * inputSize}
+    , myInputSize{inputSize}
+    , myKernelSize{kernelSize}
+{}
+
+//--------------------------------------------------------------------------------
+void Im2col::feedforward(const Tensor& input, const Tensor& kernel, const Scalar bias,
+                         Tensor& output) noexcept
+{
+    using linalg::Transpose;
+    const std::size_t kernelCount{myKernelSize * myKernelSize};
+    const std::size_t outputCount{myInputSize * myInputSize};
+
+    // Lower the input, then compute output (1 x n²) = kernel (1 x k²) * columns (k² x n²).
+    im2col(input);
+    output.fill(bias);
+    linalg::gemm(Transpose::No, Transpose::No, 1U, outputCount, kernelCount, 1.0, 
+                 kernel.data(), kernelCount, myColumns.data(), outputCount, 1.0, 
+                 output.data(), outputCount);
+}
+
+//--------------------------------------------------------------------------------
+void Im2col::backpropagate(const Tensor& input, const Tensor& delta, const Tensor& kernel,
+                           Tensor& kernelGradients, Tensor& inputGradients) noexcept
+{
+    using linalg::Transpose;
+    const std::size_t kernelCount{myKernelSize * myKernelSize};
+    const std::size_t outputCount{myInputSize * myInputSize};
+
+    // Unfold the input the deltas refer to.
+    im2col(input);
+
+    // Kernel gradients (1 x k²) = delta (1 x n²) * columns^T (n² x k²).
+    linalg::gemm(Transpose::No, Transpose::Yes, 1U, kernelCount, outputCount, 1.0, 
+                 delta.data(), outputCount, myColumns.data(), outputCount, 0.0, 
+                 kernelGradients.data(), kernelCount);
+
+    // Column gradients (k² x n²) = kernel^T (k² x 1) * delta (1 x n²), then scatter them.
+    linalg::gemm(Transpose::Yes, Transpose::No, kernelCount, outputCount, 1U, 1.0, 
+                 kernel.data(), kernelCount, delta.data(), outputCount, 0.0, 
+                 myColumnGradients.data(), outputCount);
+    col2im(inputGradients);
+}
+
+//--------------------------------------------------------------------------------
+void Im2col::im2col(const Tensor& input) noexcept
+{
+    const std::size_t padOffset{myKernelSize / 2U};
+
+    // Row (ki, kj) of the column matrix holds input(i + ki - pad, j + kj - pad) for each
+    // output (i, j), or zero where the window extends beyond the input.
+    for (std::size_t ki{}; ki < myKernelSize; ++ki)
+    {
+        for (std::size_t kj{}; kj < myKernelSize; ++kj)
+        {
+            Scalar* column{myColumns.row(ki * myKernelSize + kj)};
+
+            // Compute the range of output columns whose window column lies inside the input.
+            const std::size_t first{kj < padOffset ? padOffset - kj : 0U};
+            const std::size_t last{std::min(myInputSize, myInputSize + padOffset - kj)};
+
+            for (std::size_t i{}; i < myInputSize; ++i)
+            {
+                const std::size_t row{i + ki};
+                Scalar* dest{column + i * myInputSize};
+
+                // Fill the whole row with zeros if it's located in the padding.
+                if ((row < padOffset) || (row - padOffset >= myInputSize))
+                {
+                    std::fill(dest, dest + myInputSize, 0.0);
+                    continue;
+                }
+
+                // Else copy the valid segment and zero the padded edges.
+                const Scalar* source{input.row(row - padOffset) + first + kj - padOffset};
+                std::fill(dest, dest + first, 0.0);
+                std::copy(source, source + (last - first), dest + first);
+                std::fill(dest + last, dest + myInputSize, 0.0);
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+void Im2col::col2im(Tensor& inputGradients) const noexcept
+{
+    const std::size_t padOffset{myKernelSize / 2U};
+    inputGradients.zero();
+
+    // Accumulate each column gradient onto the input position it was gathered from.
+    for (std::size_t ki{}; ki < myKernelSize; ++ki)
+    {
+        for (std::size_t kj{}; kj < myKernelSize; ++kj)
+        {
+            const Scalar* column{myColumnGradients.row(ki * myKernelSize + kj)};
+            const std::size_t first{kj < padOffset ? padOffset - kj : 0U};
+            const std::size_t last{std::min(myInputSize, myInputSize + padOffset - kj)};
+
+            for (std::size_t i{}; i < myInputSize; ++i)
+            {
+                // Skip rows located in the padding.
+                const std::size_t row{i + ki};
+                if ((row < padOffset) || (row - padOffset >= myInputSize)) { continue; }
+
+                const Scalar* source{column + i * myInputSize};
+                Scalar* dest{inputGradients.row(row - padOffset)};
+
+                for (std::size_t j{first}; j < last; ++j)
+                {
+                    dest[j + kj - padOffset] += source[j];
+                }
+            }
+        }
+    }
+}
+} // namespace ml::conv_layer::algorithm
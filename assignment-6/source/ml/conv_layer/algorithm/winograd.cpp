@@ -0,0 +1,396 @@
+/**
+ * @brief Winograd convolution algorithm implementation details.
+ */
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+
+#include "ml/conv_layer/algorithm/winograd.h"
+#include "ml/tensor.h"
+
+namespace ml::conv_layer::algorithm
+{
+namespace
+{
+/**
+ * @brief Winograd transforms for F(m x m, 3 x 3), applied to a single column or row.
+ *
+ *        Each transform multiplies a vector x (with stride xs) by a transform matrix and
+ *        stores the result in y (with stride ys). The matrices only hold small integers and
+ *        simple fractions, so the products are written out as additions and subtractions
+ *        instead of dense matrix-vector products.
+ *
+ * @tparam TileSize Output tile size m.
+ */
+template <std::size_t TileSize>
+struct Transform;
+
+/**
+ * @brief Transforms for F(2x2, 3x3), whose matrices only hold 0, ±1 and ±0.5.
+ */
+template <>
+struct Transform<2U>
+{
+    /** Factor of the kernel transforms. */
+    static constexpr Scalar Half{0.5};
+
+    // -----------------------------------------------------------------------------
+    static void input(const Scalar* x, const std::size_t xs, Scalar* y,
+                      const std::size_t ys) noexcept
+    {
+        // Compute y = B^T x.
+        y[0U]      = x[0U] - x[2U * xs];
+        y[ys]      = x[xs] + x[2U * xs];
+        y[2U * ys] = x[2U * xs] - x[xs];
+        y[3U * ys] = x[xs] - x[3U * xs];
+    }
+
+    // -----------------------------------------------------------------------------
+    static void output(const Scalar* x, const std::size_t xs, Scalar* y,
+                       const std::size_t ys) noexcept
+    {
+        // Compute y = A^T x.
+        y[0U] = x[0U] + x[xs] + x[2U * xs];
+        y[ys] = x[xs] - x[2U * xs] - x[3U * xs];
+    }
+
+    // -----------------------------------------------------------------------------
+    static void delta(const Scalar* x, const std::size_t xs, Scalar* y,
+                      const std::size_t ys) noexcept
+    {
+        // Compute y = A x, the transpose of the output transform.
+        y[0U]      = x[0U];
+        y[ys]      = x[0U] + x[xs];
+        y[2U * ys] = x[0U] - x[xs];
+        y[3U * ys] = -x[xs];
+    }
+
+    // -----------------------------------------------------------------------------
+    static void kernel(const Scalar* x, const std::size_t xs, Scalar* y,
+                       const std::size_t ys) noexcept
+    {
+        // Compute y = G x.
+        const Scalar outer{Half * (x[0U] + x[2U * xs])};
+        y[0U]      = x[0U];
+        y[ys]      = outer + Half * x[xs];
+        y[2U * ys] = outer - Half * x[xs];
+        y[3U * ys] = x[2U * xs];
+    }
+
+    // -----------------------------------------------------------------------------
+    static void kernelGradient(const Scalar* x, const std::size_t xs, Scalar* y,
+                               const std::size_t ys) noexcept
+    {
+        // Compute y = G^T x, the transpose of the kernel transform.
+        const Scalar sum{Half * (x[xs] + x[2U * xs])};
+        y[0U]      = x[0U] + sum;
+        y[ys]      = Half * (x[xs] - x[2U * xs]);
+        y[2U * ys] = sum + x[3U * xs];
+    }
+};
+
+/**
+ * @brief Transforms for F(4x4, 3x3), whose matrices hold powers of two and multiples of 1/24.
+ */
+template <>
+struct Transform<4U>
+{
+    /** Factors of the transforms. */
+    static constexpr Scalar Two{2.0}, Four{4.0}, Five{5.0}, Eight{8.0};
+
+    /** Fractions of the kernel transforms. */
+    static constexpr Scalar Quarter{1.0 / 4.0}, Sixth{1.0 / 6.0}, Twelfth{1.0 / 12.0},
+                            TwentyFourth{1.0 / 24.0};
+
+    // -----------------------------------------------------------------------------
+    static void input(const Scalar* x, const std::size_t xs, Scalar* y,
+                      const std::size_t ys) noexcept
+    {
+        // Compute y = B^T x, sharing the terms of the symmetric row pairs.
+        const Scalar x1{x[xs]}, x2{x[2U * xs]}, x3{x[3U * xs]}, x4{x[4U * xs]};
+        const Scalar a{x4 - Four * x2}, b{x3 - Four * x1};
+        const Scalar c{x4 - x2}, d{Two * (x3 - x1)};
+        y[0U]      = Four * x[0U] - Five * x2 + x4;
+        y[ys]      = a + b;
+        y[2U * ys] = a - b;
+        y[3U * ys] = c + d;
+        y[4U * ys] = c - d;
+        y[5U * ys] = Four * x1 - Five * x3 + x[5U * xs];
+    }
+
+    // -----------------------------------------------------------------------------
+    static void output(const Scalar* x, const std::size_t xs, Scalar* y,
+                       const std::size_t ys) noexcept
+    {
+        // Compute y = A^T x, sharing the sums and differences of the symmetric columns.
+        const Scalar sum12{x[xs] + x[2U * xs]}, diff12{x[xs] - x[2U * xs]};
+        const Scalar sum34{x[3U * xs] + x[4U * xs]}, diff34{x[3U * xs] - x[4U * xs]};
+        y[0U]      = x[0U] + sum12 + sum34;
+        y[ys]      = diff12 + Two * diff34;
+        y[2U * ys] = sum12 + Four * sum34;
+        y[3U * ys] = diff12 + Eight * diff34 + x[5U * xs];
+    }
+
+    // -----------------------------------------------------------------------------
+    static void delta(const Scalar* x, const std::size_t xs, Scalar* y,
+                      const std::size_t ys) noexcept
+    {
+        // Compute y = A x, the transpose of the output transform.
+        const Scalar x0{x[0U]}, x1{x[xs]}, x2{x[2U * xs]}, x3{x[3U * xs]};
+        const Scalar even1{x0 + x2}, odd1{x1 + x3};
+        const Scalar even2{x0 + Four * x2}, odd2{Two * x1 + Eight * x3};
+        y[0U]      = x0;
+        y[ys]      = even1 + odd1;
+        y[2U * ys] = even1 - odd1;
+        y[3U * ys] = even2 + odd2;
+        y[4U * ys] = even2 - odd2;
+        y[5U * ys] = x3;
+    }
+
+    // -----------------------------------------------------------------------------
+    static void kernel(const Scalar* x, const std::size_t xs, Scalar* y,
+                       const std::size_t ys) noexcept
+    {
+        // Compute y = G x.
+        const Scalar outer{x[0U] + x[2U * xs]};
+        const Scalar outer2{TwentyFourth * x[0U] + Sixth * x[2U * xs]};
+        y[0U]      = Quarter * x[0U];
+        y[ys]      = -Sixth * (outer + x[xs]);
+        y[2U * ys] = -Sixth * (outer - x[xs]);
+        y[3U * ys] = outer2 + Twelfth * x[xs];
+        y[4U * ys] = outer2 - Twelfth * x[xs];
+        y[5U * ys] = x[2U * xs];
+    }
+
+    // -----------------------------------------------------------------------------
+    static void kernelGradient(const Scalar* x, const std::size_t xs, Scalar* y,
+                               const std::size_t ys) noexcept
+    {
+        // Compute y = G^T x, the transpose of the kernel transform.
+        const Scalar sum12{x[xs] + x[2U * xs]}, diff12{x[2U * xs] - x[xs]};
+        const Scalar sum34{x[3U * xs] + x[4U * xs]}, diff34{x[3U * xs] - x[4U * xs]};
+        y[0U]      = Quarter * x[0U] - Sixth * sum12 + TwentyFourth * sum34;
+        y[ys]      = Sixth * diff12 + Twelfth * diff34;
+        y[2U * ys] = Sixth * (sum34 - sum12) + x[5U * xs];
+    }
+};
+
+/** Signature of the transforms of a single column or row. */
+using Transform1d = void (*)(const Scalar*, std::size_t, Scalar*, std::size_t) noexcept;
+
+// -----------------------------------------------------------------------------
+template <std::size_t InSize, std::size_t OutSize, Transform1d Apply>
+void transform(const Scalar* in, const std::size_t stride,
+               Scalar (&out)[OutSize][OutSize]) noexcept
+{
+    // Compute out = P in P^T by applying P to every column, then to every row.
+    Scalar columns[OutSize][InSize];
+    for (std::size_t j{}; j < InSize; ++j) { Apply(in + j, stride, &columns[0U][j], InSize); }
+    for (std::size_t i{}; i < OutSize; ++i) { Apply(columns[i], 1U, out[i], 1U); }
+}
+
+// -----------------------------------------------------------------------------
+std::size_t paddedSize(const std::size_t inputSize, const std::size_t tileSize) noexcept
+{
+    // Round the input size up to a whole number of tiles, add one row/column on each side.
+    const std::size_t tileCount{(inputSize + tileSize - 1U) / tileSize};
+    return tileCount * tileSize + 2U;
+}
+} // namespace
+
+//--------------------------------------------------------------------------------
+template <std::size_t TileSize>
+Winograd<TileSize>::Winograd(const std::size_t inputSize, const std::size_t kernelSize)
+    : myInputPadded{}
+    , myDeltaPadded{}
+    , myKernelTransformed{InputTileSize, InputTileSize}
+    , myRotatedKernelTransformed{InputTileSize, InputTileSize}
+    , myKernelValid{false}
+    , myRotatedKernelValid{false}
+{
+    // Throw an exception if the kernel size isn't supported.
+    if (KernelSize != kernelSize)
+    {
+        std::stringstream msg{};
+        msg << "Invalid kernel size " << kernelSize << ": Winograd convolution requires kernel size "
+            << KernelSize << "!\n";
+        throw std::invalid_argument(msg.str());
+    }
+
+    // Initialize the padded matrices with zeros.
+    const std::size_t padded{paddedSize(inputSize, TileSize)};
+    myInputPadded = Tensor{padded, padded};
+    myDeltaPadded = Tensor{padded, padded};
+}
+
+//--------------------------------------------------------------------------------
+template <std::size_t TileSize>
+void Winograd<TileSize>::feedforward(const Tensor& input, const Tensor& kernel,
+                                     const Scalar bias, Tensor& output) noexcept
+{
+    // Transform the kernel unless a valid transform is cached.
+    if (!myKernelValid)
+    {
+        transformKernel(kernel, false, myKernelTransformed);
+        myKernelValid = true;
+    }
+    pad(input, myInputPadded);
+    convolve(myInputPadded, myKernelTransformed, bias, output);
+}
+
+//--------------------------------------------------------------------------------
+template <std::size_t TileSize>
+void Winograd<TileSize>::backpropagate(const Tensor& input, const Tensor& delta,
+                                       const Tensor& kernel, Tensor& kernelGradients,
+                                       Tensor& inputGradients) noexcept
+{
+    // Accumulate the kernel gradients in the Winograd domain. Each output tile is
+    // A^T (U ⊙ V) A, so the gradient of the loss with respect to U is the sum over the tiles
+    // of (A δ A^T) ⊙ V, which only needs to be transformed back once as G^T dU G.
+    using T = Transform<TileSize>;
+    const std::size_t outputSize{delta.dim(0U)};
+    const std::size_t stride{myInputPadded.dim(1U)};
+    Scalar transformedGradients[InputTileSize][InputTileSize]{};
+    pad(input, myInputPadded);
+    pad(delta, myDeltaPadded);
+
+    for (std::size_t ti{}; ti < outputSize; ti += TileSize)
+    {
+        for (std::size_t tj{}; tj < outputSize; tj += TileSize)
+        {
+            // The deltas beyond the output are zero, since the padding is never written.
+            Scalar v[InputTileSize][InputTileSize];
+            Scalar d[InputTileSize][InputTileSize];
+            transform<InputTileSize, InputTileSize, T::input>(myInputPadded.row(ti) + tj,
+                                                               stride, v);
+            transform<TileSize, InputTileSize, T::delta>(myDeltaPadded.row(ti + 1U) + tj + 1U,
+                                                         stride, d);
+
+            for (std::size_t i{}; i < InputTileSize; ++i)
+            {
+                for (std::size_t j{}; j < InputTileSize; ++j)
+                {
+                    transformedGradients[i][j] += d[i][j] * v[i][j];
+                }
+            }
+        }
+    }
+    Scalar g[KernelSize][KernelSize];
+    transform<InputTileSize, KernelSize, T::kernelGradient>(&transformedGradients[0U][0U],
+                                                            InputTileSize, g);
+
+    for (std::size_t ki{}; ki < KernelSize; ++ki)
+    {
+        for (std::size_t kj{}; kj < KernelSize; ++kj) { kernelGradients(ki, kj) = g[ki][kj]; }
+    }
+
+    // Compute the input gradients by convolving the deltas with the rotated kernel.
+    if (!myRotatedKernelValid)
+    {
+        transformKernel(kernel, true, myRotatedKernelTransformed);
+        myRotatedKernelValid = true;
+    }
+    convolve(myDeltaPadded, myRotatedKernelTransformed, 0.0, inputGradients);
+}
+
+//--------------------------------------------------------------------------------
+template <std::size_t TileSize>
+void Winograd<TileSize>::invalidate() noexcept
+{
+    myKernelValid        = false;
+    myRotatedKernelValid = false;
+}
+
+//--------------------------------------------------------------------------------
+template <std::size_t TileSize>
+void Winograd<TileSize>::pad(const Tensor& source, Tensor& padded) noexcept
+{
+    // Copy the source into the interior, leaving the (already zeroed) border untouched.
+    for (std::size_t i{}; i < source.dim(0U); ++i)
+    {
+        const Scalar* sourceRow{source.row(i)};
+        Scalar* paddedRow{padded.row(i + 1U) + 1U};
+        for (std::size_t j{}; j < source.dim(1U); ++j) { paddedRow[j] = sourceRow[j]; }
+    }
+}
+
+//--------------------------------------------------------------------------------
+template <std::size_t TileSize>
+void Winograd<TileSize>::transformKernel(const Tensor& kernel, const bool rotate,
+                                         Tensor& transformed) noexcept
+{
+    using T = Transform<TileSize>;
+    Scalar g[KernelSize][KernelSize]{};
+    Scalar u[InputTileSize][InputTileSize]{};
+
+    // Copy the kernel, rotated 180 degrees if requested.
+    for (std::size_t ki{}; ki < KernelSize; ++ki)
+    {
+        for (std::size_t kj{}; kj < KernelSize; ++kj)
+        {
+            g[ki][kj] = rotate ? kernel(KernelSize - 1U - ki, KernelSize - 1U - kj)
+                               : kernel(ki, kj);
+        }
+    }
+
+    // Compute U = G g G^T.
+    transform<KernelSize, InputTileSize, T::kernel>(&g[0U][0U], KernelSize, u);
+
+    for (std::size_t i{}; i < InputTileSize; ++i)
+    {
+        for (std::size_t j{}; j < InputTileSize; ++j) { transformed(i, j) = u[i][j]; }
+    }
+}
+
+//--------------------------------------------------------------------------------
+template <std::size_t TileSize>
+void Winograd<TileSize>::convolve(const Tensor& padded, const Tensor& transformed,
+                                  const Scalar bias, Tensor& output) noexcept
+{
+    using T = Transform<TileSize>;
+    const std::size_t outputSize{output.dim(0U)};
+    const std::size_t stride{padded.dim(1U)};
+    Scalar u[InputTileSize][InputTileSize];
+
+    for (std::size_t i{}; i < InputTileSize; ++i)
+    {
+        for (std::size_t j{}; j < InputTileSize; ++j) { u[i][j] = transformed(i, j); }
+    }
+
+    // Compute the output tile by tile.
+    for (std::size_t ti{}; ti < outputSize; ti += TileSize)
+    {
+        for (std::size_t tj{}; tj < outputSize; tj += TileSize)
+        {
+            Scalar v[InputTileSize][InputTileSize];
+            Scalar y[TileSize][TileSize];
+
+            // Transform the input tile: V = B^T d B.
+            transform<InputTileSize, InputTileSize, T::input>(padded.row(ti) + tj, stride, v);
+
+            // Multiply element-wise with the transformed kernel.
+            for (std::size_t i{}; i < InputTileSize; ++i)
+            {
+                for (std::size_t j{}; j < InputTileSize; ++j) { v[i][j] *= u[i][j]; }
+            }
+
+            // Transform back: Y = A^T M A.
+            transform<InputTileSize, TileSize, T::output>(&v[0U][0U], InputTileSize, y);
+
+            // Store the outputs located inside the output matrix.
+            for (std::size_t i{}; (i < TileSize) && (ti + i < outputSize); ++i)
+            {
+                for (std::size_t j{}; (j < TileSize) && (tj + j < outputSize); ++j)
+                {
+                    output(ti + i, tj + j) = y[i][j] + bias;
+                }
+            }
+        }
+    }
+}
+
+// Explicit instantiation of the supported tile sizes.
+template class Winograd<2U>;
+template class Winograd<4U>;
+
+} // namespace ml::conv_layer::algorithm
@@ -6,10 +6,15 @@
 #include <cstdlib>
 #include <memory>
 #include <sstream>
+#include <stdexcept>
 
-#include "ml/act_func/interface.h"
+#include "ml/conv_layer/algorithm/interface.h"
 #include "ml/conv_layer/conv.h"
 #include "ml/factory/factory.h"
+#include "ml/linalg/blas.h"
+#include "ml/memory/buffer.h"
+#include "ml/parallel/thread_pool.h"
+#include "ml/parameter_mode.h"
 #include "ml/types.h"
 #include "ml/utils.h"
 
@@ -17,16 +22,22 @@ namespace ml::conv_layer
 {
 //--------------------------------------------------------------------------------
 ConvLayer::ConvLayer(const std::size_t inputSize, const std::size_t kernelSize,
-                     const act_func::Type actFuncType)
-    : myInputPadded{}
-    , myInputGradientsPadded{}
+                     const act_func::Type actFuncType, const algorithm::Type algorithm,
+                     const ParameterMode mode)
+    : myInputBatch{}
+    , myInputGradientBatch{}
     , myInputGradients{}
     , myKernel{}
     , myKernelGradients{}
+    , mySampleKernelGradients{}
+    , myOutputBatch{}
     , myOutput{}
-    , myBias{randomStartVal()}
+    , myDelta{}
+    , myBias{}
     , myBiasGradient{}
-    , myActFunc{nullptr}
+    , myBatchSize{}
+    , myActFunc{actFuncType}
+    , myAlgorithm{nullptr}
 {
     // Implement kernel min and max size. Min size can't be 0.
     constexpr std::size_t minKernelSize{1U};
@@ -46,172 +57,307 @@ ConvLayer::ConvLayer(const std::size_t inputSize, const std::size_t kernelSize,
             "Failed to create convolutional layer: kernel size cannot be greater than input size!");
     }
 
-    // Calculate pad offset and padded size.
-    const std::size_t padOffset{kernelSize / 2U};
-    const std::size_t paddedSize{inputSize + 2U * padOffset};
+    // Initialize the matrices with zeros, with room for a single sample per batch.
+    myKernelGradients       = Tensor{kernelSize, kernelSize};
+    mySampleKernelGradients = Tensor{kernelSize, kernelSize};
+    myDelta                 = Tensor{inputSize, inputSize};
+    setMaxBatchSize(1U);
 
-    // Initialize the matrices with zeros.
-    initMatrix(myInputPadded, paddedSize);
-    initMatrix(myInputGradients, inputSize);
-    initMatrix(myInputGradientsPadded, paddedSize);
-    initMatrix(myKernel, kernelSize);
-    initMatrix(myKernelGradients, kernelSize);
-    initMatrix(myOutput, inputSize);
+    // Create convolution algorithm instance with a factory.
+    ml::factory::Factory factory{};
+    myAlgorithm = factory.convAlgorithm(algorithm, inputSize, kernelSize);
+
+    // Only record the shapes of external parameters, they are supplied later.
+    if (ParameterMode::External == mode)
+    {
+        myKernel = Tensor::wrap(nullptr, {kernelSize, kernelSize});
+        myBias   = Tensor::wrap(nullptr, {1U});
+        return;
+    }
+    myKernel = Tensor{kernelSize, kernelSize};
+    myBias   = Tensor{1U};
+
+    // Initialize the bias with a random value.
+    myBias(0U) = randomStartVal();
 
     // Initialize the kernel with random values.
     for (std::size_t ki{}; ki < kernelSize; ++ki)
     {
         for (std::size_t kj{}; kj < kernelSize; ++kj)
         {
-            myKernel[ki][kj] = randomStartVal();
+            myKernel(ki, kj) = randomStartVal();
         }
     }
-
-    // Create activation function instance with a factory.
-    ml::factory::Factory factory{};
-    myActFunc = factory.actFunc(actFuncType);
 }
 
 //--------------------------------------------------------------------------------
-std::size_t ConvLayer::inputSize() const noexcept { return myInputGradients.size(); }
+std::size_t ConvLayer::inputSize() const noexcept { return myDelta.dim(0U); }
+
+//--------------------------------------------------------------------------------
+std::size_t ConvLayer::outputSize() const noexcept { return myDelta.dim(0U); }
+
+//--------------------------------------------------------------------------------
+const Tensor& ConvLayer::output() const noexcept { return myOutput; }
+
+//--------------------------------------------------------------------------------
+const Tensor& ConvLayer::inputGradients() const noexcept { return myInputGradients; }
 
 //--------------------------------------------------------------------------------
-std::size_t ConvLayer::outputSize() const noexcept { return myOutput.size(); }
+std::size_t ConvLayer::channelCount() const noexcept { return 1U; }
 
 //--------------------------------------------------------------------------------
-const Matrix2d& ConvLayer::output() const noexcept { return myOutput; }
+Type ConvLayer::type() const noexcept { return Type::Conv; }
 
 //--------------------------------------------------------------------------------
-const Matrix2d& ConvLayer::inputGradients() const noexcept { return myInputGradients; }
+std::size_t ConvLayer::kernelSize() const noexcept { return myKernel.dim(0U); }
 
 //--------------------------------------------------------------------------------
-bool ConvLayer::feedforward(const Matrix2d& input) noexcept
+act_func::Type ConvLayer::actFunc() const noexcept { return myActFunc.type(); }
+
+//--------------------------------------------------------------------------------
+TensorList ConvLayer::parameters()
 {
-    // Check the input matrix, return false on dimension mismatch.
-    if ((input.size() != myOutput.size()) || !isMatrixSquare(input)) { return false; }
+    // Move the views into the list, since copying a tensor creates an owning deep copy.
+    TensorList parameters{};
+    parameters.reserve(2U);
+    parameters.push_back(myKernel.view());
+    parameters.push_back(myBias.view());
+    return parameters;
+}
 
-    // Pad the input with zeros.
-    padInput(input);
+//--------------------------------------------------------------------------------
+TensorList ConvLayer::gradients()
+{
+    TensorList gradients{};
+    gradients.reserve(2U);
+    gradients.push_back(myKernelGradients.view());
+    gradients.push_back(Tensor::wrap(&myBiasGradient, {1U}));
+    return gradients;
+}
 
-    // Run feedforward; accumulate bias and contributions from the input and the kernel.
-    for (std::size_t i{}; i < myOutput.size(); ++i)
-    {
-        for (std::size_t j{}; j < myOutput.size(); ++j)
-        {
-            // Start by adding the bias value.
-            auto sum{myBias};
+//--------------------------------------------------------------------------------
+bool ConvLayer::shareParameters(Interface& source) noexcept
+{
+    // Return false unless the source is a convolutional layer with the same kernel size.
+    auto* const layer{dynamic_cast<ConvLayer*>(&source)};
+    if ((nullptr == layer) || !myKernel.sameShape(layer->myKernel)) { return false; }
 
-            // Iterate through the kernel and add the input * kernel values.
-            for (std::size_t ki{}; ki < myKernel.size(); ++ki)
-            {
-                for (std::size_t kj{}; kj < myKernel.size(); ++kj)
-                {
-                    sum += myInputPadded[i + ki][j + kj] * myKernel[ki][kj];
-                }
-            }
-            // Pass the sum through the ReLU activation function, store as output.
-            myOutput[i][j] = myActFunc->output(sum);
-        }
-    }
+    // Use views of the parameters of the source, drop cached kernel data.
+    myKernel = layer->myKernel.view();
+    myBias   = layer->myBias.view();
+    myAlgorithm->invalidate();
+    return true;
+}
+
+//--------------------------------------------------------------------------------
+bool ConvLayer::useParameters(TensorList& parameters) noexcept
+{
+    // Return false unless the tensors are a kernel of the same size and a single bias.
+    if ((2U != parameters.size()) || !parameters[0U].sameShape(myKernel)
+        || !parameters[0U].isContiguous() || !parameters[1U].sameShape(myBias)) { return false; }
+
+    // Use views of the tensors, drop cached kernel data.
+    myKernel = parameters[0U].view();
+    myBias   = parameters[1U].view();
+    myAlgorithm->invalidate();
     return true;
 }
 
 //--------------------------------------------------------------------------------
-bool ConvLayer::backpropagate(const Matrix2d& outputGradients) noexcept
+void ConvLayer::invalidateParameters() noexcept
+{
+    // Drop cached kernel data, since the kernel has been updated.
+    myAlgorithm->invalidate();
+}
+
+//--------------------------------------------------------------------------------
+std::size_t ConvLayer::maxBatchSize() const noexcept { return myOutputBatch.dim(0U); }
+
+//--------------------------------------------------------------------------------
+void ConvLayer::setMaxBatchSize(const std::size_t batchSize)
 {
-    // Check the output gradients matrix, return false on dimension mismatch.
-    if ((outputGradients.size() != myOutput.size()) || !isMatrixSquare(outputGradients))
+    // Throw an exception if the batch size is invalid.
+    if (0U == batchSize)
     {
-        return false;
+        throw std::invalid_argument("Cannot set max batch size: the batch size cannot be 0!");
     }
 
-    // Reinitialize the gradients with zeros (to remove old values).
-    // Else values from the previous backpropagation would still remain.
-    initMatrix(myInputGradientsPadded);
-    initMatrix(myInputGradients);
-    initMatrix(myKernelGradients);
-    myBiasGradient = 0.0;
+    // Reallocate the batch matrices, let the views refer to the first sample.
+    const std::size_t size{inputSize()};
+    myInputBatch         = Tensor{batchSize, size, size};
+    myInputGradientBatch = Tensor{batchSize, size, size};
+    myOutputBatch        = Tensor{batchSize, size, size};
+    myInputGradients     = myInputGradientBatch.slice(0U);
+    myOutput             = myOutputBatch.slice(0U);
+    myBatchSize          = 1U;
+}
 
-    // Iterate through the output gradients.
-    for (std::size_t i{}; i < myOutput.size(); ++i)
-    {
-        for (std::size_t j{}; j < myOutput.size(); ++j)
-        {
-            // Calculate output derivate.
-            const auto delta{outputGradients[i][j] * myActFunc->delta(myOutput[i][j])};
+//--------------------------------------------------------------------------------
+memory::BufferList ConvLayer::buffers() noexcept
+{
+    // The input is stored for backpropagation, the delta matrix holds a single sample.
+    return memory::BufferList{
+        memory::Buffer{&myInputBatch, nullptr, memory::Role::Input},
+        memory::Buffer{&myOutputBatch, &myOutput, memory::Role::Output},
+        memory::Buffer{&myInputGradientBatch, &myInputGradients, memory::Role::InputGradients},
+        memory::Buffer{&myDelta, nullptr, memory::Role::Scratch}};
+}
 
-            // Accumulate the bias gradient by adding all output delta values.
-            myBiasGradient += delta;
+//--------------------------------------------------------------------------------
+bool ConvLayer::feedforward(const Tensor& input) noexcept
+{
+    // Check the input, return false on dimension mismatch or if the batch is too large.
+    const std::size_t sampleCount{batchSize(input, myInputBatch)};
+    if (0U == sampleCount) { return false; }
 
-            // Iterate through the kernel.
-            for (std::size_t ki{}; ki < myKernel.size(); ++ki)
-            {
-                for (std::size_t kj{}; kj < myKernel.size(); ++kj)
-                {
-                    myKernelGradients[ki][kj] += myInputPadded[i + ki][j + kj] * delta;
-                    myInputGradientsPadded[i + ki][j + kj] += myKernel[ki][kj] * delta;
-                }
-            }
-        }
+    // Store the input for backpropagation, let the views match the layout of the input.
+    const bool batched{input.rank() == myInputBatch.rank()};
+    Tensor inputs{myInputBatch.narrow(0U, 0U, sampleCount)};
+    inputs.copyFrom(input);
+    myOutput         = batchView(myOutputBatch, sampleCount, batched);
+    myInputGradients = batchView(myInputGradientBatch, sampleCount, batched);
+    myBatchSize      = sampleCount;
+
+    // Approximate cost of an activation, used to split the outputs into chunks.
+    constexpr std::size_t actFuncCost{8U};
+
+    for (std::size_t s{}; s < sampleCount; ++s)
+    {
+        // Run feedforward; accumulate contributions from the input and the kernel.
+        Tensor output{myOutputBatch.slice(s)};
+        myAlgorithm->feedforward(inputs.slice(s), myKernel, Scalar{}, output);
+
+        // Add the bias and apply the activation function in a single pass.
+        parallel::parallelFor(output.size(), actFuncCost, 
+                              [&](const std::size_t first, const std::size_t last)
+        {
+            myActFunc.forward(last - first, myBias(0U), output.data() + first);
+        });
     }
-    // Extract input gradients without zeros.
-    extractInputGradients();
     return true;
 }
 
 //--------------------------------------------------------------------------------
-bool ConvLayer::optimize(double learningRate) noexcept
+bool ConvLayer::feedforwardPooled(const Tensor& input, const std::size_t poolSize, 
+                                  Tensor& output) noexcept
 {
-    // Check the learning rate, return false if out of range.
-    if ((0.0 >= learningRate) || (1.0 < learningRate)) { return false; }
+    // Check the arguments, return false on dimension mismatch or if the batch is too large.
+    const std::size_t sampleCount{batchSize(input, myInputBatch)};
+    const std::size_t size{outputSize()};
+    if ((0U == sampleCount) || (0U == poolSize) || (0U != (size % poolSize))) { return false; }
 
-    // Adjust the bias with the computed bias gradient, multiplied by the learning rate.
-    // We subtract, since the gradients are computed in this manner, as opposed to what
-    // we've used in dense layer.
-    myBias += myBiasGradient * learningRate;
+    const std::size_t pooledSize{size / poolSize};
+    if ((output.rank() != myOutputBatch.rank()) || (output.dim(0U) < sampleCount) 
+        || (output.dim(1U) != pooledSize) || (output.dim(2U) != pooledSize)) { return false; }
 
-    // Adjust the kernel weights with the corresponding gradients and the learning rate.
-    for (std::size_t ki{}; ki < myKernel.size(); ++ki)
+    // The output isn't stored, so backpropagation must fail until the next feedforward.
+    const bool batched{input.rank() == myInputBatch.rank()};
+    myBatchSize = 0U;
+
+    for (std::size_t s{}; s < sampleCount; ++s)
     {
-        for (std::size_t kj{}; kj < myKernel.size(); ++kj)
+        // Run the convolution without bias, use the output batch as scratch space.
+        Tensor sums{myOutputBatch.slice(s)};
+        Tensor pooled{output.slice(s)};
+        myAlgorithm->feedforward(sampleView(input, sums.rank(), s), myKernel, Scalar{}, sums);
+
+        // Find the max value of each pool, then add the bias and apply the activation
+        // function to the pooled values only.
+        parallel::parallelFor(pooledSize, size * poolSize,
+                              [&](const std::size_t first, const std::size_t last)
         {
-            myKernel[ki][kj] += myKernelGradients[ki][kj] * learningRate;
-        }
+            for (std::size_t i{first}; i < last; ++i)
+            {
+                Scalar* pooledRow{pooled.row(i)};
+
+                for (std::size_t j{}; j < pooledSize; ++j)
+                {
+                    Scalar maxVal{sums(i * poolSize, j * poolSize)};
+
+                    for (std::size_t pi{}; pi < poolSize; ++pi)
+                    {
+                        const Scalar* sumRow{sums.row(i * poolSize + pi) + j * poolSize};
+
+                        for (std::size_t pj{}; pj < poolSize; ++pj)
+                        {
+                            maxVal = sumRow[pj] > maxVal ? sumRow[pj] : maxVal;
+                        }
+                    }
+                    pooledRow[j] = maxVal;
+                }
+                myActFunc.forward(pooledSize, myBias(0U), pooledRow);
+            }
+        });
     }
+    output = batchView(output, sampleCount, batched);
     return true;
 }
 
 //--------------------------------------------------------------------------------
-void ConvLayer::padInput(const Matrix2d& input) noexcept
+bool ConvLayer::feedforwardFused(Interface& source, const Tensor& input) noexcept
+{
+    // Nothing to fuse with, run the layers one by one.
+    return source.feedforward(input) && feedforward(source.output());
+}
+
+//--------------------------------------------------------------------------------
+bool ConvLayer::backpropagate(const Tensor& outputGradients) noexcept
 {
-    // Compute the pad offset (the number of zeros in each direction).
-    const std::size_t padOffset{myKernel.size() / 2U};
+    // Check the output gradients, return false unless they match the latest batch.
+    if ((0U == myBatchSize) || (myBatchSize != batchSize(outputGradients, myOutputBatch)))
+    {
+        return false;
+    }
+
+    // Reinitialize the gradients (to remove the old values).
+    myBiasGradient = 0.0;
+    myKernelGradients.zero();
 
-    // Ensure that the padded input matrix is filled with zeros only.
-    initMatrix(myInputPadded);
+    // Average the gradients over the batch.
+    const Scalar scale{static_cast<Scalar>(1.0 / myBatchSize)};
 
-    // Copy the input values to the corresponding padded matrix.
-    for (std::size_t i{}; i < myOutput.size(); ++i)
+    for (std::size_t s{}; s < myBatchSize; ++s)
     {
-        for (std::size_t j{}; j < myOutput.size(); ++j)
-        {
-            myInputPadded[i + padOffset][j + padOffset] = input[i][j];
-        }
+        const Tensor output{myOutputBatch.slice(s)};
+        Tensor inputGradients{myInputGradientBatch.slice(s)};
+
+        // Calculate the output deltas from the output gradients.
+        myDelta.copyFrom(sampleView(outputGradients, myDelta.rank(), s));
+        myActFunc.backwardFromOutput(myDelta.size(), output.data(), myDelta.data(), myDelta.data());
+
+        // Accumulate the bias gradient by adding all output delta values.
+        Scalar deltaSum{};
+        for (std::size_t i{}; i < myDelta.size(); ++i) { deltaSum += myDelta.data()[i]; }
+        myBiasGradient += deltaSum * scale;
+        // Compute the kernel gradients and the input gradients (without padding).
+        myAlgorithm->backpropagate(myInputBatch.slice(s), myDelta, myKernel, 
+                                   mySampleKernelGradients, inputGradients);
+        linalg::axpy(myKernelGradients.size(), scale, mySampleKernelGradients.data(), 
+                     myKernelGradients.data());
     }
+    return true;
 }
 
 //--------------------------------------------------------------------------------
-void ConvLayer::extractInputGradients() noexcept
+bool ConvLayer::optimize(double learningRate) noexcept
 {
-    // Compute the pad offset (the number of zeros in each direction).
-    const std::size_t padOffset{myKernel.size() / 2U};
+    // Check the learning rate, return false if out of range.
+    if ((0.0 >= learningRate) || (1.0 < learningRate)) { return false; }
+
+    // Adjust the bias with the computed bias gradient, multiplied by the learning rate.
+    // The gradients are descent directions (as in the dense layer), hence we add them.
+    myBias(0U) += myBiasGradient * learningRate;
 
-    for (std::size_t i{}; i < myOutput.size(); ++i)
+    // Adjust the kernel weights with the corresponding gradients and the learning rate.
+    for (std::size_t ki{}; ki < myKernel.dim(0U); ++ki)
     {
-        for (std::size_t j{}; j < myOutput.size(); ++j)
+        for (std::size_t kj{}; kj < myKernel.dim(1U); ++kj)
         {
-            myInputGradients[i][j] = myInputGradientsPadded[i + padOffset][j + padOffset];
+            myKernel(ki, kj) += myKernelGradients(ki, kj) * learningRate;
         }
     }
+    // Let the algorithm know that the kernel has been updated.
+    myAlgorithm->invalidate();
+    return true;
 }
 } // namespace ml::conv_layer
@@ -0,0 +1,39 @@
+/**
+ * @brief Channel-blocked memory layout implementation details.
+ */
+#include <cstddef>
+
+#include "ml/conv_layer/layout.h"
+#include "ml/tensor.h"
+
+namespace ml::conv_layer
+{
+//--------------------------------------------------------------------------------
+Tensor featureMaps(const std::size_t batchSize, const std::size_t channelCount,
+                   const std::size_t size)
+{
+    // Drop the channel dimensions for a single channel, the layout is the same.
+    if (1U == channelCount) { return Tensor{batchSize, size, size}; }
+
+    const std::size_t width{blockWidth(channelCount)};
+    return Tensor{batchSize, channelCount / width, size, size, width};
+}
+
+//--------------------------------------------------------------------------------
+Tensor featureMapView(Scalar* data, const std::size_t batchSize, const std::size_t channelCount,
+                      const std::size_t size) noexcept
+{
+    // Same shapes as featureMaps(), without allocating.
+    if (1U == channelCount) { return Tensor::wrap(data, {batchSize, size, size}); }
+
+    const std::size_t width{blockWidth(channelCount)};
+    return Tensor::wrap(data, {batchSize, channelCount / width, size, size, width});
+}
+
+//--------------------------------------------------------------------------------
+std::size_t featureMapSize(const Tensor& batch) noexcept
+{
+    // The size is the extent of the next-to-last dimension in both layouts.
+    return batch.dim(batch.rank() - 2U);
+}
+} // namespace ml::conv_layer
@@ -12,10 +12,15 @@
 
 //! @note Sortera headerfiler alfabetiskt.
 #include <vector>
+#include <cstdint>
 #include <cstdlib>
+#include <limits>
 #include <sstream>
+#include <utility>
 
+#include "ml/conv_layer/layout.h"
 #include "ml/conv_layer/max_pool.h"
+#include "ml/memory/buffer.h"
 #include "ml/types.h"
 #include "ml/utils.h"
 
@@ -24,15 +29,26 @@
 
 namespace ml::conv_layer
 {
-MaxPoolLayer::MaxPoolLayer(const std::size_t inputSize, const std::size_t poolSize)
-    : myInput{}
+MaxPoolLayer::MaxPoolLayer(const std::size_t inputSize, const std::size_t poolSize,
+                           const std::size_t channelCount)
+    : myMaxIndices{}
+    , myInputGradientBatch{}
     , myInputGradients{}
+    , myOutputBatch{}
     , myOutput{}
+    , myBatchSize{}
+    , myChannelCount{channelCount}
     //! @note Detta attribut bör som sagt tas bort.
     , myActFunc{} 
 {
-     // Check the input arguments, throw an exception if invalid.
-    if ((0U == inputSize) || (0U == poolSize) || (0U != (inputSize % poolSize)))
+     // Check the input arguments, throw an exception if invalid. The position within a pool
+     // must fit in the max value indices.
+    constexpr std::size_t maxPoolSize{256U};
+    static_assert(maxPoolSize * maxPoolSize - 1U <= std::numeric_limits<std::uint16_t>::max(),
+                  "Max value indices too narrow for the max pool size!");
+
+    if ((0U == inputSize) || (0U == poolSize) || (0U != (inputSize % poolSize))
+        || (maxPoolSize < poolSize) || !isValidChannelCount(channelCount))
     {
         throw std::invalid_argument(
             "Cannot create max pooling layer: invalid input arguments!");
@@ -41,126 +57,249 @@ MaxPoolLayer::MaxPoolLayer(const std::size_t inputSize, const std::size_t poolSi
     // Compute the output size.
     const std::size_t outputSize{inputSize / poolSize};
 
-    // Initialize the matrices.
-    initMatrix(myInput, inputSize);
-    initMatrix(myInputGradients, inputSize);
-    initMatrix(myOutput, outputSize);
+    // Initialize the matrices, with room for a single sample per batch.
+    myInputGradientBatch = featureMaps(1U, channelCount, inputSize);
+    myOutputBatch        = featureMaps(1U, channelCount, outputSize);
+    setMaxBatchSize(1U);
+}
+
+//--------------------------------------------------------------------------------
+std::size_t MaxPoolLayer::inputSize() const noexcept 
+{ 
+    return featureMapSize(myInputGradientBatch); 
+}
+
+//--------------------------------------------------------------------------------
+std::size_t MaxPoolLayer::outputSize() const noexcept { return featureMapSize(myOutputBatch); }
+
+//--------------------------------------------------------------------------------
+std::size_t MaxPoolLayer::channelCount() const noexcept { return myChannelCount; }
+
+//--------------------------------------------------------------------------------
+const Tensor& MaxPoolLayer::output() const noexcept { return myOutput; }
+
+//--------------------------------------------------------------------------------
+const Tensor& MaxPoolLayer::inputGradients() const noexcept { return myInputGradients; }
+
+//--------------------------------------------------------------------------------
+Type MaxPoolLayer::type() const noexcept { return Type::MaxPool; }
+
+//--------------------------------------------------------------------------------
+std::size_t MaxPoolLayer::kernelSize() const noexcept 
+{ 
+    return inputSize() / outputSize(); 
 }
 
 //--------------------------------------------------------------------------------
-std::size_t MaxPoolLayer::inputSize() const noexcept { return myInputGradients.size(); }
+act_func::Type MaxPoolLayer::actFunc() const noexcept { return act_func::Type::None; }
 
 //--------------------------------------------------------------------------------
-std::size_t MaxPoolLayer::outputSize() const noexcept { return myOutput.size(); }
+TensorList MaxPoolLayer::parameters() { return TensorList{}; }
 
 //--------------------------------------------------------------------------------
-const Matrix2d& MaxPoolLayer::output() const noexcept { return myOutput; }
+TensorList MaxPoolLayer::gradients() { return TensorList{}; }
 
 //--------------------------------------------------------------------------------
-const Matrix2d& MaxPoolLayer::inputGradients() const noexcept { return myInputGradients; }
+bool MaxPoolLayer::shareParameters(Interface& source) noexcept
+{
+    // Return true if the source is a pooling layer, there are no parameters to share.
+    return Type::MaxPool == source.type();
+}
 
 //--------------------------------------------------------------------------------
-bool MaxPoolLayer::feedforward(const Matrix2d& input) noexcept
+bool MaxPoolLayer::useParameters(TensorList& parameters) noexcept
 {
-    // Check the input matrix, return false on dimension mismatch.
-    if ((input.size() != myInput.size()) || !isMatrixSquare(input)) { return false; }
+    // Pooling layers have no trainable parameters.
+    return parameters.empty();
+}
 
-    // Calculate the pool size.
-    const std::size_t poolSize{input.size() / myOutput.size()};
+//--------------------------------------------------------------------------------
+void MaxPoolLayer::invalidateParameters() noexcept {}
+
+//--------------------------------------------------------------------------------
+std::size_t MaxPoolLayer::maxBatchSize() const noexcept { return myOutputBatch.dim(0U); }
 
-    // Iterate through the image pool by pool, find and store the max value.
-    for (std::size_t i{}; i < myOutput.size(); ++i)
+//--------------------------------------------------------------------------------
+void MaxPoolLayer::setMaxBatchSize(const std::size_t batchSize)
+{
+    // Throw an exception if the batch size is invalid.
+    if (0U == batchSize)
     {
-        for (std::size_t j{}; j < myOutput.size(); ++j)
-        {
-            // Get the input row and column.
-            const std::size_t inRow{i * poolSize};
-            const std::size_t inCol{j * poolSize};
+        throw std::invalid_argument("Cannot set max batch size: the batch size cannot be 0!");
+    }
+
+    // Reallocate the batch matrices, let the views refer to the first sample.
+    const std::size_t inputSize{this->inputSize()};
+    const std::size_t outputSize{this->outputSize()};
+    myInputGradientBatch = featureMaps(batchSize, myChannelCount, inputSize);
+    myOutputBatch        = featureMaps(batchSize, myChannelCount, outputSize);
+    myMaxIndices.assign(myOutputBatch.size(), 0U);
+    myInputGradients     = myInputGradientBatch.slice(0U);
+    myOutput             = myOutputBatch.slice(0U);
+    myBatchSize          = 1U;
+}
 
-            // Use the first value as max value, compare with the other values in the pool.
-            double maxVal{input[inRow][inCol]};
+//--------------------------------------------------------------------------------
+memory::BufferList MaxPoolLayer::buffers() noexcept
+{
+    // The max value positions are kept by the layer, since they aren't scalars.
+    return memory::BufferList{
+        memory::Buffer{&myOutputBatch, &myOutput, memory::Role::Output},
+        memory::Buffer{&myInputGradientBatch, &myInputGradients, memory::Role::InputGradients}};
+}
 
-            // Iterate through the pool.
-            for (std::size_t pi{}; pi < poolSize; ++pi)
+//--------------------------------------------------------------------------------
+bool MaxPoolLayer::feedforward(const Tensor& input) noexcept
+{
+    // Check the input, return false on dimension mismatch or if the batch is too large.
+    const std::size_t sampleCount{batchSize(input, myInputGradientBatch)};
+    if (0U == sampleCount) { return false; }
+
+    // Let the views match the layout of the input. The input isn't stored, the position of
+    // each max value is recorded instead.
+    const bool batched{input.rank() == myInputGradientBatch.rank()};
+    myOutput         = batchView(myOutputBatch, sampleCount, batched);
+    myInputGradients = batchView(myInputGradientBatch, sampleCount, batched);
+    myBatchSize      = sampleCount;
+
+    // Calculate the pool size and the number of channel blocks (see ml/conv_layer/layout.h).
+    const std::size_t inputSize{this->inputSize()};
+    const std::size_t outputSize{this->outputSize()};
+    const std::size_t poolSize{kernelSize()};
+    const std::size_t width{blockWidth(myChannelCount)};
+    const std::size_t blockCount{myChannelCount / width};
+    const std::size_t sampleOutputSize{myOutputBatch.size() / myOutputBatch.dim(0U)};
+
+    for (std::size_t s{}; s < sampleCount; ++s)
+    {
+        const Scalar* sample{sampleView(input, myOutputBatch.rank() - 1U, s).data()};
+        Scalar* output{myOutputBatch.slice(s).data()};
+        std::uint16_t* indices{myMaxIndices.data() + s * sampleOutputSize};
+
+        // Iterate through the image pool by pool, find and store the max value of each channel.
+        for (std::size_t b{}; b < blockCount; ++b)
+        {
+            for (std::size_t i{}; i < outputSize; ++i)
             {
-                for (std::size_t pj{}; pj < poolSize; ++pj)
+                for (std::size_t j{}; j < outputSize; ++j)
                 {
-                    // Get the value at the current cell.
-                    const auto val{input[inRow + pi][inCol + pj]};
+                    // Get the first cell of the pool and the corresponding output cell.
+                    const Scalar* pool{sample 
+                        + ((b * inputSize + i * poolSize) * inputSize + j * poolSize) * width};
+                    const std::size_t outOffset{((b * outputSize + i) * outputSize + j) * width};
+                    Scalar* maxVal{output + outOffset};
+                    std::uint16_t* maxIndex{indices + outOffset};
 
-                    // Compare the value with the local max, store the bigger one.
-                    if (val > maxVal) { maxVal = val; }
+                    // Use the first values as max values, compare with the other values in the 
+                    // pool. The channels of a block are adjacent, so they're compared at once.
+                    for (std::size_t c{}; c < width; ++c) 
+                    { 
+                        maxVal[c]   = pool[c]; 
+                        maxIndex[c] = 0U;
+                    }
+
+                    for (std::size_t pi{}; pi < poolSize; ++pi)
+                    {
+                        for (std::size_t pj{}; pj < poolSize; ++pj)
+                        {
+                            const Scalar* val{pool + (pi * inputSize + pj) * width};
+                            const auto index{static_cast<std::uint16_t>(pi * poolSize + pj)};
+
+                            // Store the bigger values and their positions, so that the first
+                            // max value of each pool is kept.
+                            for (std::size_t c{}; c < width; ++c)
+                            {
+                                const bool bigger{val[c] > maxVal[c]};
+                                maxVal[c]   = bigger ? val[c] : maxVal[c];
+                                maxIndex[c] = bigger ? index : maxIndex[c];
+                            }
+                        }
+                    }
                 }
             }
-            // Store the max value in the output matrix.
-            myOutput[i][j] = maxVal;
         }
     }
-    // Store the input for backpropagation.
-    myInput = input;
-
     // Return true to indicate success.
     return true;
 }
 
 //--------------------------------------------------------------------------------
-bool MaxPoolLayer::backpropagate(const Matrix2d& outputGradients) noexcept
+bool MaxPoolLayer::feedforwardPooled(const Tensor& input, const std::size_t poolSize,
+                                     Tensor& output) noexcept
 {
-    // Check the output gradient matrix, return false on dimension mismatch.
-    if ((outputGradients.size() != myOutput.size()) || !isMatrixSquare(outputGradients))
+    // Pooling layers don't pool their own output, let the caller run the layers one by one.
+    (void) (input);
+    (void) (poolSize);
+    (void) (output);
+    return false;
+}
+
+//--------------------------------------------------------------------------------
+bool MaxPoolLayer::feedforwardFused(Interface& source, const Tensor& input) noexcept
+{
+    // Let the source pool its output straight into the output batch if supported.
+    Tensor output{myOutputBatch.view()};
+
+    if (source.feedforwardPooled(input, kernelSize(), output))
+    {
+        // No max value positions are recorded, so backpropagation must fail.
+        myOutput    = std::move(output);
+        myBatchSize = 0U;
+        return true;
+    }
+    // Else run the layers one by one.
+    return source.feedforward(input) && feedforward(source.output());
+}
+
+//--------------------------------------------------------------------------------
+bool MaxPoolLayer::backpropagate(const Tensor& outputGradients) noexcept
+{
+    // Check the output gradients, return false unless they match the latest batch.
+    if ((0U == myBatchSize) || (myBatchSize != batchSize(outputGradients, myOutputBatch)))
     {
         return false;
     }
 
-    // Calculate the pool size.
-    const std::size_t poolSize{myInput.size() / myOutput.size()};
+    // Calculate the pool size and the number of channel blocks (see ml/conv_layer/layout.h).
+    const std::size_t inputSize{this->inputSize()};
+    const std::size_t outputSize{this->outputSize()};
+    const std::size_t poolSize{kernelSize()};
+    const std::size_t width{blockWidth(myChannelCount)};
+    const std::size_t blockCount{myChannelCount / width};
+    const std::size_t sampleOutputSize{myOutputBatch.size() / myOutputBatch.dim(0U)};
 
     // Reinitialize input matrix with zeros (remove leftovers from previous backpropagation).
-    initMatrix(myInputGradients);
+    myInputGradientBatch.zero();
 
-    // Locate the max value coordinates (row, col) and place the gradients there.
-    for (std::size_t i{}; i < myOutput.size(); ++i)
+    for (std::size_t s{}; s < myBatchSize; ++s)
     {
-        for (std::size_t j{}; j < myOutput.size(); ++j)
-        {
-            // Compute the input row and column.
-            const std::size_t inRow{i * poolSize};
-            const std::size_t inCol{j * poolSize};
-
-            // Get the max value for comparison.
-            const auto maxVal{myOutput[i][j]};
-
-            // Variables holding the max coordinates (start with the first call of the pool).
-            std::size_t maxRow{inRow};
-            std::size_t maxCol{inCol};
+        const Tensor output{myOutputBatch.slice(s)};
+        const Scalar* gradients{sampleView(outputGradients, output.rank(), s).data()};
+        const std::uint16_t* indices{myMaxIndices.data() + s * sampleOutputSize};
+        Scalar* inputGradients{myInputGradientBatch.slice(s).data()};
 
-            // Indicate whether the max value has been found.
-            bool found{false};
-
-            for (std::size_t pi{}; pi < poolSize; ++pi)
+        // Write each output gradient to the recorded max value position of its pool.
+        for (std::size_t b{}; b < blockCount; ++b)
+        {
+            for (std::size_t i{}; i < outputSize; ++i)
             {
-                for (std::size_t pj{}; pj < poolSize; ++pj)
+                for (std::size_t j{}; j < outputSize; ++j)
                 {
-                    // Get the value of the current cell.
-                    const auto val{myInput[inRow + pi][inCol + pj]};
+                    // Compute the offsets of the first cell of the pool and the output cell.
+                    const std::size_t inOffset{
+                        ((b * inputSize + i * poolSize) * inputSize + j * poolSize) * width};
+                    const std::size_t outOffset{((b * outputSize + i) * outputSize + j) * width};
 
-                    // If this is the max value, store the coordinates.
-                    if (val == maxVal)
+                    for (std::size_t c{}; c < width; ++c)
                     {
-                        // Store the coordinates of the max value.
-                        maxRow = inRow + pi;
-                        maxCol = inCol + pj;
-
-                        // Indicate that the value has been found and break the 'pj' loop.
-                        found = true;
-                        break;
+                        const std::size_t index{indices[outOffset + c]};
+                        const std::size_t pi{index / poolSize};
+                        const std::size_t pj{index % poolSize};
+                        inputGradients[inOffset + (pi * inputSize + pj) * width + c] =
+                            gradients[outOffset + c];
                     }
                 }
-                // Break the 'pi' loop if the max value has been found.
-                if (found) { break; }
             }
-            // Write the output gradient to the max value position.
-            myInputGradients[maxRow][maxCol] = outputGradients[i][j];
         }
     }
     // Return true to indicate success.
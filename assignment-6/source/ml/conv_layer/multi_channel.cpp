@@ -0,0 +1,1150 @@
+/**
+ * @brief Multi-channel convolutional layer implementation details.
+ *
+ *        The inner loops exist in a default version and, on x86, in AVX2 and AVX-512 versions
+ *        compiled via function target attributes, so the compiler vectorizes the loops over
+ *        the channels of a block for the wider registers. Full blocks of output channels
+ *        are computed in tiles of adjacent pixels, via AVX2 intrinsics on x86. The version
+ *        matching the active SIMD level (see ml/linalg/simd.h) is selected on every pass.
+ *        Layers using the im2col algorithm instead lower the convolution onto the blocked GEMM
+ *        in ml::linalg, which dispatches on the SIMD level itself.
+ */
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+
+#include "ml/conv_layer/layout.h"
+#include "ml/conv_layer/multi_channel.h"
+#include "ml/linalg/blas.h"
+#include "ml/linalg/gemm.h"
+#include "ml/linalg/simd.h"
+#include "ml/memory/buffer.h"
+#include "ml/parallel/thread_pool.h"
+#include "ml/parameter_mode.h"
+#include "ml/types.h"
+#include "ml/utils.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define ML_X86_KERNELS
+#endif
+
+namespace ml::conv_layer
+{
+namespace
+{
+/**
+ * @brief Dimensions of a multi-channel convolution.
+ */
+struct Geometry
+{
+    /** Size (height and width) of the feature maps. */
+    std::size_t size;
+
+    /** Kernel size. */
+    std::size_t kernelSize;
+
+    /** Number of input channel blocks. */
+    std::size_t inputBlocks;
+
+    /** Number of output channel blocks. */
+    std::size_t outputBlocks;
+
+    /** Number of channels per input block. */
+    std::size_t inputWidth;
+
+    /** Number of channels per output block. */
+    std::size_t outputWidth;
+};
+
+// -----------------------------------------------------------------------------
+constexpr std::size_t windowFirst(const std::size_t pos, const std::size_t pad) noexcept
+{
+    // First kernel index that maps position pos onto the feature map.
+    return pos < pad ? pad - pos : 0U;
+}
+
+// -----------------------------------------------------------------------------
+constexpr std::size_t windowLast(const std::size_t pos, const std::size_t pad,
+                                 const std::size_t size, const std::size_t kernelSize) noexcept
+{
+    // One past the last kernel index that maps position pos onto the feature map.
+    const std::size_t last{size + pad - pos};
+    return last < kernelSize ? last : kernelSize;
+}
+
+// -----------------------------------------------------------------------------
+// forwardPixels: compute Count adjacent output pixels of one output block, starting with the
+//                biases. The kernel window is clipped at the border, which equals convolving
+//                the zero-padded input.
+// filterGradients: accumulate the filter gradients of one output block over one sample.
+// inputGradientRow: compute one input gradient row of one input block.
+#define ML_MULTI_CHANNEL_LOOPS(suffix, attributes)                                                \
+    template <std::size_t Width, std::size_t InWidth, std::size_t Count>                          \
+    attributes void forwardPixels##suffix(const Geometry& g, const Scalar* input,                 \
+                                          const Scalar* filters, const Scalar* bias,              \
+                                          Scalar* output, const std::size_t y,                    \
+                                          const std::size_t x, const std::size_t kxFirst,         \
+                                          const std::size_t kxLast) noexcept                      \
+    {                                                                                             \
+        const std::size_t s{g.size}, k{g.kernelSize};                                             \
+        const std::size_t wi{0U == InWidth ? g.inputWidth : InWidth};                             \
+        const std::size_t wo{0U == Width ? g.outputWidth : Width};                                \
+        const std::size_t pad{k / 2U};                                                            \
+        const std::size_t kyFirst{windowFirst(y, pad)}, kyLast{windowLast(y, pad, s, k)};         \
+                                                                                                  \
+        /* Accumulate Count adjacent pixels at once to hide the latency of the additions. */      \
+        Scalar acc[Count][ChannelBlock];                                                          \
+        for (std::size_t p{}; p < Count; ++p)                                                     \
+        {                                                                                         \
+            for (std::size_t l{}; l < wo; ++l) { acc[p][l] = bias[l]; }                           \
+        }                                                                                         \
+                                                                                                  \
+        for (std::size_t ib{}; ib < g.inputBlocks; ++ib)                                          \
+        {                                                                                         \
+            for (std::size_t ky{kyFirst}; ky < kyLast; ++ky)                                      \
+            {                                                                                     \
+                const Scalar* in{input + ((ib * s + y + ky - pad) * s + x) * wi};                 \
+                const Scalar* f{filters + (ib * k + ky) * k * wi * wo};                           \
+                                                                                                  \
+                for (std::size_t kx{kxFirst}; kx < kxLast; ++kx)                                  \
+                {                                                                                 \
+                    _Pragma("GCC unroll 16")                                                      \
+                    for (std::size_t c{}; c < wi; ++c)                                            \
+                    {                                                                             \
+                        const Scalar* weights{f + (kx * wi + c) * wo};                            \
+                                                                                                  \
+                        _Pragma("GCC unroll 16")                                                  \
+                        for (std::size_t p{}; p < Count; ++p)                                     \
+                        {                                                                         \
+                            const Scalar value{in[(p + kx - pad) * wi + c]};                      \
+                            for (std::size_t l{}; l < wo; ++l) { acc[p][l] += value * weights[l]; }\
+                        }                                                                         \
+                    }                                                                             \
+                }                                                                                 \
+            }                                                                                     \
+        }                                                                                         \
+        for (std::size_t p{}; p < Count; ++p)                                                     \
+        {                                                                                         \
+            for (std::size_t l{}; l < wo; ++l) { output[(x + p) * wo + l] = acc[p][l]; }          \
+        }                                                                                         \
+    }                                                                                             \
+                                                                                                  \
+    template <std::size_t Width>                                                                  \
+    attributes inline void filterGradients##suffix(const Geometry& g, const Scalar* input,        \
+                                                   const Scalar* delta,                           \
+                                                   Scalar* gradients) noexcept                    \
+    {                                                                                             \
+        const std::size_t s{g.size}, k{g.kernelSize}, wi{g.inputWidth};                           \
+        const std::size_t wo{0U == Width ? g.outputWidth : Width};                                \
+        const std::size_t pad{k / 2U};                                                            \
+                                                                                                  \
+        for (std::size_t y{}; y < s; ++y)                                                         \
+        {                                                                                         \
+            const std::size_t kyFirst{windowFirst(y, pad)}, kyLast{windowLast(y, pad, s, k)};     \
+                                                                                                  \
+            for (std::size_t x{}; x < s; ++x)                                                     \
+            {                                                                                     \
+                const std::size_t kxFirst{windowFirst(x, pad)};                                   \
+                const std::size_t kxLast{windowLast(x, pad, s, k)};                               \
+                const Scalar* d{delta + (y * s + x) * wo};                                        \
+                                                                                                  \
+                for (std::size_t ib{}; ib < g.inputBlocks; ++ib)                                  \
+                {                                                                                 \
+                    for (std::size_t ky{kyFirst}; ky < kyLast; ++ky)                              \
+                    {                                                                             \
+                        const Scalar* in{input + (ib * s + y + ky - pad) * s * wi};               \
+                        Scalar* grad{gradients + (ib * k + ky) * k * wi * wo};                    \
+                                                                                                  \
+                        for (std::size_t kx{kxFirst}; kx < kxLast; ++kx)                          \
+                        {                                                                         \
+                            for (std::size_t c{}; c < wi; ++c)                                    \
+                            {                                                                     \
+                                const Scalar value{in[(x + kx - pad) * wi + c]};                  \
+                                Scalar* out{grad + (kx * wi + c) * wo};                           \
+                                for (std::size_t l{}; l < wo; ++l) { out[l] += value * d[l]; }    \
+                            }                                                                     \
+                        }                                                                         \
+                    }                                                                             \
+                }                                                                                 \
+            }                                                                                     \
+        }                                                                                         \
+    }                                                                                             \
+                                                                                                  \
+    attributes void filterGradients##suffix(const Geometry& g, const Scalar* input,               \
+                                            const Scalar* delta, Scalar* gradients) noexcept      \
+    {                                                                                             \
+        /* Let full blocks use a constant width, so the loop over the block vectorizes. */        \
+        if (ChannelBlock == g.outputWidth)                                                        \
+        {                                                                                         \
+            filterGradients##suffix<ChannelBlock>(g, input, delta, gradients);                    \
+        }                                                                                         \
+        else { filterGradients##suffix<0U>(g, input, delta, gradients); }                         \
+    }                                                                                             \
+                                                                                                  \
+    attributes void inputGradientRow##suffix(const Geometry& g, const Scalar* delta,              \
+                                             const Scalar* filters, Scalar* inputGradients,       \
+                                             const std::size_t ib, const std::size_t y) noexcept  \
+    {                                                                                             \
+        const std::size_t s{g.size}, k{g.kernelSize}, wi{g.inputWidth}, wo{g.outputWidth};        \
+        const std::size_t pad{k / 2U};                                                            \
+        const std::size_t kk{k * k};                                                              \
+                                                                                                  \
+        for (std::size_t x{}; x < s; ++x)                                                         \
+        {                                                                                         \
+            Scalar acc[ChannelBlock]{};                                                           \
+                                                                                                  \
+            /* Input (y, x) contributes to output (y + pad - ky, x + pad - kx). */                \
+            for (std::size_t ky{}; ky < k; ++ky)                                                  \
+            {                                                                                     \
+                if ((y + pad < ky) || (y + pad - ky >= s)) { continue; }                          \
+                                                                                                  \
+                for (std::size_t kx{}; kx < k; ++kx)                                              \
+                {                                                                                 \
+                    if ((x + pad < kx) || (x + pad - kx >= s)) { continue; }                      \
+                                                                                                  \
+                    for (std::size_t ob{}; ob < g.outputBlocks; ++ob)                             \
+                    {                                                                             \
+                        const Scalar* d{                                                          \
+                            delta + ((ob * s + y + pad - ky) * s + x + pad - kx) * wo};           \
+                        const Scalar* f{                                                          \
+                            filters + ((ob * g.inputBlocks + ib) * kk + ky * k + kx) * wi * wo};  \
+                                                                                                  \
+                        for (std::size_t l{}; l < wo; ++l)                                        \
+                        {                                                                         \
+                            const Scalar dl{d[l]};                                                \
+                            for (std::size_t c{}; c < wi; ++c) { acc[c] += f[c * wo + l] * dl; }  \
+                        }                                                                         \
+                    }                                                                             \
+                }                                                                                 \
+            }                                                                                     \
+            for (std::size_t c{}; c < wi; ++c) { inputGradients[x * wi + c] = acc[c]; }           \
+        }                                                                                         \
+    }
+
+ML_MULTI_CHANNEL_LOOPS(Default, )
+
+#ifdef ML_X86_KERNELS
+ML_MULTI_CHANNEL_LOOPS(Avx2, __attribute__((target("avx2,fma"))))
+ML_MULTI_CHANNEL_LOOPS(Avx512, __attribute__((target("avx512f"))))
+#endif
+
+#undef ML_MULTI_CHANNEL_LOOPS
+
+/** Function pointer type of the output pixel loops. */
+using PixelsLoop = void (*)(const Geometry&, const Scalar*, const Scalar*, const Scalar*,
+                            Scalar*, std::size_t, std::size_t, std::size_t,
+                            std::size_t) noexcept;
+
+/** Number of adjacent output pixels computed at once by the portable loops. */
+constexpr std::size_t PixelTile{4U};
+
+#ifdef ML_X86_KERNELS
+/** Number of adjacent output pixels computed at once by the AVX2 tile. */
+constexpr std::size_t AvxPixelTile{8U};
+
+// -----------------------------------------------------------------------------
+// A full block of channels fills a 256-bit register in both precisions.
+__attribute__((target("avx2,fma")))
+inline __m256d loadBlock(const double* data) noexcept { return _mm256_loadu_pd(data); }
+
+__attribute__((target("avx2,fma")))
+inline __m256 loadBlock(const float* data) noexcept { return _mm256_loadu_ps(data); }
+
+__attribute__((target("avx2,fma")))
+inline __m256d broadcast(const double* value) noexcept { return _mm256_broadcast_sd(value); }
+
+__attribute__((target("avx2,fma")))
+inline __m256 broadcast(const float* value) noexcept { return _mm256_broadcast_ss(value); }
+
+__attribute__((target("avx2,fma")))
+inline __m256d multiplyAdd(const __m256d x, const __m256d y, const __m256d sum) noexcept
+{
+    return _mm256_fmadd_pd(x, y, sum);
+}
+
+__attribute__((target("avx2,fma")))
+inline __m256 multiplyAdd(const __m256 x, const __m256 y, const __m256 sum) noexcept
+{
+    return _mm256_fmadd_ps(x, y, sum);
+}
+
+__attribute__((target("avx2,fma")))
+inline void storeBlock(double* data, const __m256d block) noexcept
+{
+    _mm256_storeu_pd(data, block);
+}
+
+__attribute__((target("avx2,fma")))
+inline void storeBlock(float* data, const __m256 block) noexcept
+{
+    _mm256_storeu_ps(data, block);
+}
+
+// -----------------------------------------------------------------------------
+__attribute__((target("avx2,fma")))
+void forwardTileAvx2(const Geometry& g, const Scalar* input, const Scalar* filters,
+                     const Scalar* bias, Scalar* output, const std::size_t y,
+                     const std::size_t x, const std::size_t, const std::size_t) noexcept
+{
+    // Compute AvxPixelTile adjacent pixels of a full output block, with the whole kernel
+    // window inside the feature map (so the window range is ignored).
+    const std::size_t s{g.size}, k{g.kernelSize}, wi{g.inputWidth}, pad{k / 2U};
+    const std::size_t kyFirst{windowFirst(y, pad)}, kyLast{windowLast(y, pad, s, k)};
+    decltype(loadBlock(bias)) acc[AvxPixelTile];
+
+    for (std::size_t p{}; p < AvxPixelTile; ++p) { acc[p] = loadBlock(bias); }
+
+    for (std::size_t ib{}; ib < g.inputBlocks; ++ib)
+    {
+        for (std::size_t ky{kyFirst}; ky < kyLast; ++ky)
+        {
+            // The kernel columns and the input channels of a row are adjacent in both the
+            // input and the filters, so they're traversed as a single range.
+            const Scalar* in{input + ((ib * s + y + ky - pad) * s + x - pad) * wi};
+            const Scalar* f{filters + (ib * k + ky) * k * wi * ChannelBlock};
+
+            for (std::size_t i{}; i < k * wi; ++i)
+            {
+                const auto weights{loadBlock(f + i * ChannelBlock)};
+
+                _Pragma("GCC unroll 8")
+                for (std::size_t p{}; p < AvxPixelTile; ++p)
+                {
+                    acc[p] = multiplyAdd(broadcast(in + p * wi + i), weights, acc[p]);
+                }
+            }
+        }
+    }
+    for (std::size_t p{}; p < AvxPixelTile; ++p)
+    {
+        storeBlock(output + (x + p) * ChannelBlock, acc[p]);
+    }
+}
+#endif
+
+/**
+ * @brief Inner loops matching a SIMD level and the block widths of a layer.
+ */
+struct Loops
+{
+    /** Loop computing a single output pixel. */
+    PixelsLoop pixel;
+
+    /** Loop computing a tile of output pixels inside the feature map, or nullptr. */
+    PixelsLoop tile;
+
+    /** Number of pixels per tile. */
+    std::size_t tileSize;
+
+    /** Filter gradient loop. */
+    void (*filterGradients)(const Geometry&, const Scalar*, const Scalar*, Scalar*) noexcept;
+
+    /** Input gradient row loop. */
+    void (*inputGradientRow)(const Geometry&, const Scalar*, const Scalar*, Scalar*, std::size_t,
+                             std::size_t) noexcept;
+};
+
+// -----------------------------------------------------------------------------
+Loops loops(const Geometry& g) noexcept
+{
+    // Full output blocks use constant widths and tiles of pixels, other layers the generic loops.
+    const bool fullBlocks{ChannelBlock == g.outputWidth};
+
+#ifdef ML_X86_KERNELS
+    switch (linalg::simdLevel())
+    {
+        case linalg::SimdLevel::Avx512:
+            return Loops{fullBlocks ? &forwardPixelsAvx512<ChannelBlock, 0U, 1U>
+                                    : &forwardPixelsAvx512<0U, 0U, 1U>,
+                         fullBlocks ? &forwardTileAvx2 : nullptr, AvxPixelTile,
+                         &filterGradientsAvx512, &inputGradientRowAvx512};
+        case linalg::SimdLevel::Avx2:
+            return Loops{fullBlocks ? &forwardPixelsAvx2<ChannelBlock, 0U, 1U>
+                                    : &forwardPixelsAvx2<0U, 0U, 1U>,
+                         fullBlocks ? &forwardTileAvx2 : nullptr, AvxPixelTile,
+                         &filterGradientsAvx2, &inputGradientRowAvx2};
+        default:
+            break;
+    }
+#endif
+    PixelsLoop tile{nullptr};
+    if (fullBlocks)
+    {
+        // Let the loop over the input channels unroll for the common widths.
+        tile = ChannelBlock == g.inputWidth
+            ? &forwardPixelsDefault<ChannelBlock, ChannelBlock, PixelTile>
+            : 1U == g.inputWidth ? &forwardPixelsDefault<ChannelBlock, 1U, PixelTile>
+                                 : &forwardPixelsDefault<ChannelBlock, 0U, PixelTile>;
+    }
+    return Loops{fullBlocks ? &forwardPixelsDefault<ChannelBlock, 0U, 1U>
+                            : &forwardPixelsDefault<0U, 0U, 1U>,
+                 tile, PixelTile, &filterGradientsDefault, &inputGradientRowDefault};
+}
+
+// -----------------------------------------------------------------------------
+void forwardRow(const Loops& loops, const Geometry& g, const Scalar* input,
+                const Scalar* filters, const Scalar* bias, Scalar* output,
+                const std::size_t y) noexcept
+{
+    // Compute one output row of one output block, in tiles where the whole kernel window is
+    // inside the feature map and pixel by pixel at the border.
+    const std::size_t s{g.size}, k{g.kernelSize}, pad{k / 2U};
+    std::size_t x{};
+
+    while (x < s)
+    {
+        if ((nullptr != loops.tile) && (pad <= x) && (x + loops.tileSize + k - 1U <= s + pad))
+        {
+            loops.tile(g, input, filters, bias, output, y, x, 0U, k);
+            x += loops.tileSize;
+        }
+        else
+        {
+            loops.pixel(g, input, filters, bias, output, y, x, windowFirst(x, pad),
+                        windowLast(x, pad, s, k));
+            ++x;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+Geometry geometry(const Tensor& filters, const std::size_t size,
+                  const std::size_t kernelSize) noexcept
+{
+    return Geometry{size, kernelSize, filters.dim(1U), filters.dim(0U), filters.dim(3U),
+                    filters.dim(4U)};
+}
+
+// -----------------------------------------------------------------------------
+constexpr bool useIm2col(const std::size_t inputChannels,
+                         const std::size_t outputChannels) noexcept
+{
+    // The thresholds come from the multi-channel benchmark (source/bench/multi_channel.cpp,
+    // 28x28 inputs, 3x3 and 5x5 kernels, double and float). The GEMM only pays off once its
+    // tiles fill up: below 16 output channels or 8 input channels the direct loops win, by
+    // up to 2-3x for a single input channel. The exception is a partial output block, where
+    // the direct loops waste most of their vector lanes and lose to the GEMM.
+    constexpr std::size_t minInputChannels{8U};
+    constexpr std::size_t minOutputChannels{16U};
+    return (ChannelBlock > outputChannels)
+        || ((minInputChannels <= inputChannels) && (minOutputChannels <= outputChannels));
+}
+
+// -----------------------------------------------------------------------------
+constexpr std::size_t windowSize(const Geometry& g) noexcept
+{
+    // Number of input values in the window of an output pixel, over all input channels.
+    return g.inputBlocks * g.kernelSize * g.kernelSize * g.inputWidth;
+}
+
+// -----------------------------------------------------------------------------
+void lowerInput(const Geometry& g, const Scalar* input, Scalar* rows, const std::size_t first,
+                const std::size_t last) noexcept
+{
+    // Row p holds the window of pixel p, ordered (input block, kernel row, kernel column,
+    // channel) like the filters, with zeros where the window extends beyond the input. The
+    // kernel columns and the channels of a kernel row are adjacent in the input, so each
+    // kernel row is copied as a single range.
+    const std::size_t s{g.size}, k{g.kernelSize}, wi{g.inputWidth}, pad{k / 2U};
+
+    for (std::size_t p{first}; p < last; ++p)
+    {
+        const std::size_t y{p / s}, x{p % s};
+        const std::size_t kxFirst{windowFirst(x, pad)}, kxLast{windowLast(x, pad, s, k)};
+        Scalar* row{rows + p * windowSize(g)};
+
+        for (std::size_t ib{}; ib < g.inputBlocks; ++ib)
+        {
+            for (std::size_t ky{}; ky < k; ++ky)
+            {
+                Scalar* dest{row + (ib * k + ky) * k * wi};
+
+                // Fill the whole kernel row with zeros if it's located in the padding.
+                if ((y + ky < pad) || (y + ky - pad >= s))
+                {
+                    std::fill(dest, dest + k * wi, 0.0);
+                    continue;
+                }
+                const std::size_t offset{((ib * s + y + ky - pad) * s + x + kxFirst - pad) * wi};
+                const Scalar* source{input + offset};
+                std::fill(dest, dest + kxFirst * wi, 0.0);
+                std::copy(source, source + (kxLast - kxFirst) * wi, dest + kxFirst * wi);
+                std::fill(dest + kxLast * wi, dest + k * wi, 0.0);
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void raiseGradients(const Geometry& g, const Scalar* rows, Scalar* inputGradients,
+                    const std::size_t ib) noexcept
+{
+    // Accumulate the window gradients of one input block onto the input positions they were
+    // gathered from, the input gradients must be zero on entry.
+    const std::size_t s{g.size}, k{g.kernelSize}, wi{g.inputWidth}, pad{k / 2U};
+
+    for (std::size_t p{}; p < s * s; ++p)
+    {
+        const std::size_t y{p / s}, x{p % s};
+        const std::size_t kxFirst{windowFirst(x, pad)}, kxLast{windowLast(x, pad, s, k)};
+        const std::size_t kyFirst{windowFirst(y, pad)}, kyLast{windowLast(y, pad, s, k)};
+        const Scalar* row{rows + p * windowSize(g)};
+
+        for (std::size_t ky{kyFirst}; ky < kyLast; ++ky)
+        {
+            const Scalar* source{row + ((ib * k + ky) * k + kxFirst) * wi};
+            const std::size_t offset{((ib * s + y + ky - pad) * s + x + kxFirst - pad) * wi};
+            Scalar* dest{inputGradients + offset};
+            for (std::size_t i{}; i < (kxLast - kxFirst) * wi; ++i) { dest[i] += source[i]; }
+        }
+    }
+}
+} // namespace
+
+//--------------------------------------------------------------------------------
+MultiChannelConvLayer::MultiChannelConvLayer(const std::size_t inputChannels,
+                                             const std::size_t outputChannels,
+                                             const std::size_t inputSize,
+                                             const std::size_t kernelSize,
+                                             const act_func::Type actFuncType,
+                                             const algorithm::Type algorithm,
+                                             const ParameterMode mode)
+    : myInputBatch{}
+    , myInputGradientBatch{}
+    , myInputGradients{}
+    , myFilters{}
+    , myFilterGradients{}
+    , myBias{}
+    , myBiasGradients{}
+    , myOutputBatch{}
+    , myOutput{}
+    , myDeltaBatch{}
+    , myRows{}
+    , myPixels{}
+    , myLoweredFilters{}
+    , myLoweredFilterGradients{}
+    , myInputChannels{inputChannels}
+    , myOutputChannels{outputChannels}
+    , myKernelSize{kernelSize}
+    , myBatchSize{}
+    , myActFunc{actFuncType}
+    , myAlgorithm{algorithm}
+{
+    // Implement kernel min and max size. Min size can't be 0.
+    constexpr std::size_t minKernelSize{1U};
+    constexpr std::size_t maxKernelSize{11U};
+
+    // Throw exception if a channel count or the kernel size is invalid.
+    if (!isValidChannelCount(inputChannels) || !isValidChannelCount(outputChannels))
+    {
+        std::stringstream msg{};
+        msg << "Invalid channel counts " << inputChannels << " -> " << outputChannels
+            << ": channel counts must be at most " << ChannelBlock << " or a multiple of "
+            << ChannelBlock << "!\n";
+        throw std::invalid_argument(msg.str());
+    }
+    else if ((minKernelSize > kernelSize) || (maxKernelSize < kernelSize))
+    {
+        std::stringstream msg{};
+        msg << "Invalid kernel size " << kernelSize << ": kernel size must be in range ["
+            << minKernelSize << ", " << maxKernelSize << "]!\n";
+        throw std::invalid_argument(msg.str());
+    }
+    else if (inputSize < kernelSize)
+    {
+        throw std::invalid_argument("Failed to create multi-channel convolutional layer: "
+                                    "kernel size cannot be greater than input size!");
+    }
+    else if ((algorithm::Type::Direct != algorithm) && (algorithm::Type::Im2col != algorithm)
+             && (algorithm::Type::Auto != algorithm))
+    {
+        throw std::invalid_argument("Failed to create multi-channel convolutional layer: "
+                                    "only direct convolution and im2col are supported!");
+    }
+
+    // Lower the convolution onto GEMM for the channel counts where it's faster.
+    if (algorithm::Type::Auto == algorithm)
+    {
+        myAlgorithm = useIm2col(inputChannels, outputChannels) ? algorithm::Type::Im2col
+                                                               : algorithm::Type::Direct;
+    }
+    if (algorithm::Type::Im2col == myAlgorithm)
+    {
+        const std::size_t rowSize{inputChannels * kernelSize * kernelSize};
+        myRows                   = Tensor{inputSize * inputSize, rowSize};
+        myPixels                 = Tensor{inputSize * inputSize, outputChannels};
+        myLoweredFilters         = Tensor{rowSize, outputChannels};
+        myLoweredFilterGradients = Tensor{rowSize, outputChannels};
+    }
+
+    // Initialize the matrices with zeros, with room for a single sample per batch.
+    const std::size_t inputWidth{blockWidth(inputChannels)};
+    const std::size_t outputWidth{blockWidth(outputChannels)};
+    const Tensor::Shape filterShape{outputChannels / outputWidth, inputChannels / inputWidth,
+                                    kernelSize * kernelSize, inputWidth, outputWidth};
+    myInputBatch = featureMaps(1U, inputChannels, inputSize);
+    setMaxBatchSize(1U);
+
+    // Only record the shapes of external parameters, they are supplied later. The gradients
+    // are allocated on first use, since such layers are often only used for inference.
+    if (ParameterMode::External == mode)
+    {
+        myFilters = Tensor::wrap(nullptr, filterShape, Tensor::MaxRank);
+        myBias    = Tensor::wrap(nullptr, {outputChannels});
+        return;
+    }
+    myFilters = Tensor{filterShape, Tensor::MaxRank};
+    myBias    = Tensor{outputChannels};
+    allocateGradients();
+
+    // Initialize the biases and the filters with random values, scale the filters by the
+    // number of input channels to keep the sums in the same range as a single-channel kernel.
+    const Scalar filterScale{static_cast<Scalar>(1.0 / inputChannels)};
+    for (std::size_t i{}; i < myBias.size(); ++i) { myBias.data()[i] = randomStartVal(); }
+    for (std::size_t i{}; i < myFilters.size(); ++i)
+    {
+        myFilters.data()[i] = randomStartVal() * filterScale;
+    }
+}
+
+//--------------------------------------------------------------------------------
+std::size_t MultiChannelConvLayer::inputSize() const noexcept
+{
+    return featureMapSize(myInputBatch);
+}
+
+//--------------------------------------------------------------------------------
+std::size_t MultiChannelConvLayer::outputSize() const noexcept { return inputSize(); }
+
+//--------------------------------------------------------------------------------
+const Tensor& MultiChannelConvLayer::output() const noexcept { return myOutput; }
+
+//--------------------------------------------------------------------------------
+const Tensor& MultiChannelConvLayer::inputGradients() const noexcept
+{
+    return myInputGradients;
+}
+
+//--------------------------------------------------------------------------------
+std::size_t MultiChannelConvLayer::channelCount() const noexcept { return myOutputChannels; }
+
+//--------------------------------------------------------------------------------
+Type MultiChannelConvLayer::type() const noexcept { return Type::MultiChannel; }
+
+//--------------------------------------------------------------------------------
+std::size_t MultiChannelConvLayer::kernelSize() const noexcept { return myKernelSize; }
+
+//--------------------------------------------------------------------------------
+act_func::Type MultiChannelConvLayer::actFunc() const noexcept { return myActFunc.type(); }
+
+//--------------------------------------------------------------------------------
+TensorList MultiChannelConvLayer::parameters()
+{
+    // Move the views into the list, since copying a tensor creates an owning deep copy.
+    TensorList parameters{};
+    parameters.reserve(2U);
+    parameters.push_back(myFilters.view());
+    parameters.push_back(myBias.view());
+    return parameters;
+}
+
+//--------------------------------------------------------------------------------
+TensorList MultiChannelConvLayer::gradients()
+{
+    if (myFilterGradients.empty()) { allocateGradients(); }
+
+    TensorList gradients{};
+    gradients.reserve(2U);
+    gradients.push_back(myFilterGradients.view());
+    gradients.push_back(myBiasGradients.view());
+    return gradients;
+}
+
+//--------------------------------------------------------------------------------
+bool MultiChannelConvLayer::shareParameters(Interface& source) noexcept
+{
+    // Return false unless the source is a multi-channel layer with the same filter shape.
+    auto* const layer{dynamic_cast<MultiChannelConvLayer*>(&source)};
+    if ((nullptr == layer) || !myFilters.sameShape(layer->myFilters)) { return false; }
+
+    // Use views of the parameters of the source.
+    myFilters = layer->myFilters.view();
+    myBias    = layer->myBias.view();
+    return true;
+}
+
+//--------------------------------------------------------------------------------
+bool MultiChannelConvLayer::useParameters(TensorList& parameters) noexcept
+{
+    // Return false unless the tensors are filters of the same shape and the biases.
+    if ((2U != parameters.size()) || !parameters[0U].sameShape(myFilters)
+        || !parameters[0U].isContiguous() || !parameters[1U].sameShape(myBias)) { return false; }
+
+    // Use views of the tensors.
+    myFilters = parameters[0U].view();
+    myBias    = parameters[1U].view();
+    return true;
+}
+
+//--------------------------------------------------------------------------------
+void MultiChannelConvLayer::invalidateParameters() noexcept
+{
+    // Nothing to recompute, the filters are read directly.
+}
+
+//--------------------------------------------------------------------------------
+std::size_t MultiChannelConvLayer::maxBatchSize() const noexcept
+{
+    return myOutputBatch.dim(0U);
+}
+
+//--------------------------------------------------------------------------------
+void MultiChannelConvLayer::setMaxBatchSize(const std::size_t batchSize)
+{
+    // Throw an exception if the batch size is invalid.
+    if (0U == batchSize)
+    {
+        throw std::invalid_argument("Cannot set max batch size: the batch size cannot be 0!");
+    }
+
+    // Reallocate the batch matrices, let the views refer to the first sample.
+    const std::size_t size{inputSize()};
+    myInputBatch         = featureMaps(batchSize, myInputChannels, size);
+    myInputGradientBatch = featureMaps(batchSize, myInputChannels, size);
+    myOutputBatch        = featureMaps(batchSize, myOutputChannels, size);
+    myDeltaBatch         = featureMaps(batchSize, myOutputChannels, size);
+    myInputGradients     = myInputGradientBatch.slice(0U);
+    myOutput             = myOutputBatch.slice(0U);
+    myBatchSize          = 1U;
+}
+
+//--------------------------------------------------------------------------------
+memory::BufferList MultiChannelConvLayer::buffers() noexcept
+{
+    return memory::BufferList{
+        memory::Buffer{&myInputBatch, nullptr, memory::Role::Input},
+        memory::Buffer{&myOutputBatch, &myOutput, memory::Role::Output},
+        memory::Buffer{&myInputGradientBatch, &myInputGradients, memory::Role::InputGradients},
+        memory::Buffer{&myDeltaBatch, nullptr, memory::Role::Scratch}};
+}
+
+//--------------------------------------------------------------------------------
+bool MultiChannelConvLayer::feedforward(const Tensor& input) noexcept
+{
+    // Check the input, return false on dimension mismatch or if the batch is too large.
+    const std::size_t sampleCount{batchSize(input, myInputBatch)};
+    if (0U == sampleCount) { return false; }
+
+    // Store the input for backpropagation, let the views match the layout of the input.
+    const bool batched{input.rank() == myInputBatch.rank()};
+    Tensor inputs{myInputBatch.narrow(0U, 0U, sampleCount)};
+    inputs.copyFrom(input);
+    myOutput         = batchView(myOutputBatch, sampleCount, batched);
+    myInputGradients = batchView(myInputGradientBatch, sampleCount, batched);
+    myBatchSize      = sampleCount;
+
+    const Geometry g{geometry(myFilters, inputSize(), myKernelSize)};
+    const Loops loops{conv_layer::loops(g)};
+    const std::size_t filterSize{myFilters.size() / g.outputBlocks};
+    const std::size_t rowCost{g.size * filterSize};
+
+    // Compute the whole output of each sample at once via GEMM when lowered.
+    if (algorithm::Type::Im2col == myAlgorithm)
+    {
+        lowerFilters();
+        for (std::size_t s{}; s < sampleCount; ++s)
+        {
+            forwardSample(inputs.slice(s).data(), myOutputBatch.slice(s).data(), true);
+        }
+        return true;
+    }
+
+    // The output rows of all blocks and samples are independent, split them across the thread
+    // pool in a single pass. The samples form the innermost loop, so the filters of a block
+    // stay cached across the batch instead of being reloaded for every sample.
+    const std::size_t rowSize{g.size * g.outputWidth};
+    parallel::parallelFor(g.outputBlocks * g.size, sampleCount * rowCost,
+                          [&](const std::size_t first, const std::size_t last)
+    {
+        for (std::size_t row{first}; row < last; ++row)
+        {
+            const std::size_t ob{row / g.size};
+
+            for (std::size_t s{}; s < sampleCount; ++s)
+            {
+                Scalar* output{myOutputBatch.slice(s).data() + row * rowSize};
+                forwardRow(loops, g, inputs.slice(s).data(), myFilters.data() + ob * filterSize,
+                           myBias.data() + ob * g.outputWidth, output, row % g.size);
+
+                // Apply the activation function while the row is cached (the biases are
+                // already added).
+                myActFunc.forward(rowSize, output, output);
+            }
+        }
+    });
+    return true;
+}
+
+//--------------------------------------------------------------------------------
+bool MultiChannelConvLayer::feedforwardPooled(const Tensor& input, const std::size_t poolSize,
+                                              Tensor& output) noexcept
+{
+    // Check the arguments, return false on dimension mismatch or if the batch is too large.
+    const std::size_t sampleCount{batchSize(input, myInputBatch)};
+    const std::size_t size{outputSize()};
+    if ((0U == sampleCount) || (0U == poolSize) || (0U != (size % poolSize))) { return false; }
+
+    const std::size_t pooledSize{size / poolSize};
+    if ((output.rank() != myOutputBatch.rank()) || (output.dim(0U) < sampleCount)
+        || (featureMapSize(output) != pooledSize)
+        || (output.size() / output.dim(0U) != myOutputChannels * pooledSize * pooledSize))
+    {
+        return false;
+    }
+
+    // The output isn't stored, so backpropagation must fail until the next feedforward.
+    const bool batched{input.rank() == myInputBatch.rank()};
+    myBatchSize = 0U;
+
+    const Geometry g{geometry(myFilters, inputSize(), myKernelSize)};
+    const Loops loops{conv_layer::loops(g)};
+    const std::size_t filterSize{myFilters.size() / g.outputBlocks};
+    const std::size_t rowSize{g.size * g.outputWidth};
+    const std::size_t pooledRowSize{pooledSize * g.outputWidth};
+    const bool lowered{algorithm::Type::Im2col == myAlgorithm};
+
+    // Compute the whole output of each sample at once via GEMM when lowered, else row by row
+    // below.
+    if (lowered)
+    {
+        lowerFilters();
+        for (std::size_t s{}; s < sampleCount; ++s)
+        {
+            forwardSample(sampleView(input, myInputBatch.rank() - 1U, s).data(),
+                          myOutputBatch.slice(s).data(), false);
+        }
+    }
+
+    // The pooled rows of all blocks and samples are independent, split them across the
+    // thread pool in a single pass, with the samples as the innermost loop.
+    parallel::parallelFor(g.outputBlocks * pooledSize,
+                          sampleCount * poolSize * g.size * filterSize,
+                          [&](const std::size_t first, const std::size_t last)
+    {
+        for (std::size_t row{first}; row < last; ++row)
+        {
+            const std::size_t ob{row / pooledSize};
+            const std::size_t y{(row % pooledSize) * poolSize};
+
+            for (std::size_t s{}; s < sampleCount; ++s)
+            {
+                // Compute the output rows of the pool one at a time in the same scratch row,
+                // reduce each into the pooled row while it's still in cache.
+                const Scalar* sample{sampleView(input, myInputBatch.rank() - 1U, s).data()};
+                Scalar* scratch{myOutputBatch.slice(s).data()};
+                Scalar* outputRow{scratch + (ob * g.size + y) * rowSize};
+                Scalar* pooledRow{output.slice(s).data() + row * pooledRowSize};
+
+                for (std::size_t pi{}; pi < poolSize; ++pi)
+                {
+                    if (lowered) { outputRow = scratch + (ob * g.size + y + pi) * rowSize; }
+                    else
+                    {
+                        forwardRow(loops, g, sample, myFilters.data() + ob * filterSize,
+                                   myBias.data() + ob * g.outputWidth, outputRow, y + pi);
+                    }
+
+                    for (std::size_t j{}; j < pooledSize; ++j)
+                    {
+                        const Scalar* pool{outputRow + j * poolSize * g.outputWidth};
+                        Scalar* maxVal{pooledRow + j * g.outputWidth};
+
+                        for (std::size_t pj{}; pj < poolSize; ++pj)
+                        {
+                            const Scalar* val{pool + pj * g.outputWidth};
+                            const bool init{(0U == pi) && (0U == pj)};
+
+                            for (std::size_t c{}; c < g.outputWidth; ++c)
+                            {
+                                maxVal[c] = init || (val[c] > maxVal[c]) ? val[c] : maxVal[c];
+                            }
+                        }
+                    }
+                }
+                // Apply the activation function to the pooled values only.
+                myActFunc.forward(pooledRowSize, pooledRow, pooledRow);
+            }
+        }
+    });
+    output = batchView(output, sampleCount, batched);
+    return true;
+}
+
+//--------------------------------------------------------------------------------
+bool MultiChannelConvLayer::feedforwardFused(Interface& source, const Tensor& input) noexcept
+{
+    // Nothing to fuse with, run the layers one by one.
+    return source.feedforward(input) && feedforward(source.output());
+}
+
+//--------------------------------------------------------------------------------
+bool MultiChannelConvLayer::backpropagate(const Tensor& outputGradients) noexcept
+{
+    // Check the output gradients, return false unless they match the latest batch.
+    if ((0U == myBatchSize) || (myBatchSize != batchSize(outputGradients, myOutputBatch)))
+    {
+        return false;
+    }
+
+    // Allocate the gradients on first use, return false if the memory cannot be allocated.
+    if (myFilterGradients.empty())
+    {
+        try { allocateGradients(); }
+        catch (const std::bad_alloc&)
+        {
+            std::cerr << "Failed to allocate the gradients of a multi-channel layer!\n";
+            return false;
+        }
+    }
+
+    // Calculate the output deltas of the whole batch from the output gradients.
+    Tensor deltas{myDeltaBatch.narrow(0U, 0U, myBatchSize)};
+    deltas.copyFrom(outputGradients);
+    myActFunc.backwardFromOutput(deltas.size(), myOutputBatch.data(), deltas.data(),
+                                 deltas.data());
+
+    const Geometry g{geometry(myFilters, inputSize(), myKernelSize)};
+    const Loops loops{conv_layer::loops(g)};
+    const std::size_t filterSize{myFilters.size() / g.outputBlocks};
+    const std::size_t pixelCount{g.size * g.size};
+
+    // Average the gradients over the batch.
+    const Scalar scale{static_cast<Scalar>(1.0 / myBatchSize)};
+
+    // Accumulate the bias gradients by adding the output deltas of each channel.
+    myBiasGradients.zero();
+    for (std::size_t s{}; s < myBatchSize; ++s)
+    {
+        const Scalar* delta{deltas.slice(s).data()};
+
+        for (std::size_t ob{}; ob < g.outputBlocks; ++ob)
+        {
+            Scalar* biasGradients{myBiasGradients.data() + ob * g.outputWidth};
+
+            for (std::size_t i{}; i < pixelCount; ++i)
+            {
+                const Scalar* d{delta + (ob * pixelCount + i) * g.outputWidth};
+                for (std::size_t l{}; l < g.outputWidth; ++l) { biasGradients[l] += d[l]; }
+            }
+        }
+    }
+    for (std::size_t i{}; i < myBiasGradients.size(); ++i) { myBiasGradients.data()[i] *= scale; }
+
+    // Compute the filter and input gradients via GEMM when lowered.
+    if (algorithm::Type::Im2col == myAlgorithm)
+    {
+        backpropagateLowered(deltas, scale);
+        return true;
+    }
+
+    // Compute the filter gradients, each output block has its own filters.
+    myFilterGradients.zero();
+    parallel::parallelFor(g.outputBlocks, myBatchSize * pixelCount * filterSize,
+                          [&](const std::size_t first, const std::size_t last)
+    {
+        for (std::size_t ob{first}; ob < last; ++ob)
+        {
+            Scalar* filterGradients{myFilterGradients.data() + ob * filterSize};
+
+            for (std::size_t s{}; s < myBatchSize; ++s)
+            {
+                loops.filterGradients(g, myInputBatch.slice(s).data(),
+                                      deltas.slice(s).data() + ob * pixelCount * g.outputWidth,
+                                      filterGradients);
+            }
+            for (std::size_t i{}; i < filterSize; ++i) { filterGradients[i] *= scale; }
+        }
+    });
+
+    // Compute the input gradients row by row, each row is written exactly once.
+    const std::size_t rowCount{g.inputBlocks * g.size};
+    for (std::size_t s{}; s < myBatchSize; ++s)
+    {
+        const Scalar* delta{deltas.slice(s).data()};
+        Scalar* inputGradients{myInputGradientBatch.slice(s).data()};
+
+        parallel::parallelFor(rowCount, g.size * myFilters.size() / g.inputBlocks,
+                              [&](const std::size_t first, const std::size_t last)
+        {
+            for (std::size_t row{first}; row < last; ++row)
+            {
+                loops.inputGradientRow(g, delta, myFilters.data(),
+                                       inputGradients + row * g.size * g.inputWidth,
+                                       row / g.size, row % g.size);
+            }
+        });
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------
+bool MultiChannelConvLayer::optimize(const double learningRate) noexcept
+{
+    // Check the learning rate and the gradients, return false if out of range or missing.
+    if ((0.0 >= learningRate) || (1.0 < learningRate) || myFilterGradients.empty()) 
+    { 
+        return false; 
+    }
+
+    // Adjust the filters and the biases with the gradients, multiplied by the learning rate.
+    const Scalar rate{static_cast<Scalar>(learningRate)};
+    linalg::axpy(myFilters.size(), rate, myFilterGradients.data(), myFilters.data());
+    linalg::axpy(myBias.size(), rate, myBiasGradients.data(), myBias.data());
+    return true;
+}
+
+//--------------------------------------------------------------------------------
+void MultiChannelConvLayer::forwardSample(const Scalar* input, Scalar* output,
+                                          const bool activate) noexcept
+{
+    const Geometry g{geometry(myFilters, inputSize(), myKernelSize)};
+    const std::size_t pixelCount{g.size * g.size};
+    const std::size_t rowSize{windowSize(g)};
+    const std::size_t channels{myOutputChannels};
+
+    // The pixels are independent, split them across the thread pool. Lower the windows of
+    // the pixels, multiply them with the filters, then add the biases (and apply the
+    // activation function if requested) while scattering the output channels into their
+    // blocks.
+    parallel::parallelFor(pixelCount, rowSize * channels,
+                          [&](const std::size_t first, const std::size_t last)
+    {
+        lowerInput(g, input, myRows.data(), first, last);
+        linalg::gemm(linalg::Transpose::No, linalg::Transpose::No, last - first, channels,
+                     rowSize, 1.0, myRows.row(first), rowSize, myLoweredFilters.data(),
+                     channels, 0.0, myPixels.row(first), channels);
+
+        for (std::size_t p{first}; p < last; ++p)
+        {
+            Scalar* values{myPixels.row(p)};
+            for (std::size_t c{}; c < channels; ++c) { values[c] += myBias.data()[c]; }
+            if (activate) { myActFunc.forward(channels, values, values); }
+
+            for (std::size_t ob{}; ob < g.outputBlocks; ++ob)
+            {
+                const Scalar* block{values + ob * g.outputWidth};
+                std::copy(block, block + g.outputWidth,
+                          output + (ob * pixelCount + p) * g.outputWidth);
+            }
+        }
+    });
+}
+
+//--------------------------------------------------------------------------------
+void MultiChannelConvLayer::backpropagateLowered(const Tensor& deltas,
+                                                 const Scalar scale) noexcept
+{
+    using linalg::Transpose;
+    const Geometry g{geometry(myFilters, inputSize(), myKernelSize)};
+    const std::size_t pixelCount{g.size * g.size};
+    const std::size_t rowSize{windowSize(g)};
+    const std::size_t channels{myOutputChannels};
+    lowerFilters();
+    myLoweredFilterGradients.zero();
+
+    for (std::size_t s{}; s < myBatchSize; ++s)
+    {
+        const Scalar* delta{deltas.slice(s).data()};
+        Scalar* inputGradients{myInputGradientBatch.slice(s).data()};
+
+        // Gather the output deltas of all blocks into rows of output channels.
+        for (std::size_t p{}; p < pixelCount; ++p)
+        {
+            Scalar* values{myPixels.row(p)};
+
+            for (std::size_t ob{}; ob < g.outputBlocks; ++ob)
+            {
+                const Scalar* pixel{delta + (ob * pixelCount + p) * g.outputWidth};
+                std::copy(pixel, pixel + g.outputWidth, values + ob * g.outputWidth);
+            }
+        }
+
+        // Filter gradients (windows x channels) += rows^T (windows x pixels) * deltas
+        // (pixels x channels), the rows of the filter gradients are independent.
+        lowerInput(g, myInputBatch.slice(s).data(), myRows.data(), 0U, pixelCount);
+        parallel::parallelFor(rowSize, pixelCount * channels,
+                              [&](const std::size_t first, const std::size_t last)
+        {
+            linalg::gemm(Transpose::Yes, Transpose::No, last - first, channels, pixelCount,
+                         scale, myRows.data() + first, rowSize, myPixels.data(), channels,
+                         1.0, myLoweredFilterGradients.row(first), channels);
+        });
+
+        // Window gradients (pixels x windows) = deltas (pixels x channels) * filters^T
+        // (channels x windows), overwriting the rows, then scatter them onto the input.
+        parallel::parallelFor(pixelCount, rowSize * channels,
+                              [&](const std::size_t first, const std::size_t last)
+        {
+            linalg::gemm(Transpose::No, Transpose::Yes, last - first, rowSize, channels, 1.0,
+                         myPixels.row(first), channels, myLoweredFilters.data(), channels,
+                         0.0, myRows.row(first), rowSize);
+        });
+        std::fill(inputGradients, inputGradients + myInputGradientBatch.slice(s).size(), 0.0);
+        parallel::parallelFor(g.inputBlocks, pixelCount * rowSize / g.inputBlocks,
+                              [&](const std::size_t first, const std::size_t last)
+        {
+            for (std::size_t ib{first}; ib < last; ++ib)
+            {
+                raiseGradients(g, myRows.data(), inputGradients, ib);
+            }
+        });
+    }
+
+    // Copy the filter gradients of each output block into the layout of the filters.
+    const std::size_t filterSize{myFilters.size() / g.outputBlocks};
+
+    for (std::size_t ob{}; ob < g.outputBlocks; ++ob)
+    {
+        Scalar* gradients{myFilterGradients.data() + ob * filterSize};
+
+        for (std::size_t r{}; r < rowSize; ++r)
+        {
+            const Scalar* row{myLoweredFilterGradients.row(r) + ob * g.outputWidth};
+            std::copy(row, row + g.outputWidth, gradients + r * g.outputWidth);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+void MultiChannelConvLayer::lowerFilters() noexcept
+{
+    // Copy the filters of each output block into the columns of its output channels. The
+    // filters may change between any two passes (and are cheap to copy compared to the
+    // convolution), so they're copied on every pass instead of being cached.
+    const std::size_t outputBlocks{myFilters.dim(0U)};
+    const std::size_t outputWidth{myFilters.dim(4U)};
+    const std::size_t rowSize{myLoweredFilters.dim(0U)};
+
+    for (std::size_t ob{}; ob < outputBlocks; ++ob)
+    {
+        const Scalar* filters{myFilters.data() + ob * rowSize * outputWidth};
+
+        for (std::size_t r{}; r < rowSize; ++r)
+        {
+            std::copy(filters + r * outputWidth, filters + (r + 1U) * outputWidth,
+                      myLoweredFilters.row(r) + ob * outputWidth);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+void MultiChannelConvLayer::allocateGradients()
+{
+    myFilterGradients = Tensor{myFilters.shape(), myFilters.rank()};
+    myBiasGradients   = Tensor{myBias.shape(), myBias.rank()};
+}
+} // namespace ml::conv_layer
@@ -0,0 +1,137 @@
+/**
+ * @brief Memory-mapped dataset implementation details.
+ */
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "ml/dataset/format.h"
+#include "ml/dataset/mapped_dataset.h"
+#include "ml/memory/mapped_file.h"
+#include "ml/scalar.h"
+#include "ml/tensor.h"
+#include "ml/types.h"
+
+namespace ml::dataset
+{
+namespace
+{
+/** Data type code of unsigned bytes in IDX files. */
+constexpr std::uint8_t IdxUnsignedByte{0x08U};
+
+/** Size of an IDX header in bytes, excluding the dimensions. */
+constexpr std::size_t IdxHeaderSize{4U};
+
+/** Size of an IDX dimension in bytes. */
+constexpr std::size_t IdxDimSize{4U};
+
+/** Scale factor normalizing pixels to the range [0, 1]. */
+constexpr Scalar PixelScale{static_cast<Scalar>(1.0 / 255.0)};
+
+// -----------------------------------------------------------------------------
+[[noreturn]] void invalidFile(const std::string& path, const char* reason)
+{
+    throw std::runtime_error("Cannot load dataset file " + path + ": " + reason + "!");
+}
+
+// -----------------------------------------------------------------------------
+std::vector<std::size_t> idxDims(const memory::MappedFile& file, const std::string& path,
+                                 const std::size_t rank)
+{
+    // Check the magic number, i.e. two zero bytes followed by the data type and the rank.
+    const std::uint8_t* const data{file.data()};
+    if ((IdxHeaderSize + rank * IdxDimSize > file.size()) || (0U != data[0U]) 
+        || (0U != data[1U]) || (rank != data[3U]))
+    {
+        invalidFile(path, "not an IDX file of the expected rank");
+    }
+    if (IdxUnsignedByte != data[2U]) { invalidFile(path, "the data type isn't unsigned byte"); }
+
+    // Read the dimensions, which are stored as big-endian 32-bit integers.
+    std::vector<std::size_t> dims(rank);
+    std::size_t size{1U};
+
+    for (std::size_t i{}; i < rank; ++i)
+    {
+        const std::uint8_t* const dim{data + IdxHeaderSize + i * IdxDimSize};
+        dims[i] = (std::size_t{dim[0U]} << 24U) | (std::size_t{dim[1U]} << 16U) 
+            | (std::size_t{dim[2U]} << 8U) | dim[3U];
+        size *= dims[i];
+    }
+
+    // Check that the file holds all the data.
+    if (IdxHeaderSize + rank * IdxDimSize + size > file.size())
+    {
+        invalidFile(path, "the data is truncated");
+    }
+    return dims;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+MappedDataset::MappedDataset(const std::string& imagePath, const std::string& labelPath,
+                             const std::size_t classCount, const Format format)
+    : myImageFile{imagePath}
+    , myLabelFile{labelPath}
+    , myImages{myImageFile.data()}
+    , myLabels{myLabelFile.data()}
+    , mySampleCount{}
+    , myInputSize{}
+    , myOutputSize{classCount}
+    , myFormat{format}
+{
+    // Read the dimensions from the headers, or derive them from the file sizes.
+    if (Format::Idx == format)
+    {
+        const auto imageDims{idxDims(myImageFile, imagePath, 3U)};
+        const auto labelDims{idxDims(myLabelFile, labelPath, 1U)};
+        if (imageDims[1U] != imageDims[2U]) { invalidFile(imagePath, "the images aren't square"); }
+
+        myImages      += IdxHeaderSize + 3U * IdxDimSize;
+        myLabels      += IdxHeaderSize + IdxDimSize;
+        mySampleCount  = std::min(imageDims[0U], labelDims[0U]);
+        myInputSize    = imageDims[1U];
+    }
+    else
+    {
+        mySampleCount = myLabelFile.size();
+        myInputSize   = static_cast<std::size_t>(
+            std::lround(std::sqrt(myImageFile.size() / static_cast<double>(mySampleCount))));
+
+        if (mySampleCount * myInputSize * myInputSize != myImageFile.size())
+        {
+            invalidFile(imagePath, "the size doesn't match square images, one per label");
+        }
+    }
+
+    // Check the labels, which only touches the pages of the label file.
+    if ((0U == mySampleCount) || (0U == myInputSize))
+    {
+        invalidFile(imagePath, "the dataset is empty");
+    }
+    for (std::size_t i{}; i < mySampleCount; ++i)
+    {
+        if (classCount <= myLabels[i]) { invalidFile(labelPath, "a label exceeds the class count"); }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void MappedDataset::load(const std::size_t index, Tensor& input, Tensor& target) const noexcept
+{
+    // Normalize the pixels of the image row by row.
+    const std::uint8_t* const image{myImages + index * myInputSize * myInputSize};
+
+    for (std::size_t i{}; i < myInputSize; ++i)
+    {
+        const std::uint8_t* const pixels{image + i * myInputSize};
+        Scalar* const row{input.data() + i * input.stride(0U)};
+        for (std::size_t j{}; j < myInputSize; ++j) { row[j] = pixels[j] * PixelScale; }
+    }
+
+    // One-hot encode the label.
+    target.fill(Scalar{});
+    target(myLabels[index]) = Scalar{1};
+}
+} // namespace ml::dataset
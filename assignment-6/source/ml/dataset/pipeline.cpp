@@ -0,0 +1,266 @@
+/**
+ * @brief Background input pipeline implementation details.
+ */
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+
+#include "ml/dataset/pipeline.h"
+#include "ml/random/generator.h"
+#include "ml/scalar.h"
+#include "ml/tensor.h"
+#include "ml/types.h"
+#include "ml/utils.h"
+
+namespace ml::dataset
+{
+namespace
+{
+/** Number of times to yield before sleeping while waiting for a buffer. */
+constexpr std::size_t SpinCount{64U};
+
+/** Time to sleep between polls once the spinning is over. */
+constexpr std::chrono::microseconds PollInterval{50};
+
+// -----------------------------------------------------------------------------
+template <typename Condition>
+bool waitUntil(const Condition& condition, const std::atomic<bool>& stopped) noexcept
+{
+    // Yield first, since the buffer is usually handed over soon, then poll at an interval.
+    for (std::size_t i{}; !condition(); ++i)
+    {
+        if (stopped.load(std::memory_order_relaxed)) { return false; }
+        if (SpinCount > i) { std::this_thread::yield(); }
+        else { std::this_thread::sleep_for(PollInterval); }
+    }
+    return true;
+}
+} // namespace
+
+/**
+ * @brief Batch buffer of the ring.
+ *
+ *        The sequence number tells the owner of the buffer: batch number b may be written by
+ *        a worker when the sequence is b, and read by the trainer when the sequence is b + 1.
+ *        The trainer releases the buffer by setting the sequence to b + buffer count.
+ */
+struct Pipeline::Slot
+{
+    /** Input batch, shape (batch size, input size, input size). */
+    Tensor inputs;
+
+    /** Target batch, shape (batch size, output size). */
+    Tensor targets;
+
+    /** Number of samples in the batch. */
+    std::size_t sampleCount;
+
+    /** Sequence number, see above. */
+    std::atomic<std::size_t> sequence;
+};
+
+// -----------------------------------------------------------------------------
+Pipeline::Pipeline(const Interface& dataset, const std::size_t batchSize,
+                   const std::size_t epochCount, const std::size_t workerCount,
+                   const std::size_t bufferCount, const Augmentation& augmentation)
+    : myDataset{dataset}
+    , myBatchSize{batchSize}
+    , myEpochCount{epochCount}
+    , myEpochBatchCount{0U < batchSize
+        ? (dataset.sampleCount() + batchSize - 1U) / batchSize : 0U}
+    , myBatchCount{myEpochBatchCount * epochCount}
+    , myAugmentation{augmentation}
+    , mySeed{random::Generator::getInstance().uint32(std::numeric_limits<std::uint32_t>::max())}
+    , mySlots{}
+    , myOrder{createTrainOrderList(dataset.sampleCount())}
+    , myOrderGenerator{mySeed}
+    , myNextClaim{}
+    , myClaimMutex{}
+    , myNextBatch{}
+    , myStallCount{}
+    , myStallSeconds{}
+    , myWorkerWaitCount{}
+    , myStopped{false}
+    , myWorkers{}
+{
+    // Throw an exception if any argument is invalid.
+    if ((0U == dataset.sampleCount()) || (0U == batchSize) || (0U == epochCount)
+        || (0U == workerCount) || (2U > bufferCount))
+    {
+        throw std::invalid_argument("Failed to create pipeline: invalid dataset, batch size, "
+                                    "epoch count, worker count or buffer count!");
+    }
+
+    // Create the batch buffers, each free for the batch with the same number.
+    const std::size_t maxBatchSize{std::min(batchSize, dataset.sampleCount())};
+
+    for (std::size_t i{}; i < bufferCount; ++i)
+    {
+        auto slot{std::make_unique<Slot>()};
+        slot->inputs      = Tensor{maxBatchSize, dataset.inputSize(), dataset.inputSize()};
+        slot->targets     = Tensor{maxBatchSize, dataset.outputSize()};
+        slot->sampleCount = 0U;
+        slot->sequence.store(i, std::memory_order_relaxed);
+        mySlots.push_back(std::move(slot));
+    }
+
+    // Start prefetching.
+    for (std::size_t i{}; i < workerCount; ++i) { myWorkers.emplace_back(&Pipeline::runWorker, this); }
+}
+
+// -----------------------------------------------------------------------------
+Pipeline::~Pipeline() noexcept
+{
+    myStopped.store(true, std::memory_order_relaxed);
+    for (auto& worker : myWorkers) { worker.join(); }
+}
+
+// -----------------------------------------------------------------------------
+bool Pipeline::next(Tensor& inputs, Tensor& targets) noexcept
+{
+    // Release the buffer of the previous batch to the worker of the batch a ring later.
+    if (0U < myNextBatch)
+    {
+        const std::size_t previous{myNextBatch - 1U};
+        mySlots[previous % mySlots.size()]->sequence.store(previous + mySlots.size(),
+                                                           std::memory_order_release);
+    }
+    if (myBatchCount <= myNextBatch) { return false; }
+
+    // Wait for the batch if it hasn't been prefetched yet.
+    Slot& slot{*mySlots[myNextBatch % mySlots.size()]};
+    const auto ready{[&]()
+    {
+        return myNextBatch + 1U == slot.sequence.load(std::memory_order_acquire);
+    }};
+
+    if (!ready())
+    {
+        const auto start{std::chrono::steady_clock::now()};
+        waitUntil(ready, myStopped);
+        myStallSeconds += std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        ++myStallCount;
+    }
+
+    // Hand out views of the batch, which stay valid until the buffer is released.
+    inputs  = slot.inputs.narrow(0U, 0U, slot.sampleCount);
+    targets = slot.targets.narrow(0U, 0U, slot.sampleCount);
+    ++myNextBatch;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+PipelineStats Pipeline::stats() const noexcept
+{
+    return PipelineStats{myNextBatch, myStallCount, myStallSeconds,
+                         myWorkerWaitCount.load(std::memory_order_relaxed)};
+}
+
+// -----------------------------------------------------------------------------
+std::size_t Pipeline::claim(std::vector<std::size_t>& indices)
+{
+    // Claim the next batch, return the batch count if every batch has been claimed.
+    const std::lock_guard<std::mutex> lock{myClaimMutex};
+    if (myBatchCount <= myNextClaim) { return myBatchCount; }
+    const std::size_t batch{myNextClaim++};
+    const std::size_t epochBatch{batch % myEpochBatchCount};
+
+    // Shuffle the sample order at the start of each epoch, when the previous epoch has been
+    // claimed completely.
+    if (0U == epochBatch) { std::shuffle(myOrder.begin(), myOrder.end(), myOrderGenerator); }
+
+    // Copy the sample indices of the batch, so the order may be shuffled again meanwhile.
+    const std::size_t first{epochBatch * myBatchSize};
+    const std::size_t last{std::min(first + myBatchSize, myOrder.size())};
+    indices.assign(myOrder.begin() + first, myOrder.begin() + last);
+    return batch;
+}
+
+// -----------------------------------------------------------------------------
+void Pipeline::runWorker() noexcept
+{
+    const std::size_t inputSize{myDataset.inputSize()};
+    const bool augmented{(0U < myAugmentation.maxShift) || myAugmentation.flip
+        || (Scalar{} < myAugmentation.noise)};
+    std::vector<std::size_t> indices{};
+    Tensor sample{inputSize, inputSize};
+
+    // Prepare batches until every batch has been claimed or the pipeline is stopped.
+    for (std::size_t batch{claim(indices)}; batch < myBatchCount; batch = claim(indices))
+    {
+        // Wait for the buffer of the batch to be released by the trainer.
+        Slot& slot{*mySlots[batch % mySlots.size()]};
+        const auto free{[&]() { return batch == slot.sequence.load(std::memory_order_acquire); }};
+
+        if (!free())
+        {
+            myWorkerWaitCount.fetch_add(1U, std::memory_order_relaxed);
+            if (!waitUntil(free, myStopped)) { return; }
+        }
+
+        // Load the samples, augmented with a generator of their own for each batch.
+        std::seed_seq seed{mySeed, static_cast<std::uint32_t>(batch)};
+        std::mt19937 generator{seed};
+
+        for (std::size_t j{}; j < indices.size(); ++j)
+        {
+            Tensor input{slot.inputs.slice(j)};
+            Tensor target{slot.targets.slice(j)};
+
+            if (augmented)
+            {
+                myDataset.load(indices[j], sample, target);
+                augment(sample, input, generator);
+            }
+            else { myDataset.load(indices[j], input, target); }
+        }
+
+        // Hand the batch to the trainer.
+        slot.sampleCount = indices.size();
+        slot.sequence.store(batch + 1U, std::memory_order_release);
+    }
+}
+
+// -----------------------------------------------------------------------------
+void Pipeline::augment(const Tensor& sample, Tensor& input,
+                       std::mt19937& generator) const noexcept
+{
+    // Draw the shift and the flip of the sample.
+    const auto maxShift{static_cast<std::ptrdiff_t>(myAugmentation.maxShift)};
+    std::uniform_int_distribution<std::ptrdiff_t> shift{-maxShift, maxShift};
+    std::normal_distribution<double> noise{0.0, static_cast<double>(myAugmentation.noise)};
+    const std::ptrdiff_t dy{shift(generator)};
+    const std::ptrdiff_t dx{shift(generator)};
+    const bool flip{myAugmentation.flip && (0U != (generator() & 1U))};
+    const auto size{static_cast<std::ptrdiff_t>(sample.dim(0U))};
+
+    // Write each pixel from its source, or 0 if the source is outside of the sample.
+    for (std::ptrdiff_t y{}; y < size; ++y)
+    {
+        for (std::ptrdiff_t x{}; x < size; ++x)
+        {
+            const std::ptrdiff_t sy{y - dy};
+            const std::ptrdiff_t sx{(flip ? size - 1 - x : x) - dx};
+            const bool inside{(0 <= sy) && (sy < size) && (0 <= sx) && (sx < size)};
+            Scalar value{inside ? sample(sy, sx) : Scalar{}};
+            if (Scalar{} < myAugmentation.noise) { value += static_cast<Scalar>(noise(generator)); }
+            input(y, x) = value;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void printStats(const PipelineStats& stats, std::ostream& ostream) noexcept
+{
+    const double share{0U < stats.batchCount
+        ? 100.0 * stats.stallCount / stats.batchCount : 0.0};
+    ostream << std::fixed << std::setprecision(1)
+            << "Batches:          " << stats.batchCount << "\n"
+            << "Trainer stalls:   " << stats.stallCount << " (" << share << " %), "
+            << stats.stallSeconds * 1000.0 << " ms\n"
+            << "Worker waits:     " << stats.workerWaitCount << "\n";
+}
+} // namespace ml::dataset
@@ -0,0 +1,36 @@
+/**
+ * @brief Dataset of tensors implementation details.
+ */
+#include <algorithm>
+
+#include "ml/dataset/tensor_dataset.h"
+#include "ml/tensor.h"
+#include "ml/types.h"
+
+namespace ml::dataset
+{
+namespace
+{
+// -----------------------------------------------------------------------------
+bool isValid(const Tensor& inputs, const Tensor& targets) noexcept
+{
+    return (3U == inputs.rank()) && (2U == targets.rank()) && (inputs.dim(1U) == inputs.dim(2U));
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+TensorDataset::TensorDataset(const Tensor& inputs, const Tensor& targets) noexcept
+    : myInputs{inputs.view()}
+    , myTargets{targets.view()}
+    , mySampleCount{isValid(inputs, targets) ? std::min(inputs.dim(0U), targets.dim(0U)) : 0U}
+    , myInputSize{isValid(inputs, targets) ? inputs.dim(1U) : 0U}
+    , myOutputSize{isValid(inputs, targets) ? targets.dim(1U) : 0U}
+{}
+
+// -----------------------------------------------------------------------------
+void TensorDataset::load(const std::size_t index, Tensor& input, Tensor& target) const noexcept
+{
+    input.copyFrom(myInputs.slice(index));
+    target.copyFrom(myTargets.slice(index));
+}
+} // namespace ml::dataset
@@ -1,11 +1,18 @@
 /**
  * @brief Dense layer implementation details.
  */
+#include <algorithm>
+#include <iostream>
 #include <stdexcept>
 
 #include "ml/act_func/type.h"
 #include "ml/dense_layer/dense.h"
-#include "ml/factory/factory.h"
+#include "ml/linalg/blas.h"
+#include "ml/linalg/gemm.h"
+#include "ml/memory/buffer.h"
+#include "ml/parameter_mode.h"
+#include "ml/parallel/thread_pool.h"
+#include "ml/tensor.h"
 #include "ml/types.h"
 #include "ml/utils.h"
 
@@ -13,112 +20,353 @@ namespace ml::dense_layer
 {
 // -----------------------------------------------------------------------------
 Dense::Dense(const std::size_t inputSize, const std::size_t outputSize,
-             const act_func::Type actFunc)
-    : myInputGradients{}
+             const act_func::Type actFunc, const ParameterMode mode)
+    : myInputGradientBatch{}
+    , myInputGradients{}
     , myBias{}
     , myWeights{}
+    , myBiasGradients{}
+    , myWeightGradients{}
+    , myOutputBatch{}
     , myOutput{}
-    , myError{}
-    , myActFunc{nullptr}
+    , myErrorBatch{}
+    , myBatchSize{}
+    , myActFunc{actFunc}
 {
     checkParameters(inputSize, outputSize);
-    initialize(inputSize, outputSize, actFunc);
+    initialize(inputSize, outputSize, mode);
 }
 
 // -----------------------------------------------------------------------------
 std::size_t Dense::inputSize() const noexcept 
 { 
-    return myWeights.empty() ? 0U : myWeights[0U].size(); 
+    return myInputGradientBatch.dim(1U); 
 }
 
 // -----------------------------------------------------------------------------
-std::size_t Dense::outputSize() const noexcept { return myOutput.size(); }
+std::size_t Dense::outputSize() const noexcept { return myOutputBatch.dim(1U); }
 
 // -----------------------------------------------------------------------------
-const std::vector<double>& Dense::output() const noexcept { return myOutput; }
+const Tensor& Dense::output() const noexcept { return myOutput; }
 
 // -----------------------------------------------------------------------------
-const std::vector<double>& Dense::inputGradients() const noexcept { return myInputGradients; }
+const Tensor& Dense::inputGradients() const noexcept { return myInputGradients; }
 
 // -----------------------------------------------------------------------------
-bool Dense::feedforward(const std::vector<double>& input) noexcept 
+act_func::Type Dense::actFunc() const noexcept { return myActFunc.type(); }
+
+// -----------------------------------------------------------------------------
+TensorList Dense::parameters()
 {
-    // Return false if the dimensions don't match.
-    constexpr const char* opName{"feedforward"};
-    if (!matchDimensions(inputSize(), input.size(), opName)) { return false; }
+    // Move the views into the list, since copying a tensor creates an owning deep copy.
+    TensorList parameters{};
+    parameters.reserve(2U);
+    parameters.push_back(myWeights.narrow(1U, 0U, inputSize()));
+    parameters.push_back(myBias.view());
+    return parameters;
+}
 
-    // Perform feedforward for all nodes in the dense layer, use `i` as node ID.
-    for (std::size_t i{}; i < outputSize(); ++i)
+// -----------------------------------------------------------------------------
+TensorList Dense::gradients()
+{
+    // Allocate the gradients on first use, since layers only used for inference never 
+    // need them.
+    if (!hasGradients())
     {
-        // Calculate the sum of the weights and the input values.
-        double sum{myBias[i]};
+        myBiasGradients   = Tensor{outputSize()};
+        myWeightGradients = Tensor{outputSize(), myWeights.dim(1U)};
+    }
 
-        for (std::size_t j{}; j < inputSize(); ++j) 
-        { 
-            sum += myWeights[i][j] * input[j];
-        }
+    TensorList gradients{};
+    gradients.reserve(2U);
+    gradients.push_back(myWeightGradients.narrow(1U, 0U, inputSize()));
+    gradients.push_back(myBiasGradients.view());
+    return gradients;
+}
+
+// -----------------------------------------------------------------------------
+bool Dense::shareParameters(Interface& source) noexcept
+{
+    // Return false unless the source is a dense layer of the same size.
+    auto* const layer{dynamic_cast<Dense*>(&source)};
+    if ((nullptr == layer) || !myWeights.sameShape(layer->myWeights)) { return false; }
+
+    // Use views of the parameters of the source (with the same row padding).
+    myWeights = layer->myWeights.view();
+    myBias    = layer->myBias.view();
+    return true;
+}
 
-        // Calculate the output by applying the activation function to the sum.
-        myOutput[i] = myActFunc->output(sum);
+// -----------------------------------------------------------------------------
+bool Dense::useParameters(TensorList& parameters) noexcept
+{
+    // Return false unless the weights are padded like the own weights (see parameters()).
+    const std::size_t stride{myWeights.stride(0U)};
+    if ((2U != parameters.size()) || (2U != parameters[0U].rank()) 
+        || (outputSize() != parameters[0U].dim(0U)) || (inputSize() != parameters[0U].dim(1U))
+        || (stride != parameters[0U].stride(0U)) || !parameters[1U].sameShape(myBias)) 
+    { 
+        return false; 
     }
-    // Return true to indicate success.
+
+    // Use views of the tensors, including the padding of the weight rows.
+    myWeights = Tensor::wrap(parameters[0U].data(), {outputSize(), stride});
+    myBias    = parameters[1U].view();
     return true;
 }
 
 // -----------------------------------------------------------------------------
-bool Dense::backpropagate(const std::vector<double>& outputGradients) noexcept 
+std::size_t Dense::maxBatchSize() const noexcept { return myOutputBatch.dim(0U); }
+
+// -----------------------------------------------------------------------------
+void Dense::setMaxBatchSize(const std::size_t batchSize)
+{
+    // Throw an exception if the batch size is invalid.
+    if (0U == batchSize)
+    {
+        throw std::invalid_argument("Cannot set max batch size: the batch size cannot be 0!");
+    }
+
+    // Reallocate the batch matrices, let the views refer to the first sample.
+    const std::size_t inputSize{this->inputSize()};
+    const std::size_t outputSize{this->outputSize()};
+    myInputGradientBatch = Tensor{batchSize, inputSize};
+    myOutputBatch        = Tensor{batchSize, outputSize};
+    myErrorBatch         = Tensor{batchSize, outputSize};
+    mySumBatch           = Tensor{outputSize, batchSize};
+    myInputGradients     = myInputGradientBatch.slice(0U);
+    myOutput             = myOutputBatch.slice(0U);
+    myBatchSize          = 1U;
+}
+
+// -----------------------------------------------------------------------------
+memory::BufferList Dense::buffers() noexcept
 {
-    // Return false if the dimensions don't match.
-    constexpr const char* opName{"backpropagation for output dense layer"};
-    if (!matchDimensions(outputSize(), outputGradients.size(), opName)) { return false; }
+    // The errors are read by the optimization, after the backpropagation.
+    return memory::BufferList{
+        memory::Buffer{&myOutputBatch, &myOutput, memory::Role::Output},
+        memory::Buffer{&myInputGradientBatch, &myInputGradients, memory::Role::InputGradients},
+        memory::Buffer{&myErrorBatch, nullptr, memory::Role::Delta}};
+}
+
+// -----------------------------------------------------------------------------
+bool Dense::feedforward(const Tensor& input) noexcept 
+{
+    // Return false if the dimensions don't match or the batch is too large.
+    constexpr const char* opName{"feedforward in dense layer"};
+    const std::size_t sampleCount{batchSize(input, myInputGradientBatch, opName)};
+    if (0U == sampleCount) { return false; }
+
+    // Let the views match the layout of the input.
+    const bool batched{input.rank() == myInputGradientBatch.rank()};
+    myOutput         = batchView(myOutputBatch, sampleCount, batched);
+    myInputGradients = batchView(myInputGradientBatch, sampleCount, batched);
+    myBatchSize      = sampleCount;
+
+    // Calculate the sum of the weights and the input values for all nodes. The output 
+    // nodes are independent, split them across the thread pool.
+    const std::size_t stride{myWeights.stride(0U)};
 
-    // Perform backpropagation for all nodes in the dense layer, use `i` as node ID.
-    for (std::size_t i{}; i < outputSize(); ++i)
+    parallel::parallelFor(outputSize(), sampleCount * inputSize(), 
+                          [&](const std::size_t first, const std::size_t last)
     {
-        // Calculate the raw error.
-        const double error{outputGradients[i] - myOutput[i]};
+        if (1U == sampleCount)
+        {
+            Scalar* output{myOutputBatch.data() + first};
+            std::fill(output, output + last - first, Scalar{});
+            linalg::gemv(linalg::Transpose::No, last - first, inputSize(), 
+                         myWeights.row(first), stride, input.data(), output);
+        }
+        else
+        {
+            // Sums^T (out x N) = weights (out x in) * inputs^T (in x N). The weights are the
+            // large operand, so let them be the rows of the product: the GEMM then streams
+            // them contiguously and only packs the small input batch transposed.
+            const std::size_t rowCount{last - first};
+            const std::size_t sumStride{mySumBatch.stride(0U)};
+            linalg::gemm(linalg::Transpose::No, linalg::Transpose::Yes, rowCount, sampleCount,
+                         inputSize(), 1.0, myWeights.row(first), stride, input.data(), 
+                         input.stride(0U), 0.0, mySumBatch.row(first), sumStride);
 
-        // Calculate error by applying the activation function derivative to the output.
-        myError[i] = error * myActFunc->delta(myOutput[i]);
-    }
+            // Transpose the sums into the output batch.
+            for (std::size_t s{}; s < sampleCount; ++s)
+            {
+                Scalar* output{myOutputBatch.row(s) + first};
+                const Scalar* sums{mySumBatch.row(first) + s};
+
+                for (std::size_t i{}; i < rowCount; ++i) { output[i] = sums[i * sumStride]; }
+            }
+        }
 
-    // Compute input gradients.
-    initMatrix(myInputGradients);
+        // Calculate the outputs by adding the bias values and applying the activation 
+        // function, while the sums are cached.
+        for (std::size_t s{}; s < sampleCount; ++s)
+        {
+            myActFunc.forwardBiases(last - first, myBias.data() + first, 
+                                    myOutputBatch.row(s) + first);
+        }
+    });
+    // Return true to indicate success.
+    return true;
+}
 
-    for (std::size_t i{}; i < inputSize(); ++i)
+// -----------------------------------------------------------------------------
+bool Dense::backpropagate(const Tensor& outputGradients) noexcept 
+{
+    // Return false unless the output gradients match the latest batch.
+    constexpr const char* opName{"backpropagation in dense layer"};
+    if (myBatchSize != batchSize(outputGradients, myOutputBatch, opName)) { return false; }
+
+    // Calculate the error of each node by applying the activation function derivative 
+    // to the output, for the whole batch at once.
+    Tensor errors{myErrorBatch.narrow(0U, 0U, myBatchSize)};
+    errors.copyFrom(outputGradients);
+    myActFunc.backwardFromOutput(errors.size(), myOutputBatch.data(), errors.data(),
+                                 errors.data());
+
+    // Compute input gradients (transposed weights times errors), traversing the weights
+    // row by row.
+    // The input gradients are independent, split them across the thread pool.
+    const std::size_t stride{myWeights.stride(0U)};
+
+    parallel::parallelFor(inputSize(), myBatchSize * outputSize(), 
+                          [&](const std::size_t first, const std::size_t last)
     {
-        for (std::size_t j{}; j < outputSize(); ++j)
+        Scalar* inputGradients{myInputGradientBatch.data() + first};
+
+        if (1U == myBatchSize)
+        {
+            std::fill(inputGradients, inputGradients + last - first, Scalar{});
+            linalg::gemv(linalg::Transpose::Yes, outputSize(), last - first, 
+                         myWeights.data() + first, stride, myErrorBatch.data(), inputGradients);
+        }
+        else
         {
-            myInputGradients[i] += myError[j] * myWeights[j][i];
+            // Input gradients (N x in) = errors (N x out) * weights (out x in).
+            linalg::gemm(linalg::Transpose::No, linalg::Transpose::No, myBatchSize, 
+                         last - first, outputSize(), 1.0, myErrorBatch.data(), outputSize(), 
+                         myWeights.data() + first, stride, 0.0, inputGradients, inputSize());
         }
+    });
+    // Return true to indicate success.
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool Dense::optimize(const Tensor& input, const double learningRate) noexcept 
+{
+    // Return false if the input doesn't match the latest batch or the learning rate 
+    // is invalid.
+    constexpr const char* opName{"optimization in dense layer"};
+    if ((myBatchSize != batchSize(input, myInputGradientBatch, opName))
+        || (!checkLearningRate(learningRate, opName))) { return false; }
+
+    // Average the gradients over the batch.
+    const Scalar rate{static_cast<Scalar>(learningRate / myBatchSize)};
+
+    // Adjust the bias with the calculated errors and the learning rate.
+    for (std::size_t s{}; s < myBatchSize; ++s)
+    {
+        linalg::axpy(outputSize(), rate, myErrorBatch.row(s), myBias.data());
+    }
+
+    // The weight rows are independent, split them across the thread pool.
+    parallel::parallelFor(outputSize(), myBatchSize * inputSize(), 
+                          [&](const std::size_t first, const std::size_t last)
+    {
+        updateWeights(input, rate, true, myWeights, first, last);
+    });
+    // Return true to indicate success.
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool Dense::computeGradients(const Tensor& input) noexcept
+{
+    // Return false if the input doesn't match the latest batch.
+    constexpr const char* opName{"gradient computation in dense layer"};
+    if ((myBatchSize != batchSize(input, myInputGradientBatch, opName)) 
+        || !checkGradients(opName)) { return false; }
+
+    // Average the gradients over the batch.
+    const Scalar scale{static_cast<Scalar>(1.0 / myBatchSize)};
+
+    // Compute the bias gradients from the calculated errors.
+    myBiasGradients.zero();
+
+    for (std::size_t s{}; s < myBatchSize; ++s)
+    {
+        linalg::axpy(outputSize(), scale, myErrorBatch.row(s), myBiasGradients.data());
     }
 
+    // The weight gradient rows are independent, split them across the thread pool.
+    parallel::parallelFor(outputSize(), myBatchSize * inputSize(), 
+                          [&](const std::size_t first, const std::size_t last)
+    {
+        updateWeights(input, scale, false, myWeightGradients, first, last);
+    });
     // Return true to indicate success.
     return true;
 }
 
 // -----------------------------------------------------------------------------
-bool Dense::optimize(const std::vector<double>& input, const double learningRate) noexcept 
+bool Dense::applyGradients(const double learningRate) noexcept
 {
-    // Return false if the dimensions don't match or the learning rate is invalid.
+    // Return false if the learning rate is invalid.
     constexpr const char* opName{"optimization in dense layer"};
-    if (!matchDimensions(inputSize(), input.size(), opName) 
-        || (!checkLearningRate(learningRate, opName))) { return false; }
+    if (!checkLearningRate(learningRate, opName) || !checkGradients(opName)) { return false; }
 
-    // Perform optimization for all nodes in the dense layer, use `i` as node ID.
-    for (std::size_t i{}; i < outputSize(); ++i)
+    // Adjust the parameters with the gradients and the learning rate, the padding of the 
+    // weight gradients is always zero.
+    const Scalar rate{static_cast<Scalar>(learningRate)};
+    linalg::axpy(outputSize(), rate, myBiasGradients.data(), myBias.data());
+    linalg::axpy(myWeights.size(), rate, myWeightGradients.data(), myWeights.data());
+
+    // Return true to indicate success.
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+void Dense::updateWeights(const Tensor& input, const Scalar alpha, const bool accumulate, 
+                          Tensor& weights, const std::size_t first, 
+                          const std::size_t last) noexcept
+{
+    const std::size_t rowCount{last - first};
+
+    if (1U == myBatchSize)
     {
-        // Adjust the bias with the calculated error and the learningRate.
-        myBias[i] += myError[i] * learningRate;
-
-        // Use `j` as weight ID.
-        for (std::size_t j{}; j < inputSize(); ++j)
-        {      
-            // Adjust the weights with the calculated error, the learningRate, and the input.
-            myWeights[i][j] += myError[i] * learningRate * input[j];
+        // Add alpha * error * input^T (rank-1 update), to zeroed rows unless accumulating.
+        if (!accumulate)
+        {
+            std::fill(weights.row(first), weights.row(first) + rowCount * weights.stride(0U), 
+                      Scalar{});
         }
+        linalg::ger(rowCount, inputSize(), alpha, myErrorBatch.data() + first, input.data(), 
+                    weights.row(first), weights.stride(0U));
+    }
+    else
+    {
+        // Weights (out x in) (+)= alpha * errors^T (out x N) * inputs (N x in).
+        linalg::gemm(linalg::Transpose::Yes, linalg::Transpose::No, rowCount, inputSize(),
+                     myBatchSize, alpha, myErrorBatch.data() + first, outputSize(), 
+                     input.data(), input.stride(0U), accumulate ? 1.0 : 0.0, 
+                     weights.row(first), weights.stride(0U));
+    }
+}
+
+// -----------------------------------------------------------------------------
+bool Dense::hasGradients() const noexcept { return 0U < myWeightGradients.size(); }
+
+// -----------------------------------------------------------------------------
+bool Dense::checkGradients(const char* opName) const noexcept
+{
+    // Print an error message and return false if the gradients haven't been allocated.
+    if (!hasGradients())
+    {
+        std::cerr << "Cannot perform " << opName << ": the gradients have not been allocated, "
+                  << "call gradients() first!\n";
+        return false;
     }
-    // Return true to indicate success.
     return true;
 }
 
@@ -138,27 +386,43 @@ void Dense::checkParameters(const std::size_t inputSize, const std::size_t outpu
 
 // -----------------------------------------------------------------------------
 void Dense::initialize(const std::size_t inputSize, const std::size_t outputSize,
-                      const act_func::Type actFunc)
+                       const ParameterMode mode)
 {
-    // Initialize the matrices.
-    initMatrix(myInputGradients, inputSize);
-    initMatrix(myBias, outputSize);
-    initMatrix(myWeights, outputSize, inputSize);
-    initMatrix(myOutput, outputSize);
-    initMatrix(myError, outputSize);
+    // Pad each weight row to a multiple of the tensor alignment, so that every row is aligned.
+    constexpr std::size_t rowAlignment{Tensor::Alignment / sizeof(Scalar)};
+    const std::size_t paddedInputSize{(inputSize + rowAlignment - 1U) / rowAlignment 
+                                      * rowAlignment};
+
+    // Initialize the batch matrices with room for a single sample per batch, the gradients
+    // are allocated on first use.
+    myInputGradientBatch = Tensor{1U, inputSize};
+    myOutputBatch        = Tensor{1U, outputSize};
+    setMaxBatchSize(1U);
+
+    // Only record the shapes of external parameters, they are supplied later.
+    if (ParameterMode::External == mode)
+    {
+        myBias    = Tensor::wrap(nullptr, {outputSize});
+        myWeights = Tensor::wrap(nullptr, {outputSize, paddedInputSize});
+        return;
+    }
+
+    // Allocate the bias and weight matrices, the weight padding is zero and never read.
+    myBias    = Tensor{outputSize};
+    myWeights = Tensor{outputSize, paddedInputSize};
+
+    // Fill the bias and weight matrices with random values. Scale the weights by the input
+    // size, so the sums don't start out large enough to saturate the activation function.
+    const Scalar weightScale{static_cast<Scalar>(1.0 / inputSize)};
 
-    // Fill the bias and weight matrices with random values.
     for (std::size_t i{}; i < outputSize; ++i)
     {
-        myBias[i] = randomStartVal();
+        myBias(i) = randomStartVal();
 
         for (std::size_t j{}; j < inputSize; ++j)
         {
-            myWeights[i][j] = randomStartVal();
+            myWeights(i, j) = weightScale * randomStartVal();
         }
     }
-    // Initialize the activation function.
-    factory::Factory factory{};
-    myActFunc = factory.actFunc(actFunc);
 }
-} // namespace ml::dense_layer
\ No newline at end of file
+} // namespace ml::dense_layer
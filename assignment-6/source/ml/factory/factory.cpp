@@ -3,11 +3,18 @@
  */
 #include <memory>
 
+#include "ml/act_func/leaky_relu.h"
 #include "ml/act_func/none.h"
 #include "ml/act_func/relu.h"
+#include "ml/act_func/sigmoid.h"
 #include "ml/act_func/tanh.h"
+#include "ml/conv_layer/algorithm/direct.h"
+#include "ml/conv_layer/algorithm/fft.h"
+#include "ml/conv_layer/algorithm/im2col.h"
+#include "ml/conv_layer/algorithm/winograd.h"
 #include "ml/conv_layer/conv.h"
 #include "ml/conv_layer/max_pool.h"
+#include "ml/conv_layer/multi_channel.h"
 #include "ml/dense_layer/dense.h"
 #include "ml/factory/factory.h"
 #include "ml/factory/stub.h"
@@ -15,6 +22,27 @@
 
 namespace ml::factory
 {
+namespace
+{
+// -----------------------------------------------------------------------------
+conv_layer::algorithm::Type autoAlgorithm(const std::size_t kernelSize) noexcept
+{
+    // The thresholds come from the convolution algorithm benchmark
+    // (source/bench/conv_algorithms.cpp, 28x28 and 64x64 inputs, double and float). Im2col
+    // only wins for 1x1 and 2x2 kernels, whose lowered input is barely larger than the input.
+    // Winograd F(2x2, 3x3) wins for 3x3 kernels, ahead of F(4x4, 3x3). The cost of FFT barely
+    // grows with the kernel size, it breaks even at 7x7 and wins from 8x8. Direct convolution
+    // wins in between, where im2col is up to 2x slower.
+    constexpr std::size_t im2colMaxKernelSize{2U};
+    constexpr std::size_t fftMinKernelSize{8U};
+
+    if (im2colMaxKernelSize >= kernelSize) { return conv_layer::algorithm::Type::Im2col; }
+    if (3U == kernelSize) { return conv_layer::algorithm::Type::Winograd2x2; }
+    return fftMinKernelSize <= kernelSize ? conv_layer::algorithm::Type::Fft
+                                          : conv_layer::algorithm::Type::Direct;
+}
+} // namespace
+
 // -----------------------------------------------------------------------------
 ActFuncPtr Factory::actFunc(const act_func::Type type) 
 { 
@@ -25,6 +53,10 @@ ActFuncPtr Factory::actFunc(const act_func::Type type)
             return std::make_unique<act_func::Relu>();
         case act_func::Type::Tanh:
             return std::make_unique<act_func::Tanh>();
+        case act_func::Type::Sigmoid:
+            return std::make_unique<act_func::Sigmoid>();
+        case act_func::Type::LeakyRelu:
+            return std::make_unique<act_func::LeakyRelu>();
         default:
             return std::make_unique<act_func::None>();
     }
@@ -32,28 +64,70 @@ ActFuncPtr Factory::actFunc(const act_func::Type type)
 
 // -----------------------------------------------------------------------------
 ConvLayerPtr Factory::convLayer(const std::size_t inputSize, const std::size_t kernelSize, 
-                             const act_func::Type actFunc) 
+                                const act_func::Type actFunc,
+                                const conv_layer::algorithm::Type algorithm,
+                                const ParameterMode mode) 
+{
+    return std::make_unique<conv_layer::ConvLayer>(inputSize, kernelSize, actFunc, algorithm, 
+                                                   mode);
+}
+
+// -----------------------------------------------------------------------------
+ConvLayerPtr Factory::multiChannelConvLayer(const std::size_t inputChannels, 
+                                            const std::size_t outputChannels,
+                                            const std::size_t inputSize, 
+                                            const std::size_t kernelSize,
+                                            const act_func::Type actFunc,
+                                            const ParameterMode mode)
+{
+    return std::make_unique<conv_layer::MultiChannelConvLayer>(inputChannels, outputChannels, 
+                                                               inputSize, kernelSize, actFunc,
+                                                               conv_layer::algorithm::Type::Auto,
+                                                               mode);
+}
+
+// -----------------------------------------------------------------------------
+ConvAlgorithmPtr Factory::convAlgorithm(const conv_layer::algorithm::Type type,
+                                        const std::size_t inputSize,
+                                        const std::size_t kernelSize)
 {
-    return std::make_unique<conv_layer::ConvLayer>(inputSize, kernelSize, actFunc);
+    // Create the corresponding convolution algorithm based on type.
+    switch (type)
+    {
+        case conv_layer::algorithm::Type::Im2col:
+            return std::make_unique<conv_layer::algorithm::Im2col>(inputSize, kernelSize);
+        case conv_layer::algorithm::Type::Winograd2x2:
+            return std::make_unique<conv_layer::algorithm::Winograd2x2>(inputSize, kernelSize);
+        case conv_layer::algorithm::Type::Winograd4x4:
+            return std::make_unique<conv_layer::algorithm::Winograd4x4>(inputSize, kernelSize);
+        case conv_layer::algorithm::Type::Fft:
+            return std::make_unique<conv_layer::algorithm::Fft>(inputSize, kernelSize);
+        case conv_layer::algorithm::Type::Auto:
+            return convAlgorithm(autoAlgorithm(kernelSize), inputSize, kernelSize);
+        default:
+            return std::make_unique<conv_layer::algorithm::Direct>(inputSize, kernelSize);
+    }
 }
 
 // -----------------------------------------------------------------------------
 DenseLayerPtr Factory::denseLayer(const std::size_t inputSize, const std::size_t outputSize, 
-                                  const act_func::Type actFunc)
+                                  const act_func::Type actFunc, const ParameterMode mode)
 {
-    return std::make_unique<dense_layer::Dense>(inputSize, outputSize, actFunc);
+    return std::make_unique<dense_layer::Dense>(inputSize, outputSize, actFunc, mode);
 }
 
 // -----------------------------------------------------------------------------
-FlattenLayerPtr Factory::flattenLayer(const std::size_t inputSize) 
+FlattenLayerPtr Factory::flattenLayer(const std::size_t inputSize, 
+                                      const std::size_t channelCount) 
 {
-    return std::make_unique<flatten_layer::FlattenLayer>(inputSize);
+    return std::make_unique<flatten_layer::FlattenLayer>(inputSize, channelCount);
 }
 
 // -----------------------------------------------------------------------------
-ConvLayerPtr Factory::maxPoolLayer(const std::size_t inputSize, const std::size_t poolSize)
+ConvLayerPtr Factory::maxPoolLayer(const std::size_t inputSize, const std::size_t poolSize,
+                                   const std::size_t channelCount)
 {
-    return std::make_unique<conv_layer::MaxPoolLayer>(inputSize, poolSize);
+    return std::make_unique<conv_layer::MaxPoolLayer>(inputSize, poolSize, channelCount);
 }
 
 // -----------------------------------------------------------------------------
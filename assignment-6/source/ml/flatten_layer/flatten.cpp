@@ -8,6 +8,7 @@
 #include <cstdlib>
 #include <sstream>
 
+#include "ml/conv_layer/layout.h"
 #include "ml/flatten_layer/flatten.h"
 #include "ml/types.h"
 #include "ml/utils.h"
@@ -18,9 +19,13 @@
 namespace ml::flatten_layer
 {
 //--------------------------------------------------------------------------------
-FlattenLayer::FlattenLayer(const std::size_t inputSize)
+FlattenLayer::FlattenLayer(const std::size_t inputSize, const std::size_t channelCount)
     : myInputGradients{}
     , myOutput{}
+    , myInputSize{inputSize}
+    , myMaxBatchSize{1U}
+    , myBatchSize{}
+    , myChannelCount{channelCount}
     //! @note Ta bort!
     , myActFunc{}
 {
@@ -29,63 +34,92 @@ FlattenLayer::FlattenLayer(const std::size_t inputSize)
     {
         throw std::invalid_argument("Cannot create flatten layer: invalid input size!");
     }
-
-    // Initialize the matrices - set output size to input size ^ 2.
-    initMatrix(myInputGradients, inputSize);
-    initMatrix(myOutput, inputSize * inputSize);
+    else if (!conv_layer::isValidChannelCount(channelCount))
+    {
+        throw std::invalid_argument("Cannot create flatten layer: invalid channel count!");
+    }
+    // Nothing is allocated, the output and the input gradients are views.
 }
 
 //--------------------------------------------------------------------------------
-std::size_t FlattenLayer::inputSize() const noexcept { return myInputGradients.size(); }
+std::size_t FlattenLayer::inputSize() const noexcept { return myInputSize; }
 
 //--------------------------------------------------------------------------------
-std::size_t FlattenLayer::outputSize() const noexcept { return myOutput.size(); }
+std::size_t FlattenLayer::outputSize() const noexcept 
+{ 
+    // Set output size to channel count * input size ^ 2.
+    return myChannelCount * myInputSize * myInputSize; 
+}
 
 //--------------------------------------------------------------------------------
-const Matrix2d& FlattenLayer::inputGradients() const noexcept { return myInputGradients; }
+const Tensor& FlattenLayer::inputGradients() const noexcept { return myInputGradients; }
 
 //--------------------------------------------------------------------------------
-const Matrix1d& FlattenLayer::output() const noexcept { return myOutput; }
+const Tensor& FlattenLayer::output() const noexcept { return myOutput; }
 
 //--------------------------------------------------------------------------------
-bool FlattenLayer::feedforward(const Matrix2d& input) noexcept
-{
-    // Get the input size.
-    const std::size_t inputSize{myInputGradients.size()};
+std::size_t FlattenLayer::maxBatchSize() const noexcept { return myMaxBatchSize; }
 
-    // Check the input matrix, return false on dimension mismatch.
-    if ((input.size() != inputSize) || !isMatrixSquare(input)) { return false; }
-
-    // Flatten the input: [i][j] => [inputSize * i + j].
-    for (std::size_t i{}; i < inputSize; ++i)
+//--------------------------------------------------------------------------------
+void FlattenLayer::setMaxBatchSize(const std::size_t batchSize)
+{
+    // Throw an exception if the batch size is invalid.
+    if (0U == batchSize)
     {
-        for (std::size_t j{}; j < inputSize; ++j)
-        {
-            myOutput[inputSize * i + j] = input[i][j];
-        }
+        throw std::invalid_argument("Cannot set max batch size: the batch size cannot be 0!");
     }
-    // Return true to indicate success.
-    return true;
+
+    // Drop the views of the latest batch, there are no buffers to reallocate.
+    myMaxBatchSize   = batchSize;
+    myInputGradients = Tensor{};
+    myOutput         = Tensor{};
+    myBatchSize      = 0U;
 }
 
 //--------------------------------------------------------------------------------
-bool FlattenLayer::backpropagate(const Matrix1d& outputGradients) noexcept
+bool FlattenLayer::feedforward(const Tensor& input) noexcept
 {
-    // Check the output matrix, return false on dimension mismatch.
-    if (outputGradients.size() != myOutput.size()) { return false; }
+    // Check the input, return false on dimension mismatch or if the batch is too large.
+    // Single channels are stored without the channel dimensions (see ml/conv_layer/layout.h).
+    const std::size_t sampleRank{1U == myChannelCount ? 2U : 4U};
+    const bool batched{input.rank() == sampleRank + 1U};
+    const std::size_t sampleCount{batched ? input.dim(0U) : 1U};
 
-    // Get the input size.
-    const std::size_t inputSize{myInputGradients.size()};
+    if ((!batched && (input.rank() != sampleRank)) || (0U == sampleCount) 
+        || (myMaxBatchSize < sampleCount) || (sampleCount * outputSize() != input.size())
+        || (myInputSize != conv_layer::featureMapSize(input))) 
+    { 
+        return false; 
+    }
 
-    // Unflatten the input: [inputSize * i + j] => [i][j].
-    for (std::size_t i{}; i < inputSize; ++i)
-    {
-        for (std::size_t j{}; j < inputSize; ++j)
-        {
-            myInputGradients[i][j] = outputGradients[inputSize * i + j];
-        }
+    // Flatten the input: [s][i][j] => [s][inputSize * i + j], i.e. view the input in 
+    // row-major order, which requires a contiguous input. Multi-channel inputs are viewed 
+    // in their channel-blocked order, which the dense layer doesn't depend on.
+    if (!input.isContiguous()) { return false; }
+    Tensor data{input.view()};
+    myOutput    = batched ? Tensor::wrap(data.data(), {sampleCount, outputSize()})
+                          : Tensor::wrap(data.data(), {outputSize()});
+    myBatchSize = sampleCount;
+    return true;
+}
+
+//--------------------------------------------------------------------------------
+bool FlattenLayer::backpropagate(const Tensor& outputGradients) noexcept
+{
+    // Check the output gradients, return false unless they match the latest output.
+    if ((0U == myBatchSize) || !outputGradients.sameShape(myOutput) 
+        || !outputGradients.isContiguous()) 
+    { 
+        return false; 
     }
-    // Return true to indicate success.
+
+    // Unflatten the output gradients: [s][inputSize * i + j] => [s][i][j], i.e. view them in
+    // the layout of the input.
+    Tensor gradients{outputGradients.view()};
+    const bool batched{2U == myOutput.rank()};
+    myInputGradients = batchView(conv_layer::featureMapView(gradients.data(), myBatchSize, 
+                                                            myChannelCount, myInputSize),
+                                 myBatchSize, batched);
     return true;
 }
 } // namespace ml::flatten_layer
@@ -0,0 +1,588 @@
+/**
+ * @brief Vectorized level 1 and level 2 BLAS-like kernels implementation details.
+ *
+ *        Each kernel exists in a scalar version and, on x86, in SSE2, AVX2 and AVX-512
+ *        versions (for both single and double precision) compiled via function target
+ *        attributes. The version matching the active
+ *        SIMD level (see ml/linalg/simd.h) is selected at runtime.
+ */
+#include <cstddef>
+#include <cstdint>
+
+#include "ml/linalg/blas.h"
+#include "ml/linalg/simd.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define ML_X86_KERNELS
+#endif
+
+namespace ml::linalg
+{
+namespace
+{
+/** Function pointer types for the dispatched kernels. */
+template <typename T>
+using DotKernel = T (*)(std::size_t, const T*, const T*);
+
+template <typename T>
+using AxpyKernel = void (*)(std::size_t, T, const T*, T*);
+
+using Int8DotKernel = std::int32_t (*)(std::size_t, const std::int8_t*, const std::int8_t*);
+
+using Int8AxpyKernel = void (*)(std::size_t, std::int8_t, const std::int8_t*, std::int32_t*);
+
+// -----------------------------------------------------------------------------
+template <typename T>
+T dotScalar(const std::size_t n, const T* x, const T* y) noexcept
+{
+    T sum{};
+    for (std::size_t i{}; i < n; ++i) { sum += x[i] * y[i]; }
+    return sum;
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void axpyScalar(const std::size_t n, const T alpha, const T* x, T* y) noexcept
+{
+    for (std::size_t i{}; i < n; ++i) { y[i] += alpha * x[i]; }
+}
+
+// -----------------------------------------------------------------------------
+std::int32_t dotInt8Scalar(const std::size_t n, const std::int8_t* x,
+                           const std::int8_t* y) noexcept
+{
+    std::int32_t sum{};
+    for (std::size_t i{}; i < n; ++i) { sum += std::int32_t{x[i]} * std::int32_t{y[i]}; }
+    return sum;
+}
+
+// -----------------------------------------------------------------------------
+void axpyInt8Scalar(const std::size_t n, const std::int8_t alpha, const std::int8_t* x,
+                    std::int32_t* y) noexcept
+{
+    for (std::size_t i{}; i < n; ++i) { y[i] += std::int32_t{alpha} * std::int32_t{x[i]}; }
+}
+
+#ifdef ML_X86_KERNELS
+// -----------------------------------------------------------------------------
+__attribute__((target("sse2")))
+double dotSse2(const std::size_t n, const double* x, const double* y) noexcept
+{
+    // Use two accumulators to hide the addition latency.
+    __m128d sum0{_mm_setzero_pd()};
+    __m128d sum1{_mm_setzero_pd()};
+    std::size_t i{};
+
+    for (; i + 4U <= n; i += 4U)
+    {
+        sum0 = _mm_add_pd(sum0, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+        sum1 = _mm_add_pd(sum1, _mm_mul_pd(_mm_loadu_pd(x + i + 2U), _mm_loadu_pd(y + i + 2U)));
+    }
+    double lanes[2U];
+    _mm_storeu_pd(lanes, _mm_add_pd(sum0, sum1));
+    double sum{lanes[0U] + lanes[1U]};
+
+    for (; i < n; ++i) { sum += x[i] * y[i]; }
+    return sum;
+}
+
+// -----------------------------------------------------------------------------
+__attribute__((target("sse2")))
+void axpySse2(const std::size_t n, const double alpha, const double* x, double* y) noexcept
+{
+    const __m128d a{_mm_set1_pd(alpha)};
+    std::size_t i{};
+
+    for (; i + 2U <= n; i += 2U)
+    {
+        _mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(y + i), _mm_mul_pd(a, _mm_loadu_pd(x + i))));
+    }
+    for (; i < n; ++i) { y[i] += alpha * x[i]; }
+}
+
+// -----------------------------------------------------------------------------
+__attribute__((target("avx2,fma")))
+double dotAvx2(const std::size_t n, const double* x, const double* y) noexcept
+{
+    // Use four accumulators to hide the FMA latency.
+    __m256d sum0{_mm256_setzero_pd()};
+    __m256d sum1{_mm256_setzero_pd()};
+    __m256d sum2{_mm256_setzero_pd()};
+    __m256d sum3{_mm256_setzero_pd()};
+    std::size_t i{};
+
+    for (; i + 16U <= n; i += 16U)
+    {
+        sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), sum0);
+        sum1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4U), _mm256_loadu_pd(y + i + 4U), sum1);
+        sum2 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 8U), _mm256_loadu_pd(y + i + 8U), sum2);
+        sum3 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 12U), _mm256_loadu_pd(y + i + 12U), sum3);
+    }
+    for (; i + 4U <= n; i += 4U)
+    {
+        sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), sum0);
+    }
+    const __m256d sum{_mm256_add_pd(_mm256_add_pd(sum0, sum1), _mm256_add_pd(sum2, sum3))};
+    const __m128d half{_mm_add_pd(_mm256_castpd256_pd128(sum), _mm256_extractf128_pd(sum, 1))};
+    double result{_mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)))};
+
+    for (; i < n; ++i) { result += x[i] * y[i]; }
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+__attribute__((target("avx2,fma")))
+void axpyAvx2(const std::size_t n, const double alpha, const double* x, double* y) noexcept
+{
+    const __m256d a{_mm256_set1_pd(alpha)};
+    std::size_t i{};
+
+    for (; i + 4U <= n; i += 4U)
+    {
+        _mm256_storeu_pd(y + i, _mm256_fmadd_pd(a, _mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+    }
+    for (; i < n; ++i) { y[i] += alpha * x[i]; }
+}
+
+// -----------------------------------------------------------------------------
+__attribute__((target("avx512f")))
+double dotAvx512(const std::size_t n, const double* x, const double* y) noexcept
+{
+    // Use two accumulators, the tail is handled with a masked load.
+    __m512d sum0{_mm512_setzero_pd()};
+    __m512d sum1{_mm512_setzero_pd()};
+    std::size_t i{};
+
+    for (; i + 16U <= n; i += 16U)
+    {
+        sum0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), sum0);
+        sum1 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 8U), _mm512_loadu_pd(y + i + 8U), sum1);
+    }
+    for (; i < n; i += 8U)
+    {
+        const __mmask8 mask{static_cast<__mmask8>(n - i < 8U ? (1U << (n - i)) - 1U : 0xFFU)};
+        sum0 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, x + i),
+                               _mm512_maskz_loadu_pd(mask, y + i), sum0);
+    }
+    double lanes[8U];
+    _mm512_storeu_pd(lanes, _mm512_add_pd(sum0, sum1));
+    return ((lanes[0U] + lanes[1U]) + (lanes[2U] + lanes[3U]))
+         + ((lanes[4U] + lanes[5U]) + (lanes[6U] + lanes[7U]));
+}
+
+// -----------------------------------------------------------------------------
+__attribute__((target("avx512f")))
+void axpyAvx512(const std::size_t n, const double alpha, const double* x, double* y) noexcept
+{
+    const __m512d a{_mm512_set1_pd(alpha)};
+
+    for (std::size_t i{}; i < n; i += 8U)
+    {
+        const __mmask8 mask{static_cast<__mmask8>(n - i < 8U ? (1U << (n - i)) - 1U : 0xFFU)};
+        const __m512d result{_mm512_fmadd_pd(a, _mm512_maskz_loadu_pd(mask, x + i),
+                                             _mm512_maskz_loadu_pd(mask, y + i))};
+        _mm512_mask_storeu_pd(y + i, mask, result);
+    }
+}
+
+// -----------------------------------------------------------------------------
+__attribute__((target("sse2")))
+float dotSse2(const std::size_t n, const float* x, const float* y) noexcept
+{
+    // Use two accumulators to hide the addition latency.
+    __m128 sum0{_mm_setzero_ps()};
+    __m128 sum1{_mm_setzero_ps()};
+    std::size_t i{};
+
+    for (; i + 8U <= n; i += 8U)
+    {
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+        sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(x + i + 4U), _mm_loadu_ps(y + i + 4U)));
+    }
+    float lanes[4U];
+    _mm_storeu_ps(lanes, _mm_add_ps(sum0, sum1));
+    float sum{(lanes[0U] + lanes[1U]) + (lanes[2U] + lanes[3U])};
+
+    for (; i < n; ++i) { sum += x[i] * y[i]; }
+    return sum;
+}
+
+// -----------------------------------------------------------------------------
+__attribute__((target("sse2")))
+void axpySse2(const std::size_t n, const float alpha, const float* x, float* y) noexcept
+{
+    const __m128 a{_mm_set1_ps(alpha)};
+    std::size_t i{};
+
+    for (; i + 4U <= n; i += 4U)
+    {
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(a, _mm_loadu_ps(x + i))));
+    }
+    for (; i < n; ++i) { y[i] += alpha * x[i]; }
+}
+
+// -----------------------------------------------------------------------------
+__attribute__((target("avx2,fma")))
+float dotAvx2(const std::size_t n, const float* x, const float* y) noexcept
+{
+    // Use four accumulators to hide the FMA latency.
+    __m256 sum0{_mm256_setzero_ps()};
+    __m256 sum1{_mm256_setzero_ps()};
+    __m256 sum2{_mm256_setzero_ps()};
+    __m256 sum3{_mm256_setzero_ps()};
+    std::size_t i{};
+
+    for (; i + 32U <= n; i += 32U)
+    {
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), sum0);
+        sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 8U), _mm256_loadu_ps(y + i + 8U), sum1);
+        sum2 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 16U), _mm256_loadu_ps(y + i + 16U), sum2);
+        sum3 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i + 24U), _mm256_loadu_ps(y + i + 24U), sum3);
+    }
+    for (; i + 8U <= n; i += 8U)
+    {
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i), sum0);
+    }
+    float lanes[8U];
+    _mm256_storeu_ps(lanes, _mm256_add_ps(_mm256_add_ps(sum0, sum1), _mm256_add_ps(sum2, sum3)));
+    float result{((lanes[0U] + lanes[1U]) + (lanes[2U] + lanes[3U]))
+               + ((lanes[4U] + lanes[5U]) + (lanes[6U] + lanes[7U]))};
+
+    for (; i < n; ++i) { result += x[i] * y[i]; }
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+__attribute__((target("avx2,fma")))
+void axpyAvx2(const std::size_t n, const float alpha, const float* x, float* y) noexcept
+{
+    const __m256 a{_mm256_set1_ps(alpha)};
+    std::size_t i{};
+
+    for (; i + 8U <= n; i += 8U)
+    {
+        _mm256_storeu_ps(y + i, _mm256_fmadd_ps(a, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+    }
+    for (; i < n; ++i) { y[i] += alpha * x[i]; }
+}
+
+// -----------------------------------------------------------------------------
+__attribute__((target("avx512f")))
+float dotAvx512(const std::size_t n, const float* x, const float* y) noexcept
+{
+    // Use two accumulators, the tail is handled with a masked load.
+    __m512 sum0{_mm512_setzero_ps()};
+    __m512 sum1{_mm512_setzero_ps()};
+    std::size_t i{};
+
+    for (; i + 32U <= n; i += 32U)
+    {
+        sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i), sum0);
+        sum1 = _mm512_fmadd_ps(_mm512_loadu_ps(x + i + 16U), _mm512_loadu_ps(y + i + 16U), sum1);
+    }
+    for (; i < n; i += 16U)
+    {
+        const __mmask16 mask{static_cast<__mmask16>(n - i < 16U ? (1U << (n - i)) - 1U : 0xFFFFU)};
+        sum0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, x + i),
+                               _mm512_maskz_loadu_ps(mask, y + i), sum0);
+    }
+    float lanes[16U];
+    _mm512_storeu_ps(lanes, _mm512_add_ps(sum0, sum1));
+    float result{};
+    for (const auto lane : lanes) { result += lane; }
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+__attribute__((target("avx512f")))
+void axpyAvx512(const std::size_t n, const float alpha, const float* x, float* y) noexcept
+{
+    const __m512 a{_mm512_set1_ps(alpha)};
+
+    for (std::size_t i{}; i < n; i += 16U)
+    {
+        const __mmask16 mask{static_cast<__mmask16>(n - i < 16U ? (1U << (n - i)) - 1U : 0xFFFFU)};
+        const __m512 result{_mm512_fmadd_ps(a, _mm512_maskz_loadu_ps(mask, x + i),
+                                            _mm512_maskz_loadu_ps(mask, y + i))};
+        _mm512_mask_storeu_ps(y + i, mask, result);
+    }
+}
+
+// -----------------------------------------------------------------------------
+__attribute__((target("sse2")))
+std::int32_t dotInt8Sse2(const std::size_t n, const std::int8_t* x,
+                         const std::int8_t* y) noexcept
+{
+    // Sign extend 16 bytes at a time to 16-bit lanes (SSE2 lacks pmovsx), then let pmaddwd
+    // multiply and add adjacent pairs into 32-bit lanes.
+    __m128i sum{_mm_setzero_si128()};
+    std::size_t i{};
+
+    for (; i + 16U <= n; i += 16U)
+    {
+        const __m128i a{_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i))};
+        const __m128i b{_mm_loadu_si128(reinterpret_cast<const __m128i*>(y + i))};
+        const __m128i aLow{_mm_srai_epi16(_mm_unpacklo_epi8(a, a), 8)};
+        const __m128i bLow{_mm_srai_epi16(_mm_unpacklo_epi8(b, b), 8)};
+        const __m128i aHigh{_mm_srai_epi16(_mm_unpackhi_epi8(a, a), 8)};
+        const __m128i bHigh{_mm_srai_epi16(_mm_unpackhi_epi8(b, b), 8)};
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(aLow, bLow));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(aHigh, bHigh));
+    }
+    std::int32_t lanes[4U];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), sum);
+    std::int32_t result{lanes[0U] + lanes[1U] + lanes[2U] + lanes[3U]};
+
+    for (; i < n; ++i) { result += std::int32_t{x[i]} * std::int32_t{y[i]}; }
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+__attribute__((target("sse2")))
+void axpyInt8Sse2(const std::size_t n, const std::int8_t alpha, const std::int8_t* x,
+                  std::int32_t* y) noexcept
+{
+    // The int8 * int8 products fit in 16 bits, so multiply in 16-bit lanes and sign extend
+    // the products to 32 bits before accumulating.
+    const __m128i a{_mm_set1_epi16(alpha)};
+    std::size_t i{};
+
+    for (; i + 8U <= n; i += 8U)
+    {
+        const __m128i v{_mm_loadl_epi64(reinterpret_cast<const __m128i*>(x + i))};
+        const __m128i product{_mm_mullo_epi16(_mm_srai_epi16(_mm_unpacklo_epi8(v, v), 8), a)};
+        const __m128i low{_mm_srai_epi32(_mm_unpacklo_epi16(product, product), 16)};
+        const __m128i high{_mm_srai_epi32(_mm_unpackhi_epi16(product, product), 16)};
+        auto* result{reinterpret_cast<__m128i*>(y + i)};
+        _mm_storeu_si128(result, _mm_add_epi32(_mm_loadu_si128(result), low));
+        _mm_storeu_si128(result + 1, _mm_add_epi32(_mm_loadu_si128(result + 1), high));
+    }
+    for (; i < n; ++i) { y[i] += std::int32_t{alpha} * std::int32_t{x[i]}; }
+}
+
+// -----------------------------------------------------------------------------
+__attribute__((target("avx2")))
+std::int32_t dotInt8Avx2(const std::size_t n, const std::int8_t* x,
+                         const std::int8_t* y) noexcept
+{
+    // Sign extend to 16-bit lanes, multiply and add adjacent pairs into 32-bit lanes.
+    __m256i sum0{_mm256_setzero_si256()};
+    __m256i sum1{_mm256_setzero_si256()};
+    std::size_t i{};
+
+    for (; i + 32U <= n; i += 32U)
+    {
+        const auto* a{reinterpret_cast<const __m128i*>(x + i)};
+        const auto* b{reinterpret_cast<const __m128i*>(y + i)};
+        const __m256i a0{_mm256_cvtepi8_epi16(_mm_loadu_si128(a))};
+        const __m256i b0{_mm256_cvtepi8_epi16(_mm_loadu_si128(b))};
+        const __m256i a1{_mm256_cvtepi8_epi16(_mm_loadu_si128(a + 1))};
+        const __m256i b1{_mm256_cvtepi8_epi16(_mm_loadu_si128(b + 1))};
+        sum0 = _mm256_add_epi32(sum0, _mm256_madd_epi16(a0, b0));
+        sum1 = _mm256_add_epi32(sum1, _mm256_madd_epi16(a1, b1));
+    }
+    std::int32_t lanes[8U];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), _mm256_add_epi32(sum0, sum1));
+    std::int32_t result{};
+    for (const auto lane : lanes) { result += lane; }
+
+    for (; i < n; ++i) { result += std::int32_t{x[i]} * std::int32_t{y[i]}; }
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+__attribute__((target("avx2")))
+void axpyInt8Avx2(const std::size_t n, const std::int8_t alpha, const std::int8_t* x,
+                  std::int32_t* y) noexcept
+{
+    // Multiply in 16-bit lanes, sign extend the products to 32 bits before accumulating.
+    const __m256i a{_mm256_set1_epi16(alpha)};
+    std::size_t i{};
+
+    for (; i + 16U <= n; i += 16U)
+    {
+        const __m128i v{_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i))};
+        const __m256i product{_mm256_mullo_epi16(_mm256_cvtepi8_epi16(v), a)};
+        const __m256i low{_mm256_cvtepi16_epi32(_mm256_castsi256_si128(product))};
+        const __m256i high{_mm256_cvtepi16_epi32(_mm256_extracti128_si256(product, 1))};
+        auto* result{reinterpret_cast<__m256i*>(y + i)};
+        _mm256_storeu_si256(result, _mm256_add_epi32(_mm256_loadu_si256(result), low));
+        _mm256_storeu_si256(result + 1, _mm256_add_epi32(_mm256_loadu_si256(result + 1), high));
+    }
+    for (; i < n; ++i) { y[i] += std::int32_t{alpha} * std::int32_t{x[i]}; }
+}
+#endif
+
+// -----------------------------------------------------------------------------
+template <typename T>
+DotKernel<T> dotKernel() noexcept
+{
+#ifdef ML_X86_KERNELS
+    switch (simdLevel())
+    {
+        case SimdLevel::Avx512:
+            return dotAvx512;
+        case SimdLevel::Avx2:
+            return dotAvx2;
+        case SimdLevel::Sse2:
+            return dotSse2;
+        default:
+            break;
+    }
+#endif
+    return dotScalar<T>;
+}
+
+// -----------------------------------------------------------------------------
+Int8DotKernel int8DotKernel() noexcept
+{
+#ifdef ML_X86_KERNELS
+    // The AVX2 kernel is used at AVX-512 level too, 16-bit lanes gain little from AVX-512F.
+    switch (simdLevel())
+    {
+        case SimdLevel::Avx512:
+        case SimdLevel::Avx2:
+            return dotInt8Avx2;
+        case SimdLevel::Sse2:
+            return dotInt8Sse2;
+        default:
+            break;
+    }
+#endif
+    return dotInt8Scalar;
+}
+
+// -----------------------------------------------------------------------------
+Int8AxpyKernel int8AxpyKernel() noexcept
+{
+#ifdef ML_X86_KERNELS
+    switch (simdLevel())
+    {
+        case SimdLevel::Avx512:
+        case SimdLevel::Avx2:
+            return axpyInt8Avx2;
+        case SimdLevel::Sse2:
+            return axpyInt8Sse2;
+        default:
+            break;
+    }
+#endif
+    return axpyInt8Scalar;
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+AxpyKernel<T> axpyKernel() noexcept
+{
+#ifdef ML_X86_KERNELS
+    switch (simdLevel())
+    {
+        case SimdLevel::Avx512:
+            return axpyAvx512;
+        case SimdLevel::Avx2:
+            return axpyAvx2;
+        case SimdLevel::Sse2:
+            return axpySse2;
+        default:
+            break;
+    }
+#endif
+    return axpyScalar<T>;
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void gemvImpl(const Transpose trans, const std::size_t m, const std::size_t n, const T* a,
+              const std::size_t lda, const T* x, T* y) noexcept
+{
+    if (Transpose::No == trans)
+    {
+        // y[i] += A[i, :] x.
+        const DotKernel<T> kernel{dotKernel<T>()};
+        for (std::size_t i{}; i < m; ++i) { y[i] += kernel(n, a + i * lda, x); }
+    }
+    else
+    {
+        // y += x[i] A[i, :]^T, so that A is traversed row by row instead of column by column.
+        const AxpyKernel<T> kernel{axpyKernel<T>()};
+        for (std::size_t i{}; i < m; ++i) { kernel(n, x[i], a + i * lda, y); }
+    }
+}
+
+// -----------------------------------------------------------------------------
+template <typename T>
+void gerImpl(const std::size_t m, const std::size_t n, const T alpha, const T* x, const T* y,
+             T* a, const std::size_t lda) noexcept
+{
+    // A[i, :] += alpha x[i] y^T.
+    const AxpyKernel<T> kernel{axpyKernel<T>()};
+    for (std::size_t i{}; i < m; ++i) { kernel(n, alpha * x[i], y, a + i * lda); }
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+float dot(const std::size_t n, const float* x, const float* y) noexcept
+{
+    return dotKernel<float>()(n, x, y);
+}
+
+// -----------------------------------------------------------------------------
+double dot(const std::size_t n, const double* x, const double* y) noexcept
+{
+    return dotKernel<double>()(n, x, y);
+}
+
+// -----------------------------------------------------------------------------
+std::int32_t dot(const std::size_t n, const std::int8_t* x, const std::int8_t* y) noexcept
+{
+    return int8DotKernel()(n, x, y);
+}
+
+// -----------------------------------------------------------------------------
+void axpy(const std::size_t n, const float alpha, const float* x, float* y) noexcept
+{
+    axpyKernel<float>()(n, alpha, x, y);
+}
+
+// -----------------------------------------------------------------------------
+void axpy(const std::size_t n, const double alpha, const double* x, double* y) noexcept
+{
+    axpyKernel<double>()(n, alpha, x, y);
+}
+
+// -----------------------------------------------------------------------------
+void axpy(const std::size_t n, const std::int8_t alpha, const std::int8_t* x,
+          std::int32_t* y) noexcept
+{
+    int8AxpyKernel()(n, alpha, x, y);
+}
+
+// -----------------------------------------------------------------------------
+void gemv(const Transpose trans, const std::size_t m, const std::size_t n, const float* a,
+          const std::size_t lda, const float* x, float* y) noexcept
+{
+    gemvImpl(trans, m, n, a, lda, x, y);
+}
+
+// -----------------------------------------------------------------------------
+void gemv(const Transpose trans, const std::size_t m, const std::size_t n, const double* a,
+          const std::size_t lda, const double* x, double* y) noexcept
+{
+    gemvImpl(trans, m, n, a, lda, x, y);
+}
+
+// -----------------------------------------------------------------------------
+void ger(const std::size_t m, const std::size_t n, const float alpha, const float* x,
+         const float* y, float* a, const std::size_t lda) noexcept
+{
+    gerImpl(m, n, alpha, x, y, a, lda);
+}
+
+// -----------------------------------------------------------------------------
+void ger(const std::size_t m, const std::size_t n, const double alpha, const double* x,
+         const double* y, double* a, const std::size_t lda) noexcept
+{
+    gerImpl(m, n, alpha, x, y, a, lda);
+}
+} // namespace ml::linalg
@@ -0,0 +1,256 @@
+/**
+ * @brief Real-valued two-dimensional fast Fourier transform (FFT) implementation details.
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "ml/linalg/fft.h"
+#include "ml/tensor.h"
+
+namespace ml::linalg
+{
+namespace
+{
+// -----------------------------------------------------------------------------
+inline Complex multiply(const Complex& a, const Complex& b) noexcept
+{
+    // Multiply without the NaN/infinity recovery of operator*, which prevents vectorization.
+    return Complex{a.real() * b.real() - a.imag() * b.imag(),
+                   a.real() * b.imag() + a.imag() * b.real()};
+}
+
+// -----------------------------------------------------------------------------
+std::vector<std::size_t> factorize(std::size_t length)
+{
+    // Split the length into radix-3 and radix-2 passes; return an empty list on other factors.
+    std::vector<std::size_t> factors{};
+    while (0U == length % 3U) { factors.push_back(3U); length /= 3U; }
+    while (0U == length % 2U) { factors.push_back(2U); length /= 2U; }
+    if (1U != length) { factors.clear(); }
+    return factors;
+}
+
+// -----------------------------------------------------------------------------
+bool isSupported(const std::size_t size)
+{
+    return (0U != size) && (0U == size % 2U) && ((2U == size) || !factorize(size).empty());
+}
+
+// -----------------------------------------------------------------------------
+void radix2(const Complex* x, Complex* y, const std::size_t m, const std::size_t stride,
+            const Complex* twiddles, const std::size_t twiddleStep) noexcept
+{
+    // y[2p] = a + b, y[2p + 1] = (a - b) W^p, where a = x[p], b = x[p + m].
+    for (std::size_t p{}; p < m; ++p)
+    {
+        const Complex w{twiddles[p * twiddleStep]};
+        const Complex* a{x + stride * p};
+        const Complex* b{x + stride * (p + m)};
+        Complex* y0{y + stride * (2U * p)};
+        Complex* y1{y0 + stride};
+
+        for (std::size_t j{}; j < stride; ++j)
+        {
+            y0[j] = a[j] + b[j];
+            y1[j] = multiply(a[j] - b[j], w);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void radix3(const Complex* x, Complex* y, const std::size_t m, const std::size_t stride,
+            const Complex* twiddles, const std::size_t twiddleStep, const bool inverse) noexcept
+{
+    // 3-point DFTs of a = x[p], b = x[p + m], c = x[p + 2m], scaled by W^0, W^p and W^2p.
+    const Scalar sine{static_cast<Scalar>((inverse ? 1.0 : -1.0) * std::sqrt(3.0) / 2.0)};
+
+    for (std::size_t p{}; p < m; ++p)
+    {
+        const Complex w1{twiddles[p * twiddleStep]};
+        const Complex w2{twiddles[2U * p * twiddleStep]};
+        const Complex* a{x + stride * p};
+        const Complex* b{x + stride * (p + m)};
+        const Complex* c{x + stride * (p + 2U * m)};
+        Complex* y0{y + stride * (3U * p)};
+        Complex* y1{y0 + stride};
+        Complex* y2{y1 + stride};
+
+        for (std::size_t j{}; j < stride; ++j)
+        {
+            const Complex sum{b[j] + c[j]};
+            const Complex diff{b[j] - c[j]};
+            const Complex t{a[j] - Scalar{0.5} * sum};
+            const Complex rotated{-sine * diff.imag(), sine * diff.real()};
+            y0[j] = a[j] + sum;
+            y1[j] = multiply(t + rotated, w1);
+            y2[j] = multiply(t - rotated, w2);
+        }
+    }
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+RealFft2d::RealFft2d(const std::size_t size)
+    : myTwiddles{}
+    , myInverseTwiddles{}
+    , myColumnFactors{factorize(size)}
+    , myRowFactors{factorize(size / 2U)}
+    , myWork{}
+    , mySize{size}
+    , mySpectrumCols{size / 2U + 1U}
+{
+    // Throw an exception if the size isn't supported.
+    if (!isSupported(size))
+    {
+        throw std::invalid_argument(
+            "Cannot create FFT: size must be even with no prime factors other than 2 and 3!");
+    }
+
+    // Precompute the twiddle factors in double precision, regardless of the scalar type.
+    const double pi{std::acos(-1.0)};
+    myTwiddles.resize(size);
+    myInverseTwiddles.resize(size);
+
+    for (std::size_t k{}; k < size; ++k)
+    {
+        const double angle{-2.0 * pi * static_cast<double>(k) / static_cast<double>(size)};
+        myTwiddles[k]        = Complex{static_cast<Scalar>(std::cos(angle)), 
+                                       static_cast<Scalar>(std::sin(angle))};
+        myInverseTwiddles[k] = std::conj(myTwiddles[k]);
+    }
+    myWork.resize(size * mySpectrumCols);
+}
+
+// -----------------------------------------------------------------------------
+std::size_t RealFft2d::nextSize(const std::size_t minSize) noexcept
+{
+    std::size_t size{std::max<std::size_t>(minSize, 2U)};
+    while (!isSupported(size)) { ++size; }
+    return size;
+}
+
+// -----------------------------------------------------------------------------
+void RealFft2d::forward(const Tensor& input, Complex* spectrum) noexcept
+{
+    const std::size_t rowCount{input.dim(0U)};
+    const std::size_t colCount{input.dim(1U)};
+
+    // Transform each input row, pack even/odd samples as real/imaginary parts first.
+    for (std::size_t i{}; i < rowCount; ++i)
+    {
+        const Scalar* source{input.row(i)};
+        Complex* row{spectrum + i * mySpectrumCols};
+
+        for (std::size_t k{}; k < mySize / 2U; ++k)
+        {
+            const std::size_t even{2U * k};
+            const std::size_t odd{even + 1U};
+            row[k] = Complex{even < colCount ? source[even] : Scalar{},
+                             odd < colCount ? source[odd] : Scalar{}};
+        }
+        transformRow(row, false);
+    }
+
+    // The spectrum of the zero padding rows is zero.
+    std::fill(spectrum + rowCount * mySpectrumCols, spectrum + spectrumSize(), Complex{});
+    transform(spectrum, mySize, mySpectrumCols, myColumnFactors, false);
+}
+
+// -----------------------------------------------------------------------------
+void RealFft2d::inverse(Complex* spectrum, const std::size_t offset, Tensor& output) noexcept
+{
+    // Inverse transform the columns, then only the rows inside the output window.
+    transform(spectrum, mySize, mySpectrumCols, myColumnFactors, true);
+    const Scalar scale{static_cast<Scalar>(1.0 / static_cast<double>(mySize * mySize / 2U))};
+
+    for (std::size_t i{}; i < output.dim(0U); ++i)
+    {
+        Complex* row{spectrum + ((i + offset) % mySize) * mySpectrumCols};
+        transformRow(row, true);
+        Scalar* destination{output.row(i)};
+
+        // Unpack real/imaginary parts as even/odd samples.
+        for (std::size_t j{}; j < output.dim(1U); ++j)
+        {
+            const std::size_t col{(j + offset) % mySize};
+            const Complex& packed{row[col / 2U]};
+            destination[j] = scale * (0U == (col & 1U) ? packed.real() : packed.imag());
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void RealFft2d::transform(Complex* data, const std::size_t length, const std::size_t width,
+                          const std::vector<std::size_t>& factors, const bool inverse) noexcept
+{
+    // Transform 'width' interleaved sequences at once: element k of sequence j is stored at
+    // data[k * width + j], so each butterfly operates on contiguous blocks of elements.
+    const Complex* twiddles{inverse ? myInverseTwiddles.data() : myTwiddles.data()};
+    Complex* x{data};
+    Complex* y{myWork.data()};
+    std::size_t n{length};
+    std::size_t stride{width};
+
+    // Perform Stockham passes, ping-ponging between the data and the work buffer.
+    for (const auto factor : factors)
+    {
+        const std::size_t m{n / factor};
+        const std::size_t twiddleStep{mySize / n};
+
+        if (2U == factor) { radix2(x, y, m, stride, twiddles, twiddleStep); }
+        else { radix3(x, y, m, stride, twiddles, twiddleStep, inverse); }
+
+        n = m;
+        stride *= factor;
+        std::swap(x, y);
+    }
+    if (x != data) { std::copy(x, x + length * width, data); }
+}
+
+// -----------------------------------------------------------------------------
+void RealFft2d::transformRow(Complex* row, const bool inverse) noexcept
+{
+    // Transform a row of N real samples, packed as N/2 complex samples, via an N/2-point FFT.
+    const std::size_t half{mySize / 2U};
+    const Complex i{Scalar{}, Scalar{1}};
+    const Scalar oneHalf{0.5};
+    Complex* buffer{myWork.data() + half};
+
+    if (!inverse)
+    {
+        transform(row, half, 1U, myRowFactors, false);
+
+        // Separate the spectra of the even and odd samples, then combine them:
+        // X[k] = E[k] + W^k O[k], E[k] = (Z[k] + Z*[h - k]) / 2, O[k] = (Z[k] - Z*[h - k]) / 2i.
+        std::copy(row, row + half, buffer);
+
+        for (std::size_t k{}; k <= half; ++k)
+        {
+            const Complex z{buffer[k % half]};
+            const Complex zr{std::conj(buffer[(half - k) % half])};
+            const Complex even{oneHalf * (z + zr)};
+            const Complex odd{multiply(-oneHalf * i, z - zr)};
+            row[k] = even + multiply(myTwiddles[k], odd);
+        }
+    }
+    else
+    {
+        // Recover the spectra of the even and odd samples, then pack them: Z[k] = E[k] + i O[k].
+        for (std::size_t k{}; k < half; ++k)
+        {
+            const Complex x{row[k]};
+            const Complex xr{std::conj(row[half - k])};
+            const Complex even{oneHalf * (x + xr)};
+            const Complex odd{multiply(oneHalf * (x - xr), myInverseTwiddles[k])};
+            buffer[k] = even + multiply(i, odd);
+        }
+        std::copy(buffer, buffer + half, row);
+        transform(row, half, 1U, myRowFactors, true);
+    }
+}
+
+} // namespace ml::linalg
@@ -0,0 +1,632 @@
+/**
+ * @brief General matrix multiplication (GEMM) implementation details.
+ *
+ *        The microkernel exists in a portable version and, on x86, in AVX2 and AVX-512
+ *        versions written with intrinsics, each with its own register tile. The version
+ *        matching the active SIMD level (see ml/linalg/simd.h) is selected on every call,
+ *        together with panels packed for its tile size. The dot-product kernel used for
+ *        narrow products A * B^T exists in the same versions.
+ */
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+
+#include "ml/linalg/gemm.h"
+#include "ml/linalg/simd.h"
+#include "ml/tensor.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define ML_X86_KERNELS
+#endif
+
+namespace ml::linalg
+{
+namespace
+{
+/** Cache block sizes: an MC x KC panel of A targets L2, a KC x NR sliver of B targets L1.
+ *  MC is a multiple of the tile rows of every microkernel. */
+constexpr std::size_t MC{120U};
+constexpr std::size_t KC{256U};
+constexpr std::size_t NC{2048U};
+
+/** Tile size (rows x columns of C held in registers) of the portable microkernel. */
+constexpr std::size_t DefaultMR{4U};
+constexpr std::size_t DefaultNR{8U};
+
+/** Tile size (rows x columns of C) of the portable dot-product kernel. */
+constexpr std::size_t DefaultDotRows{2U};
+constexpr std::size_t DefaultDotCols{2U};
+
+/** C counts as narrow with at most this many rows or columns. Packed panels are then barely
+ *  reused, so packing the large operand costs about as much as the multiplication itself. */
+constexpr std::size_t NarrowSize{16U};
+
+/** Minimum shared dimension for dot products, to amortize the reduction of the registers. */
+constexpr std::size_t DotMinDepth{64U};
+
+/** Microkernel computing an MR x NR tile of C from a packed panel of A and a sliver of B
+ *  with given row stride (NR if packed) into a tile buffer. */
+using MicroKernel = void (*)(std::size_t, const Scalar*, const Scalar*, std::size_t, 
+                             Scalar*) noexcept;
+
+/** Kernel computing a tile of C as dot products of rows of A and B into a tile buffer. */
+using DotKernel = void (*)(std::size_t, const Scalar* const*, const Scalar* const*, 
+                           Scalar*) noexcept;
+
+/**
+ * @brief Read-only view of a GEMM operand with an optional transpose.
+ */
+struct Operand
+{
+    const Scalar* data;
+    std::size_t ld;
+    bool transposed;
+
+    Scalar at(const std::size_t row, const std::size_t col) const noexcept
+    {
+        return transposed ? data[col * ld + row] : data[row * ld + col];
+    }
+};
+
+// -----------------------------------------------------------------------------
+template <std::size_t MR>
+void packA(const Operand& a, const std::size_t i0, const std::size_t p0, const std::size_t mc,
+           const std::size_t kc, Scalar* packed) noexcept
+{
+    // Store the block as MR-row panels, column by column; pad partial panels with zeros.
+    for (std::size_t ir{}; ir < mc; ir += MR)
+    {
+        for (std::size_t p{}; p < kc; ++p)
+        {
+            for (std::size_t r{}; r < MR; ++r)
+            {
+                *packed++ = ir + r < mc ? a.at(i0 + ir + r, p0 + p) : 0.0;
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+template <std::size_t NR>
+void packB(const Operand& b, const std::size_t p0, const std::size_t j0, const std::size_t kc,
+           const std::size_t nc, Scalar* packed) noexcept
+{
+    // Store the block as NR-column panels, row by row; pad partial panels with zeros. Rows
+    // of B are copied as contiguous runs unless B is transposed.
+    for (std::size_t jr{}; jr < nc; jr += NR)
+    {
+        const std::size_t nr{std::min(NR, nc - jr)};
+
+        for (std::size_t p{}; p < kc; ++p)
+        {
+            if (!b.transposed)
+            {
+                const Scalar* row{b.data + (p0 + p) * b.ld + j0 + jr};
+                std::copy(row, row + nr, packed);
+            }
+            else
+            {
+                for (std::size_t c{}; c < nr; ++c) { packed[c] = b.at(p0 + p, j0 + jr + c); }
+            }
+            std::fill(packed + nr, packed + NR, 0.0);
+            packed += NR;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void microKernelDefault(const std::size_t kc, const Scalar* a, const Scalar* b,
+                        const std::size_t ldb, Scalar* tile) noexcept
+{
+    // Accumulate a tile of rank-1 updates; the inner loop maps onto vector registers.
+    Scalar acc[DefaultMR][DefaultNR]{};
+
+    for (std::size_t p{}; p < kc; ++p)
+    {
+        for (std::size_t r{}; r < DefaultMR; ++r)
+        {
+            const Scalar ar{a[p * DefaultMR + r]};
+            for (std::size_t c{}; c < DefaultNR; ++c) { acc[r][c] += ar * b[p * ldb + c]; }
+        }
+    }
+    for (std::size_t r{}; r < DefaultMR; ++r)
+    {
+        for (std::size_t c{}; c < DefaultNR; ++c) { tile[r * DefaultNR + c] = acc[r][c]; }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void dotKernelDefault(const std::size_t k, const Scalar* const* a, const Scalar* const* b,
+                      Scalar* tile) noexcept
+{
+    // Reduce every pair of rows of A and B in one pass over the shared dimension.
+    Scalar acc[DefaultDotRows][DefaultDotCols]{};
+
+    for (std::size_t p{}; p < k; ++p)
+    {
+        for (std::size_t r{}; r < DefaultDotRows; ++r)
+        {
+            for (std::size_t c{}; c < DefaultDotCols; ++c) { acc[r][c] += a[r][p] * b[c][p]; }
+        }
+    }
+    for (std::size_t r{}; r < DefaultDotRows; ++r)
+    {
+        for (std::size_t c{}; c < DefaultDotCols; ++c) 
+        { 
+            tile[r * DefaultDotCols + c] = acc[r][c]; 
+        }
+    }
+}
+
+#ifdef ML_X86_KERNELS
+/** Number of scalars per AVX2 and AVX-512 register. */
+constexpr std::size_t Avx2Width{32U / sizeof(Scalar)};
+constexpr std::size_t Avx512Width{64U / sizeof(Scalar)};
+
+/** Tile sizes of the AVX2 and AVX-512 microkernels, two registers per row of the tile. */
+constexpr std::size_t Avx2MR{6U};
+constexpr std::size_t Avx2NR{2U * Avx2Width};
+constexpr std::size_t Avx512MR{8U};
+constexpr std::size_t Avx512NR{2U * Avx512Width};
+
+/** Tile sizes of the AVX2 and AVX-512 dot-product kernels, one register per element. */
+constexpr std::size_t Avx2DotRows{4U};
+constexpr std::size_t Avx2DotCols{3U};
+constexpr std::size_t Avx512DotRows{4U};
+constexpr std::size_t Avx512DotCols{4U};
+
+// -----------------------------------------------------------------------------
+// Register operations in both precisions, so that each microkernel is written once.
+__attribute__((target("avx2,fma")))
+inline __m256d zero256(const double*) noexcept { return _mm256_setzero_pd(); }
+
+__attribute__((target("avx2,fma")))
+inline __m256 zero256(const float*) noexcept { return _mm256_setzero_ps(); }
+
+__attribute__((target("avx2,fma")))
+inline __m256d load256(const double* data) noexcept { return _mm256_loadu_pd(data); }
+
+__attribute__((target("avx2,fma")))
+inline __m256 load256(const float* data) noexcept { return _mm256_loadu_ps(data); }
+
+__attribute__((target("avx2,fma")))
+inline __m256d broadcast256(const double* value) noexcept { return _mm256_broadcast_sd(value); }
+
+__attribute__((target("avx2,fma")))
+inline __m256 broadcast256(const float* value) noexcept { return _mm256_broadcast_ss(value); }
+
+__attribute__((target("avx2,fma")))
+inline __m256d multiplyAdd(const __m256d x, const __m256d y, const __m256d sum) noexcept
+{
+    return _mm256_fmadd_pd(x, y, sum);
+}
+
+__attribute__((target("avx2,fma")))
+inline __m256 multiplyAdd(const __m256 x, const __m256 y, const __m256 sum) noexcept
+{
+    return _mm256_fmadd_ps(x, y, sum);
+}
+
+__attribute__((target("avx2,fma")))
+inline void store(double* data, const __m256d values) noexcept { _mm256_storeu_pd(data, values); }
+
+__attribute__((target("avx2,fma")))
+inline void store(float* data, const __m256 values) noexcept { _mm256_storeu_ps(data, values); }
+
+__attribute__((target("avx512f")))
+inline __m512d zero512(const double*) noexcept { return _mm512_setzero_pd(); }
+
+__attribute__((target("avx512f")))
+inline __m512 zero512(const float*) noexcept { return _mm512_setzero_ps(); }
+
+__attribute__((target("avx512f")))
+inline __m512d load512(const double* data) noexcept { return _mm512_loadu_pd(data); }
+
+__attribute__((target("avx512f")))
+inline __m512 load512(const float* data) noexcept { return _mm512_loadu_ps(data); }
+
+__attribute__((target("avx512f")))
+inline __m512d broadcast512(const double* value) noexcept { return _mm512_set1_pd(*value); }
+
+__attribute__((target("avx512f")))
+inline __m512 broadcast512(const float* value) noexcept { return _mm512_set1_ps(*value); }
+
+__attribute__((target("avx512f")))
+inline __m512d multiplyAdd(const __m512d x, const __m512d y, const __m512d sum) noexcept
+{
+    return _mm512_fmadd_pd(x, y, sum);
+}
+
+__attribute__((target("avx512f")))
+inline __m512 multiplyAdd(const __m512 x, const __m512 y, const __m512 sum) noexcept
+{
+    return _mm512_fmadd_ps(x, y, sum);
+}
+
+__attribute__((target("avx512f")))
+inline void store(double* data, const __m512d values) noexcept { _mm512_storeu_pd(data, values); }
+
+__attribute__((target("avx512f")))
+inline void store(float* data, const __m512 values) noexcept { _mm512_storeu_ps(data, values); }
+
+template <typename Register>
+inline Scalar sum(const Register& values) noexcept
+{
+    // Add the lanes of a register pairwise.
+    Scalar lanes[sizeof(Register) / sizeof(Scalar)];
+    std::memcpy(lanes, &values, sizeof(Register));
+
+    for (std::size_t width{std::size(lanes) / 2U}; 0U < width; width /= 2U)
+    {
+        for (std::size_t i{}; i < width; ++i) { lanes[i] += lanes[i + width]; }
+    }
+    return lanes[0U];
+}
+
+// -----------------------------------------------------------------------------
+__attribute__((target("avx2,fma")))
+void microKernelAvx2(const std::size_t kc, const Scalar* a, const Scalar* b,
+                     const std::size_t ldb, Scalar* tile) noexcept
+{
+    // Hold the tile in 12 of the 16 vector registers, leaving room for a row of B and A.
+    decltype(zero256(b)) acc[Avx2MR][2U];
+
+    _Pragma("GCC unroll 6")
+    for (std::size_t r{}; r < Avx2MR; ++r) { acc[r][0U] = acc[r][1U] = zero256(b); }
+
+    for (std::size_t p{}; p < kc; ++p)
+    {
+        const auto b0{load256(b + p * ldb)};
+        const auto b1{load256(b + p * ldb + Avx2Width)};
+
+        _Pragma("GCC unroll 6")
+        for (std::size_t r{}; r < Avx2MR; ++r)
+        {
+            const auto ar{broadcast256(a + p * Avx2MR + r)};
+            acc[r][0U] = multiplyAdd(ar, b0, acc[r][0U]);
+            acc[r][1U] = multiplyAdd(ar, b1, acc[r][1U]);
+        }
+    }
+    _Pragma("GCC unroll 6")
+    for (std::size_t r{}; r < Avx2MR; ++r)
+    {
+        store(tile + r * Avx2NR, acc[r][0U]);
+        store(tile + r * Avx2NR + Avx2Width, acc[r][1U]);
+    }
+}
+
+// -----------------------------------------------------------------------------
+__attribute__((target("avx512f")))
+void microKernelAvx512(const std::size_t kc, const Scalar* a, const Scalar* b,
+                       const std::size_t ldb, Scalar* tile) noexcept
+{
+    // Hold the tile in 16 of the 32 vector registers, enough to hide the FMA latency.
+    decltype(zero512(b)) acc[Avx512MR][2U];
+
+    _Pragma("GCC unroll 8")
+    for (std::size_t r{}; r < Avx512MR; ++r) { acc[r][0U] = acc[r][1U] = zero512(b); }
+
+    for (std::size_t p{}; p < kc; ++p)
+    {
+        const auto b0{load512(b + p * ldb)};
+        const auto b1{load512(b + p * ldb + Avx512Width)};
+
+        _Pragma("GCC unroll 8")
+        for (std::size_t r{}; r < Avx512MR; ++r)
+        {
+            const auto ar{broadcast512(a + p * Avx512MR + r)};
+            acc[r][0U] = multiplyAdd(ar, b0, acc[r][0U]);
+            acc[r][1U] = multiplyAdd(ar, b1, acc[r][1U]);
+        }
+    }
+    _Pragma("GCC unroll 8")
+    for (std::size_t r{}; r < Avx512MR; ++r)
+    {
+        store(tile + r * Avx512NR, acc[r][0U]);
+        store(tile + r * Avx512NR + Avx512Width, acc[r][1U]);
+    }
+}
+
+// -----------------------------------------------------------------------------
+__attribute__((target("avx2,fma")))
+void dotKernelAvx2(const std::size_t k, const Scalar* const* a, const Scalar* const* b,
+                   Scalar* tile) noexcept
+{
+    // Hold the tile in 12 of the 16 vector registers, leaving room for the rows of B and A.
+    decltype(zero256(*b)) acc[Avx2DotRows][Avx2DotCols];
+
+    _Pragma("GCC unroll 4")
+    for (std::size_t r{}; r < Avx2DotRows; ++r)
+    {
+        _Pragma("GCC unroll 3")
+        for (std::size_t c{}; c < Avx2DotCols; ++c) { acc[r][c] = zero256(*b); }
+    }
+
+    std::size_t p{};
+
+    for (; p + Avx2Width <= k; p += Avx2Width)
+    {
+        decltype(zero256(*b)) rowsB[Avx2DotCols];
+
+        _Pragma("GCC unroll 3")
+        for (std::size_t c{}; c < Avx2DotCols; ++c) { rowsB[c] = load256(b[c] + p); }
+
+        _Pragma("GCC unroll 4")
+        for (std::size_t r{}; r < Avx2DotRows; ++r)
+        {
+            const auto rowA{load256(a[r] + p)};
+
+            _Pragma("GCC unroll 3")
+            for (std::size_t c{}; c < Avx2DotCols; ++c)
+            {
+                acc[r][c] = multiplyAdd(rowA, rowsB[c], acc[r][c]);
+            }
+        }
+    }
+
+    // Reduce the registers, then add the tail of the shared dimension.
+    for (std::size_t r{}; r < Avx2DotRows; ++r)
+    {
+        for (std::size_t c{}; c < Avx2DotCols; ++c)
+        {
+            Scalar value{sum(acc[r][c])};
+            for (std::size_t q{p}; q < k; ++q) { value += a[r][q] * b[c][q]; }
+            tile[r * Avx2DotCols + c] = value;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+__attribute__((target("avx512f")))
+void dotKernelAvx512(const std::size_t k, const Scalar* const* a, const Scalar* const* b,
+                     Scalar* tile) noexcept
+{
+    // Hold the tile in 16 of the 32 vector registers, leaving room for the rows of B and A.
+    decltype(zero512(*b)) acc[Avx512DotRows][Avx512DotCols];
+
+    _Pragma("GCC unroll 4")
+    for (std::size_t r{}; r < Avx512DotRows; ++r)
+    {
+        _Pragma("GCC unroll 4")
+        for (std::size_t c{}; c < Avx512DotCols; ++c) { acc[r][c] = zero512(*b); }
+    }
+
+    std::size_t p{};
+
+    for (; p + Avx512Width <= k; p += Avx512Width)
+    {
+        decltype(zero512(*b)) rowsB[Avx512DotCols];
+
+        _Pragma("GCC unroll 4")
+        for (std::size_t c{}; c < Avx512DotCols; ++c) { rowsB[c] = load512(b[c] + p); }
+
+        _Pragma("GCC unroll 4")
+        for (std::size_t r{}; r < Avx512DotRows; ++r)
+        {
+            const auto rowA{load512(a[r] + p)};
+
+            _Pragma("GCC unroll 4")
+            for (std::size_t c{}; c < Avx512DotCols; ++c)
+            {
+                acc[r][c] = multiplyAdd(rowA, rowsB[c], acc[r][c]);
+            }
+        }
+    }
+
+    // Reduce the registers, then add the tail of the shared dimension.
+    for (std::size_t r{}; r < Avx512DotRows; ++r)
+    {
+        for (std::size_t c{}; c < Avx512DotCols; ++c)
+        {
+            Scalar value{sum(acc[r][c])};
+            for (std::size_t q{p}; q < k; ++q) { value += a[r][q] * b[c][q]; }
+            tile[r * Avx512DotCols + c] = value;
+        }
+    }
+}
+#endif
+
+// -----------------------------------------------------------------------------
+void scale(const std::size_t m, const std::size_t n, const Scalar beta, Scalar* c,
+           const std::size_t ldc) noexcept
+{
+    // Apply beta to C up front, so that every block can simply accumulate.
+    if (1.0 == beta) { return; }
+
+    for (std::size_t i{}; i < m; ++i)
+    {
+        Scalar* row{c + i * ldc};
+        if (0.0 == beta) { std::fill(row, row + n, 0.0); }
+        else { for (std::size_t j{}; j < n; ++j) { row[j] *= beta; } }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void rowTimesMatrix(const std::size_t n, const std::size_t k, const Scalar alpha,
+                    const Operand& a, const Operand& b, Scalar* c) noexcept
+{
+    // Handle m = 1 (a vector-matrix product) without packing, walking B along its rows.
+    if (!b.transposed)
+    {
+        for (std::size_t p{}; p < k; ++p)
+        {
+            const Scalar ap{alpha * a.at(0U, p)};
+            const Scalar* row{b.data + p * b.ld};
+            for (std::size_t j{}; j < n; ++j) { c[j] += ap * row[j]; }
+        }
+    }
+    else
+    {
+        for (std::size_t j{}; j < n; ++j)
+        {
+            const Scalar* row{b.data + j * b.ld};
+            Scalar sum{};
+            for (std::size_t p{}; p < k; ++p) { sum += a.at(0U, p) * row[p]; }
+            c[j] += alpha * sum;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+template <std::size_t MR, std::size_t NR>
+void blocked(const MicroKernel kernel, const std::size_t m, const std::size_t n,
+             const std::size_t k, const Scalar alpha, const Operand& a, const Operand& b,
+             Scalar* c, const std::size_t ldc) noexcept
+{
+    // Allocate packing buffers once per thread and tile size.
+    thread_local Tensor packedA{MC * KC};
+    thread_local Tensor packedB{KC * (NC + NR)};
+
+    // Let the microkernel read B in place if C has few rows, only pack a partial last panel.
+    // Transposed B is always packed, since its panels are not contiguous.
+    const bool packAll{b.transposed || (NarrowSize < m)};
+
+    // Iterate through column blocks of C, then the shared dimension, then row blocks of C.
+    for (std::size_t jc{}; jc < n; jc += NC)
+    {
+        const std::size_t nc{std::min(NC, n - jc)};
+        const std::size_t packFrom{packAll ? 0U : nc / NR * NR};
+
+        for (std::size_t pc{}; pc < k; pc += KC)
+        {
+            const std::size_t kc{std::min(KC, k - pc)};
+            packB<NR>(b, pc, jc + packFrom, kc, nc - packFrom, packedB.data() + packFrom * kc);
+
+            for (std::size_t ic{}; ic < m; ic += MC)
+            {
+                const std::size_t mc{std::min(MC, m - ic)};
+                packA<MR>(a, ic, pc, mc, kc, packedA.data());
+
+                // Compute each MR x NR tile with the microkernel, then add it to C.
+                for (std::size_t jr{}; jr < nc; jr += NR)
+                {
+                    const std::size_t nr{std::min(NR, nc - jr)};
+                    const bool isPacked{packFrom <= jr};
+                    const Scalar* sliver{isPacked ? packedB.data() + jr * kc 
+                                                  : b.data + pc * b.ld + jc + jr};
+                    const std::size_t ldb{isPacked ? NR : b.ld};
+
+                    for (std::size_t ir{}; ir < mc; ir += MR)
+                    {
+                        const std::size_t mr{std::min(MR, mc - ir)};
+                        Scalar tile[MR * NR];
+                        kernel(kc, packedA.data() + ir * kc, sliver, ldb, tile);
+
+                        for (std::size_t r{}; r < mr; ++r)
+                        {
+                            Scalar* row{c + (ic + ir + r) * ldc + jc + jr};
+                            const Scalar* values{tile + r * NR};
+
+                            for (std::size_t col{}; col < nr; ++col)
+                            {
+                                row[col] += alpha * values[col];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+template <std::size_t Rows, std::size_t Cols>
+void dotProducts(const DotKernel kernel, const std::size_t m, const std::size_t n,
+                 const std::size_t k, const Scalar alpha, const Scalar* a, const std::size_t lda,
+                 const Scalar* b, const std::size_t ldb, Scalar* c, const std::size_t ldc) noexcept
+{
+    // Compute C = A * B^T tile by tile straight from the rows of A and B, which are both 
+    // contiguous along the shared dimension. The rows of A are reused for every column block
+    // while cached. Partial tiles repeat the last row, only the valid part is added to C.
+    for (std::size_t i{}; i < m; i += Rows)
+    {
+        const std::size_t mr{std::min(Rows, m - i)};
+        const Scalar* rowsA[Rows];
+        for (std::size_t r{}; r < Rows; ++r) { rowsA[r] = a + (i + std::min(r, mr - 1U)) * lda; }
+
+        for (std::size_t j{}; j < n; j += Cols)
+        {
+            const std::size_t nr{std::min(Cols, n - j)};
+            const Scalar* rowsB[Cols];
+            for (std::size_t col{}; col < Cols; ++col) 
+            { 
+                rowsB[col] = b + (j + std::min(col, nr - 1U)) * ldb; 
+            }
+            Scalar tile[Rows * Cols];
+            kernel(k, rowsA, rowsB, tile);
+
+            for (std::size_t r{}; r < mr; ++r)
+            {
+                Scalar* row{c + (i + r) * ldc + j};
+                const Scalar* values{tile + r * Cols};
+                for (std::size_t col{}; col < nr; ++col) { row[col] += alpha * values[col]; }
+            }
+        }
+    }
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+void gemm(const Transpose transA, const Transpose transB, const std::size_t m,
+          const std::size_t n, const std::size_t k, const Scalar alpha, const Scalar* a,
+          const std::size_t lda, const Scalar* b, const std::size_t ldb, const Scalar beta,
+          Scalar* c, const std::size_t ldc) noexcept
+{
+    // Scale C, terminate if there's nothing left to accumulate.
+    scale(m, n, beta, c, ldc);
+    if ((0U == m) || (0U == n) || (0U == k) || (0.0 == alpha)) { return; }
+
+    const Operand opA{a, lda, Transpose::Yes == transA};
+    const Operand opB{b, ldb, Transpose::Yes == transB};
+
+    // Use a vector-matrix product if A consists of a single row.
+    if (1U == m)
+    {
+        rowTimesMatrix(n, k, alpha, opA, opB, c);
+        return;
+    }
+
+    // Use dot products without packing if both operands run along the shared dimension and
+    // C is narrow.
+    if (!opA.transposed && opB.transposed && (std::min(m, n) <= NarrowSize) 
+        && (DotMinDepth <= k))
+    {
+#ifdef ML_X86_KERNELS
+        switch (simdLevel())
+        {
+            case SimdLevel::Avx512:
+                dotProducts<Avx512DotRows, Avx512DotCols>(dotKernelAvx512, m, n, k, alpha, a,
+                                                          lda, b, ldb, c, ldc);
+                return;
+            case SimdLevel::Avx2:
+                dotProducts<Avx2DotRows, Avx2DotCols>(dotKernelAvx2, m, n, k, alpha, a, lda, 
+                                                      b, ldb, c, ldc);
+                return;
+            default:
+                break;
+        }
+#endif
+        dotProducts<DefaultDotRows, DefaultDotCols>(dotKernelDefault, m, n, k, alpha, a, lda,
+                                                    b, ldb, c, ldc);
+        return;
+    }
+
+    // Use the microkernel of the active SIMD level.
+#ifdef ML_X86_KERNELS
+    switch (simdLevel())
+    {
+        case SimdLevel::Avx512:
+            blocked<Avx512MR, Avx512NR>(microKernelAvx512, m, n, k, alpha, opA, opB, c, ldc);
+            return;
+        case SimdLevel::Avx2:
+            blocked<Avx2MR, Avx2NR>(microKernelAvx2, m, n, k, alpha, opA, opB, c, ldc);
+            return;
+        default:
+            break;
+    }
+#endif
+    blocked<DefaultMR, DefaultNR>(microKernelDefault, m, n, k, alpha, opA, opB, c, ldc);
+}
+} // namespace ml::linalg
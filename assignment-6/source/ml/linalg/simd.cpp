@@ -0,0 +1,61 @@
+/**
+ * @brief Runtime detection of SIMD instruction sets implementation details.
+ */
+#include <atomic>
+
+#include "ml/linalg/simd.h"
+
+namespace ml::linalg
+{
+namespace
+{
+// -----------------------------------------------------------------------------
+std::atomic<SimdLevel>& activeLevel() noexcept
+{
+    // Detect the supported level the first time the active level is requested.
+    static std::atomic<SimdLevel> level{detectSimdLevel()};
+    return level;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+SimdLevel detectSimdLevel() noexcept
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    // Query CPUID via the compiler, which also checks that the OS saves the vector registers.
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) { return SimdLevel::Avx512; }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) { return SimdLevel::Avx2; }
+    if (__builtin_cpu_supports("sse2")) { return SimdLevel::Sse2; }
+#endif
+    return SimdLevel::Scalar;
+}
+
+// -----------------------------------------------------------------------------
+SimdLevel simdLevel() noexcept { return activeLevel().load(std::memory_order_relaxed); }
+
+// -----------------------------------------------------------------------------
+bool setSimdLevel(const SimdLevel level) noexcept
+{
+    // Return false if the level isn't supported.
+    if (detectSimdLevel() < level) { return false; }
+    activeLevel().store(level, std::memory_order_relaxed);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+const char* simdLevelName(const SimdLevel level) noexcept
+{
+    switch (level)
+    {
+        case SimdLevel::Sse2:
+            return "SSE2";
+        case SimdLevel::Avx2:
+            return "AVX2";
+        case SimdLevel::Avx512:
+            return "AVX-512";
+        default:
+            return "scalar";
+    }
+}
+} // namespace ml::linalg
@@ -0,0 +1,49 @@
+/**
+ * @brief Memory-mapped file implementation details.
+ */
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ml/memory/mapped_file.h"
+
+namespace ml::memory
+{
+// -----------------------------------------------------------------------------
+MappedFile::MappedFile(const std::string& path, const Access access)
+    : myData{nullptr}
+    , mySize{}
+    , myAccess{access}
+{
+    // Throw an exception if the file cannot be opened or is empty.
+    const int file{::open(path.c_str(), O_RDONLY)};
+    if (0 > file) { throw std::runtime_error("Cannot map file " + path + ": failed to open!"); }
+
+    struct stat status{};
+    if ((0 != ::fstat(file, &status)) || (0 >= status.st_size))
+    {
+        ::close(file);
+        throw std::runtime_error("Cannot map file " + path + ": the file is empty!");
+    }
+
+    // Map the file read-only or copy-on-write, the mapping stays valid after the file is
+    // closed.
+    mySize = static_cast<std::size_t>(status.st_size);
+    const int protection{Access::ReadOnly == access ? PROT_READ : PROT_READ | PROT_WRITE};
+    void* const data{::mmap(nullptr, mySize, protection, MAP_PRIVATE, file, 0)};
+    ::close(file);
+
+    if (MAP_FAILED == data)
+    {
+        throw std::runtime_error("Cannot map file " + path + ": failed to map!");
+    }
+    myData = static_cast<std::uint8_t*>(data);
+}
+
+// -----------------------------------------------------------------------------
+MappedFile::~MappedFile() noexcept { ::munmap(myData, mySize); }
+} // namespace ml::memory
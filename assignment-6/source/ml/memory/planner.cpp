@@ -0,0 +1,134 @@
+/**
+ * @brief Static memory planner implementation details.
+ */
+#include <algorithm>
+#include <iomanip>
+#include <numeric>
+#include <stdexcept>
+
+#include "ml/memory/planner.h"
+#include "ml/scalar.h"
+#include "ml/tensor.h"
+
+namespace ml::memory
+{
+namespace
+{
+/** Number of scalars per alignment unit of the tensor storage. */
+constexpr std::size_t AlignmentSize{Tensor::Alignment / sizeof(Scalar)};
+
+// -----------------------------------------------------------------------------
+constexpr std::size_t alignedSize(const std::size_t size) noexcept
+{
+    // Round the size up, so that the next buffer starts aligned.
+    return (size + AlignmentSize - 1U) / AlignmentSize * AlignmentSize;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+Planner::Planner() noexcept
+    : myBuffers{}
+    , myPeakSize{}
+{}
+
+// -----------------------------------------------------------------------------
+void Planner::clear() noexcept
+{
+    myBuffers.clear();
+    myPeakSize = 0U;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t Planner::add(const std::size_t size, const std::size_t first, const std::size_t last)
+{
+    // Throw an exception if the buffer is live for a negative number of steps.
+    if (last < first)
+    {
+        throw std::invalid_argument("Cannot add buffer: the last step precedes the first step!");
+    }
+    myBuffers.push_back(Entry{alignedSize(size), first, last, Unused});
+    return myBuffers.size() - 1U;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t Planner::addUnused()
+{
+    // Buffers without size are never placed.
+    myBuffers.push_back(Entry{0U, 0U, 0U, Unused});
+    return myBuffers.size() - 1U;
+}
+
+// -----------------------------------------------------------------------------
+void Planner::plan()
+{
+    // Place the largest buffers first, since they are the hardest to fit into gaps.
+    std::vector<std::size_t> order(myBuffers.size());
+    std::iota(order.begin(), order.end(), 0U);
+    std::stable_sort(order.begin(), order.end(), [&](const std::size_t a, const std::size_t b)
+    {
+        return myBuffers[a].size > myBuffers[b].size;
+    });
+
+    std::vector<const Entry*> overlapping{};
+    myPeakSize = 0U;
+
+    for (std::size_t i{}; i < order.size(); ++i)
+    {
+        Entry& buffer{myBuffers[order[i]]};
+        buffer.offset = Unused;
+        if (0U == buffer.size) { continue; }
+
+        // Collect the placed buffers that are live during any step of this buffer.
+        overlapping.clear();
+
+        for (std::size_t j{}; j < i; ++j)
+        {
+            const Entry& other{myBuffers[order[j]]};
+
+            if ((0U < other.size) && (other.first <= buffer.last) && (buffer.first <= other.last))
+            {
+                overlapping.push_back(&other);
+            }
+        }
+        std::sort(overlapping.begin(), overlapping.end(), [](const Entry* a, const Entry* b)
+        {
+            return a->offset < b->offset;
+        });
+
+        // Take the lowest gap between the overlapping buffers that fits, else the end.
+        std::size_t offset{};
+
+        for (const auto* other : overlapping)
+        {
+            if (offset + buffer.size <= other->offset) { break; }
+            offset = std::max(offset, other->offset + other->size);
+        }
+        buffer.offset = offset;
+        myPeakSize    = std::max(myPeakSize, offset + buffer.size);
+    }
+}
+
+// -----------------------------------------------------------------------------
+std::size_t Planner::offset(const std::size_t buffer) const noexcept
+{
+    return myBuffers[buffer].offset;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t Planner::totalSize() const noexcept
+{
+    std::size_t result{};
+    for (const auto& buffer : myBuffers) { result += buffer.size; }
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+void printReport(const Report& report, std::ostream& ostream) noexcept
+{
+    constexpr double kib{1024.0};
+    ostream << std::fixed << std::setprecision(1)
+            << "Inference arena:  " << report.inferenceBytes / kib << " KiB\n"
+            << "Training arena:   " << report.trainingBytes / kib << " KiB\n"
+            << "Without reuse:    " << report.totalBytes / kib << " KiB\n";
+}
+} // namespace ml::memory
@@ -0,0 +1,378 @@
+/**
+ * @brief Optimizer implementation details.
+ *
+ *        Each fused update loop exists in a default version and, on x86, in AVX2 and AVX-512
+ *        versions compiled via function target attributes, as the activation function
+ *        kernels. The version matching the active SIMD level (see ml/linalg/simd.h) is
+ *        selected when the optimizer is created.
+ */
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+
+#include "ml/linalg/simd.h"
+#include "ml/optimizer/optimizer.h"
+#include "ml/optimizer/type.h"
+#include "ml/parallel/thread_pool.h"
+#include "ml/scalar.h"
+#include "ml/tensor.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ML_X86_KERNELS
+#endif
+
+namespace ml::optimizer
+{
+namespace
+{
+/** Number of scalars per alignment unit of the tensor storage. */
+constexpr std::size_t AlignmentSize{Tensor::Alignment / sizeof(Scalar)};
+
+/** Approximate cost of updating a single parameter, in scalar operations. */
+constexpr std::size_t UpdateCost{8U};
+
+/** Shorthand for the update coefficients. */
+using Coefficients = Optimizer::Coefficients;
+
+// -----------------------------------------------------------------------------
+constexpr std::size_t alignedSize(const std::size_t size) noexcept
+{
+    // Round the size up, so that the moments of the next tensor start aligned.
+    return (size + AlignmentSize - 1U) / AlignmentSize * AlignmentSize;
+}
+
+// -----------------------------------------------------------------------------
+std::size_t storedSize(const Tensor& tensor) noexcept
+{
+    // Padded rows are updated including their padding, whose gradients are always zero.
+    if (tensor.empty()) { return 0U; }
+    return tensor.isContiguous() ? tensor.size() : tensor.dim(0U) * tensor.stride(0U);
+}
+
+// -----------------------------------------------------------------------------
+constexpr bool usesFirstMoment(const Type type) noexcept
+{
+    return (Type::Momentum == type) || (Type::Nesterov == type) || (Type::Adam == type)
+        || (Type::AdamW == type);
+}
+
+// -----------------------------------------------------------------------------
+constexpr bool usesSecondMoment(const Type type) noexcept
+{
+    return (Type::RmsProp == type) || (Type::Adam == type) || (Type::AdamW == type);
+}
+
+// -----------------------------------------------------------------------------
+Scalar rootOf(const Scalar x) noexcept
+{
+    // Vectorized as the math functions don't set errno (see the makefile).
+    return std::sqrt(x);
+}
+
+struct SgdOp
+{
+    static void update(const std::size_t i, const Coefficients& c, Scalar* p, const Scalar* g,
+                       Scalar*, Scalar*) noexcept
+    {
+        p[i] += c.learningRate * g[i];
+    }
+};
+
+struct MomentumOp
+{
+    static void update(const std::size_t i, const Coefficients& c, Scalar* p, const Scalar* g,
+                       Scalar* m, Scalar*) noexcept
+    {
+        m[i]  = c.beta1 * m[i] + g[i];
+        p[i] += c.learningRate * m[i];
+    }
+};
+
+struct NesterovOp
+{
+    static void update(const std::size_t i, const Coefficients& c, Scalar* p, const Scalar* g,
+                       Scalar* m, Scalar*) noexcept
+    {
+        // Step along the updated momentum, looking ahead by one more momentum step.
+        m[i]  = c.beta1 * m[i] + g[i];
+        p[i] += c.learningRate * (g[i] + c.beta1 * m[i]);
+    }
+};
+
+struct RmsPropOp
+{
+    static void update(const std::size_t i, const Coefficients& c, Scalar* p, const Scalar* g,
+                       Scalar*, Scalar* v) noexcept
+    {
+        v[i]  = c.beta2 * v[i] + (Scalar{1} - c.beta2) * g[i] * g[i];
+        p[i] += c.learningRate * g[i] / (rootOf(v[i]) + c.epsilon);
+    }
+};
+
+struct AdamOp
+{
+    static void update(const std::size_t i, const Coefficients& c, Scalar* p, const Scalar* g,
+                       Scalar* m, Scalar* v) noexcept
+    {
+        // The bias corrections are folded into the coefficients.
+        m[i]  = c.beta1 * m[i] + (Scalar{1} - c.beta1) * g[i];
+        v[i]  = c.beta2 * v[i] + (Scalar{1} - c.beta2) * g[i] * g[i];
+        p[i] += c.firstScale * m[i] / (rootOf(v[i]) * c.secondScale + c.epsilon);
+    }
+};
+
+struct AdamWOp
+{
+    static void update(const std::size_t i, const Coefficients& c, Scalar* p, const Scalar* g,
+                       Scalar* m, Scalar* v) noexcept
+    {
+        p[i] *= c.decay;
+        AdamOp::update(i, c, p, g, m, v);
+    }
+};
+
+/**
+ * @brief Define the fused update loop with given name suffix and attributes.
+ */
+#define ML_OPTIMIZER_LOOPS(suffix, attributes)                                                 \
+    template <typename Op>                                                                     \
+    attributes void update##suffix(const std::size_t n, const Coefficients& c, Scalar* p,      \
+                                   const Scalar* g, Scalar* m, Scalar* v) noexcept             \
+    {                                                                                          \
+        const Coefficients coefficients{c};                                                    \
+        for (std::size_t i{}; i < n; ++i) { Op::update(i, coefficients, p, g, m, v); }         \
+    }
+
+ML_OPTIMIZER_LOOPS(Default, )
+
+#ifdef ML_X86_KERNELS
+ML_OPTIMIZER_LOOPS(Avx2, __attribute__((target("avx2,fma"))))
+ML_OPTIMIZER_LOOPS(Avx512, __attribute__((target("avx512f"))))
+#endif
+
+#undef ML_OPTIMIZER_LOOPS
+
+// -----------------------------------------------------------------------------
+template <typename Op>
+Optimizer::Kernel select() noexcept
+{
+#ifdef ML_X86_KERNELS
+    switch (linalg::simdLevel())
+    {
+        case linalg::SimdLevel::Avx512:
+            return &updateAvx512<Op>;
+        case linalg::SimdLevel::Avx2:
+            return &updateAvx2<Op>;
+        default:
+            break;
+    }
+#endif
+    return &updateDefault<Op>;
+}
+
+// -----------------------------------------------------------------------------
+Optimizer::Kernel kernel(const Type type) noexcept
+{
+    // Select the fused update loop corresponding to the optimizer type.
+    switch (type)
+    {
+        case Type::Momentum:
+            return select<MomentumOp>();
+        case Type::Nesterov:
+            return select<NesterovOp>();
+        case Type::RmsProp:
+            return select<RmsPropOp>();
+        case Type::Adam:
+            return select<AdamOp>();
+        case Type::AdamW:
+            return select<AdamWOp>();
+        default:
+            return select<SgdOp>();
+    }
+}
+
+// -----------------------------------------------------------------------------
+bool isValid(const Config& config) noexcept
+{
+    return (Type::AdamW >= config.type) && (0.0 <= config.beta1) && (1.0 > config.beta1)
+        && (0.0 <= config.beta2) && (1.0 > config.beta2) && (0.0 < config.epsilon)
+        && (0.0 <= config.weightDecay);
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+Optimizer::Optimizer(const Config& config)
+    : myConfig{config}
+    , myKernel{kernel(config.type)}
+    , myEntries{}
+    , myState{}
+    , myRegionSize{}
+    , myStepCount{}
+{
+    // Throw an exception if any hyperparameter is out of range.
+    if (!isValid(config))
+    {
+        throw std::invalid_argument("Failed to create optimizer: invalid type or "
+                                    "hyperparameter!");
+    }
+}
+
+// -----------------------------------------------------------------------------
+bool Optimizer::step(TensorList& parameters, const TensorList& gradients,
+                     const double learningRate) noexcept
+{
+    // Return false if the learning rate is invalid.
+    if ((0.0 >= learningRate) || (1.0 < learningRate))
+    {
+        std::cerr << "Failed to optimize: invalid learning rate " << learningRate << "!\n";
+        return false;
+    }
+
+    // Bind the state to the parameters unless already bound, return false on mismatch.
+    if (!isBound(parameters, gradients) && !bind(parameters, gradients)) { return false; }
+
+    // Update each parameter tensor in one fused pass, split across the thread pool.
+    ++myStepCount;
+    const Coefficients c{coefficients(learningRate)};
+    const bool first{usesFirstMoment(myConfig.type)};
+    const bool second{usesSecondMoment(myConfig.type)};
+
+    for (const auto& entry : myEntries)
+    {
+        Scalar* const m{first ? myState.data() + entry.offset : nullptr};
+        Scalar* const v{second
+            ? myState.data() + (first ? myRegionSize : 0U) + entry.offset : nullptr};
+
+        parallel::parallelFor(entry.size, UpdateCost,
+                              [&](const std::size_t begin, const std::size_t end)
+        {
+            myKernel(end - begin, c, entry.parameters + begin, entry.gradients + begin,
+                     nullptr == m ? nullptr : m + begin, nullptr == v ? nullptr : v + begin);
+        });
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+void Optimizer::reset() noexcept
+{
+    myState.zero();
+    myStepCount = 0U;
+}
+
+// -----------------------------------------------------------------------------
+bool Optimizer::copyState(const Optimizer& source, TensorList& parameters,
+                          const TensorList& gradients) noexcept
+{
+    // Return false unless the optimizers are of the same type.
+    if (source.myConfig.type != myConfig.type) { return false; }
+
+    // Bind the state to the parameters, return false unless the layout matches the source.
+    if (!bind(parameters, gradients)) { return false; }
+
+    bool matches{(myEntries.size() == source.myEntries.size())
+        && (myRegionSize == source.myRegionSize)};
+    for (std::size_t i{}; matches && (i < myEntries.size()); ++i)
+    {
+        matches = myEntries[i].size == source.myEntries[i].size;
+    }
+    if (!matches)
+    {
+        myEntries.clear();
+        return false;
+    }
+
+    // Copy the moments and the step count.
+    myState.copyFrom(source.myState);
+    myStepCount = source.myStepCount;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool Optimizer::bind(TensorList& parameters, const TensorList& gradients) noexcept
+{
+    // Return false unless every parameter tensor has a gradient tensor of the same layout.
+    myEntries.clear();
+    if (parameters.size() != gradients.size()) { return false; }
+    std::size_t offset{};
+
+    try { myEntries.reserve(parameters.size()); }
+    catch (const std::bad_alloc&) { return false; }
+
+    for (std::size_t i{}; i < parameters.size(); ++i)
+    {
+        Tensor& parameter{parameters[i]};
+        const Tensor& gradient{gradients[i]};
+
+        if (!parameter.sameShape(gradient)
+            || (parameter.isContiguous() != gradient.isContiguous())
+            || (!parameter.isContiguous() && (parameter.stride(0U) != gradient.stride(0U))))
+        {
+            std::cerr << "Failed to optimize: the gradients don't match the parameters!\n";
+            myEntries.clear();
+            return false;
+        }
+        const std::size_t size{storedSize(parameter)};
+        myEntries.push_back(Entry{parameter.data(), gradient.data(), size, offset});
+        offset += alignedSize(size);
+    }
+
+    // Allocate the moments, starting from zero, return false if the memory cannot be allocated.
+    const std::size_t regionCount{std::size_t{usesFirstMoment(myConfig.type)}
+        + std::size_t{usesSecondMoment(myConfig.type)}};
+    myRegionSize = offset;
+    myStepCount  = 0U;
+
+    try { myState = 0U < regionCount * offset ? Tensor{regionCount * offset} : Tensor{}; }
+    catch (const std::bad_alloc&)
+    {
+        std::cerr << "Failed to allocate " << regionCount * offset * sizeof(Scalar)
+                  << " bytes for the optimizer state!\n";
+        myEntries.clear();
+        return false;
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool Optimizer::isBound(const TensorList& parameters,
+                        const TensorList& gradients) const noexcept
+{
+    // The state is bound if the tensors are the same as in the previous step.
+    if ((parameters.size() != myEntries.size()) || (gradients.size() != myEntries.size()))
+    {
+        return false;
+    }
+    for (std::size_t i{}; i < myEntries.size(); ++i)
+    {
+        const Entry& entry{myEntries[i]};
+
+        if ((entry.parameters != parameters[i].data()) || (entry.gradients != gradients[i].data())
+            || (entry.size != storedSize(parameters[i])))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+Optimizer::Coefficients Optimizer::coefficients(const double learningRate) const noexcept
+{
+    // Fold the bias corrections of Adam into the coefficients, i.e. the first moment is
+    // divided by 1 - beta1^t and the second moment by 1 - beta2^t.
+    const double steps{static_cast<double>(myStepCount)};
+    const double firstCorrection{1.0 - std::pow(myConfig.beta1, steps)};
+    const double secondCorrection{1.0 - std::pow(myConfig.beta2, steps)};
+
+    return Coefficients{static_cast<Scalar>(learningRate),
+                        static_cast<Scalar>(myConfig.beta1),
+                        static_cast<Scalar>(myConfig.beta2),
+                        static_cast<Scalar>(myConfig.epsilon),
+                        static_cast<Scalar>(learningRate / firstCorrection),
+                        static_cast<Scalar>(1.0 / std::sqrt(secondCorrection)),
+                        static_cast<Scalar>(1.0 - learningRate * myConfig.weightDecay)};
+}
+} // namespace ml::optimizer
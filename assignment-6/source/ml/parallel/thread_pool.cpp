@@ -0,0 +1,208 @@
+/**
+ * @brief Work-stealing thread pool implementation details.
+ */
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include "ml/parallel/thread_pool.h"
+
+namespace ml::parallel
+{
+// -----------------------------------------------------------------------------
+struct ThreadPool::Job
+{
+    /** Context passed to the invoker (the loop body). */
+    const void* context;
+
+    /** Function running the loop body over a range. */
+    Invoker invoker;
+
+    /** Number of chunks not yet done. */
+    std::atomic<std::size_t> remaining;
+};
+
+// -----------------------------------------------------------------------------
+struct ThreadPool::Task
+{
+    /** The job the task belongs to. */
+    Job* job;
+
+    /** First index of the chunk. */
+    std::size_t begin;
+
+    /** Last index of the chunk (exclusive). */
+    std::size_t end;
+};
+
+// -----------------------------------------------------------------------------
+struct ThreadPool::Queue
+{
+    /** Mutex protecting the tasks. */
+    std::mutex mutex;
+
+    /** Queued tasks, the owner pops from the front and thieves from the back. */
+    std::deque<Task> tasks;
+};
+
+// -----------------------------------------------------------------------------
+ThreadPool& ThreadPool::getInstance() noexcept
+{
+    // Create and initialize singleton thread pool instance (once only).
+    static ThreadPool myInstance{};
+
+    // Return a reference to the thread pool.
+    return myInstance;
+}
+
+// -----------------------------------------------------------------------------
+void ThreadPool::setThreadCount(const std::size_t threadCount)
+{
+    // Throw an exception if the thread count is invalid.
+    if (0U == threadCount)
+    {
+        throw std::invalid_argument("Cannot set thread count: the thread count cannot be 0!");
+    }
+    if (this->threadCount() == threadCount) { return; }
+
+    // Stop the current workers, then start one worker per thread except the caller.
+    stop();
+    myQueues.clear();
+    myStopped = false;
+
+    for (std::size_t i{1U}; i < threadCount; ++i)
+    {
+        myQueues.push_back(std::make_unique<Queue>());
+    }
+    for (std::size_t i{}; i < myQueues.size(); ++i)
+    {
+        myThreads.emplace_back(&ThreadPool::runWorker, this, i);
+    }
+}
+
+// -----------------------------------------------------------------------------
+void ThreadPool::setGrainSize(const std::size_t grainSize)
+{
+    // Throw an exception if the grain size is invalid.
+    if (0U == grainSize)
+    {
+        throw std::invalid_argument("Cannot set grain size: the grain size cannot be 0!");
+    }
+    myGrainSize = grainSize;
+}
+
+// -----------------------------------------------------------------------------
+ThreadPool::ThreadPool() noexcept
+    : myQueues{}
+    , myThreads{}
+    , myMutex{}
+    , myWakeup{}
+    , myQueuedCount{}
+    , myNextQueue{}
+    , myGrainSize{DefaultGrainSize}
+    , myStopped{false}
+{}
+
+// -----------------------------------------------------------------------------
+ThreadPool::~ThreadPool() noexcept { stop(); }
+
+// -----------------------------------------------------------------------------
+std::size_t ThreadPool::chunkSize(const std::size_t count,
+                                  const std::size_t itemCost) const noexcept
+{
+    // Use a single chunk if there are no workers or the loop is too small to split.
+    const std::size_t cost{count * std::max<std::size_t>(itemCost, 1U)};
+    if (myQueues.empty() || (2U * myGrainSize > cost)) { return count; }
+
+    // Split into chunks of at least the grain size, a few per thread for load balance.
+    constexpr std::size_t chunksPerThread{4U};
+    const std::size_t chunkCount{
+        std::min({count, cost / myGrainSize, chunksPerThread * threadCount()})};
+    return (count + chunkCount - 1U) / chunkCount;
+}
+
+// -----------------------------------------------------------------------------
+void ThreadPool::run(const std::size_t count, const std::size_t chunkSize,
+                     const void* context, const Invoker invoker) noexcept
+{
+    const std::size_t chunkCount{(count + chunkSize - 1U) / chunkSize};
+    Job job{context, invoker, {chunkCount}};
+
+    // Keep the first chunk for the calling thread, distribute the others round-robin.
+    const std::size_t first{myNextQueue.fetch_add(chunkCount - 1U)};
+
+    for (std::size_t c{1U}; c < chunkCount; ++c)
+    {
+        Queue& queue{*myQueues[(first + c) % myQueues.size()]};
+        const std::lock_guard<std::mutex> lock{queue.mutex};
+        queue.tasks.push_back(Task{&job, c * chunkSize, std::min(count, (c + 1U) * chunkSize)});
+    }
+    {
+        const std::lock_guard<std::mutex> lock{myMutex};
+        myQueuedCount += chunkCount - 1U;
+    }
+    myWakeup.notify_all();
+
+    // Run the first chunk, then help with the queued chunks until the job is done.
+    invoker(context, 0U, chunkSize);
+    job.remaining.fetch_sub(1U, std::memory_order_release);
+
+    while (0U < job.remaining.load(std::memory_order_acquire))
+    {
+        if (!runTask(first)) { std::this_thread::yield(); }
+    }
+}
+
+// -----------------------------------------------------------------------------
+bool ThreadPool::runTask(const std::size_t first) noexcept
+{
+    // Pop a task from the front of the first queue, else steal one from the back of another.
+    for (std::size_t i{}; i < myQueues.size(); ++i)
+    {
+        Queue& queue{*myQueues[(first + i) % myQueues.size()]};
+        std::unique_lock<std::mutex> lock{queue.mutex};
+        if (queue.tasks.empty()) { continue; }
+
+        const Task task{0U == i ? queue.tasks.front() : queue.tasks.back()};
+        if (0U == i) { queue.tasks.pop_front(); } else { queue.tasks.pop_back(); }
+        lock.unlock();
+        myQueuedCount.fetch_sub(1U);
+
+        // Run the task; the job may end as soon as the last chunk is marked as done.
+        task.job->invoker(task.job->context, task.begin, task.end);
+        task.job->remaining.fetch_sub(1U, std::memory_order_release);
+        return true;
+    }
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+void ThreadPool::runWorker(const std::size_t index) noexcept
+{
+    while (true)
+    {
+        if (runTask(index)) { continue; }
+
+        // Sleep until tasks are queued or the pool is stopped.
+        std::unique_lock<std::mutex> lock{myMutex};
+        myWakeup.wait(lock, [this]{ return myStopped || (0U < myQueuedCount.load()); });
+        if (myStopped) { return; }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void ThreadPool::stop() noexcept
+{
+    {
+        const std::lock_guard<std::mutex> lock{myMutex};
+        myStopped = true;
+    }
+    myWakeup.notify_all();
+
+    for (auto& thread : myThreads) { thread.join(); }
+    myThreads.clear();
+}
+} // namespace ml::parallel
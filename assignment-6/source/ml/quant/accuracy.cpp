@@ -0,0 +1,89 @@
+/**
+ * @brief Accuracy comparison implementation details.
+ */
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <stdexcept>
+
+#include "ml/cnn/interface.h"
+#include "ml/quant/accuracy.h"
+#include "ml/tensor.h"
+
+namespace ml::quant
+{
+namespace
+{
+// -----------------------------------------------------------------------------
+std::size_t predictedClass(const Tensor& output) noexcept
+{
+    // Classify single outputs by threshold, else pick the index of the largest output.
+    if (1U == output.size()) { return Scalar{0.5} < output(0U) ? 1U : 0U; }
+    std::size_t result{};
+
+    for (std::size_t i{1U}; i < output.size(); ++i)
+    {
+        if (output(result) < output(i)) { result = i; }
+    }
+    return result;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+AccuracyReport compareAccuracy(cnn::Interface& reference, cnn::Interface& candidate,
+                               const Tensor& inputs)
+{
+    // Check the models and the inputs, throw an exception if they don't match.
+    if ((reference.inputSize() != candidate.inputSize())
+        || (reference.outputSize() != candidate.outputSize()))
+    {
+        throw std::invalid_argument("Cannot compare accuracy: model size mismatch!");
+    }
+    else if ((3U != inputs.rank()) || (0U == inputs.dim(0U))
+             || (reference.inputSize() != inputs.dim(1U))
+             || (reference.inputSize() != inputs.dim(2U)))
+    {
+        throw std::invalid_argument("Cannot compare accuracy: invalid input dimensions!");
+    }
+
+    AccuracyReport report{inputs.dim(0U), 0.0, 0.0, 0.0, 0.0};
+    std::size_t agreementCount{};
+    double squareSum{};
+
+    for (std::size_t i{}; i < inputs.dim(0U); ++i)
+    {
+        // Copy the reference output, since the models may share nothing but the interface.
+        const Tensor input{inputs.slice(i)};
+        const Tensor expected{reference.predict(input)};
+        const Tensor& actual{candidate.predict(input)};
+
+        for (std::size_t j{}; j < expected.size(); ++j)
+        {
+            const double error{std::abs(static_cast<double>(actual(j) - expected(j)))};
+            report.maxAbsError = std::max(report.maxAbsError, error);
+            report.meanAbsError += error;
+            squareSum += error * error;
+        }
+        if (predictedClass(expected) == predictedClass(actual)) { ++agreementCount; }
+    }
+
+    // Turn the sums into averages.
+    const double valueCount{static_cast<double>(inputs.dim(0U) * reference.outputSize())};
+    report.meanAbsError /= valueCount;
+    report.rmsError      = std::sqrt(squareSum / valueCount);
+    report.top1Agreement = static_cast<double>(agreementCount) / inputs.dim(0U);
+    return report;
+}
+
+// -----------------------------------------------------------------------------
+void printReport(const AccuracyReport& report, std::ostream& ostream) noexcept
+{
+    ostream << std::scientific << std::setprecision(3)
+            << "Samples:          " << report.sampleCount << "\n"
+            << "Max abs error:    " << report.maxAbsError << "\n"
+            << "Mean abs error:   " << report.meanAbsError << "\n"
+            << "RMS error:        " << report.rmsError << "\n"
+            << std::fixed << std::setprecision(2)
+            << "Top-1 agreement:  " << 100.0 * report.top1Agreement << " %\n";
+}
+} // namespace ml::quant
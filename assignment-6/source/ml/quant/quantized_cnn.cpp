@@ -0,0 +1,564 @@
+/**
+ * @brief INT8 post-training quantized CNN (Convolutional Neural Network) implementation details.
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "ml/act_func/interface.h"
+#include "ml/act_func/type.h"
+#include "ml/cnn/cnn.h"
+#include "ml/conv_layer/interface.h"
+#include "ml/conv_layer/type.h"
+#include "ml/dense_layer/interface.h"
+#include "ml/factory/factory.h"
+#include "ml/linalg/blas.h"
+#include "ml/quant/quantized_cnn.h"
+#include "ml/tensor.h"
+#include "ml/types.h"
+
+namespace ml::quant
+{
+namespace
+{
+/** Range of the int8 values. */
+constexpr std::int32_t Int8Min{-128};
+constexpr std::int32_t Int8Max{127};
+
+/** Largest magnitude of the symmetrically quantized weights (-128 is left unused). */
+constexpr double WeightMax{127.0};
+
+/** Pre-activation values of tanh are clipped here, tanh(4) is within 7e-4 of 1. */
+constexpr double TanhSaturation{4.0};
+
+/**
+ * @brief Range of values observed during calibration.
+ */
+struct Range
+{
+    double min{std::numeric_limits<double>::max()};
+    double max{std::numeric_limits<double>::lowest()};
+
+    void update(const Scalar* data, const std::size_t size) noexcept
+    {
+        for (std::size_t i{}; i < size; ++i)
+        {
+            min = std::min(min, static_cast<double>(data[i]));
+            max = std::max(max, static_cast<double>(data[i]));
+        }
+    }
+};
+
+// -----------------------------------------------------------------------------
+std::int32_t clampInt8(const std::int32_t value) noexcept
+{
+    return std::clamp(value, Int8Min, Int8Max);
+}
+
+// -----------------------------------------------------------------------------
+std::int32_t toInt32(const double value) noexcept
+{
+    // Saturate instead of overflowing if the value doesn't fit.
+    constexpr double min{static_cast<double>(std::numeric_limits<std::int32_t>::min())};
+    constexpr double max{static_cast<double>(std::numeric_limits<std::int32_t>::max())};
+    return static_cast<std::int32_t>(std::clamp(std::round(value), min, max));
+}
+
+// -----------------------------------------------------------------------------
+std::int8_t quantize(const double value, const QuantParams& params) noexcept
+{
+    // Shift the value into [0, 256), where truncation rounds to nearest without a call to
+    // std::round (which isn't inlined without SSE4.1).
+    const double shifted{value / params.scale + (params.zeroPoint - Int8Min) + 0.5};
+    const auto q{static_cast<std::int32_t>(std::clamp(shifted, 0.0, Int8Max - Int8Min + 0.5))};
+    return static_cast<std::int8_t>(q + Int8Min);
+}
+
+// -----------------------------------------------------------------------------
+void quantize(const Scalar* values, const std::size_t size, const QuantParams& params,
+              std::int8_t* result) noexcept
+{
+    // Same as above, but with the division replaced by a multiplication to allow vectorization.
+    const double inverseScale{1.0 / params.scale};
+    const double offset{params.zeroPoint - Int8Min + 0.5};
+    constexpr double max{Int8Max - Int8Min + 0.5};
+
+    for (std::size_t i{}; i < size; ++i)
+    {
+        const double shifted{std::clamp(values[i] * inverseScale + offset, 0.0, max)};
+        result[i] = static_cast<std::int8_t>(static_cast<std::int32_t>(shifted) + Int8Min);
+    }
+}
+
+// -----------------------------------------------------------------------------
+double dequantize(const std::int32_t value, const QuantParams& params) noexcept
+{
+    return params.scale * (value - params.zeroPoint);
+}
+
+// -----------------------------------------------------------------------------
+QuantParams activationParams(const Range& range) noexcept
+{
+    // Always include 0 in the range, so that it (and hence the padding) is exact.
+    const double min{std::min(range.min, 0.0)};
+    const double max{std::max(range.max, 0.0)};
+
+    // Map [min, max] onto [-128, 127]; use unit scale for an all-zero range.
+    const double scale{min < max ? (max - min) / (Int8Max - Int8Min) : 1.0};
+    const auto zeroPoint{static_cast<std::int32_t>(std::round(Int8Min - min / scale))};
+    return QuantParams{scale, clampInt8(zeroPoint)};
+}
+
+// -----------------------------------------------------------------------------
+Range preActivationRange(const act_func::Type actFunc, const Range& range) noexcept
+{
+    // Negative ReLU inputs all map to 0, so they can saturate at the bottom of the range.
+    // Tanh and sigmoid (a scaled tanh of x / 2) saturate too, so there is no point in 
+    // resolving inputs far from 0.
+    switch (actFunc)
+    {
+        case act_func::Type::Relu:
+            return Range{0.0, range.max};
+        case act_func::Type::Tanh:
+            return Range{std::max(range.min, -TanhSaturation), std::min(range.max, TanhSaturation)};
+        case act_func::Type::Sigmoid:
+            return Range{std::max(range.min, -2.0 * TanhSaturation), 
+                         std::min(range.max, 2.0 * TanhSaturation)};
+        default:
+            return range;
+    }
+}
+
+// -----------------------------------------------------------------------------
+Multiplier toMultiplier(const double multiplier)
+{
+    // Split the multiplier into a fraction in [0.5, 1) and a power of two, then store the
+    // fraction in Q31 format.
+    if (0.0 >= multiplier) { return Multiplier{0, 1}; }
+    int exponent{};
+    const double fraction{std::frexp(multiplier, &exponent)};
+    auto mantissa{static_cast<std::int64_t>(std::round(fraction * (std::int64_t{1} << 31)))};
+
+    // Rounding may carry into bit 31.
+    if ((std::int64_t{1} << 31) == mantissa)
+    {
+        mantissa /= 2;
+        ++exponent;
+    }
+    const int shift{31 - exponent};
+
+    if (1 > shift)
+    {
+        throw std::invalid_argument(
+            "Cannot quantize CNN: requantization multiplier out of range!");
+    }
+    // Multipliers below 2^-31 round to 0.
+    if (62 < shift) { return Multiplier{0, 1}; }
+    return Multiplier{static_cast<std::int32_t>(mantissa), shift};
+}
+
+// -----------------------------------------------------------------------------
+std::int32_t requantize(const std::int32_t accumulator, const Multiplier& multiplier,
+                        const std::int32_t zeroPoint) noexcept
+{
+    // Compute round(accumulator * multiplier) + zero point in 64-bit integer arithmetic.
+    const std::int64_t product{std::int64_t{accumulator} * multiplier.mantissa};
+    const std::int64_t rounding{std::int64_t{1} << (multiplier.shift - 1)};
+    const auto scaled{static_cast<std::int32_t>((product + rounding) >> multiplier.shift)};
+    return clampInt8(zeroPoint + scaled);
+}
+
+// -----------------------------------------------------------------------------
+double weightScale(const Scalar* weights, const std::size_t size) noexcept
+{
+    // Map the largest magnitude onto 127, use unit scale for all-zero weights.
+    Scalar maxAbs{};
+    for (std::size_t i{}; i < size; ++i) { maxAbs = std::max(maxAbs, std::abs(weights[i])); }
+    return Scalar{} < maxAbs ? maxAbs / WeightMax : 1.0;
+}
+
+// -----------------------------------------------------------------------------
+std::int32_t quantizeWeights(const Scalar* weights, const std::size_t size, const double scale,
+                             std::int8_t* result) noexcept
+{
+    // Quantize the weights symmetrically, return their sum for the zero point correction.
+    std::int32_t sum{};
+
+    for (std::size_t i{}; i < size; ++i)
+    {
+        const double q{std::clamp(std::round(weights[i] / scale), -WeightMax, WeightMax)};
+        result[i] = static_cast<std::int8_t>(q);
+        sum += result[i];
+    }
+    return sum;
+}
+
+// -----------------------------------------------------------------------------
+void convolve(const Tensor& input, const Tensor& kernel, const Scalar bias,
+              Tensor& output) noexcept
+{
+    // Compute the pre-activation values of a conv layer (same padding as the layer).
+    const std::size_t size{input.dim(0U)};
+    const std::size_t kernelSize{kernel.dim(0U)};
+    const std::size_t padOffset{kernelSize / 2U};
+
+    for (std::size_t i{}; i < size; ++i)
+    {
+        for (std::size_t j{}; j < size; ++j)
+        {
+            Scalar sum{bias};
+
+            for (std::size_t ki{}; ki < kernelSize; ++ki)
+            {
+                for (std::size_t kj{}; kj < kernelSize; ++kj)
+                {
+                    // Indices in the padding wrap around and end up out of range.
+                    const std::size_t row{i + ki - padOffset};
+                    const std::size_t col{j + kj - padOffset};
+                    if ((row < size) && (col < size)) { sum += input(row, col) * kernel(ki, kj); }
+                }
+            }
+            output(i, j) = sum;
+        }
+    }
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+QuantizedCnn::QuantizedCnn(cnn::Cnn& cnn, const Tensor& calibrationSet)
+    : myStages{}
+    , myInputParams{}
+    , myActivations{}
+    , myPaddedInput{}
+    , myAccumulators{}
+    , myOutput{}
+    , myInputSize{cnn.inputSize()}
+{
+    // Check the calibration set, throw an exception if invalid.
+    if ((3U != calibrationSet.rank()) || (0U == calibrationSet.dim(0U))
+        || (myInputSize != calibrationSet.dim(1U)) || (myInputSize != calibrationSet.dim(2U)))
+    {
+        throw std::invalid_argument("Cannot quantize CNN: invalid calibration set dimensions!");
+    }
+
+    const ConvLayerList& convLayers{cnn.convLayers()};
+    const DenseLayerList& denseLayers{cnn.denseLayers()};
+
+    // Throw an exception if the network has multi-channel layers, which aren't supported.
+    for (auto& layer : convLayers)
+    {
+        if (conv_layer::Type::MultiChannel == layer->type())
+        {
+            throw std::invalid_argument(
+                "Cannot quantize CNN: multi-channel layers are not supported!");
+        }
+    }
+    const std::size_t layerCount{convLayers.size() + denseLayers.size()};
+
+    // Get views of the parameters of each layer.
+    std::vector<TensorList> parameters{};
+    parameters.reserve(layerCount);
+    for (auto& layer : convLayers) { parameters.push_back(layer->parameters()); }
+    for (auto& layer : denseLayers) { parameters.push_back(layer->parameters()); }
+
+    // Run the calibration set through the network, record the value ranges of each layer.
+    Range inputRange{};
+    std::vector<Range> preActRanges(layerCount);
+    std::vector<Range> outputRanges(layerCount);
+    TensorList preAct{};
+
+    for (auto& layer : convLayers)
+    {
+        preAct.push_back(Tensor{layer->outputSize(), layer->outputSize()});
+    }
+    for (auto& layer : denseLayers) { preAct.push_back(Tensor{layer->outputSize()}); }
+
+    for (std::size_t s{}; s < calibrationSet.dim(0U); ++s)
+    {
+        // Run a regular feedforward, since prediction doesn't store the pre-pool outputs.
+        const Tensor input{calibrationSet.slice(s)};
+        cnn.feedforward(input);
+        inputRange.update(input.data(), input.size());
+        const Tensor* layerInput{&input};
+
+        for (std::size_t i{}; i < convLayers.size(); ++i)
+        {
+            const auto& layer{*convLayers[i]};
+
+            if (conv_layer::Type::Conv == layer.type())
+            {
+                convolve(*layerInput, parameters[i][0U], parameters[i][1U](0U), preAct[i]);
+                preActRanges[i].update(preAct[i].data(), preAct[i].size());
+            }
+            outputRanges[i].update(layer.output().data(), layer.output().size());
+            layerInput = &layer.output();
+        }
+        // The flattened output of the conv layers is the row-major output of the last one.
+        for (std::size_t j{}; j < denseLayers.size(); ++j)
+        {
+            const std::size_t i{convLayers.size() + j};
+            const Tensor& weights{parameters[i][0U]};
+            preAct[i].copyFrom(parameters[i][1U]);
+            linalg::gemv(linalg::Transpose::No, weights.dim(0U), weights.dim(1U), weights.data(),
+                         weights.stride(0U), layerInput->data(), preAct[i].data());
+            preActRanges[i].update(preAct[i].data(), preAct[i].size());
+            const Tensor& output{denseLayers[j]->output()};
+            outputRanges[i].update(output.data(), output.size());
+            layerInput = &output;
+        }
+    }
+
+    // Quantize the layers one by one, each taking the output parameters of the previous one.
+    factory::Factory factory{};
+    myInputParams = activationParams(inputRange);
+    QuantParams inputParams{myInputParams};
+    std::size_t maxActivationSize{myInputSize * myInputSize};
+    std::size_t maxPaddedSize{};
+    std::size_t maxAccumulatorSize{};
+
+    // Build the activation lookup table of given stage.
+    const auto setActFunc{[&](Stage& stage, const act_func::Type type, const std::size_t i)
+    {
+        const QuantParams preActParams{activationParams(preActivationRange(type, preActRanges[i]))};
+        const auto actFunc{factory.actFunc(type)};
+        stage.preActZeroPoint = preActParams.zeroPoint;
+        stage.output          = activationParams(outputRanges[i]);
+
+        for (std::int32_t q{Int8Min}; q <= Int8Max; ++q)
+        {
+            const auto preActVal{static_cast<Scalar>(dequantize(q, preActParams))};
+            stage.actFunc[q - Int8Min] = quantize(actFunc->output(preActVal), stage.output);
+        }
+        return preActParams;
+    }};
+
+    for (std::size_t i{}; i < convLayers.size(); ++i)
+    {
+        auto& layer{*convLayers[i]};
+        Stage stage{};
+        stage.inputSize      = layer.inputSize();
+        stage.outputSize     = layer.outputSize();
+        stage.kernelSize     = layer.kernelSize();
+        stage.inputZeroPoint = inputParams.zeroPoint;
+
+        if (conv_layer::Type::MaxPool == layer.type())
+        {
+            // The max is unaffected by the (monotonic) quantization, so keep the parameters.
+            stage.type   = StageType::MaxPool;
+            stage.output = inputParams;
+        }
+        else
+        {
+            const Tensor& kernel{parameters[i][0U]};
+            const std::size_t kernelSize{stage.kernelSize};
+            const double scale{weightScale(kernel.data(), kernel.size())};
+            const double accScale{inputParams.scale * scale};
+
+            // Padding holds the input zero point, so the correction is the same everywhere.
+            stage.type = StageType::Conv;
+            stage.weights.resize(kernel.size());
+            const std::int32_t weightSum{quantizeWeights(kernel.data(), kernel.size(), scale,
+                                                         stage.weights.data())};
+            stage.bias = {toInt32(parameters[i][1U](0U) / accScale)
+                          - inputParams.zeroPoint * weightSum};
+
+            const QuantParams preActParams{setActFunc(stage, layer.actFunc(), i)};
+            stage.multipliers = {toMultiplier(accScale / preActParams.scale)};
+
+            const std::size_t paddedSize{stage.inputSize + kernelSize - 1U};
+            maxPaddedSize      = std::max(maxPaddedSize, paddedSize * paddedSize);
+            maxAccumulatorSize = std::max(maxAccumulatorSize, stage.outputSize * paddedSize);
+        }
+        inputParams       = stage.output;
+        maxActivationSize = std::max(maxActivationSize, stage.outputSize * stage.outputSize);
+        myStages.push_back(std::move(stage));
+    }
+
+    for (std::size_t j{}; j < denseLayers.size(); ++j)
+    {
+        const std::size_t i{convLayers.size() + j};
+        const Tensor& weights{parameters[i][0U]};
+        const Tensor& bias{parameters[i][1U]};
+        Stage stage{};
+        stage.type           = StageType::Dense;
+        stage.inputSize      = weights.dim(1U);
+        stage.outputSize     = weights.dim(0U);
+        stage.inputZeroPoint = inputParams.zeroPoint;
+        stage.weights.resize(stage.outputSize * stage.inputSize);
+
+        const QuantParams preActParams{setActFunc(stage, denseLayers[j]->actFunc(), i)};
+
+        // Quantize each node separately, since the weight ranges of the nodes may differ a lot.
+        for (std::size_t node{}; node < stage.outputSize; ++node)
+        {
+            const double scale{weightScale(weights.row(node), stage.inputSize)};
+            const double accScale{inputParams.scale * scale};
+            const std::int32_t weightSum{quantizeWeights(weights.row(node), stage.inputSize, scale,
+                                         stage.weights.data() + node * stage.inputSize)};
+            const std::int32_t nodeBias{toInt32(bias(node) / accScale)};
+            stage.bias.push_back(nodeBias - inputParams.zeroPoint * weightSum);
+            stage.multipliers.push_back(toMultiplier(accScale / preActParams.scale));
+        }
+        inputParams       = stage.output;
+        maxActivationSize = std::max(maxActivationSize, stage.outputSize);
+        myStages.push_back(std::move(stage));
+    }
+
+    // Allocate the buffers used during inference.
+    for (auto& buffer : myActivations) { buffer.resize(maxActivationSize); }
+    myPaddedInput.resize(maxPaddedSize);
+    myAccumulators.resize(maxAccumulatorSize);
+    myOutput = Tensor{cnn.outputSize()};
+}
+
+// -----------------------------------------------------------------------------
+QuantizedCnn::~QuantizedCnn() noexcept = default;
+
+// -----------------------------------------------------------------------------
+std::size_t QuantizedCnn::inputSize() const noexcept { return myInputSize; }
+
+// -----------------------------------------------------------------------------
+std::size_t QuantizedCnn::outputSize() const noexcept { return myOutput.size(); }
+
+// -----------------------------------------------------------------------------
+const Tensor& QuantizedCnn::predict(const Tensor& input) noexcept
+{
+    // Return the previous output on dimension mismatch.
+    if ((2U != input.rank()) || (myInputSize != input.dim(0U)) || (myInputSize != input.dim(1U)))
+    {
+        return myOutput;
+    }
+
+    // Quantize the input row by row (the elements of each row are contiguous).
+    for (std::size_t i{}; i < myInputSize; ++i)
+    {
+        quantize(input.row(i), myInputSize, myInputParams,
+                 myActivations[0U].data() + i * myInputSize);
+    }
+
+    // Run the layers, swapping the activation buffers in between.
+    std::size_t current{};
+
+    for (const auto& stage : myStages)
+    {
+        const std::int8_t* layerInput{myActivations[current].data()};
+        std::int8_t* layerOutput{myActivations[1U - current].data()};
+
+        switch (stage.type)
+        {
+            case StageType::Conv:
+                runConv(stage, layerInput, layerOutput);
+                break;
+            case StageType::MaxPool:
+                runMaxPool(stage, layerInput, layerOutput);
+                break;
+            case StageType::Dense:
+                runDense(stage, layerInput, layerOutput);
+                break;
+        }
+        current = 1U - current;
+    }
+
+    // Dequantize the output.
+    const QuantParams& outputParams{myStages.back().output};
+
+    for (std::size_t i{}; i < myOutput.size(); ++i)
+    {
+        myOutput(i) = static_cast<Scalar>(dequantize(myActivations[current][i], outputParams));
+    }
+    return myOutput;
+}
+
+// -----------------------------------------------------------------------------
+void QuantizedCnn::runConv(const Stage& stage, const std::int8_t* input,
+                           std::int8_t* output) noexcept
+{
+    const std::size_t size{stage.inputSize};
+    const std::size_t kernelSize{stage.kernelSize};
+    const std::size_t padOffset{kernelSize / 2U};
+    const std::size_t paddedSize{size + kernelSize - 1U};
+
+    // Pad the input with its zero point, i.e. the quantized value of 0.
+    std::int8_t* padded{myPaddedInput.data()};
+    const auto zeroPoint{static_cast<std::int8_t>(stage.inputZeroPoint)};
+    std::fill(padded, padded + paddedSize * paddedSize, zeroPoint);
+
+    for (std::size_t i{}; i < size; ++i)
+    {
+        std::memcpy(padded + (i + padOffset) * paddedSize + padOffset, input + i * size, size);
+    }
+
+    // Accumulate each kernel weight times the shifted padded input. The accumulators use the
+    // row stride of the padded input, so that each weight is handled by a single long axpy;
+    // the last kernelSize - 1 columns of each accumulator row are junk and never read.
+    std::int32_t* accumulators{myAccumulators.data()};
+    const std::size_t length{(size - 1U) * paddedSize + size};
+    std::fill(accumulators, accumulators + length, stage.bias[0U]);
+
+    for (std::size_t ki{}; ki < kernelSize; ++ki)
+    {
+        for (std::size_t kj{}; kj < kernelSize; ++kj)
+        {
+            const std::int8_t* source{padded + ki * paddedSize + kj};
+            linalg::axpy(length, stage.weights[ki * kernelSize + kj], source, accumulators);
+        }
+    }
+
+    // Requantize the sums, then apply the activation function.
+    for (std::size_t i{}; i < size; ++i)
+    {
+        for (std::size_t j{}; j < size; ++j)
+        {
+            const std::int32_t preAct{requantize(accumulators[i * paddedSize + j],
+                                                 stage.multipliers[0U], stage.preActZeroPoint)};
+            output[i * size + j] = stage.actFunc[preAct - Int8Min];
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void QuantizedCnn::runMaxPool(const Stage& stage, const std::int8_t* input,
+                              std::int8_t* output) const noexcept
+{
+    const std::size_t inputSize{stage.inputSize};
+    const std::size_t outputSize{stage.outputSize};
+    const std::size_t poolSize{stage.kernelSize};
+
+    // Find the max value of each pool.
+    for (std::size_t i{}; i < outputSize; ++i)
+    {
+        for (std::size_t j{}; j < outputSize; ++j)
+        {
+            const std::int8_t* pool{input + i * poolSize * inputSize + j * poolSize};
+            std::int8_t maxVal{pool[0U]};
+
+            for (std::size_t pi{}; pi < poolSize; ++pi)
+            {
+                for (std::size_t pj{}; pj < poolSize; ++pj)
+                {
+                    maxVal = std::max(maxVal, pool[pi * inputSize + pj]);
+                }
+            }
+            output[i * outputSize + j] = maxVal;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+void QuantizedCnn::runDense(const Stage& stage, const std::int8_t* input,
+                            std::int8_t* output) noexcept
+{
+    // Compute the int32 sum of each node, requantize and apply the activation function.
+    for (std::size_t i{}; i < stage.outputSize; ++i)
+    {
+        const std::int8_t* weights{stage.weights.data() + i * stage.inputSize};
+        const std::int32_t sum{stage.bias[i] + linalg::dot(stage.inputSize, input, weights)};
+        const std::int32_t preAct{requantize(sum, stage.multipliers[i], stage.preActZeroPoint)};
+        output[i] = stage.actFunc[preAct - Int8Min];
+    }
+}
+} // namespace ml::quant
@@ -46,6 +46,9 @@ double Generator::float64(const double min, const double max) const noexcept
     return (std::rand() / static_cast<double>(RAND_MAX)) * (max - min) + min;
 }
 
+// -----------------------------------------------------------------------------
+void Generator::seed(const std::uint32_t value) const noexcept { std::srand(value); }
+
 // -----------------------------------------------------------------------------
 Generator::Generator() noexcept
 {
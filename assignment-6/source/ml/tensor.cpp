@@ -0,0 +1,323 @@
+/**
+ * @brief Contiguous, strided tensor implementation details.
+ */
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+
+#include "ml/tensor.h"
+
+namespace ml
+{
+namespace
+{
+// -----------------------------------------------------------------------------
+Tensor::Shape toShape(const std::initializer_list<std::size_t> shape)
+{
+    // Throw an exception if the rank is too high.
+    if (Tensor::MaxRank < shape.size())
+    {
+        throw std::invalid_argument("Cannot create tensor: rank exceeds the maximum rank!");
+    }
+
+    // Copy the extents, dimensions beyond the rank get extent 1.
+    Tensor::Shape result{};
+    result.fill(1U);
+    std::copy(shape.begin(), shape.end(), result.begin());
+    return result;
+}
+
+// -----------------------------------------------------------------------------
+template <typename Function>
+void forEachOffset(const Tensor& tensor, Function&& function) noexcept
+{
+    // Visit the offset of each element in row-major order, taking the strides into account.
+    // The innermost dimension is looped over, the indices of the outer dimensions are
+    // advanced like an odometer, so every rank up to MaxRank is covered.
+    if (0U == tensor.size()) { return; }
+    const std::size_t last{0U < tensor.rank() ? tensor.rank() - 1U : 0U};
+    std::array<std::size_t, Tensor::MaxRank> index{};
+    std::size_t base{};
+
+    for (;;)
+    {
+        for (std::size_t l{}; l < tensor.dim(last); ++l) { function(base + l * tensor.stride(last)); }
+
+        // Advance to the next row, carrying into the outer dimensions, stop after the last row.
+        std::size_t d{last};
+
+        for (; 0U < d; --d)
+        {
+            const std::size_t outer{d - 1U};
+            base += tensor.stride(outer);
+            if (++index[outer] < tensor.dim(outer)) { break; }
+            base -= index[outer] * tensor.stride(outer);
+            index[outer] = 0U;
+        }
+        if (0U == d) { return; }
+    }
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+Tensor::Tensor() noexcept
+    : myStorage{nullptr}
+    , myData{nullptr}
+    , myShape{}
+    , myStrides{}
+    , myRank{}
+    , mySize{}
+{}
+
+// -----------------------------------------------------------------------------
+Tensor::Tensor(const std::initializer_list<std::size_t> shape)
+    : Tensor(toShape(shape), shape.size())
+{}
+
+// -----------------------------------------------------------------------------
+Tensor::Tensor(const Shape& shape, const std::size_t rank)
+    : Tensor()
+{
+    setShape(shape, rank);
+    allocate();
+}
+
+// -----------------------------------------------------------------------------
+Tensor::Tensor(const Tensor& other)
+    : Tensor(other.myShape, other.myRank)
+{
+    copyFrom(other);
+}
+
+// -----------------------------------------------------------------------------
+Tensor::Tensor(Tensor&& other) noexcept
+    : myStorage{std::move(other.myStorage)}
+    , myData{other.myData}
+    , myShape{other.myShape}
+    , myStrides{other.myStrides}
+    , myRank{other.myRank}
+    , mySize{other.mySize}
+{
+    other = Tensor{};
+}
+
+// -----------------------------------------------------------------------------
+Tensor& Tensor::operator=(const Tensor& other)
+{
+    // Allocate new storage and copy the elements, unless this is a self-assignment.
+    if (this != &other)
+    {
+        Tensor copy{other};
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+// -----------------------------------------------------------------------------
+Tensor& Tensor::operator=(Tensor&& other) noexcept
+{
+    // Transfer the storage, then reset the other tensor.
+    if (this != &other)
+    {
+        myStorage     = std::move(other.myStorage);
+        myData        = other.myData;
+        myShape       = other.myShape;
+        myStrides     = other.myStrides;
+        myRank        = other.myRank;
+        mySize        = other.mySize;
+        other.myData  = nullptr;
+        other.myShape = {};
+        other.myRank  = 0U;
+        other.mySize  = 0U;
+    }
+    return *this;
+}
+
+// -----------------------------------------------------------------------------
+Tensor Tensor::wrap(Scalar* data, const std::initializer_list<std::size_t> shape)
+{
+    Tensor view{};
+    view.setShape(toShape(shape), shape.size());
+    view.myData = data;
+    return view;
+}
+
+// -----------------------------------------------------------------------------
+Tensor Tensor::wrap(Scalar* data, const Shape& shape, const std::size_t rank)
+{
+    Tensor view{};
+    view.setShape(shape, rank);
+    view.myData = data;
+    return view;
+}
+
+// -----------------------------------------------------------------------------
+bool Tensor::isContiguous() const noexcept
+{
+    // Compare the strides with the strides of a row-major layout, starting from the last dimension.
+    std::size_t expected{1U};
+
+    for (std::size_t i{MaxRank}; i > 0U; --i)
+    {
+        if ((1U < myShape[i - 1U]) && (expected != myStrides[i - 1U])) { return false; }
+        expected *= myShape[i - 1U];
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+bool Tensor::sameShape(const Tensor& other) const noexcept
+{
+    return (myRank == other.myRank) && (myShape == other.myShape);
+}
+
+// -----------------------------------------------------------------------------
+void Tensor::fill(const Scalar value) noexcept
+{
+    // Fill the whole block at once if possible, else visit element by element.
+    if (isContiguous()) { std::fill(myData, myData + mySize, value); }
+    else { forEachOffset(*this, [&](const std::size_t offset) { myData[offset] = value; }); }
+}
+
+// -----------------------------------------------------------------------------
+bool Tensor::copyFrom(const Tensor& other) noexcept
+{
+    // Return false if the number of elements doesn't match.
+    if (mySize != other.mySize) { return false; }
+
+    // Copy the whole block at once if possible.
+    if (isContiguous() && other.isContiguous())
+    {
+        std::copy(other.myData, other.myData + mySize, myData);
+        return true;
+    }
+
+    // Else gather the source elements in row-major order, then scatter them.
+    Scalar* destination{myData};
+    const Shape& strides{myStrides};
+    const Shape& shape{myShape};
+    std::size_t index{};
+
+    forEachOffset(other, [&](const std::size_t offset)
+    {
+        // Compute the destination offset of the index-th element.
+        std::size_t remainder{index++};
+        std::size_t destOffset{};
+
+        for (std::size_t i{MaxRank}; i > 0U; --i)
+        {
+            destOffset += (remainder % shape[i - 1U]) * strides[i - 1U];
+            remainder /= shape[i - 1U];
+        }
+        destination[destOffset] = other.myData[offset];
+    });
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+Tensor Tensor::view() const noexcept
+{
+    Tensor view{};
+    view.myData    = myData;
+    view.myShape   = myShape;
+    view.myStrides = myStrides;
+    view.myRank    = myRank;
+    view.mySize    = mySize;
+    return view;
+}
+
+// -----------------------------------------------------------------------------
+Tensor Tensor::reshape(const std::initializer_list<std::size_t> shape) const
+{
+    // Only contiguous tensors can be reshaped without copying.
+    if (!isContiguous())
+    {
+        throw std::invalid_argument("Cannot reshape tensor: the tensor isn't contiguous!");
+    }
+
+    Tensor view{Tensor::wrap(myData, shape)};
+
+    // Throw an exception if the number of elements doesn't match.
+    if (view.mySize != mySize)
+    {
+        throw std::invalid_argument("Cannot reshape tensor: element count mismatch!");
+    }
+    return view;
+}
+
+// -----------------------------------------------------------------------------
+Tensor Tensor::slice(const std::size_t index) const noexcept
+{
+    // Drop the first dimension and offset the data pointer.
+    Tensor view{};
+    view.myData = myData + index * myStrides[0U];
+    view.myRank = 0U < myRank ? myRank - 1U : 0U;
+    view.myShape.fill(1U);
+    view.myStrides.fill(1U);
+
+    for (std::size_t i{1U}; i < MaxRank; ++i)
+    {
+        view.myShape[i - 1U]   = myShape[i];
+        view.myStrides[i - 1U] = myStrides[i];
+    }
+    view.mySize = 0U < myShape[0U] ? mySize / myShape[0U] : 0U;
+    return view;
+}
+
+// -----------------------------------------------------------------------------
+Tensor Tensor::narrow(const std::size_t dim, const std::size_t start,
+                      const std::size_t length) const
+{
+    // Throw an exception if the range is outside the dimension.
+    if ((myRank <= dim) || (myShape[dim] < start + length))
+    {
+        throw std::invalid_argument("Cannot narrow tensor: range out of bounds!");
+    }
+
+    // Keep the strides, offset the data pointer and shrink the dimension.
+    Tensor view{this->view()};
+    view.myData       = myData + start * myStrides[dim];
+    view.myShape[dim] = length;
+    view.mySize       = 0U < myShape[dim] ? mySize / myShape[dim] * length : 0U;
+    return view;
+}
+
+// -----------------------------------------------------------------------------
+void Tensor::setShape(const Shape& shape, const std::size_t rank)
+{
+    // Throw an exception if the rank is too high.
+    if (MaxRank < rank)
+    {
+        throw std::invalid_argument("Cannot create tensor: rank exceeds the maximum rank!");
+    }
+
+    // Store the shape, dimensions beyond the rank get extent 1.
+    myRank = rank;
+    myShape.fill(1U);
+    std::copy(shape.begin(), shape.begin() + rank, myShape.begin());
+
+    // Compute row-major strides and the element count.
+    std::size_t stride{1U};
+
+    for (std::size_t i{MaxRank}; i > 0U; --i)
+    {
+        myStrides[i - 1U] = stride;
+        stride *= myShape[i - 1U];
+    }
+    mySize = 0U < rank ? stride : 0U;
+}
+
+// -----------------------------------------------------------------------------
+void Tensor::allocate()
+{
+    // Allocate one aligned block holding all elements, initialized with zeros.
+    if (0U == mySize) { return; }
+    void* memory{::operator new[](mySize * sizeof(Scalar), std::align_val_t{Alignment})};
+    myStorage.reset(static_cast<Scalar*>(memory));
+    myData = myStorage.get();
+    zero();
+}
+} // namespace ml
@@ -3,146 +3,128 @@
  */
 #include <iomanip>
 #include <iostream>
+#include <stdexcept>
 
 #include "ml/random/generator.h"
+#include "ml/tensor.h"
 #include "ml/types.h"
 #include "ml/utils.h"
 
 namespace ml
 {
 // -----------------------------------------------------------------------------
-void initMatrix(Matrix1d& matrix) noexcept
-{ 
-    // Fill the matrix with zeros.
-    for (auto& num : matrix) { num = 0.0; }
-}
-
-// -----------------------------------------------------------------------------
-void initMatrix(Matrix2d& matrix) noexcept
-{ 
-    // Fill the matrix with zeros.
-    for (auto& row : matrix)
-    {
-        for (auto& column : row) { column = 0.0; }
+bool isMatrixSquare(const Tensor& matrix, const char* opName) noexcept
+{
+    // Print an error message and return false if the tensor isn't a square matrix.
+    if ((2U != matrix.rank()) || (matrix.dim(0U) != matrix.dim(1U)))
+    { 
+        if (nullptr != opName)
+        {
+            std::cerr << "Cannot perform " << opName << " due to matrix not being square!\n";
+        }
+        else { std::cout << "Matrix is not square!\n"; }
+        return false; 
     }
+    return true;
 }
 
 // -----------------------------------------------------------------------------
-void initMatrix(Matrix1d& matrix, const std::size_t size)
-{ 
-    // Resize the matrix if necessary.
-    matrix.resize(size);
-
-    // Fill the matrix with zeros.
-    initMatrix(matrix);
-}
-
-// -----------------------------------------------------------------------------
-void initMatrix(Matrix2d& matrix, const std::size_t size)
-{ 
-    // Resize the matrix f necessary.
-    matrix.resize(size, Matrix1d(size));
-
-    // Fill the matrix with zeros.
-    initMatrix(matrix);
-}
-
-// -----------------------------------------------------------------------------
-void initMatrix(Matrix2d& matrix, const std::size_t rowCount, const std::size_t colCount)
+void printMatrix(const Tensor& tensor, std::ostream& ostream,
+                 const std::size_t precision) noexcept
 {
-    // Resize the matrix f necessary.
-    matrix.resize(rowCount, Matrix1d(colCount));
-
-    // Fill the matrix with zeros.
-    initMatrix(matrix);
-}
+    // Set output formatting for floating point numbers.
+    ostream << std::fixed << std::setprecision(precision) << "[";
 
-// -----------------------------------------------------------------------------
-bool isMatrixSquare(const Matrix2d& matrix, const char* opName) noexcept
-{
-    // Check each row in the matrix.
-    for (std::size_t i{}; i < matrix.size(); ++i)
+    // Print one-dimensional tensors on a single line.
+    if (1U == tensor.rank())
+    {
+        for (std::size_t i{}; i < tensor.dim(0U); ++i)
+        {
+            ostream << tensor(i);
+            if (i + 1U < tensor.dim(0U)) { ostream << ", "; }
+        }
+        ostream << "]\n";
+    }
+    // Print two-dimensional tensors row by row.
+    else if (2U == tensor.rank())
     {
-        // Print an error message and return false if the matrix isn't square.
-        if (matrix[i].size() != matrix.size()) 
-        { 
-            if (nullptr != opName)
+        for (std::size_t i{}; i < tensor.dim(0U); ++i)
+        {
+            ostream << "[";
+
+            for (std::size_t j{}; j < tensor.dim(1U); ++j)
             {
-                std::cerr << "Cannot perform " << opName << " due to matrix not being square!\n";
+                ostream << tensor(i, j);
+                if (j + 1U < tensor.dim(1U)) { ostream << ", "; }
             }
-            else { std::cout << "Matrix is not square!\n"; }
-            return false; 
+            // Print row separator or closing bracket.
+            if (i + 1U < tensor.dim(0U)) { ostream << "],\n"; }
+            else { ostream << "]"; }
         }
+        ostream << "]\n";
+    }
+    // Print tensors of higher rank slice by slice.
+    else
+    {
+        ostream << "\n";
+        for (std::size_t i{}; i < tensor.dim(0U); ++i)
+        {
+            printMatrix(tensor.slice(i), ostream, precision);
+        }
+        ostream << "]\n";
     }
-    return true;
 }
 
 // -----------------------------------------------------------------------------
-bool isMatrixSquare(const Matrix2d& matrix, const std::size_t row, const char* opName) noexcept
+Tensor toTensor(const Matrix1d& matrix)
 {
-    // Check the specified row in the matrix if valid. Print an error message if not.
-    if (matrix.size() <= row)
-    {
-        std::cerr << "Invalid row " << row << " in matrix of size " << matrix.size() << "!\n";
-        return false;
-    }
+    // Copy the elements into a new tensor.
+    Tensor tensor{matrix.size()};
 
-    // Print an error message and return false if the matrix isn't square.
-    if (matrix[row].size() != matrix.size()) 
-    { 
-        if (nullptr != opName)
-        {
-            std::cerr << "Cannot perform " << opName << " due to matrix not being square!\n";
-        }
-        else { std::cout << "Matrix is not square!\n"; }
-        return false; 
-    }
-    return true;
+    for (std::size_t i{}; i < matrix.size(); ++i) { tensor(i) = matrix[i]; }
+    return tensor;
 }
 
 // -----------------------------------------------------------------------------
-void printMatrix(const ml::Matrix2d& matrix, std::ostream& ostream,
-                 const std::size_t precision) noexcept
+Tensor toTensor(const Matrix2d& matrix)
 {
-    // Set output formatting for floating point numbers.
-    ostream << std::fixed << std::setprecision(precision) << "[";
-    const auto* lastColumn{matrix.empty() ? nullptr : &matrix[matrix.size() - 1U]};
+    // Use the size of the first row as column count.
+    const std::size_t colCount{matrix.empty() ? 0U : matrix[0U].size()};
+    Tensor tensor{matrix.size(), colCount};
 
-    // Iterate over each row in the matrix.
-    for (const auto& column : matrix)
+    // Copy the elements row by row, throw an exception if the rows are of different size.
+    for (std::size_t i{}; i < matrix.size(); ++i)
     {
-        ostream << "[";
-        const auto* lastRow{column.empty() ? nullptr : &column[column.size() - 1U]};
-
-        // Print each element in the row.
-        for (const auto& row : column)
+        if (colCount != matrix[i].size())
         {
-            ostream << row;
-            if (&row < lastRow) { ostream << ", "; }
+            throw std::invalid_argument("Cannot convert matrix to tensor: row size mismatch!");
         }
-        // Print row separator or closing bracket.
-        if (&column < lastColumn) { ostream << "],\n"; }
-        else { ostream << "]"; }
+        for (std::size_t j{}; j < colCount; ++j) { tensor(i, j) = matrix[i][j]; }
     }
-    ostream << "]\n";
+    return tensor;
 }
 
 // -----------------------------------------------------------------------------
-void printMatrix(const ml::Matrix1d& matrix, std::ostream& ostream,
-                 const std::size_t precision) noexcept
+Tensor toTensor(const Matrix3d& matrix)
 {
-    // Set output formatting for floating point numbers.
-    ostream << std::fixed << std::setprecision(precision) << "[";
-
-    const auto* lastNum{matrix.empty() ? nullptr : &matrix[matrix.size() - 1U]};
+    // Use the dimensions of the first submatrix.
+    const std::size_t rowCount{matrix.empty() ? 0U : matrix[0U].size()};
+    const std::size_t colCount{0U == rowCount ? 0U : matrix[0U][0U].size()};
+    Tensor tensor{matrix.size(), rowCount, colCount};
 
-    // Iterate through the matrix.
-    for (const auto& num : matrix)
+    // Copy each submatrix, throw an exception if the submatrices are of different size.
+    for (std::size_t i{}; i < matrix.size(); ++i)
     {
-        ostream << num;
-        if (&num < lastNum) { ostream << ", "; }
+        const Tensor submatrix{toTensor(matrix[i])};
+
+        if ((rowCount != submatrix.dim(0U)) || (colCount != submatrix.dim(1U)))
+        {
+            throw std::invalid_argument("Cannot convert matrix to tensor: size mismatch!");
+        }
+        Tensor slice{tensor.slice(i)};
+        slice.copyFrom(submatrix);
     }
-    ostream << "]\n";
+    return tensor;
 }
 
 // -----------------------------------------------------------------------------
@@ -167,6 +149,47 @@ bool matchDimensions(const std::size_t expectedSize, const std::size_t actualSiz
     return false;
 }
 
+// -----------------------------------------------------------------------------
+std::size_t batchSize(const Tensor& tensor, const Tensor& storage, const char* opName) noexcept
+{
+    // A single sample has one dimension less than the storage, a batch the same rank.
+    const std::size_t sampleRank{0U < storage.rank() ? storage.rank() - 1U : 0U};
+    const std::size_t offset{tensor.rank() == storage.rank() ? 1U : 0U};
+    bool match{(0U < sampleRank) && (sampleRank + offset == tensor.rank())};
+
+    // Compare the sample dimensions.
+    for (std::size_t i{}; match && (i < sampleRank); ++i)
+    {
+        match = tensor.dim(i + offset) == storage.dim(i + 1U);
+    }
+
+    // Return the number of samples if the batch fits in the storage.
+    const std::size_t count{0U < offset ? tensor.dim(0U) : 1U};
+    if (match && (0U < count) && (count <= storage.dim(0U))) { return count; }
+
+    // Print an error message on mismatch if requested.
+    if (nullptr != opName)
+    {
+        std::cerr << "Cannot perform " << opName << " due to dimension mismatch: expected a "
+                  << "sample or a batch of at most " << storage.dim(0U) << " samples!\n";
+    }
+    return 0U;
+}
+
+// -----------------------------------------------------------------------------
+Tensor batchView(const Tensor& storage, const std::size_t batchSize, const bool batched)
+{
+    // Keep the batch dimension for batches, drop it for single samples.
+    return batched ? storage.narrow(0U, 0U, batchSize) : storage.slice(0U);
+}
+
+// -----------------------------------------------------------------------------
+Tensor sampleView(const Tensor& tensor, const std::size_t sampleRank, 
+                  const std::size_t index) noexcept
+{
+    return sampleRank < tensor.rank() ? tensor.slice(index) : tensor.view();
+}
+
 // -----------------------------------------------------------------------------
 bool checkLearningRate(const double learningRate, const char* opName) noexcept
 {
@@ -185,13 +208,13 @@ bool checkLearningRate(const double learningRate, const char* opName) noexcept
 }
 
 // -----------------------------------------------------------------------------
-double randomStartVal() noexcept
+Scalar randomStartVal() noexcept
 {
     constexpr double min{0.0};
     constexpr double max{1.0};
 
     // Return a random starting value in the range [0.0, 1.0] (inclusive).
-    return random::Generator::getInstance().float64(min, max);
+    return static_cast<Scalar>(random::Generator::getInstance().float64(min, max));
 }
 
 // -----------------------------------------------------------------------------
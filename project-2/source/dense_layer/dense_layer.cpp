@@ -58,17 +58,18 @@ double actFuncOutput(const ml::ActFunc actFunc, const double input) noexcept
 }
 
 // -----------------------------------------------------------------------------
-double actFuncDelta(const ActFunc actFunc, const double input) noexcept
+double actFuncDelta(const ActFunc actFunc, const double output) noexcept
 {
     // Calculate how much the activation function changes (needed for learning).
+    // The derivative is computed from the output y = f(x), which is already stored.
     switch (actFunc)
     {
         case ml::ActFunc::Relu:
-             // ReLU derivative: f'(x) = 1 if x > 0, else 0.
-             return 0.0 < input ? 1.0 : 0.0;
+             // ReLU derivative: f'(x) = 1 if x > 0 (i.e. y > 0), else 0.
+             return 0.0 < output ? 1.0 : 0.0;
         case ml::ActFunc::Tanh:
-             // Tanh derivative: f'(x) = 1 - tanh²(x).
-             return 1.0 - std::tanh(input) * std::tanh(input);
+             // Tanh derivative: f'(x) = 1 - tanh²(x) = 1 - y².
+             return 1.0 - output * output;
         default:
             std::cout << "Invalid activation function!\n";
             return 0.0;